@@ -0,0 +1,195 @@
+#include <stdlib.h>
+#include <string.h>
+#include "Asset_Pack.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+
+_Static_assert(sizeof(asset_pack_header_t) == 16, "asset_pack_header_t is part of the pack format");
+_Static_assert(sizeof(asset_pack_entry_t) == 40, "asset_pack_entry_t is part of the pack format");
+
+static const char *TAG_ASSET = "ASSET_PACK";
+
+static const asset_pack_entry_t *pack_index;   // entries of the loaded pack, in the pack itself
+static lv_img_dsc_t *pack_dscs;                 // one image source per entry, data pointing into the pack
+static uint16_t pack_count;
+
+/* Index order: name bytewise (NUL padded), then frame */
+static int asset_cmp(const char *name, uint16_t frame, const asset_pack_entry_t *e)
+{
+    int c = strncmp(name, e->name, ASSET_PACK_NAME_MAX);
+    return c ? c : (int) frame - (int) e->frame;
+}
+
+/* The least size of the pixels: the row index of run-length encoded images, pointing inside the pixels,
+ * and rows of packets giving exactly `w` pixels each before the end of the pixels. UINT32_MAX if broken */
+static uint32_t asset_min_size(const asset_pack_entry_t *e, const uint8_t *px)
+{
+    if (e->header.cf != LV_IMG_CF_RLE_TRUE_COLOR && e->header.cf != LV_IMG_CF_RLE_TRUE_COLOR_ALPHA) {
+        return lv_img_buf_get_img_size(e->header.w, e->header.h, e->header.cf);
+    }
+    if (e->header.h == 0) {
+        // No row index to find the rows by, the decoder rejects it too
+        return UINT32_MAX;
+    }
+    uint32_t index_size = e->header.h * sizeof(uint32_t);
+    if (e->size < index_size) {
+        return index_size;
+    }
+    uint32_t px_size = e->header.cf == LV_IMG_CF_RLE_TRUE_COLOR ? sizeof(lv_color_t) : LV_IMG_PX_SIZE_ALPHA_BYTE;
+    for (uint32_t y = 0; y < e->header.h; y++) {
+        uint32_t ofs;
+        memcpy(&ofs, px + y * sizeof(uint32_t), sizeof(ofs));
+        if (ofs < index_size || ofs >= e->size) {
+            return UINT32_MAX;
+        }
+        uint32_t x = 0;
+        while (x < e->header.w) {
+            if (ofs >= e->size) {
+                return UINT32_MAX;
+            }
+            uint8_t ctrl = px[ofs];
+            uint32_t n = (ctrl & 0x7F) + 1;
+            ofs += 1 + ((ctrl & 0x80) ? px_size : n * px_size);
+            x += n;
+            if (ofs > e->size || x > e->header.w) {
+                return UINT32_MAX;
+            }
+        }
+    }
+    return index_size;
+}
+
+static esp_err_t asset_check_entry(const asset_pack_header_t *hdr, const asset_pack_entry_t *e, uint32_t blobs_start)
+{
+    if (e->name[ASSET_PACK_NAME_MAX - 1] != '\0' || e->name[0] == '\0') {
+        ESP_LOGE(TAG_ASSET, "entry with a bad name");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (e->offset % ASSET_PACK_ALIGN || e->offset < blobs_start || e->offset > hdr->size || e->size > hdr->size - e->offset) {
+        ESP_LOGE(TAG_ASSET, "%s: pixels outside the pack", e->name);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (e->header.always_zero || e->header.cf == LV_IMG_CF_UNKNOWN || e->frame >= e->frames ||
+        e->size < asset_min_size(e, (const uint8_t *) hdr + e->offset)) {
+        ESP_LOGE(TAG_ASSET, "%s: bad image header", e->name);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t Asset_Pack_Load(const void *pack, size_t size)
+{
+    const asset_pack_header_t *hdr = pack;
+
+    if (pack == NULL || (uintptr_t) pack % ASSET_PACK_ALIGN || size < sizeof(*hdr) || hdr->magic != ASSET_PACK_MAGIC) {
+        ESP_LOGW(TAG_ASSET, "no asset pack");
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (hdr->version != ASSET_PACK_VERSION || hdr->entry_size != sizeof(asset_pack_entry_t)) {
+        ESP_LOGE(TAG_ASSET, "asset pack version %u not supported", hdr->version);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (hdr->size > size || sizeof(*hdr) + (size_t) hdr->count * sizeof(asset_pack_entry_t) > hdr->size) {
+        ESP_LOGE(TAG_ASSET, "asset pack truncated (%u bytes, %u available)", (unsigned) hdr->size, (unsigned) size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+#if LV_COLOR_DEPTH == 16
+    if (!(hdr->flags & ASSET_PACK_FLAG_COLOR_16_SWAP) != !LV_COLOR_16_SWAP) {
+        ESP_LOGE(TAG_ASSET, "asset pack pixel byte order does not match LV_COLOR_16_SWAP %d", LV_COLOR_16_SWAP);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#endif
+
+    const asset_pack_entry_t *index = (const asset_pack_entry_t *)(hdr + 1);
+    uint32_t blobs_start = sizeof(*hdr) + hdr->count * sizeof(asset_pack_entry_t);
+    for (uint16_t i = 0; i < hdr->count; i++) {
+        esp_err_t err = asset_check_entry(hdr, &index[i], blobs_start);
+        if (err != ESP_OK) {
+            return err;
+        }
+        // Lookups are binary searches: the index must be strictly ordered
+        if (i > 0 && asset_cmp(index[i].name, index[i].frame, &index[i - 1]) <= 0) {
+            ESP_LOGE(TAG_ASSET, "%s: index not sorted", index[i].name);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    lv_img_dsc_t *dscs = malloc((hdr->count ? hdr->count : 1) * sizeof(lv_img_dsc_t));
+    if (dscs == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint16_t i = 0; i < hdr->count; i++) {
+        dscs[i] = (lv_img_dsc_t) {
+            .header = index[i].header,
+            .data_size = index[i].size,
+            .data = (const uint8_t *) pack + index[i].offset,
+        };
+    }
+    free(pack_dscs);
+    pack_dscs = dscs;
+    pack_index = index;
+    pack_count = hdr->count;
+    ESP_LOGI(TAG_ASSET, "asset pack: %u images, %u bytes", hdr->count, (unsigned) hdr->size);
+    return ESP_OK;
+}
+
+esp_err_t Asset_Pack_Init(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, ASSET_PACK_PARTITION);
+    const void *pack = NULL;
+    esp_partition_mmap_handle_t handle;
+
+    if (part == NULL) {
+        ESP_LOGW(TAG_ASSET, "no %s partition", ASSET_PACK_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+    // The pixels are read by LVGL straight from flash through the cache, the mapping is never released
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &pack, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG_ASSET, "cannot map %s: %s", ASSET_PACK_PARTITION, esp_err_to_name(err));
+        return err;
+    }
+    err = Asset_Pack_Load(pack, part->size);
+    if (err != ESP_OK) {
+        esp_partition_munmap(handle);
+    }
+    return err;
+}
+
+uint16_t Asset_Count(void)
+{
+    return pack_count;
+}
+
+/* Position of (name, frame) in the index, or -1 */
+static int asset_find(const char *name, uint16_t frame)
+{
+    int lo = 0, hi = pack_count;
+
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (asset_cmp(name, frame, &pack_index[mid]) > 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < pack_count && asset_cmp(name, frame, &pack_index[lo]) == 0 ? lo : -1;
+}
+
+const lv_img_dsc_t *Asset_Get_Frame(const char *name, uint16_t frame)
+{
+    int i = name ? asset_find(name, frame) : -1;
+    return i < 0 ? NULL : &pack_dscs[i];
+}
+
+const lv_img_dsc_t *Asset_Get(const char *name)
+{
+    return Asset_Get_Frame(name, 0);
+}
+
+uint16_t Asset_Frame_Count(const char *name)
+{
+    int i = name ? asset_find(name, 0) : -1;
+    return i < 0 ? 0 : pack_index[i].frames;
+}
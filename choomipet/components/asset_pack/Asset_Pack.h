@@ -0,0 +1,45 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+// Data partition holding the pack (partitions.csv), written with tools/asset_pack.py and parttool.py
+#define ASSET_PACK_PARTITION           "flash_test"
+#define ASSET_PACK_MAGIC               0x4B415043      // "CPAK"
+#define ASSET_PACK_VERSION             1
+#define ASSET_PACK_NAME_MAX            24              // name bytes in the index, NUL padded, at least one NUL
+#define ASSET_PACK_ALIGN               4               // every pixel blob starts on this boundary
+#define ASSET_PACK_FLAG_COLOR_16_SWAP  0x0001          // 16 bit pixels are stored MSB first (LV_COLOR_16_SWAP 1)
+
+/*
+ * Pack layout, little-endian:
+ *   asset_pack_header_t
+ *   asset_pack_entry_t[count]      sorted by name (bytewise), then frame
+ *   pixel blobs                    ASSET_PACK_ALIGN aligned, in LVGL's format for header.cf
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;          // index entries
+    uint32_t size;           // bytes of the whole pack, header included
+    uint16_t flags;          // ASSET_PACK_FLAG_*
+    uint16_t entry_size;     // sizeof(asset_pack_entry_t)
+} asset_pack_header_t;
+
+typedef struct {
+    char name[ASSET_PACK_NAME_MAX];
+    uint16_t frame;          // frame number within the name, 0 for a still image
+    uint16_t frames;         // frames sharing the name, the same in each of them
+    lv_img_header_t header;
+    uint32_t offset;         // pixel blob, from the start of the pack
+    uint32_t size;           // lv_img_dsc_t.data_size
+} asset_pack_entry_t;
+
+esp_err_t Asset_Pack_Init(void);                        // Map ASSET_PACK_PARTITION and load its pack; without a valid pack every lookup returns NULL
+esp_err_t Asset_Pack_Load(const void *pack, size_t size); // Load a pack already in addressable memory; it must stay there
+uint16_t Asset_Count(void);                              // Index entries of the loaded pack
+const lv_img_dsc_t *Asset_Get(const char *name);         // Frame 0 of `name` as an image source whose pixels stay in the pack, or NULL
+const lv_img_dsc_t *Asset_Get_Frame(const char *name, uint16_t frame);
+uint16_t Asset_Frame_Count(const char *name);            // 0 if `name` is not in the pack
@@ -26,7 +26,7 @@ void LCD_Init(void)
         .lcd_cmd_bits = EXAMPLE_LCD_CMD_BITS,
         .lcd_param_bits = EXAMPLE_LCD_PARAM_BITS,
         .spi_mode = 0,
-        .trans_queue_depth = 10,
+        .trans_queue_depth = EXAMPLE_LCD_TRANS_QUEUE_DEPTH,
         .on_color_trans_done = example_notify_lvgl_flush_ready,
         .user_ctx = &disp_drv,
     };
@@ -36,7 +36,8 @@ void LCD_Init(void)
     esp_lcd_panel_dev_st7789t_config_t panel_config = {
         .reset_gpio_num = EXAMPLE_PIN_NUM_LCD_RST,
         .rgb_endian = LCD_RGB_ENDIAN_BGR,
-        .bits_per_pixel = 16,
+        .bits_per_pixel = EXAMPLE_LCD_BITS_PER_PIXEL,
+        .flags.little_endian = LVGL_PANEL_LITTLE_ENDIAN,
     };
     ESP_LOGI(TAG_LCD, "Install ST7789T panel driver");
     ESP_ERROR_CHECK(esp_lcd_new_panel_st7789t(io_handle, &panel_config, &panel_handle));
@@ -72,10 +73,16 @@ void BK_Init(void)
     // 配置LEDC
     ledc_timer_config_t ledc_timer = {
         .duty_resolution = LEDC_TIMER_13_BIT,
-        .freq_hz = 5000,
         .speed_mode = LEDC_LS_MODE,
         .timer_num = LEDC_HS_TIMER,
+#if CONFIG_PM_ENABLE
+        // 浅睡眠时APB时钟停止，改用RC_FAST时钟让背光PWM保持输出（13位分辨率下最高约2kHz）
+        .freq_hz = 2000,
+        .clk_cfg = LEDC_USE_RC_FAST_CLK
+#else
+        .freq_hz = 5000,
         .clk_cfg = LEDC_AUTO_CLK
+#endif
     };
     ledc_timer_config(&ledc_timer);
 
@@ -84,6 +91,9 @@ void BK_Init(void)
     ledc_channel.gpio_num   = EXAMPLE_PIN_NUM_BK_LIGHT;
     ledc_channel.speed_mode = LEDC_LS_MODE;
     ledc_channel.timer_sel  = LEDC_HS_TIMER;
+#if CONFIG_PM_ENABLE
+    ledc_channel.sleep_mode = LEDC_SLEEP_MODE_KEEP_ALIVE;
+#endif
     ledc_channel_config(&ledc_channel);
     ledc_fade_func_install(0);
 }
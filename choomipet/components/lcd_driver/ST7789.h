@@ -31,6 +31,14 @@
 // The pixel number in horizontal and vertical
 #define EXAMPLE_LCD_H_RES              172
 #define EXAMPLE_LCD_V_RES              320
+// Pixel format on the SPI bus: 16 (RGB565) or 12 (RGB444, LVGL_Driver packs each band before sending it)
+#ifndef EXAMPLE_LCD_BITS_PER_PIXEL
+#define EXAMPLE_LCD_BITS_PER_PIXEL     16
+#endif
+// Panel refresh rate set by Frame Rate Control (0xC6 = 0x0F) in the Vernon_ST7789T init sequence; LVGL paces frames to a divisor of it
+#define EXAMPLE_LCD_REFRESH_HZ         60
+// Depth of the panel IO SPI transaction queue
+#define EXAMPLE_LCD_TRANS_QUEUE_DEPTH  10
 // Bit number used to represent command and parameter
 #define EXAMPLE_LCD_CMD_BITS           8
 #define EXAMPLE_LCD_PARAM_BITS         8
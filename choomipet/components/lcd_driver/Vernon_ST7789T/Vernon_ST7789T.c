@@ -47,6 +47,9 @@ typedef struct {
     uint8_t fb_bits_per_pixel;
     uint8_t madctl_val; // save current value of LCD_CMD_MADCTL register
     uint8_t colmod_cal; // save surrent value of LCD_CMD_COLMOD register
+    uint8_t ramctrl_val; // second parameter of RAMCTRL (0xB0), holds the ENDIAN bit
+    int vscroll_top;     // frame memory line of the first scrolling line (VSCRDEF TFA)
+    int vscroll_height;  // number of scrolling lines (VSCRDEF VSA)
 } st7789t_panel_t;
 
 esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_st7789t_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel)
@@ -86,6 +89,10 @@ esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const es
         st7789t->colmod_cal = 0x55;
         fb_bits_per_pixel = 16;
         break;
+    case 12: // RGB444, two pixels packed in three bytes
+        st7789t->colmod_cal = 0x53;
+        fb_bits_per_pixel = 12;
+        break;
     case 18: // RGB666
         st7789t->colmod_cal = 0x66;
         // each color component (R/G/B) should occupy the 6 high bits of a byte, which means 3 full bytes are required for a pixel
@@ -96,6 +103,11 @@ esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const es
         break;
     }
 
+    // RAMCTRL: EPF = 10, ENDIAN selects the byte order of 65K pixels on the wire
+    st7789t->ramctrl_val = panel_dev_config->flags.little_endian ? 0xE8 : 0xE0;
+    // power-on default: the whole frame memory scrolls
+    st7789t->vscroll_height = ST7789T_GRAM_LINES;
+
     st7789t->io = io;
     st7789t->fb_bits_per_pixel = fb_bits_per_pixel;
     st7789t->reset_gpio_num = panel_dev_config->reset_gpio_num;
@@ -168,10 +180,10 @@ static esp_err_t panel_st7789t_init(esp_lcd_panel_t *panel)
     
     /* Memory Data Access Control, MX=MV=1, MY=ML=MH=0, RGB=0 */
     esp_lcd_panel_io_tx_param(io, 0x36, (uint8_t []){0x00}, 1);                           // 0x36: 接口像素格式 X镜像，Y镜像
-    /* Interface Pixel Format, 16bits/pixel for RGB/MCU interface */
-    esp_lcd_panel_io_tx_param(io, 0x3A, (uint8_t []){0x55}, 1);                           // 0x3A: Porch 设置
+    /* Interface Pixel Format: 12, 16 or 18 bits/pixel, from bits_per_pixel */
+    esp_lcd_panel_io_tx_param(io, 0x3A, (uint8_t []){st7789t->colmod_cal}, 1);           // 0x3A: Porch 设置
     
-    esp_lcd_panel_io_tx_param(io, 0xB0, (uint8_t []){0x00, 0xE8}, 2);   
+    esp_lcd_panel_io_tx_param(io, 0xB0, (uint8_t []){0x00, st7789t->ramctrl_val}, 2);
     /* Porch Setting */
     esp_lcd_panel_io_tx_param(io, 0xB2, (uint8_t []){0x0c, 0x0c, 0x00, 0x33, 0x33}, 5);      
     /* Gate Control, Vgh=13.65V, Vgl=-10.43V */
@@ -229,7 +241,8 @@ static esp_err_t panel_st7789t_draw_bitmap(esp_lcd_panel_t *panel, int x_start,
         (y_end - 1) & 0xFF,
     }, 4);
     // transfer frame buffer
-    size_t len = (x_end - x_start) * (y_end - y_start) * st7789t->fb_bits_per_pixel / 8;
+    // rounded up: an odd pixel count at 12 bpp ends with half a byte
+    size_t len = ((x_end - x_start) * (y_end - y_start) * st7789t->fb_bits_per_pixel + 7) / 8;
     esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, color_data, len);
 
     return ESP_OK;
@@ -305,3 +318,38 @@ static esp_err_t panel_st7789t_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
     esp_lcd_panel_io_tx_param(io, command, NULL, 0);
     return ESP_OK;
 }
+
+esp_err_t esp_lcd_st7789t_vscroll_define(esp_lcd_panel_handle_t panel, int top, int height)
+{
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    esp_lcd_panel_io_handle_t io = st7789t->io;
+
+    top += st7789t->y_gap;
+    ESP_RETURN_ON_FALSE(top >= 0 && height > 0 && top + height <= ST7789T_GRAM_LINES, ESP_ERR_INVALID_ARG, TAG, "invalid scroll area");
+    int bottom = ST7789T_GRAM_LINES - top - height;
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_VSCRDEF, (uint8_t[]) {
+        (top >> 8) & 0xFF,
+        top & 0xFF,
+        (height >> 8) & 0xFF,
+        height & 0xFF,
+        (bottom >> 8) & 0xFF,
+        bottom & 0xFF,
+    }, 6);
+    st7789t->vscroll_top = top;
+    st7789t->vscroll_height = height;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7789t_vscroll_start(esp_lcd_panel_handle_t panel, int offset)
+{
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    esp_lcd_panel_io_handle_t io = st7789t->io;
+
+    ESP_RETURN_ON_FALSE(offset >= 0 && offset < st7789t->vscroll_height, ESP_ERR_INVALID_ARG, TAG, "invalid scroll offset");
+    int line = st7789t->vscroll_top + offset;
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_VSCSAD, (uint8_t[]) {
+        (line >> 8) & 0xFF,
+        line & 0xFF,
+    }, 2);
+    return ESP_OK;
+}
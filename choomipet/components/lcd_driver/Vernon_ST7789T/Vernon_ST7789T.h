@@ -22,9 +22,10 @@ typedef struct {
         lcd_color_rgb_endian_t color_space; /*!< @deprecated Set RGB color space, please use rgb_endian instead */
         lcd_color_rgb_endian_t rgb_endian;  /*!< Set RGB data endian: RGB or BGR */
     };
-    unsigned int bits_per_pixel;       /*!< Color depth, in bpp */
+    unsigned int bits_per_pixel;       /*!< Color depth, in bpp: 12 (RGB444), 16 (RGB565) or 18 (RGB666) */
     struct {
         unsigned int reset_active_high: 1; /*!< Setting this if the panel reset is high level active */
+        unsigned int little_endian: 1;     /*!< Set if RGB565 pixels are sent LSB first (RAMCTRL ENDIAN), MSB first otherwise */
     } flags;                               /*!< LCD panel config flags */
     void *vendor_config; /*!< vendor specific configuration, optional, left as NULL if not used */
 } esp_lcd_panel_dev_st7789t_config_t;
@@ -42,6 +43,41 @@ typedef struct {
  */
 esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_st7789t_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Number of lines of the ST7789T frame memory, the vertical scroll areas always add up to it
+ */
+#define ST7789T_GRAM_LINES 320
+
+/**
+ * @brief Define the vertical scrolling area (VSCRDEF)
+ *
+ * Lines [top, top + height) of the frame memory scroll, the lines above and below stay fixed.
+ * The gap set with esp_lcd_panel_set_gap() is applied to `top`, like in esp_lcd_panel_draw_bitmap().
+ * Scrolling follows the frame memory lines, so it is only meaningful without Y mirroring (MADCTL MY = 0).
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st7789t()
+ * @param[in] top First line of the scrolling area
+ * @param[in] height Number of lines in the scrolling area
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if the area does not fit into the frame memory
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_vscroll_define(esp_lcd_panel_handle_t panel, int top, int height);
+
+/**
+ * @brief Set the vertical scroll start address (VSCSAD)
+ *
+ * The first line of the scrolling area shows frame memory line `top + offset`, the following lines
+ * continue from there and wrap around inside the scrolling area. Offset 0 turns scrolling off.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st7789t()
+ * @param[in] offset Scroll offset inside the area set by esp_lcd_st7789t_vscroll_define(), 0 .. height - 1
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if the offset is outside the scrolling area
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_vscroll_start(esp_lcd_panel_handle_t panel, int offset);
+
 #ifdef __cplusplus
 }
 #endif
@@ -168,6 +168,13 @@ LV_EXPORT_CONST_INT(LV_DPI_DEF);
     #define LV_LOG_TRACE_ANIM       0
 #endif  /*LV_USE_LOG*/
 
+/*Variables of the drawing functions: one instance per thread when the screen is rendered in parallel*/
+#if LV_USE_PARALLEL_RENDER
+    #define LV_RENDER_LOCAL _Thread_local
+#else
+    #define LV_RENDER_LOCAL
+#endif
+
 
 /*If running without lv_conf.h add typedefs with default value*/
 #ifdef LV_CONF_SKIP
@@ -34,7 +34,7 @@ static bool event_is_bubbled(lv_event_t * e);
 /**********************
  *  STATIC VARIABLES
  **********************/
-static lv_event_t * event_head;
+static LV_RENDER_LOCAL lv_event_t * event_head;   /*Per thread: the draw events are sent by every rendering thread*/
 
 /**********************
  *      MACROS
@@ -159,6 +159,21 @@ void _lv_event_mark_deleted(lv_obj_t * obj)
 }
 
 
+bool _lv_event_has_draw_cb(const lv_obj_t * obj)
+{
+    if(!obj->spec_attr) return false;
+
+    uint32_t i;
+    for(i = 0; i < obj->spec_attr->event_dsc_cnt; i++) {
+        const lv_event_dsc_t * event_dsc = &obj->spec_attr->event_dsc[i];
+        lv_event_code_t code = event_dsc->filter & ~LV_EVENT_PREPROCESS;
+        if(event_dsc->cb == NULL) continue;
+        if(code == LV_EVENT_ALL || (code >= LV_EVENT_DRAW_MAIN_BEGIN && code <= LV_EVENT_DRAW_PART_END)) return true;
+    }
+
+    return false;
+}
+
 struct _lv_event_dsc_t * lv_obj_add_event_cb(lv_obj_t * obj, lv_event_cb_t event_cb, lv_event_code_t filter,
                                              void * user_data)
 {
@@ -223,6 +223,15 @@ uint32_t lv_event_register_id(void);
  */
 void _lv_event_mark_deleted(struct _lv_obj_t * obj);
 
+/**
+ * Tell whether an event handler was added to an object for any of the draw events
+ * (`LV_EVENT_DRAW_MAIN_BEGIN` ... `LV_EVENT_DRAW_PART_END` or `LV_EVENT_ALL`).
+ * The handlers of the object's class don't count.
+ * @param obj       pointer to an object
+ * @return          true: the object has an event handler for the draw events
+ */
+bool _lv_event_has_draw_cb(const struct _lv_obj_t * obj);
+
 
 /**
  * Add an event handler function for an object.
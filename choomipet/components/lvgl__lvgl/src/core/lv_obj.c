@@ -14,6 +14,7 @@
 #include "lv_theme.h"
 #include "../misc/lv_assert.h"
 #include "../draw/lv_draw.h"
+#include "../draw/sw/lv_draw_sw.h"
 #include "../misc/lv_anim.h"
 #include "../misc/lv_timer.h"
 #include "../misc/lv_async.h"
@@ -63,6 +64,7 @@ static void lv_obj_draw(lv_event_t * e);
 static void lv_obj_event(const lv_obj_class_t * class_p, lv_event_t * e);
 static void draw_scrollbar(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx);
 static lv_res_t scrollbar_init_draw_dsc(lv_obj_t * obj, lv_draw_rect_dsc_t * dsc);
+static bool state_diff_is_scrollbar_only(lv_obj_t * obj, lv_state_t state1, lv_state_t state2);
 static bool obj_valid_child(const lv_obj_t * parent, const lv_obj_t * obj_to_find);
 static void lv_obj_set_state(lv_obj_t * obj, lv_state_t new_state);
 
@@ -196,6 +198,8 @@ void lv_init(void)
 
 void lv_deinit(void)
 {
+    lv_draw_sw_shadow_cache_free();
+    lv_gradient_free_cache();
     _lv_gc_clear_roots();
 
     lv_disp_set_default(NULL);
@@ -251,7 +255,7 @@ void lv_obj_add_flag(lv_obj_t * obj, lv_obj_flag_t f)
     }
 
     if((was_on_layout != lv_obj_is_layout_positioned(obj)) || (f & (LV_OBJ_FLAG_LAYOUT_1 |  LV_OBJ_FLAG_LAYOUT_2))) {
-        lv_obj_mark_layout_as_dirty(lv_obj_get_parent(obj));
+        _lv_obj_mark_layout_as_dirty_from(lv_obj_get_parent(obj), obj);
         lv_obj_mark_layout_as_dirty(obj);
     }
 
@@ -280,13 +284,13 @@ void lv_obj_clear_flag(lv_obj_t * obj, lv_obj_flag_t f)
     if(f & LV_OBJ_FLAG_HIDDEN) {
         lv_obj_invalidate(obj);
         if(lv_obj_is_layout_positioned(obj)) {
-            lv_obj_mark_layout_as_dirty(lv_obj_get_parent(obj));
+            _lv_obj_mark_layout_as_dirty_from(lv_obj_get_parent(obj), obj);
             lv_obj_mark_layout_as_dirty(obj);
         }
     }
 
     if((was_on_layout != lv_obj_is_layout_positioned(obj)) || (f & (LV_OBJ_FLAG_LAYOUT_1 |  LV_OBJ_FLAG_LAYOUT_2))) {
-        lv_obj_mark_layout_as_dirty(lv_obj_get_parent(obj));
+        _lv_obj_mark_layout_as_dirty_from(lv_obj_get_parent(obj), obj);
     }
 
 }
@@ -457,10 +461,13 @@ static void lv_obj_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_obj_enable_style_refresh(false); /*No need to refresh the style because the object will be deleted*/
     lv_obj_remove_style_all(obj);
     lv_obj_enable_style_refresh(true);
+    _lv_obj_style_cache_free(obj);
 
     /*Remove the animations from this object*/
     lv_anim_del(obj, NULL);
 
+    _lv_obj_reset_draw_list(obj, false);
+
     /*Delete from the group*/
     lv_group_t * group = lv_obj_get_group(obj);
     if(group) lv_group_remove_obj(obj);
@@ -474,6 +481,10 @@ static void lv_obj_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
             lv_mem_free(obj->spec_attr->event_dsc);
             obj->spec_attr->event_dsc = NULL;
         }
+        if(obj->spec_attr->layout_cache) {
+            lv_mem_free(obj->spec_attr->layout_cache);
+            obj->spec_attr->layout_cache = NULL;
+        }
 
         lv_mem_free(obj->spec_attr);
         obj->spec_attr = NULL;
@@ -859,7 +870,7 @@ static void lv_obj_event(const lv_obj_class_t * class_p, lv_event_t * e)
         lv_coord_t align = lv_obj_get_style_align(obj, LV_PART_MAIN);
         uint16_t layout = lv_obj_get_style_layout(obj, LV_PART_MAIN);
         if(layout || align || w == LV_SIZE_CONTENT || h == LV_SIZE_CONTENT) {
-            lv_obj_mark_layout_as_dirty(obj);
+            _lv_obj_mark_layout_as_dirty_from(obj, lv_event_get_param(e));
         }
     }
     else if(code == LV_EVENT_CHILD_DELETED) {
@@ -943,17 +954,47 @@ static void lv_obj_set_state(lv_obj_t * obj, lv_state_t new_state)
     lv_mem_buf_release(ts);
 
     if(cmp_res == _LV_STYLE_STATE_CMP_DIFF_REDRAW) {
-        lv_obj_invalidate(obj);
+        /*E.g. the scrollbars are highlighted in LV_STATE_SCROLLED: don't redraw the whole object*/
+        if(state_diff_is_scrollbar_only(obj, prev_state, new_state)) {
+            lv_obj_scrollbar_invalidate(obj);
+        }
+        else {
+            _lv_obj_reset_draw_list(obj, true);     /*The children can inherit e.g. the text color of the new state*/
+            lv_obj_invalidate(obj);
+        }
     }
     else if(cmp_res == _LV_STYLE_STATE_CMP_DIFF_LAYOUT) {
         lv_obj_refresh_style(obj, LV_PART_ANY, LV_STYLE_PROP_ANY);
     }
     else if(cmp_res == _LV_STYLE_STATE_CMP_DIFF_DRAW_PAD) {
+        _lv_obj_reset_draw_list(obj, true);
         lv_obj_invalidate(obj);
         lv_obj_refresh_ext_draw_size(obj);
     }
 }
 
+/**
+ * Tell whether only styles of the scrollbar part differ between two states
+ * @param obj       pointer to an object
+ * @param state1    a state
+ * @param state2    an other state
+ * @return          true: only the scrollbars look different
+ */
+static bool state_diff_is_scrollbar_only(lv_obj_t * obj, lv_state_t state1, lv_state_t state2)
+{
+    uint32_t i;
+    for(i = 0; i < obj->style_cnt; i++) {
+        if(obj->styles[i].is_trans) continue;
+
+        lv_state_t state_act = lv_obj_style_get_selector_state(obj->styles[i].selector);
+        bool valid1 = state_act & (~state1) ? false : true;
+        bool valid2 = state_act & (~state2) ? false : true;
+        if(valid1 != valid2 && lv_obj_style_get_selector_part(obj->styles[i].selector) != LV_PART_SCROLLBAR) return false;
+    }
+
+    return true;
+}
+
 static bool obj_valid_child(const lv_obj_t * parent, const lv_obj_t * obj_to_find)
 {
     /*Check all children of `parent`*/
@@ -160,6 +160,9 @@ typedef struct {
     struct _lv_event_dsc_t * event_dsc; /**< Dynamically allocated event callback and user data array*/
     lv_point_t scroll;                  /**< The current X/Y scroll offset*/
 
+    void * layout_cache;                /**< Data the layout keeps between its updates, see `_lv_obj_get_layout_cache()`*/
+    uint32_t layout_dirty_from;         /**< The first child changed since the last layout update (0: update all)*/
+
     lv_coord_t ext_click_pad;           /**< Extra click padding in all direction*/
     lv_coord_t ext_draw_size;           /**< EXTend the size in every direction for drawing.*/
 
@@ -181,8 +184,13 @@ typedef struct _lv_obj_t {
 #endif
     lv_area_t coords;
     lv_obj_flag_t flags;
+    struct _lv_draw_list_t * draw_list;     /**< Recorded draw calls, see `lv_disp_drv_t::retained_mem`*/
+#if LV_USE_OBJ_STYLE_CACHE
+    struct _lv_obj_style_cache_t * style_cache; /**< Cached style properties, see `LV_USE_OBJ_STYLE_CACHE`*/
+#endif
     lv_state_t state;
     uint16_t layout_inv : 1;
+    uint16_t child_layout_inv : 1;      /**< A descendant's layout is dirty, see `lv_obj_mark_layout_as_dirty()`*/
     uint16_t readjust_scroll_after_layout : 1;
     uint16_t scr_layout_inv : 1;
     uint16_t skip_trans : 1;
@@ -190,6 +198,8 @@ typedef struct _lv_obj_t {
     uint16_t h_layout   : 1;
     uint16_t w_layout   : 1;
     uint16_t being_deleted   : 1;
+    uint16_t draw_list_seen : 1;        /**< Drawn unchanged, its draw calls can be recorded in the next refresh*/
+    uint16_t draw_list_frame : 1;       /**< Parity of the refresh which drew it first*/
 } lv_obj_t;
 
 
@@ -393,6 +393,21 @@ lv_layer_type_t _lv_obj_get_layer_type(const lv_obj_t * obj)
     else return LV_LAYER_TYPE_NONE;
 }
 
+void _lv_obj_reset_draw_list(lv_obj_t * obj, bool children)
+{
+    _lv_draw_list_free(obj->draw_list);
+    obj->draw_list = NULL;
+    obj->draw_list_seen = 0;
+
+    if(children) {
+        uint32_t i;
+        uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+        for(i = 0; i < child_cnt; i++) {
+            _lv_obj_reset_draw_list(obj->spec_attr->children[i], true);
+        }
+    }
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -161,6 +161,13 @@ lv_coord_t _lv_obj_get_ext_draw_size(const struct _lv_obj_t * obj);
 
 lv_layer_type_t _lv_obj_get_layer_type(const struct _lv_obj_t * obj);
 
+/**
+ * Drop the recorded draw calls of an object because it will look different.
+ * @param obj       pointer to an object
+ * @param children  true: drop the draw calls of the children too (e.g. an inherited property changed)
+ */
+void _lv_obj_reset_draw_list(struct _lv_obj_t * obj, bool children);
+
 /**********************
  *      MACROS
  **********************/
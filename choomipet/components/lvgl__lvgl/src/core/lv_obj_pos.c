@@ -15,10 +15,20 @@
  *      DEFINES
  *********************/
 #define MY_CLASS &lv_obj_class
+#define ANIM_INV_CNT 4      /*Objects remembered as invalidated in an animation step*/
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    const lv_obj_t * obj;
+    lv_area_t area;
+} anim_inv_t;
+
+typedef struct {
+    uint32_t layout;
+    uint32_t size;
+} layout_cache_t;
 
 /**********************
  *  STATIC PROTOTYPES
@@ -26,12 +36,17 @@
 static lv_coord_t calc_content_width(lv_obj_t * obj);
 static lv_coord_t calc_content_height(lv_obj_t * obj);
 static void layout_update_core(lv_obj_t * obj);
+static lv_obj_t * mark_child_layout_inv(lv_obj_t * obj);
 static void transform_point(const lv_obj_t * obj, lv_point_t * p, bool inv);
+static bool invalidate_area(const lv_obj_t * obj, const lv_area_t * area);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static uint32_t layout_cnt;
+static anim_inv_t anim_inv[ANIM_INV_CNT];
+static uint32_t anim_inv_step;
+static uint8_t anim_inv_next;
 
 /**********************
  *      MACROS
@@ -201,6 +216,7 @@ bool lv_obj_refr_size(lv_obj_t * obj)
     lv_obj_invalidate(obj);
 
     obj->readjust_scroll_after_layout = 1;
+    mark_child_layout_inv(obj);
 
     /*If the object was out of the parent invalidate the new scrollbar area too.
      *If it wasn't out of the parent but out now, also invalidate the scrollbars*/
@@ -288,9 +304,10 @@ bool lv_obj_is_layout_positioned(const lv_obj_t * obj)
 void lv_obj_mark_layout_as_dirty(lv_obj_t * obj)
 {
     obj->layout_inv = 1;
+    if(obj->spec_attr) obj->spec_attr->layout_dirty_from = 0;
 
     /*Mark the screen as dirty too to mark that there is something to do on this screen*/
-    lv_obj_t * scr = lv_obj_get_screen(obj);
+    lv_obj_t * scr = mark_child_layout_inv(obj);
     scr->scr_layout_inv = 1;
 
     /*Make the display refreshing*/
@@ -298,6 +315,38 @@ void lv_obj_mark_layout_as_dirty(lv_obj_t * obj)
     if(disp->refr_timer) lv_timer_resume(disp->refr_timer);
 }
 
+void _lv_obj_mark_layout_as_dirty_from(lv_obj_t * obj, lv_obj_t * child)
+{
+    /*Search from the end: mostly the last, just created children change*/
+    uint32_t i = lv_obj_get_child_cnt(obj);
+    while(i > 0 && obj->spec_attr->children[i - 1] != child) i--;
+    if(i == 0) {
+        lv_obj_mark_layout_as_dirty(obj);
+        return;
+    }
+
+    uint32_t from = i - 1;
+    if(obj->layout_inv) from = LV_MIN(from, obj->spec_attr->layout_dirty_from);
+    lv_obj_mark_layout_as_dirty(obj);
+    obj->spec_attr->layout_dirty_from = from;
+}
+
+void * _lv_obj_get_layout_cache(lv_obj_t * obj, uint32_t layout, uint32_t size)
+{
+    layout_cache_t * cache = obj->spec_attr->layout_cache;
+    if(cache && cache->layout == layout && cache->size == size) return cache + 1;
+
+    cache = lv_mem_realloc(cache, sizeof(layout_cache_t) + size);
+    obj->spec_attr->layout_cache = cache;
+    LV_ASSERT_MALLOC(cache);
+    if(cache == NULL) return NULL;
+
+    cache->layout = layout;
+    cache->size = size;
+    lv_memset_00(cache + 1, size);
+    return cache + 1;
+}
+
 void lv_obj_update_layout(const lv_obj_t * obj)
 {
     static bool mutex = false;
@@ -838,14 +887,7 @@ void lv_obj_invalidate_area(const lv_obj_t * obj, const lv_area_t * area)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
-    lv_disp_t * disp   = lv_obj_get_disp(obj);
-    if(!lv_disp_is_invalidation_enabled(disp)) return;
-
-    lv_area_t area_tmp;
-    lv_area_copy(&area_tmp, area);
-    if(!lv_obj_area_is_visible(obj, &area_tmp)) return;
-
-    _lv_inv_area(lv_obj_get_disp(obj),  &area_tmp);
+    invalidate_area(obj, area);
 }
 
 void lv_obj_invalidate(const lv_obj_t * obj)
@@ -861,8 +903,24 @@ void lv_obj_invalidate(const lv_obj_t * obj)
     obj_coords.x2 += ext_size;
     obj_coords.y2 += ext_size;
 
-    lv_obj_invalidate_area(obj, &obj_coords);
+    /*The animations of a step often change several properties of the same object: invalidate it only once*/
+    uint32_t step = _lv_anim_get_step_id();
+    if(step) {
+        if(step != anim_inv_step) {
+            lv_memset_00(anim_inv, sizeof(anim_inv));
+            anim_inv_step = step;
+        }
+        uint32_t i;
+        for(i = 0; i < ANIM_INV_CNT; i++) {
+            if(anim_inv[i].obj == obj && _lv_area_is_equal(&anim_inv[i].area, &obj_coords)) return;
+        }
+    }
 
+    if(invalidate_area(obj, &obj_coords) && step) {
+        anim_inv[anim_inv_next].obj = obj;
+        anim_inv[anim_inv_next].area = obj_coords;
+        anim_inv_next = (anim_inv_next + 1) % ANIM_INV_CNT;
+    }
 }
 
 bool lv_obj_area_is_visible(const lv_obj_t * obj, lv_area_t * area)
@@ -1005,13 +1063,15 @@ static lv_coord_t calc_content_width(lv_obj_t * obj)
     lv_coord_t child_res = LV_COORD_MIN;
     uint32_t i;
     uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    /*The not hidden, not floating children are positioned by the layout if there is any*/
+    bool on_layout = lv_obj_get_style_layout(obj, LV_PART_MAIN) != 0;
     /*With RTL find the left most coordinate*/
     if(lv_obj_get_style_base_dir(obj, LV_PART_MAIN) == LV_BASE_DIR_RTL) {
         for(i = 0; i < child_cnt; i++) {
             lv_obj_t * child = obj->spec_attr->children[i];
             if(lv_obj_has_flag_any(child,  LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_FLOATING)) continue;
 
-            if(!lv_obj_is_layout_positioned(child)) {
+            if(!on_layout || lv_obj_has_flag(child, LV_OBJ_FLAG_IGNORE_LAYOUT)) {
                 lv_align_t align = lv_obj_get_style_align(child, 0);
                 switch(align) {
                     case LV_ALIGN_DEFAULT:
@@ -1043,7 +1103,7 @@ static lv_coord_t calc_content_width(lv_obj_t * obj)
             lv_obj_t * child = obj->spec_attr->children[i];
             if(lv_obj_has_flag_any(child,  LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_FLOATING)) continue;
 
-            if(!lv_obj_is_layout_positioned(child)) {
+            if(!on_layout || lv_obj_has_flag(child, LV_OBJ_FLAG_IGNORE_LAYOUT)) {
                 lv_align_t align = lv_obj_get_style_align(child, 0);
                 switch(align) {
                     case LV_ALIGN_DEFAULT:
@@ -1089,12 +1149,14 @@ static lv_coord_t calc_content_height(lv_obj_t * obj)
     lv_coord_t child_res = LV_COORD_MIN;
     uint32_t i;
     uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    /*The not hidden, not floating children are positioned by the layout if there is any*/
+    bool on_layout = lv_obj_get_style_layout(obj, LV_PART_MAIN) != 0;
     for(i = 0; i < child_cnt; i++) {
         lv_obj_t * child = obj->spec_attr->children[i];
         if(lv_obj_has_flag_any(child,  LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_FLOATING)) continue;
 
 
-        if(!lv_obj_is_layout_positioned(child)) {
+        if(!on_layout || lv_obj_has_flag(child, LV_OBJ_FLAG_IGNORE_LAYOUT)) {
             lv_align_t align = lv_obj_get_style_align(child, 0);
             switch(align) {
                 case LV_ALIGN_DEFAULT:
@@ -1132,17 +1194,27 @@ static void layout_update_core(lv_obj_t * obj)
 {
     uint32_t i;
     uint32_t child_cnt = lv_obj_get_child_cnt(obj);
-    for(i = 0; i < child_cnt; i++) {
-        lv_obj_t * child = obj->spec_attr->children[i];
-        layout_update_core(child);
+
+    /*Visit only the children with something to update in their subtree*/
+    if(obj->child_layout_inv) {
+        obj->child_layout_inv = 0;
+        for(i = 0; i < child_cnt; i++) {
+            lv_obj_t * child = obj->spec_attr->children[i];
+            layout_update_core(child);
+        }
     }
 
     if(obj->layout_inv) {
+        uint32_t dirty_from = child_cnt > 0 ? obj->spec_attr->layout_dirty_from : 0;
         obj->layout_inv = 0;
         lv_obj_refr_size(obj);
         lv_obj_refr_pos(obj);
 
         if(child_cnt > 0) {
+            /*Also update what was marked meanwhile (e.g. on size change) in one go*/
+            if(obj->layout_inv) dirty_from = LV_MIN(dirty_from, obj->spec_attr->layout_dirty_from);
+            obj->spec_attr->layout_dirty_from = dirty_from;
+
             uint32_t layout_id = lv_obj_get_style_layout(obj, LV_PART_MAIN);
             if(layout_id > 0 && layout_id <= layout_cnt) {
                 void  * user_data = LV_GC_ROOT(_lv_layout_list)[layout_id - 1].user_data;
@@ -1157,6 +1229,20 @@ static void layout_update_core(lv_obj_t * obj)
     }
 }
 
+/**
+ * Mark the parents of an object to visit it in the next layout update
+ * @param obj       pointer to an object
+ * @return          the screen of the object
+ */
+static lv_obj_t * mark_child_layout_inv(lv_obj_t * obj)
+{
+    while(obj->parent) {
+        obj = obj->parent;
+        obj->child_layout_inv = 1;
+    }
+    return obj;
+}
+
 static void transform_point(const lv_obj_t * obj, lv_point_t * p, bool inv)
 {
     int16_t angle = lv_obj_get_style_transform_angle(obj, 0);
@@ -1186,3 +1272,25 @@ static void transform_point(const lv_obj_t * obj, lv_point_t * p, bool inv)
 
     lv_point_transform(p, angle, zoom, &pivot);
 }
+
+/**
+ * Mark an area of an object as invalid
+ * @param obj   pointer to an object
+ * @param area  the area to redraw
+ * @return      true: the area was added to the invalid areas of the display
+ */
+static bool invalidate_area(const lv_obj_t * obj, const lv_area_t * area)
+{
+    /*Whatever changed, the recorded draw calls are outdated*/
+    _lv_obj_reset_draw_list((lv_obj_t *)obj, false);
+
+    lv_disp_t * disp   = lv_obj_get_disp(obj);
+    if(!lv_disp_is_invalidation_enabled(disp)) return false;
+
+    lv_area_t area_tmp;
+    lv_area_copy(&area_tmp, area);
+    if(!lv_obj_area_is_visible(obj, &area_tmp)) return false;
+
+    _lv_inv_area(lv_obj_get_disp(obj),  &area_tmp);
+    return true;
+}
@@ -146,6 +146,24 @@ bool lv_obj_is_layout_positioned(const struct _lv_obj_t * obj);
  */
 void lv_obj_mark_layout_as_dirty(struct _lv_obj_t * obj);
 
+/**
+ * Mark the object for layout update because one of its children changed (its size, flags or layout styles).
+ * The layout can keep the children before it where they are, see `spec_attr->layout_dirty_from`.
+ * @param obj      pointer to an object whose children needs to be updated
+ * @param child    the changed child. NULL or an other object: update all the children
+ */
+void _lv_obj_mark_layout_as_dirty_from(struct _lv_obj_t * obj, struct _lv_obj_t * child);
+
+/**
+ * Get the data a layout keeps about an object between its updates. It's freed with the object.
+ * @param obj      pointer to an object with children
+ * @param layout   ID of the layout
+ * @param size     size of the data
+ * @return         the data of the last update if it was kept by the same layout with the same size,
+ *                 else new zeroed data. NULL if out of memory
+ */
+void * _lv_obj_get_layout_cache(struct _lv_obj_t * obj, uint32_t layout, uint32_t size);
+
 /**
  * Update the layout of an object.
  * @param obj      pointer to an object whose children needs to be updated
@@ -11,6 +11,7 @@
 #include "lv_indev.h"
 #include "lv_disp.h"
 #include "lv_indev_scroll.h"
+#include "lv_refr.h"
 
 /*********************
  *      DEFINES
@@ -36,6 +37,10 @@ static void scroll_y_anim(void * obj, int32_t v);
 static void scroll_anim_ready_cb(lv_anim_t * a);
 static void scroll_area_into_view(const lv_area_t * area, lv_obj_t * child, lv_point_t * scroll_value,
                                   lv_anim_enable_t anim_en);
+static bool hw_vscroll(lv_obj_t * obj, lv_coord_t dy);
+static bool hw_vscroll_invariant(lv_obj_t * obj);
+static bool hw_vscroll_covered(lv_obj_t * obj, const lv_area_t * region);
+static bool obj_is_on(lv_obj_t * obj, const lv_area_t * area);
 
 /**********************
  *  STATIC VARIABLES
@@ -421,7 +426,7 @@ lv_res_t _lv_obj_scroll_by_raw(lv_obj_t * obj, lv_coord_t x, lv_coord_t y)
     lv_obj_move_children_by(obj, x, y, true);
     lv_res_t res = lv_event_send(obj, LV_EVENT_SCROLL, NULL);
     if(res != LV_RES_OK) return res;
-    lv_obj_invalidate(obj);
+    if(x != 0 || !hw_vscroll(obj, y)) lv_obj_invalidate(obj);
     return LV_RES_OK;
 }
 
@@ -798,3 +803,167 @@ static void scroll_area_into_view(const lv_area_t * area, lv_obj_t * child, lv_p
     scroll_value->y += anim_en == LV_ANIM_OFF ? 0 : y_scroll;
     lv_obj_scroll_by(parent, x_scroll, y_scroll, anim_en);
 }
+
+/**
+ * Let the display move the already flushed pixels of a vertically scrolled object
+ * (e.g. with hardware scrolling) and redraw only the rows scrolled in.
+ * Used only if the visible part of `obj` spans the whole width of the display,
+ * nothing but `obj` and its children is drawn there and the object's own drawing
+ * doesn't change when it's moved vertically.
+ * @param obj       the scrolled object, its children are already moved
+ * @param dy        the scroll distance, positive: the content moved down
+ * @return          true: handled, the exposed rows are invalidated; false: `obj` needs to be invalidated
+ */
+static bool hw_vscroll(lv_obj_t * obj, lv_coord_t dy)
+{
+    lv_disp_t * disp = lv_obj_get_disp(obj);
+    lv_disp_drv_t * drv = disp->driver;
+    if(drv->vscroll_cb == NULL) return false;
+    if(drv->full_refresh || drv->direct_mode || drv->rotated != LV_DISP_ROT_NONE) return false;
+    if(!lv_disp_is_invalidation_enabled(disp) || disp->rendering_in_progress || disp->prev_scr) return false;
+    if(disp->inv_tiles_used) return false;      /*The pending areas can't be moved with the content*/
+
+    /*The scrolled rows are the visible part of the object*/
+    lv_area_t region;
+    lv_area_copy(&region, &obj->coords);
+    if(!lv_obj_area_is_visible(obj, &region)) return false;
+    if(!_lv_area_intersect(&region, &region, &obj->coords)) return false;      /*Drop the safety margin*/
+    if(region.x1 > 0 || region.x2 < lv_disp_get_hor_res(disp) - 1) return false;
+    if(LV_ABS(dy) >= lv_area_get_height(&region)) return false;
+
+    if(!hw_vscroll_invariant(obj)) return false;
+    if(hw_vscroll_covered(obj, &region)) return false;
+
+    if(!drv->vscroll_cb(drv, &region, dy)) return false;
+
+    /*Areas still waiting to be redrawn moved with the content too*/
+    uint16_t inv_cnt = disp->inv_p;
+    uint16_t i;
+    for(i = 0; i < inv_cnt; i++) {
+        lv_area_t a;
+        if(!_lv_area_intersect(&a, &disp->inv_areas[i], &region)) continue;
+        lv_area_move(&a, 0, dy);
+        if(_lv_area_intersect(&a, &a, &region)) _lv_inv_area(disp, &a);
+    }
+
+    /*The rows scrolled in*/
+    lv_area_t exposed = region;
+    if(dy > 0) exposed.y2 = region.y1 + dy - 1;
+    else exposed.y1 = region.y2 + dy + 1;
+    _lv_inv_area(disp, &exposed);
+
+    /*The scrollbars stay in place but their pixels were moved with the content: redraw their tracks*/
+    if(lv_obj_get_scrollbar_mode(obj) != LV_SCROLLBAR_MODE_OFF) {
+        lv_coord_t tickness = lv_obj_get_style_width(obj, LV_PART_SCROLLBAR);
+        lv_area_t track = region;
+        if(lv_obj_get_style_base_dir(obj, LV_PART_SCROLLBAR) == LV_BASE_DIR_RTL) {
+            track.x1 = obj->coords.x1 + lv_obj_get_style_pad_left(obj, LV_PART_SCROLLBAR);
+            track.x2 = track.x1 + tickness - 1;
+        }
+        else {
+            track.x2 = obj->coords.x2 - lv_obj_get_style_pad_right(obj, LV_PART_SCROLLBAR);
+            track.x1 = track.x2 - tickness + 1;
+        }
+        _lv_inv_area(disp, &track);
+
+        track = region;
+        track.y2 = obj->coords.y2 - lv_obj_get_style_pad_bottom(obj, LV_PART_SCROLLBAR);
+        track.y1 = track.y2 - tickness + 1;
+        if(_lv_area_intersect(&track, &track, &region)) {
+            _lv_inv_area(disp, &track);
+            lv_area_move(&track, 0, dy);
+            if(_lv_area_intersect(&track, &track, &region)) _lv_inv_area(disp, &track);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Tell whether the object looks the same on every row, i.e. moving its drawn
+ * pixels vertically gives the same result as redrawing it after scrolling.
+ */
+static bool hw_vscroll_invariant(lv_obj_t * obj)
+{
+    lv_obj_t * parent;
+    for(parent = lv_obj_get_parent(obj); parent; parent = lv_obj_get_parent(parent)) {
+        if(lv_obj_get_style_transform_zoom(parent, LV_PART_MAIN) != LV_IMG_ZOOM_NONE) return false;
+        if(lv_obj_get_style_transform_angle(parent, LV_PART_MAIN) != 0) return false;
+    }
+
+    if(lv_obj_get_style_opa_recursive(obj, LV_PART_MAIN) < LV_OPA_MAX) return false;
+    if(lv_obj_get_style_bg_opa(obj, LV_PART_MAIN) < LV_OPA_MAX) return false;
+    if(lv_obj_get_style_bg_grad_dir(obj, LV_PART_MAIN) != LV_GRAD_DIR_NONE) return false;
+    if(lv_obj_get_style_bg_img_src(obj, LV_PART_MAIN) != NULL) return false;
+    if(lv_obj_get_style_radius(obj, LV_PART_MAIN) != 0) return false;
+    if(lv_obj_get_style_blend_mode(obj, LV_PART_MAIN) != LV_BLEND_MODE_NORMAL) return false;
+    if(lv_obj_get_style_transform_zoom(obj, LV_PART_MAIN) != LV_IMG_ZOOM_NONE) return false;
+    if(lv_obj_get_style_transform_angle(obj, LV_PART_MAIN) != 0) return false;
+
+    /*Horizontal border lines would be scrolled away with the content*/
+    if(lv_obj_get_style_border_width(obj, LV_PART_MAIN) > 0 &&
+       lv_obj_get_style_border_opa(obj, LV_PART_MAIN) > LV_OPA_MIN &&
+       (lv_obj_get_style_border_side(obj, LV_PART_MAIN) & (LV_BORDER_SIDE_TOP | LV_BORDER_SIDE_BOTTOM))) {
+        return false;
+    }
+
+    /*Floating children stay in place while scrolling*/
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    for(i = 0; i < child_cnt; i++) {
+        lv_obj_t * child = obj->spec_attr->children[i];
+        if(lv_obj_has_flag(child, LV_OBJ_FLAG_FLOATING) && !lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Tell whether anything is drawn over `obj` in `region`: its younger siblings,
+ * the younger siblings of its ancestors, the ancestors' scrollbars and the top and system layers.
+ */
+static bool hw_vscroll_covered(lv_obj_t * obj, const lv_area_t * region)
+{
+    lv_obj_t * child = obj;
+    lv_obj_t * parent = lv_obj_get_parent(obj);
+    while(parent) {
+        uint32_t i;
+        uint32_t child_cnt = lv_obj_get_child_cnt(parent);
+        for(i = lv_obj_get_index(child) + 1; i < child_cnt; i++) {
+            if(obj_is_on(parent->spec_attr->children[i], region)) return true;
+        }
+
+        lv_area_t hor_area;
+        lv_area_t ver_area;
+        lv_obj_get_scrollbar_area(parent, &hor_area, &ver_area);
+        if(lv_area_get_size(&hor_area) > 0 && _lv_area_is_on(&hor_area, region)) return true;
+        if(lv_area_get_size(&ver_area) > 0 && _lv_area_is_on(&ver_area, region)) return true;
+
+        child = parent;
+        parent = lv_obj_get_parent(parent);
+    }
+
+    lv_disp_t * disp = lv_obj_get_disp(obj);
+    lv_obj_t * layers[2] = {lv_disp_get_layer_top(disp), lv_disp_get_layer_sys(disp)};
+    uint32_t l;
+    for(l = 0; l < 2; l++) {
+        uint32_t i;
+        uint32_t child_cnt = lv_obj_get_child_cnt(layers[l]);
+        for(i = 0; i < child_cnt; i++) {
+            if(obj_is_on(layers[l]->spec_attr->children[i], region)) return true;
+        }
+    }
+
+    return false;
+}
+
+static bool obj_is_on(lv_obj_t * obj, const lv_area_t * area)
+{
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return false;
+
+    lv_area_t obj_area;
+    lv_area_copy(&obj_area, &obj->coords);
+    lv_coord_t ext_size = _lv_obj_get_ext_draw_size(obj);
+    lv_area_increase(&obj_area, ext_size, ext_size);
+    return _lv_area_is_on(&obj_area, area);
+}
@@ -8,6 +8,7 @@
  *********************/
 #include "lv_obj.h"
 #include "lv_disp.h"
+#include "lv_refr.h"
 #include "../misc/lv_gc.h"
 
 /*********************
@@ -15,6 +16,12 @@
  *********************/
 #define MY_CLASS &lv_obj_class
 
+/*Number of properties in the style cache, see `style_cache_index()`*/
+#define STYLE_CACHE_PROP_CNT    23
+
+/*Objects with fewer styles are not cached: looking up a property in one style is about as fast*/
+#define STYLE_CACHE_MIN_STYLES  2
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -35,6 +42,21 @@ typedef enum {
     CACHE_NEED_CHECK = 4,
 } cache_t;
 
+#if LV_USE_OBJ_STYLE_CACHE
+/**
+ * The result of `get_prop_core()` for the cached properties of the main part in a state.
+ * Only `LV_PART_MAIN` is cached so an object has at most one.
+ */
+typedef struct _lv_obj_style_cache_t {
+    lv_style_value_t values[STYLE_CACHE_PROP_CNT];
+    uint32_t gen;           /**< `style_cache_gen` when it was filled*/
+    lv_state_t state;
+    uint32_t known;         /**< The result of the property is stored*/
+    uint32_t found;         /**< The property is set in a style: the value is stored*/
+    uint32_t inherit;       /**< The property is set to inherit*/
+} _lv_obj_style_cache_t;
+#endif
+
 /**********************
  *  GLOBAL PROTOTYPES
  **********************/
@@ -45,6 +67,9 @@ typedef enum {
 static lv_style_t * get_local_style(lv_obj_t * obj, lv_style_selector_t selector);
 static _lv_obj_style_t * get_trans_style(lv_obj_t * obj, uint32_t part);
 static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, lv_style_value_t * v);
+static lv_style_res_t get_prop_cached(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop,
+                                      lv_style_value_t * v);
+static void style_cache_invalidate(lv_obj_t * obj, lv_style_prop_t prop);
 static void report_style_change_core(void * style, lv_obj_t * obj);
 static void refresh_children_style(lv_obj_t * obj);
 static bool trans_del(lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, trans_t * tr_limit);
@@ -59,6 +84,11 @@ static void fade_in_anim_ready(lv_anim_t * a);
  *  STATIC VARIABLES
  **********************/
 static bool style_refr = true;
+static LV_RENDER_LOCAL uint32_t style_scan_cnt;
+#if LV_USE_OBJ_STYLE_CACHE
+static bool style_cache_en = true;
+static uint32_t style_cache_gen;   /*Incremented when a style might have been changed*/
+#endif
 
 /**********************
  *      MACROS
@@ -152,6 +182,11 @@ void lv_obj_remove_style(lv_obj_t * obj, lv_style_t * style, lv_style_selector_t
 
 void lv_obj_report_style_change(lv_style_t * style)
 {
+#if LV_USE_OBJ_STYLE_CACHE
+    /*Any object can use the style*/
+    style_cache_gen++;
+#endif
+
     if(!style_refr) return;
     lv_disp_t * d = lv_disp_get_next(NULL);
 
@@ -168,9 +203,10 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
-    if(!style_refr) return;
+    /*Forget the cached value even if refreshing is disabled to not read old values*/
+    style_cache_invalidate(obj, prop);
 
-    lv_obj_invalidate(obj);
+    if(!style_refr) return;
 
     lv_part_t part = lv_obj_style_get_selector_part(selector);
 
@@ -179,6 +215,16 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
     bool is_inheritable = lv_style_prop_has_flag(prop, LV_STYLE_PROP_INHERIT);
     bool is_layer_refr = lv_style_prop_has_flag(prop, LV_STYLE_PROP_LAYER_REFR);
 
+    /*A drawing property of the scrollbars (e.g. a fading transition while scrolling) affects only the scrollbars*/
+    if(part == LV_PART_SCROLLBAR && prop != LV_STYLE_PROP_ANY && !is_layout_refr && !is_ext_draw) {
+        lv_obj_scrollbar_invalidate(obj);
+        return;
+    }
+
+    /*The children draw with the inherited properties and the opacity of their parents too*/
+    _lv_obj_reset_draw_list(obj, prop == LV_STYLE_PROP_ANY || is_inheritable || prop == LV_STYLE_OPA);
+    lv_obj_invalidate(obj);
+
     if(is_layout_refr) {
         if(part == LV_PART_ANY ||
            part == LV_PART_MAIN ||
@@ -190,7 +236,7 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
     }
     if((part == LV_PART_ANY || part == LV_PART_MAIN) && (prop == LV_STYLE_PROP_ANY || is_layout_refr)) {
         lv_obj_t * parent = lv_obj_get_parent(obj);
-        if(parent) lv_obj_mark_layout_as_dirty(parent);
+        if(parent) _lv_obj_mark_layout_as_dirty_from(parent, obj);
     }
 
     /*Cache the layer type*/
@@ -220,13 +266,37 @@ void lv_obj_enable_style_refresh(bool en)
     style_refr = en;
 }
 
+#if LV_USE_OBJ_STYLE_CACHE
+void lv_obj_enable_style_cache(bool en)
+{
+    style_cache_en = en;
+}
+#endif
+
+uint32_t _lv_obj_style_get_scan_cnt(void)
+{
+    return style_scan_cnt;
+}
+
+void _lv_obj_style_cache_free(lv_obj_t * obj)
+{
+#if LV_USE_OBJ_STYLE_CACHE
+    if(obj->style_cache) {
+        lv_mem_free(obj->style_cache);
+        obj->style_cache = NULL;
+    }
+#else
+    LV_UNUSED(obj);
+#endif
+}
+
 lv_style_value_t lv_obj_get_style_prop(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
 {
     lv_style_value_t value_act;
     bool inheritable = lv_style_prop_has_flag(prop, LV_STYLE_PROP_INHERIT);
     lv_style_res_t found = LV_STYLE_RES_NOT_FOUND;
     while(obj) {
-        found = get_prop_core(obj, part, prop, &value_act);
+        found = get_prop_cached(obj, part, prop, &value_act);
         if(found == LV_STYLE_RES_FOUND) break;
         if(!inheritable) break;
 
@@ -342,6 +412,7 @@ void _lv_obj_style_create_transition(lv_obj_t * obj, lv_part_t part, lv_state_t
 
     _lv_obj_style_t * style_trans = get_trans_style(obj, part);
     lv_style_set_prop(style_trans->style, tr_dsc->prop, v1);   /*Be sure `trans_style` has a valid value*/
+    style_cache_invalidate(obj, tr_dsc->prop);
 
     if(tr_dsc->prop == LV_STYLE_RADIUS) {
         if(v1.num == LV_RADIUS_CIRCLE || v2.num == LV_RADIUS_CIRCLE) {
@@ -605,6 +676,8 @@ static _lv_obj_style_t * get_trans_style(lv_obj_t * obj,  lv_style_selector_t se
 
 static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, lv_style_value_t * v)
 {
+    style_scan_cnt++;
+
     uint8_t group = 1 << _lv_style_get_prop_group(prop);
     int32_t weight = -1;
     lv_state_t state = obj->state;
@@ -670,6 +743,163 @@ static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_sty
     else return LV_STYLE_RES_NOT_FOUND;
 }
 
+#if LV_USE_OBJ_STYLE_CACHE
+/**
+ * Get the index of a property in the style cache
+ * @param prop  a style property
+ * @return      the index or -1 if the property is not cached
+ */
+static int32_t style_cache_index(lv_style_prop_t prop)
+{
+    switch(prop) {
+        case LV_STYLE_RADIUS:
+            return 0;
+        case LV_STYLE_CLIP_CORNER:
+            return 1;
+        case LV_STYLE_OPA:
+            return 2;
+        case LV_STYLE_COLOR_FILTER_DSC:
+            return 3;
+        case LV_STYLE_PAD_TOP:
+            return 4;
+        case LV_STYLE_PAD_BOTTOM:
+            return 5;
+        case LV_STYLE_PAD_LEFT:
+            return 6;
+        case LV_STYLE_PAD_RIGHT:
+            return 7;
+        case LV_STYLE_BG_COLOR:
+            return 8;
+        case LV_STYLE_BG_OPA:
+            return 9;
+        case LV_STYLE_BG_IMG_SRC:
+            return 10;
+        case LV_STYLE_BORDER_COLOR:
+            return 11;
+        case LV_STYLE_BORDER_OPA:
+            return 12;
+        case LV_STYLE_BORDER_WIDTH:
+            return 13;
+        case LV_STYLE_BORDER_SIDE:
+            return 14;
+        case LV_STYLE_BORDER_POST:
+            return 15;
+        case LV_STYLE_OUTLINE_WIDTH:
+            return 16;
+        case LV_STYLE_SHADOW_WIDTH:
+            return 17;
+        case LV_STYLE_TEXT_COLOR:
+            return 18;
+        case LV_STYLE_TEXT_OPA:
+            return 19;
+        case LV_STYLE_TEXT_FONT:
+            return 20;
+        case LV_STYLE_TEXT_LETTER_SPACE:
+            return 21;
+        case LV_STYLE_TEXT_LINE_SPACE:
+            return 22;
+        default:
+            return -1;
+    }
+}
+#endif
+
+/**
+ * Look up a property in the styles of an object like `get_prop_core()`,
+ * but use the result stored in the style cache of the object if the property is cached.
+ */
+static lv_style_res_t get_prop_cached(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop,
+                                      lv_style_value_t * v)
+{
+    /*E.g. labels usually have no styles and inherit the text properties*/
+    if(obj->style_cnt == 0) return LV_STYLE_RES_NOT_FOUND;
+
+#if LV_USE_OBJ_STYLE_CACHE
+    int32_t idx = style_cache_index(prop);
+    /*Transitions are skipped only temporarily, to get the values of an other state.
+     *The other parts are read less often and would need a cache each.*/
+    if(idx < 0 || !style_cache_en || obj->skip_trans || obj->style_cnt < STYLE_CACHE_MIN_STYLES ||
+       part != LV_PART_MAIN) {
+        return get_prop_core(obj, part, prop, v);
+    }
+
+    uint32_t bit = (uint32_t)1 << idx;
+    _lv_obj_style_cache_t * cache = obj->style_cache;
+
+    if(cache && (cache->known & bit) && cache->state == obj->state && cache->gen == style_cache_gen) {
+        if(cache->found & bit) {
+            *v = cache->values[idx];
+            return LV_STYLE_RES_FOUND;
+        }
+        return (cache->inherit & bit) ? LV_STYLE_RES_INHERIT : LV_STYLE_RES_NOT_FOUND;
+    }
+
+    lv_style_res_t found = get_prop_core(obj, part, prop, v);
+
+    /*The strips rendered in parallel only read the cache*/
+    if(_lv_refr_is_parallel()) return found;
+
+    if(cache == NULL) {
+        cache = lv_mem_alloc(sizeof(_lv_obj_style_cache_t));
+        if(cache == NULL) return found;
+        cache->known = 0;
+        /*Storing the results doesn't change the object*/
+        ((lv_obj_t *)obj)->style_cache = cache;
+    }
+
+    if(cache->known == 0 || cache->state != obj->state || cache->gen != style_cache_gen) {
+        cache->state = obj->state;
+        cache->gen = style_cache_gen;
+        cache->known = 0;
+        cache->found = 0;
+        cache->inherit = 0;
+    }
+
+    cache->known |= bit;
+    if(found == LV_STYLE_RES_FOUND) {
+        cache->found |= bit;
+        cache->values[idx] = *v;
+    }
+    else if(found == LV_STYLE_RES_INHERIT) {
+        cache->inherit |= bit;
+    }
+    return found;
+#else
+    return get_prop_core(obj, part, prop, v);
+#endif
+}
+
+/**
+ * Forget the cached results of a property of an object in every state.
+ * The cache is freed if the object has too few styles to be cached.
+ * @param obj   pointer to an object
+ * @param prop  the changed property or `LV_STYLE_PROP_ANY`
+ */
+static void style_cache_invalidate(lv_obj_t * obj, lv_style_prop_t prop)
+{
+#if LV_USE_OBJ_STYLE_CACHE
+    if(obj->style_cnt < STYLE_CACHE_MIN_STYLES) {
+        _lv_obj_style_cache_free(obj);
+        return;
+    }
+
+    uint32_t mask;
+    if(prop == LV_STYLE_PROP_ANY) {
+        mask = UINT32_MAX;
+    }
+    else {
+        int32_t idx = style_cache_index(prop);
+        if(idx < 0) return;
+        mask = (uint32_t)1 << idx;
+    }
+
+    if(obj->style_cache) obj->style_cache->known &= ~mask;
+#else
+    LV_UNUSED(obj);
+    LV_UNUSED(prop);
+#endif
+}
+
 /**
  * Refresh the style of all children of an object. (Called recursively)
  * @param style refresh objects only with this
@@ -740,6 +970,7 @@ static bool trans_del(lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, tran
                     lv_style_remove_prop(obj->styles[i].style, tr->prop);
                 }
             }
+            style_cache_invalidate(obj, tr->prop);
 
             /*Free the transition descriptor too*/
             lv_anim_del(tr, NULL);
@@ -835,6 +1066,7 @@ static void trans_anim_start_cb(lv_anim_t * a)
 
     _lv_obj_style_t * style_trans = get_trans_style(tr->obj, tr->selector);
     lv_style_set_prop(style_trans->style, tr->prop, tr->start_value);   /*Be sure `trans_style` has a valid value*/
+    style_cache_invalidate(tr->obj, tr->prop);
 
 }
 
@@ -865,6 +1097,7 @@ static void trans_anim_ready_cb(lv_anim_t * a)
 
                 _lv_obj_style_t * obj_style = &obj->styles[i];
                 lv_style_remove_prop(obj_style->style, prop);
+                style_cache_invalidate(obj, prop);
 
                 if(lv_style_is_empty(obj->styles[i].style)) {
                     lv_obj_remove_style(obj, obj_style->style, obj_style->selector);
@@ -118,6 +118,29 @@ void lv_obj_refresh_style(struct _lv_obj_t * obj, lv_part_t part, lv_style_prop_
  */
 void lv_obj_enable_style_refresh(bool en);
 
+#if LV_USE_OBJ_STYLE_CACHE
+/**
+ * Enable or disable the cache of the frequently drawn style properties of the objects.
+ * The cache is enabled by default; disabling it is useful to compare the two cases.
+ * @param en        true: enable the cache; false: look up every property in the styles
+ */
+void lv_obj_enable_style_cache(bool en);
+#endif
+
+/**
+ * Get how many times the styles of an object were scanned for a property on the calling thread.
+ * Used to measure the style cache.
+ * @return          number of style scans since the start
+ */
+uint32_t _lv_obj_style_get_scan_cnt(void);
+
+/**
+ * Free the cached style properties of an object.
+ * Called when the object is deleted.
+ * @param obj       pointer to an object
+ */
+void _lv_obj_style_cache_free(struct _lv_obj_t * obj);
+
 /**
  * Get the value of a style property. The current state of the object will be considered.
  * Inherited properties will be inherited.
@@ -12,6 +12,7 @@
 #include "../hal/lv_hal_tick.h"
 #include "../hal/lv_hal_disp.h"
 #include "../misc/lv_timer.h"
+#include "../misc/lv_anim.h"
 #include "../misc/lv_mem.h"
 #include "../misc/lv_math.h"
 #include "../misc/lv_gc.h"
@@ -26,6 +27,29 @@
 /*********************
  *      DEFINES
  *********************/
+/*Frame pacing, see `lv_disp_drv_t::panel_period_us`*/
+#define PACING_DIV_MAX      6U  /*Slowest rate: a frame every 6 panel refreshes*/
+#define PACING_WINDOW       16  /*Frames over which overruns are counted*/
+#define PACING_OVERRUNS     2   /*Overruns in a window that make the rate fall back*/
+#define PACING_SETTLE       10  /*Frames in a row that must fit a faster rate before it is used*/
+#define PACING_HOLD_MAX     480 /*Longest wait before a rate that failed is tried again [frames]*/
+
+/*Occlusion culling, see `lv_disp_drv_t::cull_occluded`*/
+#define OCCL_COVER_MAX      16  /*Opaque areas remembered per draw area*/
+#define OCCL_CULLED_MAX     32  /*Objects skipped per draw area*/
+
+/*Retained drawing, see `lv_disp_drv_t::retained_mem`*/
+#define DRAW_LIST_OBJ_MAX   1024 /*Largest draw list of an object [bytes]*/
+
+/*Parallel rendering, see `lv_disp_drv_t::render_strips`*/
+#define RENDER_STRIPS_MAX   8
+#define RENDER_STRIP_MIN_H  8    /*Thinnest strip [px]*/
+
+#if LV_USE_PARALLEL_RENDER
+    #if LV_COLOR_SCREEN_TRANSP
+        #error "LV_USE_PARALLEL_RENDER: the layers with alpha set `screen_transp` in the display driver for all threads"
+    #endif
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -48,20 +72,52 @@ typedef struct {
 #endif
 } mem_monitor_t;
 
+/*Objects hidden in the area being drawn*/
+typedef struct {
+    lv_area_t area;                         /*The area being drawn*/
+    lv_area_t covers[OCCL_COVER_MAX];       /*Opaque parts of the objects visited so far, front to back*/
+    lv_obj_t * culled[OCCL_CULLED_MAX];     /*Objects skipped by `refr_obj()`*/
+    uint8_t cover_cnt;
+    uint8_t culled_cnt;
+    uint8_t area_covered : 1;               /*A cover contains `area`: everything behind it is hidden*/
+} occlusion_t;
+
+typedef struct {
+    lv_draw_ctx_t * draw_ctx;
+    lv_area_t clip_area;
+} render_strip_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void lv_refr_join_area(void);
+static bool inv_tiles_begin(lv_disp_t * disp);
+static void inv_tiles_mark(lv_disp_t * disp, const lv_area_t * area);
+static void inv_tiles_to_areas(lv_disp_t * disp);
 static void refr_invalid_areas(void);
 static void refr_sync_areas(void);
 static void refr_area(const lv_area_t * area_p);
 static void refr_area_part(lv_draw_ctx_t * draw_ctx);
+static void refr_area_draw(lv_draw_ctx_t * draw_ctx, const lv_area_t * top_area);
+#if LV_USE_PARALLEL_RENDER
+    static bool refr_area_parallel(lv_draw_ctx_t * draw_ctx);
+    static void render_strip_job(void * job_data, uint32_t idx);
+#endif
 static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj);
 static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj);
+static void occlusion_collect(const lv_area_t * area);
+static void occlusion_walk(lv_obj_t * obj, const lv_area_t * clip, bool collect);
+static void occlusion_add_cover(const lv_area_t * cover);
+static bool occlusion_is_culled(const lv_obj_t * obj);
+static void occlusion_clear(void);
 static void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj);
+static bool draw_list_get(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj, const lv_area_t * obj_coords_ext);
 static uint32_t get_max_row(lv_disp_t * disp, lv_coord_t area_w, lv_coord_t area_h);
 static void draw_buf_flush(lv_disp_t * disp);
 static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void pacing_frame_begin(lv_disp_t * disp, uint32_t start);
+static void pacing_frame_done(lv_disp_t * disp, uint32_t start);
+static void pacing_schedule(lv_disp_t * disp, lv_timer_t * tmr);
 
 #if LV_USE_PERF_MONITOR
     static void perf_monitor_init(perf_monitor_t * perf_monitor);
@@ -75,6 +131,9 @@ static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_
  **********************/
 static uint32_t px_num;
 static lv_disp_t * disp_refr; /*Display being refreshed*/
+static LV_RENDER_LOCAL occlusion_t occl;
+static uint8_t refr_parity;   /*Flipped in every refresh, tells if objects were drawn in an earlier one*/
+static bool par_active;       /*The strips of a part are being rendered in parallel*/
 
 #if LV_USE_PERF_MONITOR
     static perf_monitor_t   perf_monitor;
@@ -141,12 +200,19 @@ void lv_obj_redraw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
     /*If the object is visible on the current clip area OR has overflow visible draw it.
      *With overflow visible drawing should happen to apply the masks which might affect children */
     bool should_draw = com_clip_res || lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE);
+    /*Replay the recorded draw calls instead of asking the object to draw itself*/
+    bool retained = should_draw && draw_list_get(draw_ctx, obj, &obj_coords_ext);
     if(should_draw) {
         draw_ctx->clip_area = &clip_coords_for_obj;
 
-        lv_event_send(obj, LV_EVENT_DRAW_MAIN_BEGIN, draw_ctx);
-        lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
-        lv_event_send(obj, LV_EVENT_DRAW_MAIN_END, draw_ctx);
+        if(retained) {
+            _lv_draw_list_replay(draw_ctx, obj->draw_list, &obj->coords, false);
+        }
+        else {
+            lv_event_send(obj, LV_EVENT_DRAW_MAIN_BEGIN, draw_ctx);
+            lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
+            lv_event_send(obj, LV_EVENT_DRAW_MAIN_END, draw_ctx);
+        }
 #if LV_USE_REFR_DEBUG
         lv_color_t debug_color = lv_color_make(lv_rand(0, 0xFF), lv_rand(0, 0xFF), lv_rand(0, 0xFF));
         lv_draw_rect_dsc_t draw_dsc;
@@ -188,9 +254,14 @@ void lv_obj_redraw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
         draw_ctx->clip_area = &clip_coords_for_obj;
 
         /*If all the children are redrawn make 'post draw' draw*/
-        lv_event_send(obj, LV_EVENT_DRAW_POST_BEGIN, draw_ctx);
-        lv_event_send(obj, LV_EVENT_DRAW_POST, draw_ctx);
-        lv_event_send(obj, LV_EVENT_DRAW_POST_END, draw_ctx);
+        if(retained) {
+            _lv_draw_list_replay(draw_ctx, obj->draw_list, &obj->coords, true);
+        }
+        else {
+            lv_event_send(obj, LV_EVENT_DRAW_POST_BEGIN, draw_ctx);
+            lv_event_send(obj, LV_EVENT_DRAW_POST, draw_ctx);
+            lv_event_send(obj, LV_EVENT_DRAW_POST_END, draw_ctx);
+        }
     }
 
     draw_ctx->clip_area = clip_area_ori;
@@ -217,6 +288,7 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
     /*Clear the invalidate buffer if the parameter is NULL*/
     if(area_p == NULL) {
         disp->inv_p = 0;
+        disp->inv_tiles_used = 0;
         return;
     }
 
@@ -242,6 +314,12 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
 
     if(disp->driver->rounder_cb) disp->driver->rounder_cb(disp->driver, &com_area);
 
+    if(disp->inv_tiles_used) {
+        inv_tiles_mark(disp, &com_area);
+        if(disp->refr_timer) lv_timer_resume(disp->refr_timer);
+        return;
+    }
+
     /*Save only if this area is not in one of the saved areas*/
     uint16_t i;
     for(i = 0; i < disp->inv_p; i++) {
@@ -252,6 +330,11 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
     if(disp->inv_p < LV_INV_BUF_SIZE) {
         lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
     }
+    else if(inv_tiles_begin(disp)) {    /*If no place for the area continue in the dirty tiles*/
+        inv_tiles_mark(disp, &com_area);
+        if(disp->refr_timer) lv_timer_resume(disp->refr_timer);
+        return;
+    }
     else {   /*If no place for the area add the screen*/
         disp->inv_p = 0;
         lv_area_copy(&disp->inv_areas[disp->inv_p], &scr_area);
@@ -280,6 +363,21 @@ void _lv_refr_set_disp_refreshing(lv_disp_t * disp)
     disp_refr = disp;
 }
 
+bool _lv_refr_is_parallel(void)
+{
+    return par_active;
+}
+
+void _lv_refr_lock(void)
+{
+    if(par_active) disp_refr->driver->render_lock_cb(disp_refr->driver, true);
+}
+
+void _lv_refr_unlock(void)
+{
+    if(par_active) disp_refr->driver->render_lock_cb(disp_refr->driver, false);
+}
+
 /**
  * Called periodically to handle the refreshing
  * @param tmr pointer to the timer itself
@@ -305,6 +403,10 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         disp_refr = lv_disp_get_default();
     }
 
+    /*Advance the animations to the time this frame is due, not to the time the timer happened to run*/
+    bool paced = tmr && disp_refr->driver->panel_period_us;
+    if(paced) pacing_frame_begin(disp_refr, start);
+
     /*Refresh the screen's layout if required*/
     lv_obj_update_layout(disp_refr->act_scr);
     if(disp_refr->prev_scr) lv_obj_update_layout(disp_refr->prev_scr);
@@ -315,11 +417,14 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
     /*Do nothing if there is no active screen*/
     if(disp_refr->act_scr == NULL) {
         disp_refr->inv_p = 0;
+        if(paced) pacing_schedule(disp_refr, tmr);
         LV_LOG_WARN("there is no active screen");
         REFR_TRACE("finished");
         return;
     }
 
+    if(disp_refr->inv_tiles_used) inv_tiles_to_areas(disp_refr);
+    refr_parity ^= 1;
     lv_refr_join_area();
     refr_sync_areas();
     refr_invalid_areas();
@@ -351,8 +456,12 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         if(disp_refr->driver->monitor_cb) {
             disp_refr->driver->monitor_cb(disp_refr->driver, elaps, px_num);
         }
+
+        if(paced) pacing_frame_done(disp_refr, start);
     }
 
+    if(paced) pacing_schedule(disp_refr, tmr);
+
     lv_mem_buf_free_all();
     _lv_font_clean_up_fmt_txt();
 
@@ -388,7 +497,10 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         uint32_t fps_limit;
         uint32_t fps;
 
-        if(disp_refr->refr_timer) {
+        if(disp_refr->driver->panel_period_us && disp_refr->pacing.div) {
+            fps_limit = 1000000 / (disp_refr->driver->panel_period_us * disp_refr->pacing.div);
+        }
+        else if(disp_refr->refr_timer) {
             fps_limit = 1000 / disp_refr->refr_timer->period;
         }
         else {
@@ -468,10 +580,297 @@ uint32_t lv_refr_get_fps_avg(void)
 #endif
 
 
+void lv_refr_get_pacing(lv_disp_t * disp, lv_refr_pacing_t * pacing)
+{
+    if(!disp) disp = lv_disp_get_default();
+    lv_memset_00(pacing, sizeof(lv_refr_pacing_t));
+    if(!disp || !disp->driver->panel_period_us || disp->pacing.div == 0) return;
+
+    const lv_disp_pacing_t * p = &disp->pacing;
+    pacing->period_us = disp->driver->panel_period_us * p->div;
+    pacing->fps = (1000000 + pacing->period_us / 2) / pacing->period_us;
+    pacing->div = p->div;
+    pacing->frames = p->frames;
+    pacing->dropped = p->dropped;
+    pacing->rate_changes = p->rate_changes;
+    pacing->jitter_avg_us = p->jitter_cnt ? p->jitter_sum_us / p->jitter_cnt : 0;
+    pacing->jitter_max_us = p->jitter_max_us;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Switch a display whose `inv_areas` are full to the dirty tiles: (re)allocate the bitmap for the current
+ * resolution and tile size and mark the saved areas in it.
+ * @param disp  pointer to a display
+ * @return      false if the driver has no tile size or there is no memory: redraw the whole screen instead
+ */
+static bool inv_tiles_begin(lv_disp_t * disp)
+{
+    uint8_t size = disp->driver->inv_tile_size;
+    if(size == 0) return false;
+    if(size & (size - 1)) {
+        LV_LOG_WARN("inv_tile_size %d is not a power of two", size);
+        return false;
+    }
+
+    uint8_t shift = 0;
+    while((1 << shift) < size) shift++;
+    uint16_t cols = (lv_disp_get_hor_res(disp) + size - 1) >> shift;
+    uint16_t words = (cols + 31) / 32;
+    uint16_t rows = (lv_disp_get_ver_res(disp) + size - 1) >> shift;
+    if(disp->inv_tiles == NULL || shift != disp->inv_tile_shift || words != disp->inv_tile_words ||
+       rows != disp->inv_tile_rows) {
+        uint32_t * tiles = lv_mem_realloc(disp->inv_tiles, (uint32_t)words * rows * sizeof(uint32_t));
+        if(tiles == NULL) return false;
+        disp->inv_tiles = tiles;
+        disp->inv_tile_shift = shift;
+        disp->inv_tile_words = words;
+        disp->inv_tile_rows = rows;
+    }
+
+    lv_memset_00(disp->inv_tiles, (uint32_t)disp->inv_tile_words * disp->inv_tile_rows * sizeof(uint32_t));
+    disp->inv_tiles_used = 1;
+    uint16_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        inv_tiles_mark(disp, &disp->inv_areas[i]);
+    }
+    return true;
+}
+
+/**
+ * Mark the tiles an area touches as dirty
+ * @param disp  pointer to a display using its dirty tiles
+ * @param area  an area on the screen
+ */
+static void inv_tiles_mark(lv_disp_t * disp, const lv_area_t * area)
+{
+    uint8_t shift = disp->inv_tile_shift;
+    uint32_t c1 = area->x1 >> shift;
+    uint32_t c2 = area->x2 >> shift;
+    uint32_t r;
+    for(r = area->y1 >> shift; r <= (uint32_t)(area->y2 >> shift); r++) {
+        uint32_t * row = &disp->inv_tiles[r * disp->inv_tile_words];
+        uint32_t c = c1;
+        while(c <= c2) {
+            uint32_t w = c >> 5;
+            uint32_t last = LV_MIN(c2, (w << 5) + 31);
+            uint32_t bits = last - c + 1;
+            row[w] |= (bits == 32 ? 0xFFFFFFFF : ((1UL << bits) - 1)) << (c & 31);
+            c = last + 1;
+        }
+    }
+}
+
+/**
+ * Turn the dirty tiles into `inv_areas`: every run of dirty tiles in a row of tiles is a rectangle,
+ * extended downwards while the rows below have a run with the same columns. Full-width or stacked runs
+ * so become few, tall rectangles, each one flush window.
+ * @param disp  pointer to a display using its dirty tiles
+ */
+static void inv_tiles_to_areas(lv_disp_t * disp)
+{
+    uint8_t shift = disp->inv_tile_shift;
+    lv_coord_t hor_res = lv_disp_get_hor_res(disp);
+    lv_coord_t ver_res = lv_disp_get_ver_res(disp);
+    uint32_t cols = (hor_res + (1 << shift) - 1) >> shift;
+    uint16_t prev_first = 0;    /*Areas from here on end in the previous row of tiles*/
+
+    disp->inv_p = 0;
+    lv_memset_00(disp->inv_area_joined, sizeof(disp->inv_area_joined));
+
+    uint32_t r;
+    for(r = 0; r < disp->inv_tile_rows; r++) {
+        const uint32_t * row = &disp->inv_tiles[r * disp->inv_tile_words];
+        uint16_t row_first = disp->inv_p;
+        uint32_t c = 0;
+        while(c < cols) {
+            if(!(row[c >> 5] & (1UL << (c & 31)))) {
+                c++;
+                continue;
+            }
+            uint32_t c1 = c;
+            while(c < cols && (row[c >> 5] & (1UL << (c & 31)))) c++;
+
+            lv_area_t a;
+            a.x1 = c1 << shift;
+            a.x2 = LV_MIN((lv_coord_t)(c << shift) - 1, hor_res - 1);
+            a.y1 = r << shift;
+            a.y2 = LV_MIN((lv_coord_t)((r + 1) << shift) - 1, ver_res - 1);
+
+            /*Continue the area of the same run in the row above*/
+            uint16_t i;
+            for(i = prev_first; i < row_first; i++) {
+                lv_area_t * prev = &disp->inv_areas[i];
+                if(prev->x1 == a.x1 && prev->x2 == a.x2 && prev->y2 == a.y1 - 1) break;
+            }
+            if(i < row_first) {
+                disp->inv_areas[i].y2 = a.y2;
+                /*Keep the areas that reach this row together after `row_first`*/
+                lv_area_t tmp = disp->inv_areas[i];
+                disp->inv_areas[i] = disp->inv_areas[row_first - 1];
+                disp->inv_areas[row_first - 1] = tmp;
+                row_first--;
+            }
+            else if(disp->inv_p < LV_INV_BUF_SIZE) {
+                disp->inv_areas[disp->inv_p++] = a;
+            }
+            else {
+                /*Out of areas: grow the one that grows the least over this run too*/
+                uint16_t best = 0;
+                uint32_t best_growth = UINT32_MAX;
+                for(i = 0; i < disp->inv_p; i++) {
+                    lv_area_t joined;
+                    _lv_area_join(&joined, &disp->inv_areas[i], &a);
+                    uint32_t growth = lv_area_get_size(&joined) - lv_area_get_size(&disp->inv_areas[i]);
+                    if(growth < best_growth) {
+                        best = i;
+                        best_growth = growth;
+                    }
+                }
+                _lv_area_join(&disp->inv_areas[best], &disp->inv_areas[best], &a);
+            }
+        }
+        prev_first = row_first;
+    }
+    disp->inv_tiles_used = 0;
+
+    /*The tiles may not meet the driver's alignment*/
+    if(disp->driver->rounder_cb) {
+        uint16_t i;
+        for(i = 0; i < disp->inv_p; i++) disp->driver->rounder_cb(disp->driver, &disp->inv_areas[i]);
+    }
+}
+
+static void pacing_advance(lv_disp_pacing_t * p, uint32_t period_us)
+{
+    uint32_t us = p->next_frac_us + period_us;
+    p->next_tick += us / 1000;
+    p->next_frac_us = us % 1000;
+}
+
+static void pacing_set_div(lv_disp_pacing_t * p, uint8_t div)
+{
+    p->last_up = div < p->div;
+    p->div = div;
+    p->rate_changes++;
+    p->settle_cnt = 0;
+    p->overruns = 0;
+    p->window_cnt = 0;
+    p->since_change = 0;
+}
+
+/**
+ * Find the slot of the frame starting now and step the animations to it.
+ * The first frame and the first one after the display was idle start a new grid of slots.
+ */
+static void pacing_frame_begin(lv_disp_t * disp, uint32_t start)
+{
+    lv_disp_pacing_t * p = &disp->pacing;
+    uint32_t panel_us = disp->driver->panel_period_us;
+
+    if(p->div == 0) {
+        /*Start from the rate closest to the default refresh period*/
+        uint32_t div = (LV_DISP_DEF_REFR_PERIOD * 1000 + panel_us / 2) / panel_us;
+        p->div = LV_CLAMP(1U, div, PACING_DIV_MAX);
+        p->next_tick = start;
+        p->next_frac_us = 0;
+        p->resync = 1;
+    }
+
+    uint32_t period_us = panel_us * p->div;
+    int32_t late = (int32_t)(start - p->next_tick);
+    if(late > 0 && (uint32_t)late * 1000 >= period_us) {
+        p->next_tick = start;
+        p->next_frac_us = 0;
+        p->resync = 1;
+    }
+
+    _lv_anim_refr_at(p->next_tick, (period_us + 999) / 1000);
+}
+
+/**
+ * Account a drawn frame, move to the next slot and adapt the rate to the measured frame time.
+ * The frame time is the rendering plus the waiting for the flush: a flush that does not keep up
+ * shows in it once the driver's buffers are full.
+ */
+static void pacing_frame_done(lv_disp_t * disp, uint32_t start)
+{
+    lv_disp_pacing_t * p = &disp->pacing;
+    uint32_t panel_us = disp->driver->panel_period_us;
+    uint32_t period_us = panel_us * p->div;
+    uint32_t now = lv_tick_get();
+    uint32_t cost_us = lv_tick_elaps(start) * 1000;
+
+    /*Jitter: how far from its slot the frame started*/
+    if(!p->resync) {
+        int32_t late_us = (int32_t)(start - p->next_tick) * 1000 - p->next_frac_us;
+        uint32_t dev = LV_ABS(late_us);
+        p->jitter_cnt++;
+        p->jitter_sum_us += dev;
+        if(dev > p->jitter_max_us) p->jitter_max_us = dev;
+    }
+    p->resync = 0;
+    p->frames++;
+    if(p->since_change < UINT16_MAX) p->since_change++;
+
+    p->cost_peak_us -= p->cost_peak_us / 8;
+    if(cost_us > p->cost_peak_us) p->cost_peak_us = cost_us;
+
+    /*A frame that ran past the next slot gives up the slots it missed: the following frames stay on
+     *the grid, i.e. frames are dropped at an even cadence instead of being shown late*/
+    pacing_advance(p, period_us);
+    while((int32_t)(now - p->next_tick) > 0) {
+        pacing_advance(p, period_us);
+        p->dropped++;
+    }
+
+    /*Only a frame that itself took longer than the period asks for a slower rate,
+     *not one that just started late in its slot*/
+    bool overrun = cost_us > period_us;
+    if(overrun) p->overruns++;
+    if(p->hold) p->hold--;
+
+    if(p->overruns >= PACING_OVERRUNS && p->div < PACING_DIV_MAX) {
+        /*Fall back to a slower rate, straight to the one the frame time fits in if that is slower still.
+         *If a faster rate failed right after it was chosen, wait longer each time before trying it again*/
+        if(p->last_up && p->since_change < 2 * PACING_SETTLE) {
+            p->backoff = LV_CLAMP(PACING_SETTLE, p->backoff * 2, PACING_HOLD_MAX);
+            p->hold = p->backoff;
+        }
+        uint32_t div = (p->cost_peak_us + panel_us - 1) / panel_us;
+        pacing_set_div(p, LV_CLAMP((uint32_t)p->div + 1, div, PACING_DIV_MAX));
+        return;
+    }
+
+    if(++p->window_cnt >= PACING_WINDOW) {
+        p->window_cnt = 0;
+        p->overruns = 0;
+    }
+
+    /*Use the fastest rate the recent peak frame time fits in with 25 % margin once it did so for a while*/
+    uint32_t fit = (p->cost_peak_us + p->cost_peak_us / 4) / panel_us + 1;
+    if(!overrun && fit < p->div) {
+        if(p->hold == 0 && ++p->settle_cnt >= PACING_SETTLE) pacing_set_div(p, fit);
+    }
+    else {
+        p->settle_cnt = 0;
+    }
+}
+
+/**
+ * Let the refresh timer run again when the next slot is due.
+ * The timer measures its period from its last run, i.e. from the start of this refresh.
+ */
+static void pacing_schedule(lv_disp_t * disp, lv_timer_t * tmr)
+{
+    const lv_disp_pacing_t * p = &disp->pacing;
+    int32_t wait = (int32_t)(p->next_tick - tmr->last_run) + (p->next_frac_us ? 1 : 0);
+    lv_timer_set_period(tmr, wait > 0 ? wait : 0);
+}
+
 /**
  * Join the areas which has got common parts
  */
@@ -725,15 +1124,35 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
 #endif
     }
 
+#if LV_USE_PARALLEL_RENDER
+    if(!refr_area_parallel(draw_ctx))
+#endif
+    {
+        refr_area_draw(draw_ctx, draw_ctx->buf_area);
+    }
+
+    draw_buf_flush(disp_refr);
+}
+
+/**
+ * Draw the objects in the clip area of a draw context
+ * @param draw_ctx  pointer to a draw context
+ * @param top_area  the objects behind an object covering this area are not drawn
+ */
+static void refr_area_draw(lv_draw_ctx_t * draw_ctx, const lv_area_t * top_area)
+{
     lv_obj_t * top_act_scr = NULL;
     lv_obj_t * top_prev_scr = NULL;
 
     /*Get the most top object which is not covered by others*/
-    top_act_scr = lv_refr_get_top_obj(draw_ctx->buf_area, lv_disp_get_scr_act(disp_refr));
+    top_act_scr = lv_refr_get_top_obj(top_area, lv_disp_get_scr_act(disp_refr));
     if(disp_refr->prev_scr) {
-        top_prev_scr = lv_refr_get_top_obj(draw_ctx->buf_area, disp_refr->prev_scr);
+        top_prev_scr = lv_refr_get_top_obj(top_area, disp_refr->prev_scr);
     }
 
+    /*Mark the objects which are hidden by others in front of them*/
+    if(disp_refr->driver->cull_occluded) occlusion_collect(draw_ctx->clip_area);
+
     /*Draw a display background if there is no top object*/
     if(top_act_scr == NULL && top_prev_scr == NULL) {
         lv_area_t a;
@@ -795,8 +1214,75 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
     refr_obj_and_children(draw_ctx, lv_disp_get_layer_top(disp_refr));
     refr_obj_and_children(draw_ctx, lv_disp_get_layer_sys(disp_refr));
 
-    draw_buf_flush(disp_refr);
+    occlusion_clear();
+}
+
+#if LV_USE_PARALLEL_RENDER
+/**
+ * Render the clip area of a draw context in horizontal strips in parallel if the driver asks for it.
+ * Every strip has a draw context of its own, they all draw into the same buffer.
+ * @param draw_ctx  pointer to the draw context of the display
+ * @return          false: the area was not rendered, render it on this thread
+ */
+static bool refr_area_parallel(lv_draw_ctx_t * draw_ctx)
+{
+    lv_disp_drv_t * drv = disp_refr->driver;
+    if(drv->render_strips < 2 || drv->render_cb == NULL || drv->render_lock_cb == NULL) return false;
+
+    const lv_area_t * clip = draw_ctx->clip_area;
+    lv_coord_t h = lv_area_get_height(clip);
+    uint32_t strip_cnt = LV_MIN(drv->render_strips, RENDER_STRIPS_MAX);
+    strip_cnt = LV_MIN(strip_cnt, (uint32_t)(h / RENDER_STRIP_MIN_H));
+    if(strip_cnt < 2) return false;
+
+    /*Create the draw contexts of the strips once*/
+    if(disp_refr->render_ctx_cnt < strip_cnt) {
+        uint32_t cnt = LV_MIN(drv->render_strips, RENDER_STRIPS_MAX);
+        uint8_t * ctx_buf = lv_mem_alloc(cnt * drv->draw_ctx_size);
+        LV_ASSERT_MALLOC(ctx_buf);
+        if(ctx_buf == NULL) return false;
+
+        uint32_t i;
+        for(i = 0; i < disp_refr->render_ctx_cnt; i++) {
+            drv->draw_ctx_deinit(drv, (lv_draw_ctx_t *)((uint8_t *)disp_refr->render_ctx + i * drv->draw_ctx_size));
+        }
+        if(disp_refr->render_ctx) lv_mem_free(disp_refr->render_ctx);
+
+        lv_memset_00(ctx_buf, cnt * drv->draw_ctx_size);
+        for(i = 0; i < cnt; i++) {
+            drv->draw_ctx_init(drv, (lv_draw_ctx_t *)(ctx_buf + i * drv->draw_ctx_size));
+        }
+        disp_refr->render_ctx = ctx_buf;
+        disp_refr->render_ctx_cnt = (uint8_t)cnt;
+    }
+
+    render_strip_t strips[RENDER_STRIPS_MAX];
+    uint32_t i;
+    for(i = 0; i < strip_cnt; i++) {
+        lv_draw_ctx_t * strip_ctx = (lv_draw_ctx_t *)((uint8_t *)disp_refr->render_ctx + i * drv->draw_ctx_size);
+        strip_ctx->buf = draw_ctx->buf;
+        strip_ctx->buf_area = draw_ctx->buf_area;
+        strips[i].clip_area = *clip;
+        strips[i].clip_area.y1 = clip->y1 + (lv_coord_t)(h * i / strip_cnt);
+        strips[i].clip_area.y2 = clip->y1 + (lv_coord_t)(h * (i + 1) / strip_cnt) - 1;
+        strip_ctx->clip_area = &strips[i].clip_area;
+        strips[i].draw_ctx = strip_ctx;
+    }
+
+    par_active = true;
+    drv->render_cb(drv, render_strip_job, strips, strip_cnt);
+    par_active = false;
+
+    return true;
+}
+
+static void render_strip_job(void * job_data, uint32_t idx)
+{
+    render_strip_t * strip = &((render_strip_t *)job_data)[idx];
+    refr_area_draw(strip->draw_ctx, &strip->clip_area);
+    lv_draw_wait_for_finish(strip->draw_ctx);
 }
+#endif /*LV_USE_PARALLEL_RENDER*/
 
 /**
  * Search the most top object which fully covers an area
@@ -890,6 +1376,211 @@ static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj)
     }
 }
 
+/**
+ * Find the objects which are completely hidden in an area by opaque objects drawn after them.
+ * They are listed in `occl.culled` and skipped by `refr_obj()` until `occlusion_clear()`.
+ * `lv_refr_get_top_obj()` already skips everything behind an object covering the whole area,
+ * this also skips e.g. a sprite behind a speech bubble when the area is larger than the bubble.
+ * @param area the area being drawn
+ */
+static void occlusion_collect(const lv_area_t * area)
+{
+    occl.area = *area;
+    occl.cover_cnt = 0;
+    occl.culled_cnt = 0;
+    occl.area_covered = 0;
+
+    /*The reverse order of `refr_area_part()`*/
+    occlusion_walk(lv_disp_get_layer_sys(disp_refr), area, true);
+    occlusion_walk(lv_disp_get_layer_top(disp_refr), area, true);
+    lv_obj_t * front = disp_refr->act_scr;
+    lv_obj_t * back = disp_refr->prev_scr;
+    if(disp_refr->draw_prev_over_act) {
+        front = disp_refr->prev_scr;
+        back = disp_refr->act_scr;
+    }
+    if(front) occlusion_walk(front, area, true);
+    if(back) occlusion_walk(back, area, true);
+}
+
+/**
+ * Visit an object and its children front to back: mark them if the covers found so far hide them,
+ * then add their opaque parts to the covers.
+ * @param obj pointer to an object
+ * @param clip the area where `obj` can be drawn (the parents' clipping applied)
+ * @param collect false: the object is drawn masked or with opacity, it doesn't hide anything
+ */
+static void occlusion_walk(lv_obj_t * obj, const lv_area_t * clip, bool collect)
+{
+    if(occl.area_covered) return;
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return;
+    /*Layers can be transformed, their content is not drawn at its coordinates*/
+    if(_lv_obj_get_layer_type(obj) != LV_LAYER_TYPE_NONE) return;
+
+    bool overflow = lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE);
+    lv_area_t clip_children;
+    if(overflow) {
+        clip_children = *clip;
+    }
+    else {
+        /*Not visible: neither the object nor its children are drawn*/
+        if(!_lv_area_intersect(&clip_children, clip, &obj->coords)) return;
+
+        /*Is everything the object draws (shadow, outline... too) hidden?*/
+        lv_area_t vis;
+        lv_coord_t ext_draw_size = _lv_obj_get_ext_draw_size(obj);
+        lv_area_copy(&vis, &obj->coords);
+        lv_area_increase(&vis, ext_draw_size, ext_draw_size);
+        _lv_area_intersect(&vis, &vis, clip);
+        uint32_t i;
+        for(i = 0; i < occl.cover_cnt; i++) {
+            if(_lv_area_is_in(&vis, &occl.covers[i], 0)) break;
+        }
+        if(i < occl.cover_cnt) {
+            if(occl.culled_cnt < OCCL_CULLED_MAX) {
+                occl.culled[occl.culled_cnt] = obj;
+                occl.culled_cnt++;
+            }
+            return;
+        }
+    }
+
+    /*Only the straight middle of a rounded object can cover*/
+    lv_area_t cover;
+    lv_cover_check_info_t info;
+    info.res = LV_COVER_RES_NOT_COVER;
+    if(collect) {
+        lv_area_copy(&cover, &obj->coords);
+        lv_coord_t r = lv_obj_get_style_radius(obj, LV_PART_MAIN);
+        if(r > 0) {
+            r = LV_MIN(r, LV_MIN(lv_area_get_width(&cover), lv_area_get_height(&cover)) / 2);
+            cover.x1 += r;
+            cover.x2 -= r;
+        }
+        if(_lv_area_intersect(&cover, &cover, clip)) {
+            info.res = LV_COVER_RES_COVER;
+            info.area = &cover;
+            lv_event_send(obj, LV_EVENT_COVER_CHECK, &info);
+        }
+        /*Children drawn with a mask or with the opacity of this object don't cover*/
+        if(info.res == LV_COVER_RES_MASKED || lv_obj_get_style_clip_corner(obj, LV_PART_MAIN) ||
+           lv_obj_get_style_opa(obj, LV_PART_MAIN) < LV_OPA_MAX) {
+            collect = false;
+        }
+    }
+
+    int32_t i;
+    int32_t child_cnt = lv_obj_get_child_cnt(obj);
+    for(i = child_cnt - 1; i >= 0; i--) {
+        occlusion_walk(obj->spec_attr->children[i], &clip_children, collect);
+    }
+
+    if(info.res == LV_COVER_RES_COVER && lv_obj_get_style_blend_mode(obj, LV_PART_MAIN) == LV_BLEND_MODE_NORMAL) {
+        occlusion_add_cover(&cover);
+    }
+}
+
+static void occlusion_add_cover(const lv_area_t * cover)
+{
+    if(_lv_area_is_in(&occl.area, cover, 0)) occl.area_covered = 1;
+
+    /*Grow a cover which has the same width or height and touches this one (e.g. a column of list items)*/
+    uint32_t i;
+    for(i = 0; i < occl.cover_cnt; i++) {
+        lv_area_t * c = &occl.covers[i];
+        if((c->x1 == cover->x1 && c->x2 == cover->x2 && c->y1 <= cover->y2 + 1 && cover->y1 <= c->y2 + 1) ||
+           (c->y1 == cover->y1 && c->y2 == cover->y2 && c->x1 <= cover->x2 + 1 && cover->x1 <= c->x2 + 1)) {
+            _lv_area_join(c, c, cover);
+            return;
+        }
+    }
+
+    /*If full replace the smallest cover if this one is larger*/
+    if(occl.cover_cnt < OCCL_COVER_MAX) {
+        occl.covers[occl.cover_cnt] = *cover;
+        occl.cover_cnt++;
+        return;
+    }
+    uint32_t min_i = 0;
+    for(i = 1; i < occl.cover_cnt; i++) {
+        if(lv_area_get_size(&occl.covers[i]) < lv_area_get_size(&occl.covers[min_i])) min_i = i;
+    }
+    if(lv_area_get_size(cover) > lv_area_get_size(&occl.covers[min_i])) occl.covers[min_i] = *cover;
+}
+
+static bool occlusion_is_culled(const lv_obj_t * obj)
+{
+    uint32_t i;
+    for(i = 0; i < occl.culled_cnt; i++) {
+        if(occl.culled[i] == obj) return true;
+    }
+    return false;
+}
+
+static void occlusion_clear(void)
+{
+    occl.culled_cnt = 0;
+}
+
+/**
+ * Get the recorded draw calls of an object. Record them if the object was already drawn in an earlier
+ * refresh and didn't change since then: objects changing in every refresh (animations) and objects with
+ * draw event handlers added by the user are not recorded.
+ * The draw events are sent with the whole drawing area of the object as clip area and the draw functions
+ * only record their arguments, so the list can be replayed in any area later.
+ * @param draw_ctx          pointer to the draw context
+ * @param obj               pointer to an object
+ * @param obj_coords_ext    the object's coordinates with the extra draw size
+ * @return                  true: replay `obj->draw_list` instead of sending the draw events
+ */
+static bool draw_list_get(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj, const lv_area_t * obj_coords_ext)
+{
+    uint32_t mem_max = disp_refr ? disp_refr->driver->retained_mem : 0;
+    if(mem_max == 0) return false;
+    if(obj->draw_list == LV_DRAW_LIST_FAILED) return false;
+    /*The handlers added by the user can draw anything, also state which doesn't invalidate the object*/
+    if(_lv_event_has_draw_cb(obj)) return false;
+    if(obj->draw_list) return true;
+
+    /*The threads rendering in parallel can draw the same object*/
+    _lv_refr_lock();
+    bool record = false;
+    uint32_t mem_used = _lv_draw_list_get_mem_used();
+    if(obj->draw_list) {
+        /*Recorded by an other thread meanwhile*/
+    }
+    else if(!obj->draw_list_seen) {
+        obj->draw_list_seen = 1;
+        obj->draw_list_frame = refr_parity;
+    }
+    else if(obj->draw_list_frame != refr_parity && mem_used < mem_max) {
+        record = true;
+    }
+    _lv_refr_unlock();
+    if(!record) return obj->draw_list != NULL && obj->draw_list != LV_DRAW_LIST_FAILED;
+
+    const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+    draw_ctx->clip_area = obj_coords_ext;
+    _lv_draw_list_record_start(draw_ctx, &obj->coords, LV_MIN(mem_max - mem_used, DRAW_LIST_OBJ_MAX));
+    lv_event_send(obj, LV_EVENT_DRAW_MAIN_BEGIN, draw_ctx);
+    lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
+    lv_event_send(obj, LV_EVENT_DRAW_MAIN_END, draw_ctx);
+    _lv_draw_list_record_post();
+    lv_event_send(obj, LV_EVENT_DRAW_POST_BEGIN, draw_ctx);
+    lv_event_send(obj, LV_EVENT_DRAW_POST, draw_ctx);
+    lv_event_send(obj, LV_EVENT_DRAW_POST_END, draw_ctx);
+    lv_draw_list_t * list = _lv_draw_list_record_finish();
+    draw_ctx->clip_area = clip_area_ori;
+
+    /*Don't try again until the object changes*/
+    _lv_refr_lock();
+    if(obj->draw_list == NULL) obj->draw_list = list ? list : LV_DRAW_LIST_FAILED;
+    else _lv_draw_list_free(list);
+    bool res = obj->draw_list != LV_DRAW_LIST_FAILED;
+    _lv_refr_unlock();
+
+    return res;
+}
 
 static lv_res_t layer_get_area(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj, lv_layer_type_t layer_type,
                                lv_area_t * layer_area_out)
@@ -969,6 +1660,7 @@ void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
 {
     /*Do not refresh hidden objects*/
     if(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return;
+    if(occlusion_is_culled(obj)) return;
     lv_layer_type_t layer_type = _lv_obj_get_layer_type(obj);
     if(layer_type == LV_LAYER_TYPE_NONE) {
         lv_obj_redraw(draw_ctx, obj);
@@ -26,6 +26,20 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+/**
+ * Frame pacing of a display, see `lv_disp_drv_t::panel_period_us`
+ */
+typedef struct {
+    uint32_t period_us;         /**< Period the frames are paced to, 0 if the display is not paced*/
+    uint32_t fps;               /**< The same as frames per second*/
+    uint8_t div;                /**< Panel refreshes per frame*/
+    uint32_t frames;            /**< Frames drawn while paced*/
+    uint32_t dropped;           /**< Slots given up because a frame ran past its slot*/
+    uint32_t rate_changes;      /**< How many times the rate was changed*/
+    uint32_t jitter_avg_us;     /**< Mean distance between the start of a frame and its slot*/
+    uint32_t jitter_max_us;     /**< Largest such distance*/
+} lv_refr_pacing_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -85,6 +99,24 @@ lv_disp_t * _lv_refr_get_disp_refreshing(void);
  */
 void _lv_refr_set_disp_refreshing(lv_disp_t * disp);
 
+/**
+ * Tell if the parts of the screen are being rendered in parallel (`lv_disp_drv_t::render_strips`).
+ * The drawing functions are called on several threads then.
+ * @return true: rendering in parallel
+ */
+bool _lv_refr_is_parallel(void);
+
+/**
+ * Lock the data shared by the threads rendering in parallel, e.g. the heap.
+ * Does nothing if not rendering in parallel. Can be nested.
+ */
+void _lv_refr_lock(void);
+
+/**
+ * Unlock the data locked by `_lv_refr_lock()`
+ */
+void _lv_refr_unlock(void);
+
 #if LV_USE_PERF_MONITOR
 /**
  * Reset FPS counter
@@ -98,6 +130,13 @@ void lv_refr_reset_fps_counter(void);
 uint32_t lv_refr_get_fps_avg(void);
 #endif
 
+/**
+ * Get the frame rate a display is paced to and how evenly its frames were drawn.
+ * @param disp      pointer to a display, NULL to use the default display
+ * @param pacing    filled with the pacing state, all zero if the display is not paced
+ */
+void lv_refr_get_pacing(lv_disp_t * disp, lv_refr_pacing_t * pacing);
+
 /**
  * Called periodically to handle the refreshing
  * @param timer pointer to the timer itself
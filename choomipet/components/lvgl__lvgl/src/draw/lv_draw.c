@@ -8,6 +8,7 @@
  *********************/
 #include "lv_draw.h"
 #include "sw/lv_draw_sw.h"
+#include "sw/lv_draw_sw_blend_kernels.h"
 
 /*********************
  *      DEFINES
@@ -39,7 +40,7 @@
 
 void lv_draw_init(void)
 {
-    /*Nothing to init now*/
+    _lv_draw_sw_blend_kernels_init();
 }
 
 void lv_draw_wait_for_finish(lv_draw_ctx_t * draw_ctx)
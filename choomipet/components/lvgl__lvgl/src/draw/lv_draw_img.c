@@ -17,6 +17,8 @@
 /*********************
  *      DEFINES
  *********************/
+/*Read this many bytes of lines at once and draw them together when the image is read line-by-line*/
+#define READ_LINES_BUF_SIZE 4096
 
 /**********************
  *      TYPEDEFS
@@ -70,6 +72,11 @@ void lv_draw_img(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc, const
 
     if(dsc->opa <= LV_OPA_MIN) return;
 
+    if(_lv_draw_list_is_recording()) {
+        _lv_draw_list_add_img(dsc, coords, src);
+        return;
+    }
+
     lv_res_t res = LV_RES_INV;
 
     if(draw_ctx->draw_img) {
@@ -102,9 +109,11 @@ uint8_t lv_img_cf_get_px_size(lv_img_cf_t cf)
             break;
         case LV_IMG_CF_TRUE_COLOR:
         case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED:
+        case LV_IMG_CF_RLE_TRUE_COLOR:
             px_size = LV_COLOR_SIZE;
             break;
         case LV_IMG_CF_TRUE_COLOR_ALPHA:
+        case LV_IMG_CF_RLE_TRUE_COLOR_ALPHA:
             px_size = LV_IMG_PX_SIZE_ALPHA_BYTE << 3;
             break;
         case LV_IMG_CF_INDEXED_1BIT:
@@ -165,6 +174,7 @@ bool lv_img_cf_has_alpha(lv_img_cf_t cf)
 
     switch(cf) {
         case LV_IMG_CF_TRUE_COLOR_ALPHA:
+        case LV_IMG_CF_RLE_TRUE_COLOR_ALPHA:
         case LV_IMG_CF_RAW_ALPHA:
         case LV_IMG_CF_INDEXED_1BIT:
         case LV_IMG_CF_INDEXED_2BIT:
@@ -230,6 +240,11 @@ void lv_draw_img_decoded(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc
 {
     if(draw_ctx->draw_img_decoded == NULL) return;
 
+    if(_lv_draw_list_is_recording()) {
+        _lv_draw_list_cancel();
+        return;
+    }
+
     draw_ctx->draw_img_decoded(draw_ctx, dsc, coords, map_p, color_format);
 }
 
@@ -254,11 +269,13 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
     else if(lv_img_cf_has_alpha(cdsc->dec_dsc.header.cf)) cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
     else cf = LV_IMG_CF_TRUE_COLOR;
 
+    /*Not in the entry: it can be cached and drawn by other threads too*/
+    const uint8_t * img_data = cdsc->dec_dsc.img_data;
     if(cf == LV_IMG_CF_ALPHA_8BIT) {
         if(draw_dsc->angle || draw_dsc->zoom != LV_IMG_ZOOM_NONE) {
             /* resume normal method */
             cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
-            cdsc->dec_dsc.img_data = NULL;
+            img_data = NULL;
         }
     }
 
@@ -269,7 +286,7 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
     }
     /*The decoder could open the image and gave the entire uncompressed image.
      *Just draw it!*/
-    else if(cdsc->dec_dsc.img_data) {
+    else if(img_data) {
         lv_area_t map_area_rot;
         lv_area_copy(&map_area_rot, coords);
         if(draw_dsc->angle || draw_dsc->zoom != LV_IMG_ZOOM_NONE) {
@@ -295,7 +312,7 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
 
         const lv_area_t * clip_area_ori = draw_ctx->clip_area;
         draw_ctx->clip_area = &clip_com;
-        lv_draw_img_decoded(draw_ctx, draw_dsc, coords, cdsc->dec_dsc.img_data, cf);
+        lv_draw_img_decoded(draw_ctx, draw_dsc, coords, img_data, cf);
         draw_ctx->clip_area = clip_area_ori;
     }
     /*The whole uncompressed image is not available. Try to read it line-by-line*/
@@ -311,37 +328,41 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
 
         int32_t width = lv_area_get_width(&mask_com);
 
-        uint8_t  * buf = lv_mem_buf_get(lv_area_get_width(&mask_com) *
-                                        LV_IMG_PX_SIZE_ALPHA_BYTE);  /*+1 because of the possible alpha byte*/
+        /*Draw as many lines at once as fit into the buffer.
+         *The planes of RGB565A8 and the alpha only lines are drawn one by one*/
+        uint32_t line_size = width * LV_IMG_PX_SIZE_ALPHA_BYTE; /*The possible alpha byte too*/
+        int32_t buf_rows = 1;
+        if(cf != LV_IMG_CF_RGB565A8 && cf != LV_IMG_CF_ALPHA_8BIT) buf_rows = LV_MAX(READ_LINES_BUF_SIZE / line_size, 1);
+        buf_rows = LV_MIN(buf_rows, lv_area_get_height(&mask_com));
+        uint8_t  * buf = lv_mem_buf_get(line_size * buf_rows);
 
         const lv_area_t * clip_area_ori = draw_ctx->clip_area;
-        lv_area_t line;
-        lv_area_copy(&line, &mask_com);
-        lv_area_set_height(&line, 1);
+        lv_area_t lines;
+        lv_area_copy(&lines, &mask_com);
         int32_t x = mask_com.x1 - coords->x1;
         int32_t y = mask_com.y1 - coords->y1;
-        int32_t row;
+        uint32_t px_size = lv_img_cf_get_px_size(cf) >> 3;
         lv_res_t read_res;
-        for(row = mask_com.y1; row <= mask_com.y2; row++) {
-            lv_area_t mask_line;
-            union_ok = _lv_area_intersect(&mask_line, clip_area_ori, &line);
-            if(union_ok == false) continue;
-
-            read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, x, y, width, buf);
-            if(read_res != LV_RES_OK) {
-                lv_img_decoder_close(&cdsc->dec_dsc);
-                LV_LOG_WARN("Image draw can't read the line");
-                lv_mem_buf_release(buf);
-                draw_cleanup(cdsc);
-                draw_ctx->clip_area = clip_area_ori;
-                return LV_RES_INV;
+        while(lines.y1 <= mask_com.y2) {
+            lines.y2 = LV_MIN(lines.y1 + buf_rows - 1, mask_com.y2);
+            int32_t i;
+            for(i = 0; i <= lines.y2 - lines.y1; i++) {
+                read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, x, y + i, width, buf + i * width * px_size);
+                if(read_res != LV_RES_OK) {
+                    /*Don't keep it in the cache, it's closed when released*/
+                    lv_img_cache_invalidate_src(src);
+                    LV_LOG_WARN("Image draw can't read the line");
+                    lv_mem_buf_release(buf);
+                    draw_cleanup(cdsc);
+                    draw_ctx->clip_area = clip_area_ori;
+                    return LV_RES_INV;
+                }
             }
 
-            draw_ctx->clip_area = &mask_line;
-            lv_draw_img_decoded(draw_ctx, draw_dsc, &line, buf, cf);
-            line.y1++;
-            line.y2++;
-            y++;
+            draw_ctx->clip_area = &lines;
+            lv_draw_img_decoded(draw_ctx, draw_dsc, &lines, buf, cf);
+            y += lv_area_get_height(&lines);
+            lines.y1 = lines.y2 + 1;
         }
         draw_ctx->clip_area = clip_area_ori;
         lv_mem_buf_release(buf);
@@ -366,10 +387,5 @@ static void show_error(lv_draw_ctx_t * draw_ctx, const lv_area_t * coords, const
 
 static void draw_cleanup(_lv_img_cache_entry_t * cache)
 {
-    /*Automatically close images with no caching*/
-#if LV_IMG_CACHE_DEF_SIZE == 0
-    lv_img_decoder_close(&cache->dec_dsc);
-#else
-    LV_UNUSED(cache);
-#endif
+    _lv_img_cache_release(cache);
 }
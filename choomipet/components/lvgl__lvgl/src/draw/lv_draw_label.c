@@ -83,11 +83,19 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
         return;
     }
 
+    if(_lv_draw_list_is_recording()) {
+        _lv_draw_list_add_label(dsc, coords, txt);
+        return;
+    }
+
     if(draw_ctx->draw_letter == NULL) {
         LV_LOG_WARN("draw->draw_letter == NULL (there is no function to draw letters)");
         return;
     }
 
+    /*The hint is written while drawing, the threads rendering in parallel would race for it*/
+    if(_lv_refr_is_parallel()) hint = NULL;
+
     lv_draw_label_dsc_t dsc_mod = *dsc;
 
     const lv_font_t * font = dsc->font;
@@ -364,6 +372,11 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 void lv_draw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,  const lv_point_t * pos_p,
                     uint32_t letter)
 {
+    if(_lv_draw_list_is_recording()) {
+        _lv_draw_list_cancel();
+        return;
+    }
+
     draw_ctx->draw_letter(draw_ctx, dsc, pos_p, letter);
 }
 
@@ -0,0 +1,280 @@
+/**
+ * @file lv_draw_list.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw.h"
+#include "lv_draw_list.h"
+#include "../misc/lv_mem.h"
+#include "../misc/lv_assert.h"
+#include "../core/lv_refr.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ENTRY_FLAG_CLIP     0x01    /*The entry was drawn with a clip area of its own*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    ENTRY_RECT,
+    ENTRY_LABEL,
+    ENTRY_IMG,
+} entry_type_t;
+
+/*Entries are packed without padding and copied out when replayed, followed by
+ *the clip area (with ENTRY_FLAG_CLIP), the descriptor and then the text of a label
+ *or the source of an image*/
+typedef struct {
+    uint8_t type;
+    uint8_t flags;
+    uint16_t txt_len;       /*Length of the text of a label without the terminating 0*/
+    lv_area_t coords;
+} entry_head_t;
+
+typedef struct {
+    struct _lv_draw_ctx_t * draw_ctx;
+    lv_area_t coords;
+    lv_area_t clip_area;    /*The clip area the recording was started with*/
+    uint8_t * buf;
+    uint32_t size;
+    uint32_t max_size;
+    uint32_t post_ofs;
+    uint8_t active : 1;
+    uint8_t failed : 1;
+} recorder_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint8_t * add_entry(entry_type_t type, const lv_area_t * coords, uint32_t dsc_size, uint32_t extra_size);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static LV_RENDER_LOCAL recorder_t rec;
+static uint32_t mem_used;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_draw_list_record_start(struct _lv_draw_ctx_t * draw_ctx, const lv_area_t * coords, uint32_t max_size)
+{
+    LV_ASSERT(rec.active == 0);
+
+    rec.draw_ctx = draw_ctx;
+    rec.coords = *coords;
+    rec.clip_area = *draw_ctx->clip_area;
+    rec.size = 0;
+    rec.post_ofs = 0;
+    rec.max_size = LV_MIN(max_size, UINT16_MAX);
+    rec.buf = rec.max_size > sizeof(lv_draw_list_t) ? lv_mem_buf_get(rec.max_size) : NULL;
+    rec.failed = rec.buf == NULL;
+    rec.active = 1;
+}
+
+void _lv_draw_list_record_post(void)
+{
+    rec.post_ofs = rec.size;
+}
+
+lv_draw_list_t * _lv_draw_list_record_finish(void)
+{
+    lv_draw_list_t * list = NULL;
+
+    rec.active = 0;
+    if(!rec.failed) {
+        list = lv_mem_alloc(sizeof(lv_draw_list_t) + rec.size);
+        if(list) {
+            list->size = (uint16_t)rec.size;
+            list->post_ofs = (uint16_t)rec.post_ofs;
+            lv_memcpy(list->data, rec.buf, rec.size);
+            _lv_refr_lock();
+            mem_used += sizeof(lv_draw_list_t) + rec.size;
+            _lv_refr_unlock();
+        }
+    }
+    if(rec.buf) lv_mem_buf_release(rec.buf);
+    rec.buf = NULL;
+
+    return list;
+}
+
+bool _lv_draw_list_is_recording(void)
+{
+    return rec.active;
+}
+
+void _lv_draw_list_add_rect(const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
+{
+    /*E.g. the transparent background of the layers or a label*/
+    bool visible = dsc->bg_opa > LV_OPA_MIN ||
+                   (dsc->bg_img_src && dsc->bg_img_opa > LV_OPA_MIN) ||
+                   (dsc->border_width && dsc->border_opa > LV_OPA_MIN) ||
+                   (dsc->outline_width && dsc->outline_opa > LV_OPA_MIN) ||
+                   (dsc->shadow_width && dsc->shadow_opa > LV_OPA_MIN);
+    if(!visible) return;
+
+    uint8_t * p = add_entry(ENTRY_RECT, coords, sizeof(*dsc), 0);
+    if(p) lv_memcpy(p, dsc, sizeof(*dsc));
+}
+
+void _lv_draw_list_add_label(const lv_draw_label_dsc_t * dsc, const lv_area_t * coords, const char * txt)
+{
+    /*The text is copied: widgets can draw texts formatted into a local buffer*/
+    size_t txt_len = strlen(txt);
+    if(txt_len >= UINT16_MAX) {
+        _lv_draw_list_cancel();
+        return;
+    }
+
+    uint8_t * p = add_entry(ENTRY_LABEL, coords, sizeof(*dsc), (uint32_t)txt_len + 1);
+    if(p == NULL) return;
+    lv_memcpy(p, dsc, sizeof(*dsc));
+    lv_memcpy(p + sizeof(*dsc), txt, txt_len + 1);
+}
+
+void _lv_draw_list_add_img(const lv_draw_img_dsc_t * dsc, const lv_area_t * coords, const void * src)
+{
+    uint8_t * p = add_entry(ENTRY_IMG, coords, sizeof(*dsc), sizeof(src));
+    if(p == NULL) return;
+    lv_memcpy(p, dsc, sizeof(*dsc));
+    lv_memcpy(p + sizeof(*dsc), &src, sizeof(src));
+}
+
+void _lv_draw_list_cancel(void)
+{
+    rec.failed = 1;
+}
+
+void _lv_draw_list_replay(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_list_t * list, const lv_area_t * coords,
+                          bool post)
+{
+    const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+    const uint8_t * p = list->data + (post ? list->post_ofs : 0);
+    const uint8_t * end = list->data + (post ? list->size : list->post_ofs);
+
+    while(p < end) {
+        entry_head_t head;
+        lv_memcpy(&head, p, sizeof(head));
+        p += sizeof(head);
+
+        lv_area_t area = head.coords;
+        lv_area_move(&area, coords->x1, coords->y1);
+
+        bool visible = true;
+        lv_area_t clip;
+        if(head.flags & ENTRY_FLAG_CLIP) {
+            lv_memcpy(&clip, p, sizeof(clip));
+            p += sizeof(clip);
+            lv_area_move(&clip, coords->x1, coords->y1);
+            visible = _lv_area_intersect(&clip, &clip, clip_area_ori);
+            draw_ctx->clip_area = &clip;
+        }
+
+        switch(head.type) {
+            case ENTRY_RECT: {
+                    lv_draw_rect_dsc_t dsc;
+                    lv_memcpy(&dsc, p, sizeof(dsc));
+                    p += sizeof(dsc);
+                    if(visible) lv_draw_rect(draw_ctx, &dsc, &area);
+                    break;
+                }
+            case ENTRY_LABEL: {
+                    lv_draw_label_dsc_t dsc;
+                    lv_memcpy(&dsc, p, sizeof(dsc));
+                    p += sizeof(dsc);
+                    if(visible) lv_draw_label(draw_ctx, &dsc, &area, (const char *)p, NULL);
+                    p += head.txt_len + 1;
+                    break;
+                }
+            case ENTRY_IMG: {
+                    lv_draw_img_dsc_t dsc;
+                    const void * src;
+                    lv_memcpy(&dsc, p, sizeof(dsc));
+                    p += sizeof(dsc);
+                    lv_memcpy(&src, p, sizeof(src));
+                    p += sizeof(src);
+                    if(visible) lv_draw_img(draw_ctx, &dsc, &area, src);
+                    break;
+                }
+            default:
+                LV_ASSERT_MSG(false, "Invalid draw list entry");
+                draw_ctx->clip_area = clip_area_ori;
+                return;
+        }
+
+        draw_ctx->clip_area = clip_area_ori;
+    }
+}
+
+void _lv_draw_list_free(lv_draw_list_t * list)
+{
+    if(list == NULL || list == LV_DRAW_LIST_FAILED) return;
+    _lv_refr_lock();
+    mem_used -= sizeof(lv_draw_list_t) + list->size;
+    _lv_refr_unlock();
+    lv_mem_free(list);
+}
+
+uint32_t _lv_draw_list_get_mem_used(void)
+{
+    return mem_used;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Append an entry to the recording
+ * @param type          type of the entry
+ * @param coords        absolute coordinates of the drawn item
+ * @param dsc_size      size of the descriptor
+ * @param extra_size    bytes after the descriptor
+ * @return              where to copy the descriptor or NULL if the recording failed
+ */
+static uint8_t * add_entry(entry_type_t type, const lv_area_t * coords, uint32_t dsc_size, uint32_t extra_size)
+{
+    if(rec.failed) return NULL;
+
+    /*The clip area is stored only if a widget narrowed it, e.g. to the text area of a label*/
+    const lv_area_t * clip_area = rec.draw_ctx->clip_area;
+    bool own_clip = clip_area->x1 != rec.clip_area.x1 || clip_area->y1 != rec.clip_area.y1 ||
+                    clip_area->x2 != rec.clip_area.x2 || clip_area->y2 != rec.clip_area.y2;
+
+    uint32_t size = sizeof(entry_head_t) + (own_clip ? sizeof(lv_area_t) : 0) + dsc_size + extra_size;
+    if(rec.size + size > rec.max_size - sizeof(lv_draw_list_t)) {
+        rec.failed = 1;
+        return NULL;
+    }
+
+    uint8_t * p = rec.buf + rec.size;
+    entry_head_t head;
+    head.type = type;
+    head.flags = own_clip ? ENTRY_FLAG_CLIP : 0;
+    head.txt_len = type == ENTRY_LABEL ? (uint16_t)(extra_size - 1) : 0;
+    head.coords = *coords;
+    lv_area_move(&head.coords, -rec.coords.x1, -rec.coords.y1);
+    lv_memcpy(p, &head, sizeof(head));
+    p += sizeof(head);
+
+    if(own_clip) {
+        lv_area_t clip = *clip_area;
+        lv_area_move(&clip, -rec.coords.x1, -rec.coords.y1);
+        lv_memcpy(p, &clip, sizeof(clip));
+        p += sizeof(clip);
+    }
+
+    rec.size += size;
+    return p;
+}
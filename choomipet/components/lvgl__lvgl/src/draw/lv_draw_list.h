@@ -0,0 +1,115 @@
+/**
+ * @file lv_draw_list.h
+ *
+ */
+
+#ifndef LV_DRAW_LIST_H
+#define LV_DRAW_LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include "../misc/lv_area.h"
+#include "lv_draw_rect.h"
+#include "lv_draw_label.h"
+#include "lv_draw_img.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/** Stored instead of a list if the draw calls of an object can't be recorded*/
+#define LV_DRAW_LIST_FAILED     ((lv_draw_list_t *)(lv_uintptr_t)1)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+struct _lv_draw_ctx_t;
+
+/**
+ * The draw calls of an object recorded with their resolved descriptors.
+ * Coordinates are relative to the object so the list stays valid when the object is moved.
+ */
+typedef struct _lv_draw_list_t {
+    uint16_t size;          /**< Bytes in `data`*/
+    uint16_t post_ofs;      /**< Where the calls of the `LV_EVENT_DRAW_POST...` events start in `data`*/
+    uint8_t data[];
+} lv_draw_list_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start recording. Until `_lv_draw_list_record_finish()` `lv_draw_rect()`, `lv_draw_label()` and
+ * `lv_draw_img()` only store their arguments and any other drawing function or mask cancels the recording.
+ * @param draw_ctx  the draw context whose clip area is the object's whole drawing area
+ * @param coords    the object's coordinates, the recorded coordinates are relative to it
+ * @param max_size  the largest list to create in bytes
+ */
+void _lv_draw_list_record_start(struct _lv_draw_ctx_t * draw_ctx, const lv_area_t * coords, uint32_t max_size);
+
+/**
+ * The following draw calls belong to the `LV_EVENT_DRAW_POST...` events
+ */
+void _lv_draw_list_record_post(void);
+
+/**
+ * Stop recording.
+ * @return the recorded list or NULL if something was drawn that can't be recorded or the list didn't fit.
+ *         Free it with `_lv_draw_list_free()`.
+ */
+lv_draw_list_t * _lv_draw_list_record_finish(void);
+
+/**
+ * Tell if the draw calls are being recorded
+ * @return true: the draw functions should call `_lv_draw_list_add_...()` or `_lv_draw_list_cancel()` instead of drawing
+ */
+bool _lv_draw_list_is_recording(void);
+
+void _lv_draw_list_add_rect(const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords);
+
+void _lv_draw_list_add_label(const lv_draw_label_dsc_t * dsc, const lv_area_t * coords, const char * txt);
+
+void _lv_draw_list_add_img(const lv_draw_img_dsc_t * dsc, const lv_area_t * coords, const void * src);
+
+/**
+ * Something was drawn which can't be recorded. The recording continues but the result will be NULL.
+ */
+void _lv_draw_list_cancel(void);
+
+/**
+ * Draw a recorded list
+ * @param draw_ctx  the draw context, the calls are clipped to its clip area
+ * @param list      a recorded list
+ * @param coords    the current coordinates of the object
+ * @param post      false: replay the `LV_EVENT_DRAW_MAIN...` part; true: the `LV_EVENT_DRAW_POST...` part
+ */
+void _lv_draw_list_replay(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_list_t * list, const lv_area_t * coords,
+                          bool post);
+
+/**
+ * Free a recorded list
+ * @param list  a list returned by `_lv_draw_list_record_finish()`, `LV_DRAW_LIST_FAILED` or NULL
+ */
+void _lv_draw_list_free(lv_draw_list_t * list);
+
+/**
+ * Get the memory used by all recorded lists
+ * @return bytes allocated from the LVGL heap
+ */
+uint32_t _lv_draw_list_get_mem_used(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_LIST_H*/
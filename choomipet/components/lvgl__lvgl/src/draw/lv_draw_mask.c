@@ -60,9 +60,20 @@ static lv_opa_t * get_next_line(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_
                                 lv_coord_t * x_start);
 static inline lv_opa_t /* LV_ATTRIBUTE_FAST_MEM */ mask_mix(lv_opa_t mask_act, lv_opa_t mask_new);
 
+static void runs_add(lv_draw_mask_runs_t * runs, lv_coord_t len, lv_draw_mask_res_t res);
+static void runs_append(lv_draw_mask_runs_t * runs, const lv_draw_mask_runs_t * part, lv_draw_mask_res_t part_res,
+                        lv_coord_t len);
+static void runs_intersect(lv_draw_mask_runs_t * runs, const lv_draw_mask_runs_t * other);
+static void runs_set_edges(lv_draw_mask_runs_t * runs, lv_coord_t len, lv_draw_mask_res_t res_out,
+                           lv_draw_mask_res_t res_in, int32_t edge1_start, int32_t edge1_end,
+                           int32_t edge2_start, int32_t edge2_end);
+static void line_runs(lv_draw_mask_runs_t * runs, lv_coord_t len, bool inv, int32_t aa_start, int32_t aa_end);
+
 /**********************
  *  STATIC VARIABLES
  **********************/
+/*While `lv_draw_mask_apply_runs()` runs, the masks store the spans of the line here*/
+static LV_RENDER_LOCAL lv_draw_mask_runs_t * run_rec;
 
 /**********************
  *      MACROS
@@ -80,6 +91,9 @@ static inline lv_opa_t /* LV_ATTRIBUTE_FAST_MEM */ mask_mix(lv_opa_t mask_act, l
  */
 int16_t lv_draw_mask_add(void * param, void * custom_id)
 {
+    /*The mask is added anyway: the widget will remove it*/
+    if(_lv_draw_list_is_recording()) _lv_draw_list_cancel();
+
     /*Look for a free entry*/
     uint8_t i;
     for(i = 0; i < _LV_MASK_MAX_NUM; i++) {
@@ -163,6 +177,50 @@ lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_apply_ids(lv_opa_t * mask_
     return changed ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
 }
 
+/**
+ * Apply the added masks on a line like `lv_draw_mask_apply()` and also tell which parts of the line
+ * are transparent, unchanged or anti-aliased. Radius, angle and line masks describe their spans
+ * exactly, the other masks mark the changed lines as anti-aliased.
+ * @param mask_buf store the result mask here. Has to be `len` byte long.
+ *                 Should be initialized with the same value on the whole line.
+ * @param abs_x absolute X coordinate where the line to calculate start
+ * @param abs_y absolute Y coordinate where the line to calculate start
+ * @param len length of the line to calculate (in pixel count)
+ * @param runs store the spans of the line here. Not set if `LV_DRAW_MASK_RES_TRANSP` is returned.
+ * @return the same as `lv_draw_mask_apply()`
+ */
+lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_apply_runs(lv_opa_t * mask_buf, lv_coord_t abs_x,
+                                                                 lv_coord_t abs_y, lv_coord_t len,
+                                                                 lv_draw_mask_runs_t * runs)
+{
+    bool changed = false;
+    _lv_draw_mask_common_dsc_t * dsc;
+    lv_draw_mask_runs_t mask_runs;
+
+    _lv_draw_mask_saved_t * m = LV_GC_ROOT(_lv_draw_mask_list);
+
+    runs->cnt = 0;
+    runs_add(runs, len, LV_DRAW_MASK_RES_FULL_COVER);
+
+    while(m->param) {
+        dsc = m->param;
+        mask_runs.cnt = 0;
+        run_rec = &mask_runs;
+        lv_draw_mask_res_t res = dsc->cb(mask_buf, abs_x, abs_y, len, (void *)m->param);
+        run_rec = NULL;
+        if(res == LV_DRAW_MASK_RES_TRANSP) return LV_DRAW_MASK_RES_TRANSP;
+        else if(res == LV_DRAW_MASK_RES_CHANGED) changed = true;
+
+        /*Without spans of its own a mask could have changed any value of the line*/
+        if(mask_runs.cnt == 0 && res == LV_DRAW_MASK_RES_CHANGED) runs_add(&mask_runs, len, LV_DRAW_MASK_RES_CHANGED);
+        if(mask_runs.cnt) runs_intersect(runs, &mask_runs);
+
+        m++;
+    }
+
+    return changed ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
+}
+
 /**
  * Remove a mask with a given ID
  * @param id the ID of the mask.  Returned by `lv_draw_mask_add`
@@ -174,6 +232,7 @@ void * lv_draw_mask_remove_id(int16_t id)
     _lv_draw_mask_common_dsc_t * p = NULL;
 
     if(id != LV_MASK_ID_INV) {
+        if(_lv_draw_list_is_recording()) _lv_draw_list_cancel();
         p = LV_GC_ROOT(_lv_draw_mask_list[id]).param;
         LV_GC_ROOT(_lv_draw_mask_list[id]).param = NULL;
         LV_GC_ROOT(_lv_draw_mask_list[id]).custom_id = NULL;
@@ -627,6 +686,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_line(lv_opa_t * mas
                     int32_t k = - abs_x;
                     if(k < 0) return LV_DRAW_MASK_RES_TRANSP;
                     if(k >= 0 && k < len) lv_memset_00(&mask_buf[k], len - k);
+                    if(run_rec) line_runs(run_rec, len, false, k, k);
                     return  LV_DRAW_MASK_RES_CHANGED;
                 }
             }
@@ -637,6 +697,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_line(lv_opa_t * mas
                     if(k < 0) k = 0;
                     if(k >= len) return LV_DRAW_MASK_RES_TRANSP;
                     else if(k >= 0 && k < len) lv_memset_00(&mask_buf[0], k);
+                    if(run_rec) line_runs(run_rec, len, true, k, k);
                     return  LV_DRAW_MASK_RES_CHANGED;
                 }
             }
@@ -748,6 +809,9 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_flat(lv_opa_t * mask_b
         mask_buf[k] = mask_mix(mask_buf[k], m);
     }
 
+    /*The anti-aliased pixels are from the one at the line to `k`*/
+    if(run_rec) line_runs(run_rec, len, p->inv, xei - abs_x, k + 1);
+
     if(p->inv) {
         k = xei - abs_x;
         if(k > len) {
@@ -828,6 +892,8 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_steep(lv_opa_t * mask_
         }
         k++;
 
+        if(run_rec) line_runs(run_rec, len, p->inv, p->inv ? xsi - abs_x : k - 1, k);
+
         if(p->inv) {
             k = xsi - abs_x;
             if(k >= len) {
@@ -864,6 +930,8 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_steep(lv_opa_t * mask_
 
             k += 2;
 
+            if(run_rec) line_runs(run_rec, len, p->inv, k - 2, k);
+
             if(p->inv) {
                 k = xsi - abs_x - 1;
 
@@ -895,6 +963,8 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_steep(lv_opa_t * mask_
             }
             k++;
 
+            if(run_rec) line_runs(run_rec, len, p->inv, k - 2, k);
+
             if(p->inv) {
                 k = xsi - abs_x;
                 if(k > len)  return LV_DRAW_MASK_RES_TRANSP;
@@ -945,9 +1015,17 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_angle(lv_opa_t * ma
         lv_draw_mask_res_t res1 = LV_DRAW_MASK_RES_FULL_COVER;
         lv_draw_mask_res_t res2 = LV_DRAW_MASK_RES_FULL_COVER;
 
+        /*The line masks work on the two parts of the line*/
+        lv_draw_mask_runs_t * rec = run_rec;
+        lv_draw_mask_runs_t runs1;
+        lv_draw_mask_runs_t runs2;
+        runs1.cnt = 0;
+        runs2.cnt = 0;
+
         int32_t tmp = start_angle_last + dist - rel_x;
         if(tmp > len) tmp = len;
         if(tmp > 0) {
+            if(rec) run_rec = &runs1;
             res1 = lv_draw_mask_line(&mask_buf[0], abs_x, abs_y, tmp, &p->start_line);
             if(res1 == LV_DRAW_MASK_RES_TRANSP) {
                 lv_memset_00(&mask_buf[0], tmp);
@@ -956,10 +1034,19 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_angle(lv_opa_t * ma
 
         if(tmp > len) tmp = len;
         if(tmp < 0) tmp = 0;
+        if(rec) run_rec = &runs2;
         res2 = lv_draw_mask_line(&mask_buf[tmp], abs_x + tmp, abs_y, len - tmp, &p->end_line);
         if(res2 == LV_DRAW_MASK_RES_TRANSP) {
             lv_memset_00(&mask_buf[tmp], len - tmp);
         }
+
+        run_rec = rec;
+        if(rec) {
+            rec->cnt = 0;
+            runs_append(rec, &runs1, res1, tmp);
+            runs_append(rec, &runs2, res2, len - tmp);
+        }
+
         if(res1 == res2) return res1;
         else return LV_DRAW_MASK_RES_CHANGED;
     }
@@ -987,9 +1074,17 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_angle(lv_opa_t * ma
         lv_draw_mask_res_t res1 = LV_DRAW_MASK_RES_FULL_COVER;
         lv_draw_mask_res_t res2 = LV_DRAW_MASK_RES_FULL_COVER;
 
+        /*The line masks work on the two parts of the line*/
+        lv_draw_mask_runs_t * rec = run_rec;
+        lv_draw_mask_runs_t runs1;
+        lv_draw_mask_runs_t runs2;
+        runs1.cnt = 0;
+        runs2.cnt = 0;
+
         int32_t tmp = start_angle_last + dist - rel_x;
         if(tmp > len) tmp = len;
         if(tmp > 0) {
+            if(rec) run_rec = &runs1;
             res1 = lv_draw_mask_line(&mask_buf[0], abs_x, abs_y, tmp, (lv_draw_mask_line_param_t *)&p->end_line);
             if(res1 == LV_DRAW_MASK_RES_TRANSP) {
                 lv_memset_00(&mask_buf[0], tmp);
@@ -998,10 +1093,19 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_angle(lv_opa_t * ma
 
         if(tmp > len) tmp = len;
         if(tmp < 0) tmp = 0;
+        if(rec) run_rec = &runs2;
         res2 = lv_draw_mask_line(&mask_buf[tmp], abs_x + tmp, abs_y, len - tmp, (lv_draw_mask_line_param_t *)&p->start_line);
         if(res2 == LV_DRAW_MASK_RES_TRANSP) {
             lv_memset_00(&mask_buf[tmp], len - tmp);
         }
+
+        run_rec = rec;
+        if(rec) {
+            rec->cnt = 0;
+            runs_append(rec, &runs1, res1, tmp);
+            runs_append(rec, &runs2, res2, len - tmp);
+        }
+
         if(res1 == res2) return res1;
         else return LV_DRAW_MASK_RES_CHANGED;
     }
@@ -1010,6 +1114,13 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_angle(lv_opa_t * ma
         lv_draw_mask_res_t res1 = LV_DRAW_MASK_RES_FULL_COVER;
         lv_draw_mask_res_t res2 = LV_DRAW_MASK_RES_FULL_COVER;
 
+        /*Both line masks work on the whole line*/
+        lv_draw_mask_runs_t * rec = run_rec;
+        lv_draw_mask_runs_t runs1;
+        lv_draw_mask_runs_t runs2;
+        runs1.cnt = 0;
+        runs2.cnt = 0;
+
         if(p->cfg.start_angle == 180) {
             if(abs_y < p->cfg.vertex_p.y) res1 = LV_DRAW_MASK_RES_FULL_COVER;
             else res1 = LV_DRAW_MASK_RES_UNKNOWN;
@@ -1023,6 +1134,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_angle(lv_opa_t * ma
             res1 = LV_DRAW_MASK_RES_UNKNOWN;
         }
         else  {
+            if(rec) run_rec = &runs1;
             res1 = lv_draw_mask_line(mask_buf, abs_x, abs_y, len, &p->start_line);
         }
 
@@ -1039,9 +1151,20 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_angle(lv_opa_t * ma
             res2 = LV_DRAW_MASK_RES_UNKNOWN;
         }
         else {
+            if(rec) run_rec = &runs2;
             res2 = lv_draw_mask_line(mask_buf, abs_x, abs_y, len, &p->end_line);
         }
 
+        run_rec = rec;
+        if(rec) {
+            rec->cnt = 0;
+            runs_append(rec, &runs1, res1, len);
+            lv_draw_mask_runs_t line2;
+            line2.cnt = 0;
+            runs_append(&line2, &runs2, res2, len);
+            runs_intersect(rec, &line2);
+        }
+
         if(res1 == LV_DRAW_MASK_RES_TRANSP || res2 == LV_DRAW_MASK_RES_TRANSP) return LV_DRAW_MASK_RES_TRANSP;
         else if(res1 == LV_DRAW_MASK_RES_UNKNOWN && res2 == LV_DRAW_MASK_RES_UNKNOWN) return LV_DRAW_MASK_RES_TRANSP;
         else if(res1 == LV_DRAW_MASK_RES_FULL_COVER &&  res2 == LV_DRAW_MASK_RES_FULL_COVER) return LV_DRAW_MASK_RES_FULL_COVER;
@@ -1086,6 +1209,8 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_radius(lv_opa_t * m
             else if(first < len) {
                 lv_memset_00(&mask_buf[first], len - first);
             }
+            if(run_rec) runs_set_edges(run_rec, len, LV_DRAW_MASK_RES_TRANSP, LV_DRAW_MASK_RES_FULL_COVER,
+                                           last, last, first, first);
             if(last == 0 && first == len) return LV_DRAW_MASK_RES_FULL_COVER;
             else return LV_DRAW_MASK_RES_CHANGED;
         }
@@ -1099,6 +1224,8 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_radius(lv_opa_t * m
                     lv_memset_00(&mask_buf[first], last);
                 }
             }
+            if(run_rec) runs_set_edges(run_rec, len, LV_DRAW_MASK_RES_FULL_COVER, LV_DRAW_MASK_RES_TRANSP,
+                                           first, first, rect.x2 - abs_x + 1, rect.x2 - abs_x + 1);
         }
         return LV_DRAW_MASK_RES_CHANGED;
     }
@@ -1130,6 +1257,18 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_radius(lv_opa_t * m
     lv_coord_t cir_x_left = k + radius - x_start - 1;
     lv_coord_t i;
 
+    /*Anti-aliased on the circles, the inside is kept and the outside is cleared (or the opposite)*/
+    if(run_rec) {
+        if(outer == false) {
+            runs_set_edges(run_rec, len, LV_DRAW_MASK_RES_TRANSP, LV_DRAW_MASK_RES_FULL_COVER,
+                           cir_x_left - aa_len + 1, cir_x_left + 1, cir_x_right, cir_x_right + aa_len);
+        }
+        else {
+            runs_set_edges(run_rec, len, LV_DRAW_MASK_RES_FULL_COVER, LV_DRAW_MASK_RES_TRANSP,
+                           cir_x_left - aa_len + 1, cir_x_left + 1, cir_x_right, cir_x_right + aa_len);
+        }
+    }
+
     if(outer == false) {
         for(i = 0; i < aa_len; i++) {
             lv_opa_t opa = aa_opa[aa_len - i - 1];
@@ -1527,5 +1666,113 @@ static inline lv_opa_t LV_ATTRIBUTE_FAST_MEM mask_mix(lv_opa_t mask_act, lv_opa_
     return LV_UDIV255(mask_act * mask_new);// >> 8);
 }
 
+/*Add `len` pixels to the end of the spans*/
+static void runs_add(lv_draw_mask_runs_t * runs, lv_coord_t len, lv_draw_mask_res_t res)
+{
+    if(len <= 0) return;
+
+    if(runs->cnt) {
+        uint8_t last = runs->cnt - 1;
+        if(runs->run[last].res == res) {
+            runs->run[last].len += len;
+            return;
+        }
+        /*No more room: join to the last span and read the values there. They are right in any case.*/
+        if(runs->cnt == LV_DRAW_MASK_RUN_MAX) {
+            runs->run[last].res = LV_DRAW_MASK_RES_CHANGED;
+            runs->run[last].len += len;
+            return;
+        }
+    }
+
+    runs->run[runs->cnt].len = len;
+    runs->run[runs->cnt].res = res;
+    runs->cnt++;
+}
+
+/*Add the spans of a part of the line. Masks which haven't stored spans are described by their result.*/
+static void runs_append(lv_draw_mask_runs_t * runs, const lv_draw_mask_runs_t * part, lv_draw_mask_res_t part_res,
+                        lv_coord_t len)
+{
+    if(len <= 0) return;
+
+    if(part->cnt == 0 || part_res == LV_DRAW_MASK_RES_TRANSP) {
+        /*`LV_DRAW_MASK_RES_UNKNOWN` is returned by the angle mask for not applied line masks*/
+        if(part_res == LV_DRAW_MASK_RES_UNKNOWN) part_res = LV_DRAW_MASK_RES_FULL_COVER;
+        runs_add(runs, len, part_res);
+        return;
+    }
+
+    uint8_t i;
+    for(i = 0; i < part->cnt; i++) {
+        runs_add(runs, part->run[i].len, part->run[i].res);
+    }
+}
+
+/*The spans of two masks applied on the same line*/
+static void runs_intersect(lv_draw_mask_runs_t * runs, const lv_draw_mask_runs_t * other)
+{
+    if(runs->cnt == 1 && runs->run[0].res == LV_DRAW_MASK_RES_FULL_COVER) {
+        *runs = *other;
+        return;
+    }
+
+    lv_draw_mask_runs_t a = *runs;
+    runs->cnt = 0;
+
+    uint8_t i = 0;
+    uint8_t j = 0;
+    lv_coord_t a_len = a.run[0].len;
+    lv_coord_t b_len = other->run[0].len;
+    while(i < a.cnt && j < other->cnt) {
+        lv_coord_t len = LV_MIN(a_len, b_len);
+        lv_draw_mask_res_t res_a = a.run[i].res;
+        lv_draw_mask_res_t res_b = other->run[j].res;
+        lv_draw_mask_res_t res;
+        if(res_a == LV_DRAW_MASK_RES_TRANSP || res_b == LV_DRAW_MASK_RES_TRANSP) res = LV_DRAW_MASK_RES_TRANSP;
+        else if(res_a == LV_DRAW_MASK_RES_FULL_COVER &&
+                res_b == LV_DRAW_MASK_RES_FULL_COVER) res = LV_DRAW_MASK_RES_FULL_COVER;
+        else res = LV_DRAW_MASK_RES_CHANGED;
+        runs_add(runs, len, res);
+
+        a_len -= len;
+        b_len -= len;
+        if(a_len == 0 && ++i < a.cnt) a_len = a.run[i].len;
+        if(b_len == 0 && ++j < other->cnt) b_len = other->run[j].len;
+    }
+}
+
+/**
+ * Set the spans of a line: `res_out` outside of the two anti-aliased edges and `res_in` between them.
+ * The coordinates are relative to the start of the line and clipped to it. Overlapping edges are joined.
+ */
+static void runs_set_edges(lv_draw_mask_runs_t * runs, lv_coord_t len, lv_draw_mask_res_t res_out,
+                           lv_draw_mask_res_t res_in, int32_t edge1_start, int32_t edge1_end,
+                           int32_t edge2_start, int32_t edge2_end)
+{
+    int32_t ends[5] = {edge1_start, edge1_end, edge2_start, edge2_end, len};
+    lv_draw_mask_res_t res[5] = {res_out, LV_DRAW_MASK_RES_CHANGED, res_in, LV_DRAW_MASK_RES_CHANGED, res_out};
+
+    runs->cnt = 0;
+    int32_t x = 0;
+    uint32_t i;
+    for(i = 0; i < 5; i++) {
+        int32_t end = LV_CLAMP(x, ends[i], len);
+        runs_add(runs, end - x, res[i]);
+        x = end;
+    }
+}
+
+/**
+ * Set the spans of a line mask: the values before `aa_start` are kept (or cleared if `inv`),
+ * the ones from `aa_end` are cleared (or kept if `inv`).
+ */
+static void line_runs(lv_draw_mask_runs_t * runs, lv_coord_t len, bool inv, int32_t aa_start, int32_t aa_end)
+{
+    lv_draw_mask_res_t res_left = inv ? LV_DRAW_MASK_RES_TRANSP : LV_DRAW_MASK_RES_FULL_COVER;
+    lv_draw_mask_res_t res_right = inv ? LV_DRAW_MASK_RES_FULL_COVER : LV_DRAW_MASK_RES_TRANSP;
+    runs_set_edges(runs, len, res_left, res_right, aa_start, aa_end, len, len);
+}
+
 
 #endif /*LV_DRAW_COMPLEX*/
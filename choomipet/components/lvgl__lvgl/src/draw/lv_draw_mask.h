@@ -29,6 +29,9 @@ extern "C" {
 # define _LV_MASK_MAX_NUM     1
 #endif
 
+/*Spans of a line in `lv_draw_mask_runs_t`. More are merged to `LV_DRAW_MASK_RES_CHANGED`*/
+#define LV_DRAW_MASK_RUN_MAX    16
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -42,6 +45,20 @@ enum {
 
 typedef uint8_t lv_draw_mask_res_t;
 
+/**
+ * A line of a mask buffer as spans of pixels. `res` of a span tells how to use the buffer there:
+ * - `LV_DRAW_MASK_RES_TRANSP`: the values are 0
+ * - `LV_DRAW_MASK_RES_FULL_COVER`: no mask has changed the values since the buffer was initialized
+ * - `LV_DRAW_MASK_RES_CHANGED`: the values need to be read (anti-aliased edges)
+ */
+typedef struct {
+    struct {
+        lv_coord_t len;
+        lv_draw_mask_res_t res;
+    } run[LV_DRAW_MASK_RUN_MAX];
+    uint8_t cnt;
+} lv_draw_mask_runs_t;
+
 typedef struct {
     void * param;
     void * custom_id;
@@ -261,6 +278,22 @@ lv_draw_mask_res_t /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_mask_apply_ids(lv_opa_t *
                                                                       lv_coord_t abs_y, lv_coord_t len,
                                                                       const int16_t * ids, int16_t ids_count);
 
+/**
+ * Apply the added masks on a line like `lv_draw_mask_apply()` and also tell which parts of the line
+ * are transparent, unchanged or anti-aliased. Radius, angle and line masks describe their spans
+ * exactly, the other masks mark the changed lines as anti-aliased.
+ * @param mask_buf store the result mask here. Has to be `len` byte long.
+ *                 Should be initialized with the same value on the whole line.
+ * @param abs_x absolute X coordinate where the line to calculate start
+ * @param abs_y absolute Y coordinate where the line to calculate start
+ * @param len length of the line to calculate (in pixel count)
+ * @param runs store the spans of the line here. Not set if `LV_DRAW_MASK_RES_TRANSP` is returned.
+ * @return the same as `lv_draw_mask_apply()`
+ */
+lv_draw_mask_res_t /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_mask_apply_runs(lv_opa_t * mask_buf, lv_coord_t abs_x,
+                                                                       lv_coord_t abs_y, lv_coord_t len,
+                                                                       lv_draw_mask_runs_t * runs);
+
 //! @endcond
 
 /**
@@ -63,6 +63,11 @@ void lv_draw_rect(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, cons
 {
     if(lv_area_get_height(coords) < 1 || lv_area_get_width(coords) < 1) return;
 
+    if(_lv_draw_list_is_recording()) {
+        _lv_draw_list_add_rect(dsc, coords);
+        return;
+    }
+
     draw_ctx->draw_rect(draw_ctx, dsc, coords);
 
     LV_ASSERT_MEM_INTEGRITY();
@@ -39,6 +39,10 @@ void lv_draw_transform(lv_draw_ctx_t * draw_ctx, const lv_area_t * dest_area, co
                        lv_coord_t src_stride, const lv_draw_img_dsc_t * draw_dsc, lv_img_cf_t cf, lv_color_t * cbuf, lv_opa_t * abuf)
 {
     LV_ASSERT_NULL(draw_ctx);
+    if(_lv_draw_list_is_recording()) {
+        _lv_draw_list_cancel();
+        return;
+    }
     if(draw_ctx->draw_transform == NULL) {
         LV_LOG_WARN("draw_ctx->draw_transform == NULL");
         return;
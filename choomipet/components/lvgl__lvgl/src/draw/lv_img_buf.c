@@ -25,6 +25,7 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static const uint8_t * rle_get_px(const lv_img_dsc_t * dsc, lv_coord_t x, lv_coord_t y);
 
 /**********************
  *  STATIC VARIABLES
@@ -50,6 +51,12 @@ lv_color_t lv_img_buf_get_px_color(const lv_img_dsc_t * dsc, lv_coord_t x, lv_co
         lv_memcpy_small(&p_color, &buf_u8[px], sizeof(lv_color_t));
 #if LV_COLOR_SIZE == 32
         p_color.ch.alpha = 0xFF; /*Only the color should be get so use a default alpha value*/
+#endif
+    }
+    else if(dsc->header.cf == LV_IMG_CF_RLE_TRUE_COLOR || dsc->header.cf == LV_IMG_CF_RLE_TRUE_COLOR_ALPHA) {
+        lv_memcpy_small(&p_color, rle_get_px(dsc, x, y), sizeof(lv_color_t));
+#if LV_COLOR_SIZE == 32
+        p_color.ch.alpha = 0xFF; /*Only the color should be get so use a default alpha value*/
 #endif
     }
     else if(dsc->header.cf == LV_IMG_CF_INDEXED_1BIT) {
@@ -105,6 +112,9 @@ lv_opa_t lv_img_buf_get_px_alpha(const lv_img_dsc_t * dsc, lv_coord_t x, lv_coor
         uint32_t px = dsc->header.w * y * LV_IMG_PX_SIZE_ALPHA_BYTE + x * LV_IMG_PX_SIZE_ALPHA_BYTE;
         return buf_u8[px + LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
     }
+    else if(dsc->header.cf == LV_IMG_CF_RLE_TRUE_COLOR_ALPHA) {
+        return rle_get_px(dsc, x, y)[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+    }
     else if(dsc->header.cf == LV_IMG_CF_ALPHA_1BIT) {
         uint8_t bit = x & 0x7;
         x           = x >> 3;
@@ -390,3 +400,33 @@ void _lv_img_buf_get_transformed_area(lv_area_t * res, lv_coord_t w, lv_coord_t
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+/**
+ * Find a pixel of a run-length encoded image: jump to its row with the row index,
+ * then step over the packets on its left.
+ * The packets are cut at the end of the data (`data_size`) like in the decoder, a pixel not found there is zeros.
+ */
+static const uint8_t * rle_get_px(const lv_img_dsc_t * dsc, lv_coord_t x, lv_coord_t y)
+{
+    static const uint8_t zero_px[LV_IMG_PX_SIZE_ALPHA_BYTE];
+    uint8_t px_size = dsc->header.cf == LV_IMG_CF_RLE_TRUE_COLOR_ALPHA ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    if((uint32_t)(y + 1) * sizeof(uint32_t) > dsc->data_size) return zero_px;
+
+    const uint8_t * end = dsc->data + dsc->data_size;
+    const uint8_t * ofs = dsc->data + y * sizeof(uint32_t);
+    uint32_t row_ofs = ofs[0] | ofs[1] << 8 | ofs[2] << 16 | (uint32_t)ofs[3] << 24;
+    if(row_ofs >= dsc->data_size) return zero_px;
+    const uint8_t * p = dsc->data + row_ofs;
+
+    while(end - p >= 1 + px_size) {
+        uint8_t ctrl = *p++;
+        lv_coord_t n = (ctrl & 0x7F) + 1;
+        bool run = ctrl & 0x80;
+        /*Keep only the different pixels which are in the data*/
+        if(!run) n = LV_MIN(n, (lv_coord_t)((end - p) / px_size));
+        if(x < n) return run ? p : p + x * px_size;
+        x -= n;
+        p += run ? px_size : n * px_size;
+    }
+    return zero_px;
+}
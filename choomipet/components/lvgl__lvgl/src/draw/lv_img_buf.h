@@ -83,8 +83,8 @@ enum {
     LV_IMG_CF_RGBA5658,
     LV_IMG_CF_RGB565A8,
 
-    LV_IMG_CF_RESERVED_15,              /**< Reserved for further use.*/
-    LV_IMG_CF_RESERVED_16,              /**< Reserved for further use.*/
+    LV_IMG_CF_RLE_TRUE_COLOR,           /**< `LV_IMG_CF_TRUE_COLOR` run-length encoded by rows (see below)*/
+    LV_IMG_CF_RLE_TRUE_COLOR_ALPHA,     /**< `LV_IMG_CF_TRUE_COLOR_ALPHA` run-length encoded by rows (see below)*/
     LV_IMG_CF_RESERVED_17,              /**< Reserved for further use.*/
     LV_IMG_CF_RESERVED_18,              /**< Reserved for further use.*/
     LV_IMG_CF_RESERVED_19,              /**< Reserved for further use.*/
@@ -104,6 +104,14 @@ enum {
 };
 typedef uint8_t lv_img_cf_t;
 
+/* The data of the run-length encoded formats (`LV_IMG_CF_RLE_...`):
+ * - `h` little-endian uint32_t offsets of the rows from the start of the data, so any row can be decoded directly
+ * - the rows: packets up to `w` pixels. A control byte `c` and
+ *   - `c < 0x80`: `c + 1` different pixels follow
+ *   - `c >= 0x80`: one pixel follows, repeated `(c & 0x7F) + 1` times
+ * The pixels are stored as in the plain format (`lv_color_t` and with `_ALPHA` an alpha byte).
+ * Only `lv_img_dsc_t` variables can be encoded so, they are decoded to the plain format.*/
+
 
 /**
  * The first 8 bit is very important to distinguish the different source types.
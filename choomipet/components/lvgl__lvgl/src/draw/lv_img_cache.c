@@ -12,28 +12,48 @@
 #include "lv_draw_img.h"
 #include "../hal/lv_hal_tick.h"
 #include "../misc/lv_gc.h"
+#include "../misc/lv_lru.h"
+#include "../misc/lv_fs.h"
+#include "../core/lv_refr.h"
 
 /*********************
  *      DEFINES
  *********************/
-/*Decrement life with this value on every open*/
-#define LV_IMG_CACHE_AGING 1
-
-/*Boost life by this factor (multiply time_to_open with this value)*/
+/*Keep the images as if they were used `time_to_open` times more at every use
+ *(multiply time_to_open with this value)*/
 #define LV_IMG_CACHE_LIFE_GAIN 1
 
-/*Don't let life to be greater than this limit because it would require a lot of time to
- * "die" from very high values*/
+/*Don't let the weight to be greater than this limit because such an image would
+ *stay in the cache long after it's not used anymore*/
 #define LV_IMG_CACHE_LIFE_LIMIT 1000
 
+/*The list node and the LRU item of an entry (about)*/
+#define ENTRY_OVERHEAD 64
+
+/*Longest key: the header and a file path*/
+#define KEY_MAX_SIZE (sizeof(cache_key_t) + LV_FS_MAX_PATH_LENGTH)
+
 /**********************
  *      TYPEDEFS
  **********************/
 
+/*The images are found by their source, color and frame*/
+typedef struct {
+    const void * src;   /*The variable or NULL with files*/
+    int32_t frame_id;
+    lv_color_t color;
+    /*The path of files follows*/
+} cache_key_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 #if LV_IMG_CACHE_DEF_SIZE
+    static uint32_t make_key(uint8_t * buf, const void * src, lv_color_t color, int32_t frame_id);
+    static uint32_t get_entry_size(const _lv_img_cache_entry_t * entry);
+    static void cache_create(void);
+    static void entry_evicted_cb(void * v);
+    static void entry_free(_lv_img_cache_entry_t * entry);
     static bool lv_img_cache_match(const void * src1, const void * src2);
 #endif
 
@@ -42,6 +62,12 @@
  **********************/
 #if LV_IMG_CACHE_DEF_SIZE
     static uint16_t entry_cnt;
+    static uint32_t mem_size = LV_IMG_CACHE_DEF_MEM_SIZE;
+    static uint32_t cached_cnt;
+    static uint32_t hit_cnt;
+    static uint32_t miss_cnt;
+    static uint32_t evict_cnt;
+    static bool invalidating;
 #endif
 
 /**********************
@@ -55,66 +81,46 @@
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The least recently used images are closed when the cache is out of memory, the images slow to open are kept longer.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param color color The color of the image with `LV_IMG_CF_ALPHA_...`
  * @return pointer to the cache entry or NULL if can open the image
  */
 _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, int32_t frame_id)
 {
-    /*Is the image cached?*/
     _lv_img_cache_entry_t * cached_src = NULL;
 
 #if LV_IMG_CACHE_DEF_SIZE
-    if(entry_cnt == 0) {
+    lv_lru_t * lru = LV_GC_ROOT(_lv_img_cache_lru);
+    if(lru == NULL) {
         LV_LOG_WARN("lv_img_cache_open: the cache size is 0");
         return NULL;
     }
 
-    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    uint8_t key[KEY_MAX_SIZE];
+    uint32_t key_size = make_key(key, src, color, frame_id);
 
-    /*Decrement all lifes. Make the entries older*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].life > INT32_MIN + LV_IMG_CACHE_AGING) {
-            cache[i].life -= LV_IMG_CACHE_AGING;
-        }
+    /*Is the image cached?
+     *The threads rendering in parallel share the cache but not the entries read line by line
+     *(the decoder keeps the read position in them)*/
+    _lv_refr_lock();
+    if(key_size) lv_lru_get(lru, key, key_size, (void **)&cached_src);
+    if(cached_src && (cached_src->ref_cnt == 0 || cached_src->dec_dsc.img_data)) {
+        cached_src->ref_cnt++;
+        hit_cnt++;
+        _lv_refr_unlock();
+        LV_LOG_TRACE("image source found in the cache");
+        return cached_src;
     }
 
-    for(i = 0; i < entry_cnt; i++) {
-        if(color.full == cache[i].dec_dsc.color.full &&
-           frame_id == cache[i].dec_dsc.frame_id &&
-           lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            /*If opened increment its life.
-             *Image difficult to open should live longer to keep avoid frequent their recaching.
-             *Therefore increase `life` with `time_to_open`*/
-            cached_src = &cache[i];
-            cached_src->life += cached_src->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN;
-            if(cached_src->life > LV_IMG_CACHE_LIFE_LIMIT) cached_src->life = LV_IMG_CACHE_LIFE_LIMIT;
-            LV_LOG_TRACE("image source found in the cache");
-            break;
-        }
-    }
-
-    /*The image is not cached then cache it now*/
-    if(cached_src) return cached_src;
-
-    /*Find an entry to reuse. Select the entry with the least life*/
-    cached_src = &cache[0];
-    for(i = 1; i < entry_cnt; i++) {
-        if(cache[i].life < cached_src->life) {
-            cached_src = &cache[i];
-        }
-    }
-
-    /*Close the decoder to reuse if it was opened (has a valid source)*/
-    if(cached_src->dec_dsc.src) {
-        lv_img_decoder_close(&cached_src->dec_dsc);
-        LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
-    }
-    else {
-        LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
-    }
+    /*The image is not cached (or it's busy) then open it now*/
+    bool busy = cached_src != NULL;
+    miss_cnt++;
+    cached_src = _lv_ll_ins_head(&LV_GC_ROOT(_lv_img_cache_ll));
+    _lv_refr_unlock();
+    LV_ASSERT_MALLOC(cached_src);
+    if(cached_src == NULL) return NULL;
+    lv_memset_00(cached_src, sizeof(_lv_img_cache_entry_t));
 #else
     cached_src = &LV_GC_ROOT(_lv_img_cache_single);
 #endif
@@ -123,13 +129,17 @@ _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, i
     lv_res_t open_res = lv_img_decoder_open(&cached_src->dec_dsc, src, color, frame_id);
     if(open_res == LV_RES_INV) {
         LV_LOG_WARN("Image draw cannot open the image resource");
+#if LV_IMG_CACHE_DEF_SIZE
+        _lv_refr_lock();
+        _lv_ll_remove(&LV_GC_ROOT(_lv_img_cache_ll), cached_src);
+        _lv_refr_unlock();
+        lv_mem_free(cached_src);
+#else
         lv_memset_00(cached_src, sizeof(_lv_img_cache_entry_t));
-        cached_src->life = INT32_MIN; /*Make the empty entry very "weak" to force its us*/
+#endif
         return NULL;
     }
 
-    cached_src->life = 0;
-
     /*If `time_to_open` was not set in the open function set it here*/
     if(cached_src->dec_dsc.time_to_open == 0) {
         cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
@@ -137,14 +147,59 @@ _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, i
 
     if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
 
+#if LV_IMG_CACHE_DEF_SIZE
+    cached_src->size = get_entry_size(cached_src);
+    cached_src->ref_cnt = 1;
+
+    /*Not cached but closed when released (e.g. too long path or used by an other thread)*/
+    if(key_size == 0 || busy) return cached_src;
+
+    /*Images difficult to open should live longer to avoid their frequent recaching.
+     *Therefore weight them with `time_to_open`*/
+    uint32_t weight = LV_MIN(cached_src->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN, LV_IMG_CACHE_LIFE_LIMIT);
+
+    _lv_refr_lock();
+    cached_src->cached = 1;
+    cached_cnt++;
+    if(lv_lru_set(lru, key, key_size, cached_src, cached_src->size) == LV_LRU_OK) {
+        lv_lru_set_weight(lru, key, key_size, weight);
+        LV_LOG_INFO("image draw: cache miss, cached");
+    }
+    else {
+        /*Larger than the whole cache*/
+        cached_src->cached = 0;
+        cached_cnt--;
+        LV_LOG_INFO("image draw: cache miss, the image doesn't fit into the cache");
+    }
+    _lv_refr_unlock();
+#endif
+
     return cached_src;
 }
 
 /**
- * Set the number of images to be cached.
- * More cached images mean more opened image at same time which might mean more memory usage.
- * E.g. if 20 PNG or JPG images are open in the RAM they consume memory while opened in the cache.
- * @param new_entry_cnt number of image to cache
+ * Release an entry opened by `_lv_img_cache_open()`.
+ * Images not (or no longer) in the cache are closed here.
+ * @param entry pointer to the cache entry
+ */
+void _lv_img_cache_release(_lv_img_cache_entry_t * entry)
+{
+#if LV_IMG_CACHE_DEF_SIZE == 0
+    /*Automatically close images with no caching*/
+    lv_img_decoder_close(&entry->dec_dsc);
+#else
+    _lv_refr_lock();
+    LV_ASSERT(entry->ref_cnt > 0);
+    entry->ref_cnt--;
+    if(entry->ref_cnt == 0 && !entry->cached) entry_free(entry);
+    _lv_refr_unlock();
+#endif
+}
+
+/**
+ * Set the number of images expected in the cache. It sizes the hash table of the cache.
+ * How many images are really kept depends on the memory size of the cache (see `lv_img_cache_set_mem_size()`).
+ * @param new_entry_cnt number of images to cache. 0: disable the cache
  */
 void lv_img_cache_set_size(uint16_t new_entry_cnt)
 {
@@ -152,47 +207,93 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
     LV_UNUSED(new_entry_cnt);
     LV_LOG_WARN("Can't change cache size because it's disabled by LV_IMG_CACHE_DEF_SIZE = 0");
 #else
-    if(LV_GC_ROOT(_lv_img_cache_array) != NULL) {
-        /*Clean the cache before free it*/
-        lv_img_cache_invalidate_src(NULL);
-        lv_mem_free(LV_GC_ROOT(_lv_img_cache_array));
-    }
-
-    /*Reallocate the cache*/
-    LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(_lv_img_cache_entry_t) * new_entry_cnt);
-    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_img_cache_array));
-    if(LV_GC_ROOT(_lv_img_cache_array) == NULL) {
-        entry_cnt = 0;
-        return;
-    }
     entry_cnt = new_entry_cnt;
+    cache_create();
+#endif
+}
 
-    /*Clean the cache*/
-    lv_memset_00(LV_GC_ROOT(_lv_img_cache_array), entry_cnt * sizeof(_lv_img_cache_entry_t));
+/**
+ * Set how much RAM the opened images can keep in the cache.
+ * The images decoded to RAM (e.g. PNG or compressed images) count with their decoded size,
+ * the images used in place (e.g. `lv_img_dsc_t` variables of the built-in formats) count only with the entry.
+ * @param new_size the memory size of the cache in bytes
+ */
+void lv_img_cache_set_mem_size(uint32_t new_size)
+{
+#if LV_IMG_CACHE_DEF_SIZE == 0
+    LV_UNUSED(new_size);
+    LV_LOG_WARN("Can't change cache size because it's disabled by LV_IMG_CACHE_DEF_SIZE = 0");
+#else
+    mem_size = new_size;
+    cache_create();
 #endif
 }
 
 /**
  * Invalidate an image source in the cache.
  * Useful if the image source is updated therefore it needs to be cached again.
- * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable.
+ * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable. NULL to invalidate all images
  */
 void lv_img_cache_invalidate_src(const void * src)
 {
     LV_UNUSED(src);
 #if LV_IMG_CACHE_DEF_SIZE
-    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    lv_lru_t * lru = LV_GC_ROOT(_lv_img_cache_lru);
+    if(lru == NULL) return;
 
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(src == NULL || lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            if(cache[i].dec_dsc.src != NULL) {
-                lv_img_decoder_close(&cache[i].dec_dsc);
-            }
-
-            lv_memset_00(&cache[i], sizeof(_lv_img_cache_entry_t));
+    _lv_refr_lock();
+    invalidating = true;
+    lv_ll_t * ll = &LV_GC_ROOT(_lv_img_cache_ll);
+    _lv_img_cache_entry_t * entry = _lv_ll_get_head(ll);
+    while(entry) {
+        /*The entry might be freed*/
+        _lv_img_cache_entry_t * next = _lv_ll_get_next(ll, entry);
+        if(entry->cached && (src == NULL || lv_img_cache_match(src, entry->dec_dsc.src))) {
+            uint8_t key[KEY_MAX_SIZE];
+            uint32_t key_size = make_key(key, entry->dec_dsc.src, entry->dec_dsc.color, entry->dec_dsc.frame_id);
+            lv_lru_remove(lru, key, key_size);
         }
+        entry = next;
     }
+    invalidating = false;
+    _lv_refr_unlock();
+#endif
+}
+
+/**
+ * Get the statistics of the image cache
+ * @param mon_p pointer to a `lv_img_cache_monitor_t` variable, the result will be stored here
+ */
+void lv_img_cache_monitor(lv_img_cache_monitor_t * mon_p)
+{
+    lv_memset_00(mon_p, sizeof(lv_img_cache_monitor_t));
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_lru_t * lru = LV_GC_ROOT(_lv_img_cache_lru);
+    _lv_refr_lock();
+    mon_p->hit_cnt = hit_cnt;
+    mon_p->miss_cnt = miss_cnt;
+    mon_p->evict_cnt = evict_cnt;
+    mon_p->entry_cnt = cached_cnt;
+    if(lru) {
+        mon_p->used_size = lru->total_memory - lru->free_memory;
+        mon_p->total_size = lru->total_memory;
+    }
+    _lv_refr_unlock();
+#endif
+}
+
+bool _lv_img_cache_evict_lru(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_lru_t * lru = LV_GC_ROOT(_lv_img_cache_lru);
+    if(lru == NULL || cached_cnt == 0) return false;
+
+    _lv_refr_lock();
+    lv_lru_remove_lru_item(lru);
+    _lv_refr_unlock();
+    return true;
+#else
+    return false;
 #endif
 }
 
@@ -201,6 +302,100 @@ void lv_img_cache_invalidate_src(const void * src)
  **********************/
 
 #if LV_IMG_CACHE_DEF_SIZE
+/**
+ * Write the key of an image to a buffer
+ * @return the size of the key or 0 if the image can't be cached
+ */
+static uint32_t make_key(uint8_t * buf, const void * src, lv_color_t color, int32_t frame_id)
+{
+    cache_key_t * key = (cache_key_t *)buf;
+    /*The padding is compared too*/
+    lv_memset_00(key, sizeof(cache_key_t));
+    key->frame_id = frame_id;
+    key->color = color;
+
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    if(src_type == LV_IMG_SRC_VARIABLE) {
+        key->src = src;
+        return sizeof(cache_key_t);
+    }
+    if(src_type != LV_IMG_SRC_FILE) return 0;
+
+    size_t len = strlen(src);
+    if(len > LV_FS_MAX_PATH_LENGTH) return 0;
+    lv_memcpy(buf + sizeof(cache_key_t), src, len);
+    return sizeof(cache_key_t) + len;
+}
+
+/**
+ * The RAM kept by an opened image. Decoders allocating buffers only to read the lines aren't counted.
+ */
+static uint32_t get_entry_size(const _lv_img_cache_entry_t * entry)
+{
+    const lv_img_decoder_dsc_t * dsc = &entry->dec_dsc;
+    /*The entry, its key and the bookkeeping of the list and the LRU cache*/
+    uint32_t size = sizeof(_lv_img_cache_entry_t) + sizeof(cache_key_t) + ENTRY_OVERHEAD;
+    if(dsc->src_type == LV_IMG_SRC_FILE) size += strlen(dsc->src);
+    if(dsc->img_data == NULL) return size;
+
+    /*The built-in decoder gives the pixels of the variables in place*/
+    if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
+        const lv_img_dsc_t * img = dsc->src;
+        if(dsc->img_data >= img->data && dsc->img_data < img->data + img->data_size) return size;
+    }
+
+    return size + lv_img_buf_get_img_size(dsc->header.w, dsc->header.h, dsc->header.cf);
+}
+
+/**
+ * (Re)create the cache with `entry_cnt` and `mem_size`. The images in it are closed.
+ */
+static void cache_create(void)
+{
+    if(LV_GC_ROOT(_lv_img_cache_lru) != NULL) {
+        /*Clean the cache before free it*/
+        lv_img_cache_invalidate_src(NULL);
+        lv_lru_del(LV_GC_ROOT(_lv_img_cache_lru));
+        LV_GC_ROOT(_lv_img_cache_lru) = NULL;
+    }
+    cached_cnt = 0;
+
+    /*The entries in use stay in the list until they are released*/
+    if(_lv_ll_get_head(&LV_GC_ROOT(_lv_img_cache_ll)) == NULL) {
+        _lv_ll_init(&LV_GC_ROOT(_lv_img_cache_ll), sizeof(_lv_img_cache_entry_t));
+    }
+
+    if(entry_cnt == 0 || mem_size == 0) return;
+
+    /*Size the hash table to the number of entries*/
+    LV_GC_ROOT(_lv_img_cache_lru) = lv_lru_create(mem_size, LV_MAX(mem_size / entry_cnt, 1), entry_evicted_cb, NULL);
+    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_img_cache_lru));
+}
+
+/**
+ * Called by the LRU cache when an image is removed from it
+ */
+static void entry_evicted_cb(void * v)
+{
+    _lv_img_cache_entry_t * entry = v;
+    entry->cached = 0;
+    cached_cnt--;
+    if(!invalidating) {
+        evict_cnt++;
+        LV_LOG_INFO("image draw: close the least recently used image");
+    }
+
+    /*Drawn now, it will be closed when released*/
+    if(entry->ref_cnt == 0) entry_free(entry);
+}
+
+static void entry_free(_lv_img_cache_entry_t * entry)
+{
+    lv_img_decoder_close(&entry->dec_dsc);
+    _lv_ll_remove(&LV_GC_ROOT(_lv_img_cache_ll), entry);
+    lv_mem_free(entry);
+}
+
 static bool lv_img_cache_match(const void * src1, const void * src2)
 {
     lv_img_src_t src_type = lv_img_src_get_type(src1);
@@ -31,12 +31,26 @@ extern "C" {
 typedef struct {
     lv_img_decoder_dsc_t dec_dsc; /**< Image information*/
 
-    /** Count the cache entries's life. Add `time_to_open` to `life` when the entry is used.
-     * Decrement all lifes by one every in every ::lv_img_cache_open.
-     * If life == 0 the entry can be reused*/
-    int32_t life;
+    /** RAM kept by the opened image (the entry and the decoded pixels).
+     * It's counted against the memory size of the cache*/
+    uint32_t size;
+
+    /** Number of the draws using the entry now. Evicted entries are closed when it drops to 0*/
+    uint16_t ref_cnt;
+
+    /** 1: the entry is in the cache; 0: it's closed when released*/
+    uint8_t cached : 1;
 } _lv_img_cache_entry_t;
 
+typedef struct {
+    uint32_t hit_cnt;       /**< Opened images found in the cache*/
+    uint32_t miss_cnt;      /**< Opened images which had to be decoded*/
+    uint32_t evict_cnt;     /**< Images closed to make room for others*/
+    uint32_t entry_cnt;     /**< Images in the cache now*/
+    uint32_t used_size;     /**< RAM kept by the images in the cache*/
+    uint32_t total_size;    /**< Memory size of the cache*/
+} lv_img_cache_monitor_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -44,29 +58,57 @@ typedef struct {
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The least recently used images are closed when the cache is out of memory, the images slow to open are kept longer.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
  * @param frame_id the index of the frame. Used only with animated images, set 0 for normal images
- * @return pointer to the cache entry or NULL if can open the image
+ * @return pointer to the cache entry or NULL if can open the image.
+ *         It needs to be released with `_lv_img_cache_release()` when the drawing is done.
  */
 _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, int32_t frame_id);
 
 /**
- * Set the number of images to be cached.
- * More cached images mean more opened image at same time which might mean more memory usage.
- * E.g. if 20 PNG or JPG images are open in the RAM they consume memory while opened in the cache.
- * @param new_entry_cnt number of image to cache
+ * Release an entry opened by `_lv_img_cache_open()`.
+ * Images not (or no longer) in the cache are closed here.
+ * @param entry pointer to the cache entry
+ */
+void _lv_img_cache_release(_lv_img_cache_entry_t * entry);
+
+/**
+ * Set the number of images expected in the cache. It sizes the hash table of the cache.
+ * How many images are really kept depends on the memory size of the cache (see `lv_img_cache_set_mem_size()`).
+ * @param new_entry_cnt number of images to cache. 0: disable the cache
+ */
+void lv_img_cache_set_size(uint16_t new_entry_cnt);
+
+/**
+ * Set how much RAM the opened images can keep in the cache.
+ * The images decoded to RAM (e.g. PNG or compressed images) count with their decoded size,
+ * the images used in place (e.g. `lv_img_dsc_t` variables of the built-in formats) count only with the entry.
+ * @param new_size the memory size of the cache in bytes
  */
-void lv_img_cache_set_size(uint16_t new_slot_num);
+void lv_img_cache_set_mem_size(uint32_t new_size);
 
 /**
  * Invalidate an image source in the cache.
  * Useful if the image source is updated therefore it needs to be cached again.
- * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable.
+ * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable. NULL to invalidate all images
  */
 void lv_img_cache_invalidate_src(const void * src);
 
+/**
+ * Get the statistics of the image cache
+ * @param mon_p pointer to a `lv_img_cache_monitor_t` variable, the result will be stored here
+ */
+void lv_img_cache_monitor(lv_img_cache_monitor_t * mon_p);
+
+/**
+ * Drop the least recently used image of the cache to free memory, see `lv_mem_alloc()`.
+ * An image being drawn is closed when it's released.
+ * @return false if the cache is empty
+ */
+bool _lv_img_cache_evict_lru(void);
+
 /**********************
  *      MACROS
  **********************/
@@ -16,7 +16,7 @@
  *      DEFINES
  *********************/
 #define CF_BUILT_IN_FIRST   LV_IMG_CF_TRUE_COLOR
-#define CF_BUILT_IN_LAST    LV_IMG_CF_RGB565A8
+#define CF_BUILT_IN_LAST    LV_IMG_CF_RLE_TRUE_COLOR_ALPHA
 
 /**********************
  *      TYPEDEFS
@@ -37,6 +37,9 @@ static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, l
                                                    lv_coord_t len, uint8_t * buf);
 static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
                                                      lv_coord_t len, uint8_t * buf);
+static void lv_img_decoder_built_in_line_rle(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                             lv_coord_t len, uint8_t * buf);
+static bool is_rle(const lv_img_decoder_dsc_t * dsc);
 
 /**********************
  *  STATIC VARIABLES
@@ -300,6 +303,8 @@ lv_res_t lv_img_decoder_built_in_info(lv_img_decoder_t * decoder, const void * s
         }
 
         if(header->cf < CF_BUILT_IN_FIRST || header->cf > CF_BUILT_IN_LAST) return LV_RES_INV;
+        /*The run-length encoded rows are found in the memory*/
+        if(header->cf == LV_IMG_CF_RLE_TRUE_COLOR || header->cf == LV_IMG_CF_RLE_TRUE_COLOR_ALPHA) return LV_RES_INV;
     }
     else if(src_type == LV_IMG_SRC_SYMBOL) {
         /*The size depend on the font but it is unknown here. It should be handled outside of the
@@ -400,6 +405,36 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
             return LV_RES_OK;
         }
     }
+    /*Run-length encoded images. Only variables as they were checked in `info`*/
+    else if(cf == LV_IMG_CF_RLE_TRUE_COLOR || cf == LV_IMG_CF_RLE_TRUE_COLOR_ALPHA) {
+        const lv_img_dsc_t * img_dsc = dsc->src;
+        if(dsc->header.h == 0) {
+            LV_LOG_WARN("Image decoder open: the run-length encoded image has no rows");
+            return LV_RES_INV;
+        }
+        if(img_dsc->data_size < dsc->header.h * sizeof(uint32_t)) {
+            LV_LOG_WARN("Image decoder open: the row index of the run-length encoded image is truncated");
+            return LV_RES_INV;
+        }
+
+        /*Give the plain pixels*/
+        dsc->header.cf = cf == LV_IMG_CF_RLE_TRUE_COLOR ? LV_IMG_CF_TRUE_COLOR : LV_IMG_CF_TRUE_COLOR_ALPHA;
+
+        /*Decode small images at once. Larger ones or if there is no memory are read line by line*/
+        uint32_t size = lv_img_buf_get_img_size(dsc->header.w, dsc->header.h, dsc->header.cf);
+        if(size <= LV_IMG_RLE_DECODE_MAX_SIZE) {
+            uint8_t * px_buf = lv_mem_alloc(size);
+            if(px_buf) {
+                uint32_t row_size = size / dsc->header.h;
+                lv_coord_t y;
+                for(y = 0; y < dsc->header.h; y++) {
+                    lv_img_decoder_built_in_line_rle(dsc, 0, y, dsc->header.w, px_buf + y * row_size);
+                }
+                dsc->img_data = px_buf;
+            }
+        }
+        return LV_RES_OK;
+    }
     /*Process indexed images. Build a palette*/
     else if(cf == LV_IMG_CF_INDEXED_1BIT || cf == LV_IMG_CF_INDEXED_2BIT || cf == LV_IMG_CF_INDEXED_4BIT ||
             cf == LV_IMG_CF_INDEXED_8BIT) {
@@ -484,8 +519,12 @@ lv_res_t lv_img_decoder_built_in_read_line(lv_img_decoder_t * decoder, lv_img_de
 
     lv_res_t res = LV_RES_INV;
 
-    if(dsc->header.cf == LV_IMG_CF_TRUE_COLOR || dsc->header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA ||
-       dsc->header.cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
+    if(is_rle(dsc)) {
+        lv_img_decoder_built_in_line_rle(dsc, x, y, len, buf);
+        res = LV_RES_OK;
+    }
+    else if(dsc->header.cf == LV_IMG_CF_TRUE_COLOR || dsc->header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA ||
+            dsc->header.cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
         /*For TRUE_COLOR images read line required only for files.
          *For variables the image data was returned in `open`*/
         if(dsc->src_type == LV_IMG_SRC_FILE) {
@@ -517,6 +556,12 @@ void lv_img_decoder_built_in_close(lv_img_decoder_t * decoder, lv_img_decoder_ds
 {
     LV_UNUSED(decoder); /*Unused*/
 
+    /*Decoded at once in `open`*/
+    if(is_rle(dsc) && dsc->img_data) {
+        lv_mem_free((void *)dsc->img_data);
+        dsc->img_data = NULL;
+    }
+
     lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
     if(user_data) {
         if(dsc->src_type == LV_IMG_SRC_FILE) {
@@ -728,3 +773,67 @@ static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc,
     lv_mem_buf_release(fs_buf);
     return LV_RES_OK;
 }
+
+/**
+ * Decode `len` pixels of a row of a run-length encoded image from `x`.
+ * The row is found by its offset in the index at the beginning of the data.
+ * The packets are cut at the end of the data (`data_size`), the pixels not found there are zeros.
+ */
+static void lv_img_decoder_built_in_line_rle(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                             lv_coord_t len, uint8_t * buf)
+{
+    const lv_img_dsc_t * img_dsc = dsc->src;
+    const uint8_t * data = img_dsc->data;
+    const uint8_t * end = data + img_dsc->data_size;
+    const uint8_t * ofs = data + y * sizeof(uint32_t);
+    uint32_t row_ofs = ofs[0] | ofs[1] << 8 | ofs[2] << 16 | (uint32_t)ofs[3] << 24;
+    const uint8_t * p = row_ofs < img_dsc->data_size ? data + row_ofs : end;
+    uint8_t px_size = dsc->header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+
+    while(len > 0) {
+        if(end - p < 1 + px_size) {
+            lv_memset_00(buf, len * px_size);
+            return;
+        }
+        uint8_t ctrl = *p++;
+        lv_coord_t n = (ctrl & 0x7F) + 1;
+        bool run = ctrl & 0x80;
+        /*Keep only the different pixels which are in the data*/
+        if(!run) n = LV_MIN(n, (lv_coord_t)((end - p) / px_size));
+
+        /*Skip the packets on the left of `x`*/
+        if(x >= n) {
+            x -= n;
+            p += run ? px_size : n * px_size;
+            continue;
+        }
+
+        lv_coord_t cnt = LV_MIN(n - x, len);
+        if(run) {
+            if(px_size == sizeof(lv_color_t)) {
+                lv_color_t c;
+                lv_memcpy_small(&c, p, sizeof(lv_color_t));
+                lv_color_fill((lv_color_t *)buf, c, cnt);
+            }
+            else {
+                lv_coord_t i;
+                for(i = 0; i < cnt; i++) lv_memcpy_small(buf + i * px_size, p, px_size);
+            }
+            p += px_size;
+        }
+        else {
+            lv_memcpy(buf, p + x * px_size, cnt * px_size);
+            p += n * px_size;
+        }
+        buf += cnt * px_size;
+        len -= cnt;
+        x = 0;
+    }
+}
+
+static bool is_rle(const lv_img_decoder_dsc_t * dsc)
+{
+    if(dsc->src_type != LV_IMG_SRC_VARIABLE) return false;
+    lv_img_cf_t cf = ((const lv_img_dsc_t *)dsc->src)->header.cf;
+    return cf == LV_IMG_CF_RLE_TRUE_COLOR || cf == LV_IMG_CF_RLE_TRUE_COLOR_ALPHA;
+}
@@ -43,6 +43,24 @@ typedef struct {
     uint32_t has_alpha : 1;
 } lv_draw_sw_layer_ctx_t;
 
+/** The blurred top right corner of a shadow, computed in advance (see `lv_draw_sw_shadow_set_baked()`)*/
+typedef struct {
+    lv_coord_t width;       /**< `shadow_width`*/
+    lv_coord_t radius;      /**< Radius of the blurred rectangle*/
+    lv_coord_t core_w;      /**< Width of the blurred rectangle, at most 2 * (width + radius)*/
+    lv_coord_t core_h;      /**< Height of the blurred rectangle, at most 2 * (width + radius)*/
+    const lv_opa_t * map;   /**< (width + radius)^2 opacities, row by row*/
+} lv_draw_sw_shadow_corner_t;
+
+typedef struct {
+    uint32_t hit_cnt;       /**< Shadows found in the cache*/
+    uint32_t baked_cnt;     /**< Shadows found among the baked corners*/
+    uint32_t miss_cnt;      /**< Shadows which had to be blurred*/
+    uint32_t evict_cnt;     /**< Shadows dropped to make room for others*/
+    uint32_t used_size;     /**< RAM kept by the shadows in the cache*/
+    uint32_t total_size;    /**< Memory size of the cache*/
+} lv_draw_sw_shadow_cache_monitor_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -58,6 +76,46 @@ void lv_draw_sw_arc(lv_draw_ctx_t * draw_ctx, const lv_draw_arc_dsc_t * dsc, con
 void lv_draw_sw_rect(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords);
 
 void lv_draw_sw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords);
+
+/**
+ * Set how much RAM the blurred shadow corners can keep in the cache.
+ * Shadows larger than `LV_SHADOW_CACHE_SIZE` (`shadow_width + radius`) are not cached.
+ * The corners are kept in a static array of `LV_SHADOW_CACHE_MEM_SIZE` bytes, not in the heap.
+ * @param new_size      the memory size of the cache in bytes, at most `LV_SHADOW_CACHE_MEM_SIZE`. 0: disable the cache
+ */
+void lv_draw_sw_shadow_cache_set_mem_size(uint32_t new_size);
+
+/**
+ * Drop the shadow corners kept in the cache. It fills again as shadows are drawn. Called by `lv_deinit()`.
+ */
+void lv_draw_sw_shadow_cache_free(void);
+
+/**
+ * Get the statistics of the shadow cache
+ * @param mon_p         pointer to a `lv_draw_sw_shadow_cache_monitor_t` variable, the result will be stored here
+ */
+void lv_draw_sw_shadow_cache_monitor(lv_draw_sw_shadow_cache_monitor_t * mon_p);
+
+/**
+ * Use shadow corners computed in advance instead of blurring them when drawn.
+ * They are usually generated with `lv_draw_sw_shadow_bake()` on the host and compiled in as constants.
+ * In choomipet only the simulator's shadow benchmark uses them: the firmware draws no shadows, so it bakes none.
+ * @param corners       array of corners, it's not copied. NULL to use none
+ * @param cnt           number of corners
+ */
+void lv_draw_sw_shadow_set_baked(const lv_draw_sw_shadow_corner_t * corners, uint32_t cnt);
+
+/**
+ * Compute the shadow corner of a rectangle for `lv_draw_sw_shadow_set_baked()`.
+ * Rectangles with the same `shadow_width`, `shadow_spread` and `radius` share a corner
+ * if both sides are at least 2 * (`shadow_width` + `radius`) long.
+ * @param dsc           the style of the rectangle
+ * @param coords        the area of the rectangle, only its size matters
+ * @param corner        the corner is stored here. Its `map` is allocated with `lv_mem_alloc()`
+ * @return              false if the rectangle has no shadow or out of memory
+ */
+bool lv_draw_sw_shadow_bake(const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords,
+                            lv_draw_sw_shadow_corner_t * corner);
 void lv_draw_sw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos_p,
                        uint32_t letter);
 
@@ -80,6 +138,20 @@ void lv_draw_sw_transform(lv_draw_ctx_t * draw_ctx, const lv_area_t * dest_area,
                           lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                           const lv_draw_img_dsc_t * draw_dsc, lv_img_cf_t cf, lv_color_t * cbuf, lv_opa_t * abuf);
 
+/**
+ * Enable or disable the fast paths of `lv_draw_sw_transform()`: zoom without rotation
+ * (nearest neighbor or separable AA) and rotation by 90, 180 or 270 degrees without zoom (index remapping).
+ * Enabled by default. Mainly to compare them with the generic path.
+ * @param en            false: transform every image with the generic path
+ */
+void lv_draw_sw_transform_set_fast_paths(bool en);
+
+/**
+ * Tell whether the fast paths of `lv_draw_sw_transform()` are enabled
+ * @return              true: enabled
+ */
+bool lv_draw_sw_transform_get_fast_paths(void);
+
 struct _lv_draw_layer_ctx_t * lv_draw_sw_layer_create(struct _lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx,
                                                       lv_draw_layer_flags_t flags);
 
@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "lv_draw_sw.h"
+#include "lv_draw_sw_blend_kernels.h"
 #include "../../misc/lv_math.h"
 #include "../../hal/lv_hal_disp.h"
 #include "../../core/lv_refr.h"
@@ -14,6 +15,8 @@
 /*********************
  *      DEFINES
  *********************/
+/*Shorter covered spans of a masked line are blended with the mask*/
+#define BLEND_RUN_MIN   16
 
 /**********************
  *      TYPEDEFS
@@ -22,6 +25,12 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if LV_DRAW_COMPLEX
+static void /* LV_ATTRIBUTE_FAST_MEM */ blend_runs(lv_color_t * dest_buf, const lv_area_t * dest_area,
+                                                   lv_coord_t dest_stride, const lv_color_t * src_buf, lv_color_t color,
+                                                   lv_opa_t opa, const lv_opa_t * mask, const lv_draw_mask_runs_t * runs,
+                                                   lv_coord_t mask_x_ofs);
+#endif
 
 static void fill_set_px(lv_color_t * dest_buf, const lv_area_t * blend_area, lv_coord_t dest_stride,
                         lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stide);
@@ -147,6 +156,7 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
     }
 
     lv_coord_t mask_stride;
+    lv_coord_t mask_x_ofs = 0;
     if(mask) {
         /*Round the values in the mask if anti-aliasing is disabled*/
         if(disp->driver->antialiasing == 0) {
@@ -158,7 +168,8 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
         }
 
         mask_stride = lv_area_get_width(dsc->mask_area);
-        mask += mask_stride * (blend_area.y1 - dsc->mask_area->y1) + (blend_area.x1 - dsc->mask_area->x1);
+        mask_x_ofs = blend_area.x1 - dsc->mask_area->x1;
+        mask += mask_stride * (blend_area.y1 - dsc->mask_area->y1) + mask_x_ofs;
 
     }
     else {
@@ -187,12 +198,19 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
     }
 #endif
     else if(dsc->blend_mode == LV_BLEND_MODE_NORMAL) {
-        if(dsc->src_buf == NULL) {
-            fill_normal(dest_buf, &blend_area, dest_stride, dsc->color, dsc->opa, mask, mask_stride);
-        }
-        else {
-            map_normal(dest_buf, &blend_area, dest_stride, src_buf, src_stride, dsc->opa, mask, mask_stride);
+#if LV_DRAW_COMPLEX
+        if(mask && dsc->mask_runs && blend_area.y1 == blend_area.y2 && dsc->mask_area->y1 == dsc->mask_area->y2) {
+            blend_runs(dest_buf, &blend_area, dest_stride, src_buf, dsc->color, dsc->opa, mask, dsc->mask_runs,
+                       mask_x_ofs);
         }
+        else
+#endif
+            if(dsc->src_buf == NULL) {
+                fill_normal(dest_buf, &blend_area, dest_stride, dsc->color, dsc->opa, mask, mask_stride);
+            }
+            else {
+                map_normal(dest_buf, &blend_area, dest_stride, src_buf, src_stride, dsc->opa, mask, mask_stride);
+            }
     }
     else {
 #if LV_DRAW_COMPLEX
@@ -211,6 +229,76 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
  *   STATIC FUNCTIONS
  **********************/
 
+#if LV_DRAW_COMPLEX
+/**
+ * Blend a masked line span by span. The transparent spans are skipped, the long fully covered ones
+ * are blended without the mask and the others with the mask values.
+ * `mask_x_ofs` is the first pixel of the line in the spans.
+ */
+static void LV_ATTRIBUTE_FAST_MEM blend_runs(lv_color_t * dest_buf, const lv_area_t * dest_area,
+                                             lv_coord_t dest_stride, const lv_color_t * src_buf, lv_color_t color,
+                                             lv_opa_t opa, const lv_opa_t * mask, const lv_draw_mask_runs_t * runs,
+                                             lv_coord_t mask_x_ofs)
+{
+    int32_t w = lv_area_get_width(dest_area);
+    lv_area_t part_area;
+    part_area.x1 = 0;
+    part_area.y1 = 0;
+    part_area.y2 = 0;
+
+    /*The pixels to blend with the mask*/
+    int32_t masked_start = 0;
+    int32_t masked_end = 0;
+
+    int32_t run_start = -mask_x_ofs;
+    uint32_t i;
+    for(i = 0; i <= runs->cnt; i++) {
+        int32_t start;
+        int32_t end;
+        lv_draw_mask_res_t res;
+        if(i < runs->cnt) {
+            start = LV_MAX(run_start, 0);
+            end = LV_MIN(run_start + runs->run[i].len, w);
+            res = runs->run[i].res;
+            run_start += runs->run[i].len;
+            if(start >= end) continue;
+
+            /*The unchanged values are the same as the mask was initialized*/
+            if(res == LV_DRAW_MASK_RES_FULL_COVER &&
+               (opa != LV_OPA_COVER || mask[start] != LV_OPA_COVER || end - start < BLEND_RUN_MIN)) {
+                res = LV_DRAW_MASK_RES_CHANGED;
+            }
+
+            if(res == LV_DRAW_MASK_RES_CHANGED) {
+                if(masked_end != start) masked_start = start;
+                masked_end = end;
+                continue;
+            }
+        }
+        else {
+            /*Flush the last masked span*/
+            start = w;
+            end = w;
+            res = LV_DRAW_MASK_RES_TRANSP;
+        }
+
+        if(masked_end > masked_start) {
+            part_area.x2 = masked_end - masked_start - 1;
+            if(src_buf) map_normal(dest_buf + masked_start, &part_area, dest_stride, src_buf + masked_start, w, opa,
+                                       mask + masked_start, w);
+            else fill_normal(dest_buf + masked_start, &part_area, dest_stride, color, opa, mask + masked_start, w);
+            masked_start = masked_end;
+        }
+
+        if(res == LV_DRAW_MASK_RES_FULL_COVER) {
+            part_area.x2 = end - start - 1;
+            if(src_buf) map_normal(dest_buf + start, &part_area, dest_stride, src_buf + start, w, opa, NULL, 0);
+            else fill_normal(dest_buf + start, &part_area, dest_stride, color, opa, NULL, 0);
+        }
+    }
+}
+#endif /*LV_DRAW_COMPLEX*/
+
 static void fill_set_px(lv_color_t * dest_buf, const lv_area_t * blend_area, lv_coord_t dest_stride,
                         lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stide)
 {
@@ -254,6 +342,24 @@ static LV_ATTRIBUTE_FAST_MEM void fill_normal(lv_color_t * dest_buf, const lv_ar
     int32_t x;
     int32_t y;
 
+#if _LV_DRAW_SW_BLEND_KERNELS
+    /*The kernels give the same pixels as the code below*/
+    const _lv_draw_sw_blend_kernel_table_t * kernels = _lv_draw_sw_blend_get_kernel_table();
+    if(kernels && (mask || opa < LV_OPA_MAX)) {
+        for(y = 0; y < h; y++) {
+            if(mask) {
+                kernels->fill_mask(dest_buf, w, color, opa, mask);
+                mask += mask_stride;
+            }
+            else {
+                kernels->fill_opa(dest_buf, w, color, opa);
+            }
+            dest_buf += dest_stride;
+        }
+        return;
+    }
+#endif
+
     /*No mask*/
     if(mask == NULL) {
         if(opa >= LV_OPA_MAX) {
@@ -409,10 +515,10 @@ static inline void set_px_argb(uint8_t * buf, lv_color_t color, lv_opa_t opa)
 static inline void set_px_argb_blend(uint8_t * buf, lv_color_t color, lv_opa_t opa, lv_color_t (*blend_fp)(lv_color_t,
                                                                                                            lv_color_t, lv_opa_t))
 {
-    static lv_color_t last_dest_color;
-    static lv_color_t last_src_color;
-    static lv_color_t last_res_color;
-    static uint32_t last_opa = 0xffff; /*Set to an invalid value for first*/
+    static LV_RENDER_LOCAL lv_color_t last_dest_color;
+    static LV_RENDER_LOCAL lv_color_t last_src_color;
+    static LV_RENDER_LOCAL lv_color_t last_res_color;
+    static LV_RENDER_LOCAL uint32_t last_opa = 0xffff; /*Set to an invalid value for first*/
 
     lv_color_t bg_color;
 
@@ -655,6 +761,25 @@ static void LV_ATTRIBUTE_FAST_MEM map_normal(lv_color_t * dest_buf, const lv_are
     int32_t x;
     int32_t y;
 
+#if _LV_DRAW_SW_BLEND_KERNELS
+    /*The kernels give the same pixels as the code below*/
+    const _lv_draw_sw_blend_kernel_table_t * kernels = _lv_draw_sw_blend_get_kernel_table();
+    if(kernels && (mask || opa < LV_OPA_MAX)) {
+        for(y = 0; y < h; y++) {
+            if(mask) {
+                kernels->map_mask(dest_buf, src_buf, w, opa, mask);
+                mask += mask_stride;
+            }
+            else {
+                kernels->map_opa(dest_buf, src_buf, w, opa);
+            }
+            dest_buf += dest_stride;
+            src_buf += src_stride;
+        }
+        return;
+    }
+#endif
+
     /*Simple fill (maybe with opacity), no masking*/
     if(mask == NULL) {
         if(opa >= LV_OPA_MAX) {
@@ -1020,7 +1145,7 @@ static inline lv_color_t color_blend_true_color_subtractive(lv_color_t fg, lv_co
     tmp = bg.ch.green - fg.ch.green;
     fg.ch.green = LV_MAX(tmp, 0);
 #else
-    tmp = (bg.ch.green_h << 3) + bg.ch.green_l + (fg.ch.green_h << 3) + fg.ch.green_l;
+    tmp = (bg.ch.green_h << 3) + bg.ch.green_l - (fg.ch.green_h << 3) - fg.ch.green_l;
     tmp = LV_MAX(tmp, 0);
     fg.ch.green_h = tmp >> 3;
     fg.ch.green_l = tmp & 0x7;
@@ -36,8 +36,19 @@ typedef struct {
     const lv_area_t * mask_area;    /**< The area of `mask_buf` with absolute coordinates*/
     lv_opa_t opa;                   /**< The overall opacity*/
     lv_blend_mode_t blend_mode;     /**< E.g. LV_BLEND_MODE_ADDITIVE*/
+    const lv_draw_mask_runs_t * mask_runs;  /**< NULL or the spans of a one line `mask_buf`
+                                             *   from `lv_draw_mask_apply_runs()`*/
 } lv_draw_sw_blend_dsc_t;
 
+/** Implementations of the normal blending of translucent and masked pixels*/
+enum {
+    LV_DRAW_SW_BLEND_KERNELS_SCALAR,    /**< One pixel at a time with `lv_color_mix()`*/
+    LV_DRAW_SW_BLEND_KERNELS_SWAR,      /**< Two RGB565 pixels in a 32 bit word*/
+    LV_DRAW_SW_BLEND_KERNELS_SSE2,      /**< Eight RGB565 pixels in an SSE2 vector*/
+};
+
+typedef uint8_t lv_draw_sw_blend_kernels_t;
+
 struct _lv_draw_ctx_t;
 
 /**********************
@@ -59,6 +70,20 @@ void lv_draw_sw_blend(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_d
 void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_blend_basic(struct _lv_draw_ctx_t * draw_ctx,
                                                         const lv_draw_sw_blend_dsc_t * dsc);
 
+/**
+ * Select how translucent and masked pixels are blended. All of them give the same pixels.
+ * `lv_init()` selects the fastest one available on the build.
+ * @param kernels       e.g. `LV_DRAW_SW_BLEND_KERNELS_SCALAR`
+ * @return              false if the kernels are not available with this color format or CPU
+ */
+bool lv_draw_sw_blend_set_kernels(lv_draw_sw_blend_kernels_t kernels);
+
+/**
+ * Get the selected blend kernels.
+ * @return              e.g. `LV_DRAW_SW_BLEND_KERNELS_SWAR`
+ */
+lv_draw_sw_blend_kernels_t lv_draw_sw_blend_get_kernels(void);
+
 /**********************
  *      MACROS
  **********************/
@@ -0,0 +1,479 @@
+/**
+ * @file lv_draw_sw_blend_kernels.c
+ * Row kernels of the normal blending of RGB565 pixels. The SWAR kernels mix two pixels
+ * held in a 32 bit word, the SSE2 kernels eight pixels in a vector.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_blend_kernels.h"
+
+#if _LV_DRAW_SW_BLEND_SSE2
+#include <emmintrin.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Two native RGB565 pixels in a word: B0, R0 and G1, then G0, B1 and R1 after shifting it right by 5.
+ *Each channel has a gap of at least 5 bits below it for the fraction of the mix*/
+#define SWAR_MASK_A 0x07E0F81FU
+#define SWAR_MASK_B 0x07C0F83FU
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if _LV_DRAW_SW_BLEND_KERNELS
+static void swar_fill_opa(lv_color_t * dest, int32_t len, lv_color_t color, lv_opa_t opa);
+static void swar_fill_mask(lv_color_t * dest, int32_t len, lv_color_t color, lv_opa_t opa, const lv_opa_t * mask);
+static void swar_map_opa(lv_color_t * dest, const lv_color_t * src, int32_t len, lv_opa_t opa);
+static void swar_map_mask(lv_color_t * dest, const lv_color_t * src, int32_t len, lv_opa_t opa, const lv_opa_t * mask);
+#endif
+
+#if _LV_DRAW_SW_BLEND_SSE2
+static void sse2_fill_opa(lv_color_t * dest, int32_t len, lv_color_t color, lv_opa_t opa);
+static void sse2_fill_mask(lv_color_t * dest, int32_t len, lv_color_t color, lv_opa_t opa, const lv_opa_t * mask);
+static void sse2_map_opa(lv_color_t * dest, const lv_color_t * src, int32_t len, lv_opa_t opa);
+static void sse2_map_mask(lv_color_t * dest, const lv_color_t * src, int32_t len, lv_opa_t opa, const lv_opa_t * mask);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+#if _LV_DRAW_SW_BLEND_KERNELS
+static const _lv_draw_sw_blend_kernel_table_t swar_kernels = {
+    swar_fill_opa, swar_fill_mask, swar_map_opa, swar_map_mask
+};
+#endif
+
+#if _LV_DRAW_SW_BLEND_SSE2
+static const _lv_draw_sw_blend_kernel_table_t sse2_kernels = {
+    sse2_fill_opa, sse2_fill_mask, sse2_map_opa, sse2_map_mask
+};
+#endif
+
+static lv_draw_sw_blend_kernels_t kernels_act = LV_DRAW_SW_BLEND_KERNELS_SCALAR;
+static const _lv_draw_sw_blend_kernel_table_t * kernel_table;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_draw_sw_blend_kernels_init(void)
+{
+    if(!lv_draw_sw_blend_set_kernels(LV_DRAW_SW_BLEND_KERNELS_SSE2)) {
+        lv_draw_sw_blend_set_kernels(LV_DRAW_SW_BLEND_KERNELS_SWAR);
+    }
+}
+
+bool lv_draw_sw_blend_set_kernels(lv_draw_sw_blend_kernels_t kernels)
+{
+    const _lv_draw_sw_blend_kernel_table_t * table;
+    switch(kernels) {
+        case LV_DRAW_SW_BLEND_KERNELS_SCALAR:
+            table = NULL;
+            break;
+#if _LV_DRAW_SW_BLEND_KERNELS
+        case LV_DRAW_SW_BLEND_KERNELS_SWAR:
+            table = &swar_kernels;
+            break;
+#endif
+#if _LV_DRAW_SW_BLEND_SSE2
+        case LV_DRAW_SW_BLEND_KERNELS_SSE2:
+            table = &sse2_kernels;
+            break;
+#endif
+        default:
+            return false;
+    }
+
+    kernels_act = kernels;
+    kernel_table = table;
+    return true;
+}
+
+lv_draw_sw_blend_kernels_t lv_draw_sw_blend_get_kernels(void)
+{
+    return kernels_act;
+}
+
+const _lv_draw_sw_blend_kernel_table_t * _lv_draw_sw_blend_get_kernel_table(void)
+{
+    return kernel_table;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if _LV_DRAW_SW_BLEND_KERNELS
+
+/*Convert between the pixels in the buffers and native RGB565*/
+#if LV_COLOR_16_SWAP
+static inline uint32_t native1(uint32_t px)
+{
+    return ((px & 0xFFU) << 8) | (px >> 8);
+}
+
+static inline uint32_t native2(uint32_t px2)
+{
+    return ((px2 & 0x00FF00FFU) << 8) | ((px2 >> 8) & 0x00FF00FFU);
+}
+#else
+#define native1(px) (px)
+#define native2(px2) (px2)
+#endif
+
+/*The two pixels at `p`, which is 4 byte aligned or not*/
+static inline uint32_t load2(const lv_color_t * p)
+{
+    if((lv_uintptr_t)p & 0x3) return p[0].full | (uint32_t)p[1].full << 16;
+    return *(const uint32_t *)p;
+}
+
+/*Four mask values, the first in the lowest byte*/
+static inline uint32_t load_mask4(const lv_opa_t * mask)
+{
+    if((lv_uintptr_t)mask & 0x3) return mask[0] | mask[1] << 8 | mask[2] << 16 | (uint32_t)mask[3] << 24;
+    return *(const uint32_t *)mask;
+}
+
+/*The mix ratio of `lv_color_mix()`: 0..32*/
+static inline uint32_t mix_ratio(uint32_t opa)
+{
+    return (opa + 4) >> 3;
+}
+
+/*`lv_color_mix()` of a native pixel: every channel becomes bg + (fg - bg) * mix / 32, rounded down*/
+static inline uint32_t swar_mix1(uint32_t fg, uint32_t bg, uint32_t mix)
+{
+    fg = (fg | fg << 16) & SWAR_MASK_A;
+    bg = (bg | bg << 16) & SWAR_MASK_A;
+    uint32_t res = ((((fg - bg) * mix) >> 5) + bg) & SWAR_MASK_A;
+    return (res | res >> 16) & 0xFFFFU;
+}
+
+/*The same on two native pixels mixed with the same ratio*/
+static inline uint32_t swar_mix2(uint32_t fg, uint32_t bg, uint32_t mix)
+{
+    uint32_t fg_a = fg & SWAR_MASK_A;
+    uint32_t bg_a = bg & SWAR_MASK_A;
+    uint32_t fg_b = (fg >> 5) & SWAR_MASK_B;
+    uint32_t bg_b = (bg >> 5) & SWAR_MASK_B;
+    uint32_t res_a = ((((fg_a - bg_a) * mix) >> 5) + bg_a) & SWAR_MASK_A;
+    uint32_t res_b = ((((fg_b - bg_b) * mix) >> 5) + bg_b) & SWAR_MASK_B;
+    return res_a | res_b << 5;
+}
+
+/*Two pixels with the mix ratios of their own*/
+static inline uint32_t swar_mix2_each(uint32_t fg, uint32_t bg, uint32_t mix0, uint32_t mix1)
+{
+    if(mix0 == mix1) return swar_mix2(fg, bg, mix0);
+    return swar_mix1(fg & 0xFFFFU, bg & 0xFFFFU, mix0) | swar_mix1(fg >> 16, bg >> 16, mix1) << 16;
+}
+
+/*`LV_UDIV255()` on the two 16 bit halves, exact up to 63 * 255*/
+static inline uint32_t swar_div255(uint32_t x)
+{
+    return ((x + 0x00010001U + ((x >> 8) & 0x00FF00FFU)) >> 8) & 0x00FF00FFU;
+}
+
+/*`lv_color_mix_premult()` of two native pixels. `pre_rb` is B and R of the premultiplied color in
+ *the two halves, `pre_gg` G in both*/
+static inline uint32_t swar_premult2(uint32_t bg, uint32_t pre_rb, uint32_t pre_gg, uint32_t opa_inv)
+{
+    uint32_t rb0 = (bg & 0x1FU) | (bg & 0xF800U) << 5;
+    uint32_t rb1 = ((bg >> 16) & 0x1FU) | (bg >> 27) << 16;
+    uint32_t gg = (bg >> 5) & 0x003F003FU;
+    rb0 = swar_div255(rb0 * opa_inv + pre_rb);
+    rb1 = swar_div255(rb1 * opa_inv + pre_rb);
+    gg = swar_div255(gg * opa_inv + pre_gg);
+    return (rb0 & 0x1FU) | ((rb0 >> 5) & 0xF800U) | (gg & 0x3FU) << 5 |
+           ((rb1 & 0x1FU) | ((rb1 >> 5) & 0xF800U) | (gg >> 16) << 5) << 16;
+}
+
+/*The mask to mix ratio of `fill_normal()` and `map_normal()`*/
+static inline uint32_t fill_mask_ratio(uint32_t mask, lv_opa_t opa)
+{
+    if(opa >= LV_OPA_MAX) return mix_ratio(mask);
+    return mix_ratio(mask == LV_OPA_COVER ? opa : (mask * opa) >> 8);
+}
+
+static inline uint32_t map_mask_ratio(uint32_t mask, lv_opa_t opa)
+{
+    if(opa > LV_OPA_MAX) return mix_ratio(mask);
+    return mix_ratio(mask >= LV_OPA_MAX ? opa : (mask * opa) >> 8);
+}
+
+static void LV_ATTRIBUTE_FAST_MEM swar_fill_opa(lv_color_t * dest, int32_t len, lv_color_t color, lv_opa_t opa)
+{
+    /*Round the opacity as `fill_normal()` does for `lv_color_premult()`*/
+    opa = (uint32_t)((uint32_t)opa + 4) >> 3;
+    opa = opa << 3;
+    uint16_t premult[3];
+    lv_color_premult(color, opa, premult);
+    lv_opa_t opa_inv = 255 - opa;
+    uint32_t pre_rb = premult[2] | (uint32_t)premult[0] << 16;
+    uint32_t pre_gg = premult[1] | (uint32_t)premult[1] << 16;
+
+    int32_t x = 0;
+    if((lv_uintptr_t)dest & 0x3) {
+        dest[0].full = native1(swar_premult2(native1(dest[0].full), pre_rb, pre_gg, opa_inv) & 0xFFFFU);
+        x = 1;
+    }
+
+    /*Flat areas repeat the same pair*/
+    uint32_t last_px2 = 0;
+    uint32_t last_res2 = native2(swar_premult2(0, pre_rb, pre_gg, opa_inv));
+    for(; x < len - 1; x += 2) {
+        uint32_t * d = (uint32_t *)&dest[x];
+        if(*d != last_px2) {
+            last_px2 = *d;
+            last_res2 = native2(swar_premult2(native2(*d), pre_rb, pre_gg, opa_inv));
+        }
+        *d = last_res2;
+    }
+
+    if(x < len) dest[x].full = native1(swar_premult2(native1(dest[x].full), pre_rb, pre_gg, opa_inv) & 0xFFFFU);
+}
+
+static void LV_ATTRIBUTE_FAST_MEM swar_fill_mask(lv_color_t * dest, int32_t len, lv_color_t color, lv_opa_t opa,
+                                                 const lv_opa_t * mask)
+{
+    uint32_t fg = native1(color.full);
+    uint32_t fg2 = fg | fg << 16;
+    uint32_t c32 = color.full | (uint32_t)color.full << 16;
+    /*Where the mask covers the pixels get the color*/
+    uint32_t cover4 = opa >= LV_OPA_MAX ? 0xFFFFFFFFU : 0;
+
+    int32_t x = 0;
+    if((lv_uintptr_t)dest & 0x3) {
+        if(mask[0]) dest[0].full = native1(swar_mix1(fg, native1(dest[0].full), fill_mask_ratio(mask[0], opa)));
+        x = 1;
+    }
+
+    for(; x < len - 3; x += 4) {
+        uint32_t m4 = load_mask4(&mask[x]);
+        if(m4 == 0) continue;
+        uint32_t * d = (uint32_t *)&dest[x];
+        if(m4 == cover4) {
+            d[0] = c32;
+            d[1] = c32;
+            continue;
+        }
+        if(m4 & 0xFFFFU) d[0] = native2(swar_mix2_each(fg2, native2(d[0]), fill_mask_ratio(m4 & 0xFF, opa),
+                                                           fill_mask_ratio((m4 >> 8) & 0xFF, opa)));
+        if(m4 >> 16) d[1] = native2(swar_mix2_each(fg2, native2(d[1]), fill_mask_ratio((m4 >> 16) & 0xFF, opa),
+                                                       fill_mask_ratio(m4 >> 24, opa)));
+    }
+
+    for(; x < len; x++) {
+        if(mask[x]) dest[x].full = native1(swar_mix1(fg, native1(dest[x].full), fill_mask_ratio(mask[x], opa)));
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM swar_map_opa(lv_color_t * dest, const lv_color_t * src, int32_t len, lv_opa_t opa)
+{
+    uint32_t mix = mix_ratio(opa);
+
+    int32_t x = 0;
+    if((lv_uintptr_t)dest & 0x3) {
+        dest[0].full = native1(swar_mix1(native1(src[0].full), native1(dest[0].full), mix));
+        x = 1;
+    }
+
+    for(; x < len - 1; x += 2) {
+        uint32_t * d = (uint32_t *)&dest[x];
+        *d = native2(swar_mix2(native2(load2(&src[x])), native2(*d), mix));
+    }
+
+    if(x < len) dest[x].full = native1(swar_mix1(native1(src[x].full), native1(dest[x].full), mix));
+}
+
+static void LV_ATTRIBUTE_FAST_MEM swar_map_mask(lv_color_t * dest, const lv_color_t * src, int32_t len, lv_opa_t opa,
+                                                const lv_opa_t * mask)
+{
+    /*Where the mask covers the pixels are copied*/
+    uint32_t cover4 = opa > LV_OPA_MAX ? 0xFFFFFFFFU : 0;
+
+    int32_t x = 0;
+    if((lv_uintptr_t)dest & 0x3) {
+        if(mask[0]) dest[0].full = native1(swar_mix1(native1(src[0].full), native1(dest[0].full),
+                                                         map_mask_ratio(mask[0], opa)));
+        x = 1;
+    }
+
+    for(; x < len - 3; x += 4) {
+        uint32_t m4 = load_mask4(&mask[x]);
+        if(m4 == 0) continue;
+        uint32_t * d = (uint32_t *)&dest[x];
+        if(m4 == cover4) {
+            d[0] = load2(&src[x]);
+            d[1] = load2(&src[x + 2]);
+            continue;
+        }
+        if(m4 & 0xFFFFU) d[0] = native2(swar_mix2_each(native2(load2(&src[x])), native2(d[0]),
+                                                           map_mask_ratio(m4 & 0xFF, opa), map_mask_ratio((m4 >> 8) & 0xFF, opa)));
+        if(m4 >> 16) d[1] = native2(swar_mix2_each(native2(load2(&src[x + 2])), native2(d[1]),
+                                                       map_mask_ratio((m4 >> 16) & 0xFF, opa), map_mask_ratio(m4 >> 24, opa)));
+    }
+
+    for(; x < len; x++) {
+        if(mask[x]) dest[x].full = native1(swar_mix1(native1(src[x].full), native1(dest[x].full),
+                                                         map_mask_ratio(mask[x], opa)));
+    }
+}
+
+#endif /*_LV_DRAW_SW_BLEND_KERNELS*/
+
+#if _LV_DRAW_SW_BLEND_SSE2
+
+static inline __m128i sse2_native(__m128i px)
+{
+#if LV_COLOR_16_SWAP
+    px = _mm_or_si128(_mm_slli_epi16(px, 8), _mm_srli_epi16(px, 8));
+#endif
+    return px;
+}
+
+/*bg + (fg - bg) * mix / 32 on each channel, rounded down as `lv_color_mix()`*/
+static inline __m128i sse2_mix(__m128i fg, __m128i bg, __m128i mix)
+{
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    fg = sse2_native(fg);
+    bg = sse2_native(bg);
+
+    __m128i fr = _mm_srli_epi16(fg, 11);
+    __m128i br = _mm_srli_epi16(bg, 11);
+    __m128i fgr = _mm_and_si128(_mm_srli_epi16(fg, 5), mask6);
+    __m128i bgr = _mm_and_si128(_mm_srli_epi16(bg, 5), mask6);
+    __m128i fb = _mm_and_si128(fg, mask5);
+    __m128i bb = _mm_and_si128(bg, mask5);
+
+    __m128i r = _mm_add_epi16(br, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(fr, br), mix), 5));
+    __m128i g = _mm_add_epi16(bgr, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(fgr, bgr), mix), 5));
+    __m128i b = _mm_add_epi16(bb, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(fb, bb), mix), 5));
+
+    return sse2_native(_mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b));
+}
+
+/*The 8 mask values of `mask` in 16 bit lanes*/
+static inline __m128i sse2_load_mask(const lv_opa_t * mask)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)mask), _mm_setzero_si128());
+}
+
+static inline __m128i sse2_mix_ratio(__m128i opa)
+{
+    return _mm_srli_epi16(_mm_add_epi16(opa, _mm_set1_epi16(4)), 3);
+}
+
+static void LV_ATTRIBUTE_FAST_MEM sse2_fill_opa(lv_color_t * dest, int32_t len, lv_color_t color, lv_opa_t opa)
+{
+    lv_opa_t opa_round = (uint32_t)((uint32_t)opa + 4) >> 3;
+    opa_round = opa_round << 3;
+    uint16_t premult[3];
+    lv_color_premult(color, opa_round, premult);
+    const __m128i pre_r = _mm_set1_epi16((int16_t)premult[0]);
+    const __m128i pre_g = _mm_set1_epi16((int16_t)premult[1]);
+    const __m128i pre_b = _mm_set1_epi16((int16_t)premult[2]);
+    const __m128i opa_inv = _mm_set1_epi16((lv_opa_t)(255 - opa_round));
+    const __m128i div255 = _mm_set1_epi16((int16_t)0x8081);
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+
+    int32_t x;
+    for(x = 0; x <= len - 8; x += 8) {
+        __m128i bg = sse2_native(_mm_loadu_si128((const __m128i *)&dest[x]));
+        __m128i r = _mm_add_epi16(pre_r, _mm_mullo_epi16(_mm_srli_epi16(bg, 11), opa_inv));
+        __m128i g = _mm_add_epi16(pre_g, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(bg, 5), mask6), opa_inv));
+        __m128i b = _mm_add_epi16(pre_b, _mm_mullo_epi16(_mm_and_si128(bg, mask5), opa_inv));
+        /*LV_UDIV255: x * 0x8081 >> 23*/
+        r = _mm_srli_epi16(_mm_mulhi_epu16(r, div255), 7);
+        g = _mm_srli_epi16(_mm_mulhi_epu16(g, div255), 7);
+        b = _mm_srli_epi16(_mm_mulhi_epu16(b, div255), 7);
+        __m128i res = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b);
+        _mm_storeu_si128((__m128i *)&dest[x], sse2_native(res));
+    }
+
+    if(x < len) swar_fill_opa(&dest[x], len - x, color, opa);
+}
+
+static void LV_ATTRIBUTE_FAST_MEM sse2_fill_mask(lv_color_t * dest, int32_t len, lv_color_t color, lv_opa_t opa,
+                                                 const lv_opa_t * mask)
+{
+    const __m128i fg = _mm_set1_epi16((int16_t)color.full);
+    const __m128i opa_v = _mm_set1_epi16(opa);
+    const __m128i cover = _mm_set1_epi16(LV_OPA_COVER);
+    const __m128i zero = _mm_setzero_si128();
+
+    int32_t x;
+    for(x = 0; x <= len - 8; x += 8) {
+        __m128i m = sse2_load_mask(&mask[x]);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi16(m, zero)) == 0xFFFF) continue;
+        if(opa < LV_OPA_MAX) {
+            __m128i is_cover = _mm_cmpeq_epi16(m, cover);
+            __m128i scaled = _mm_srli_epi16(_mm_mullo_epi16(m, opa_v), 8);
+            m = _mm_or_si128(_mm_and_si128(is_cover, opa_v), _mm_andnot_si128(is_cover, scaled));
+        }
+        else if(_mm_movemask_epi8(_mm_cmpeq_epi16(m, cover)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i *)&dest[x], fg);
+            continue;
+        }
+        __m128i bg = _mm_loadu_si128((const __m128i *)&dest[x]);
+        _mm_storeu_si128((__m128i *)&dest[x], sse2_mix(fg, bg, sse2_mix_ratio(m)));
+    }
+
+    if(x < len) swar_fill_mask(&dest[x], len - x, color, opa, &mask[x]);
+}
+
+static void LV_ATTRIBUTE_FAST_MEM sse2_map_opa(lv_color_t * dest, const lv_color_t * src, int32_t len, lv_opa_t opa)
+{
+    const __m128i mix = _mm_set1_epi16((int16_t)mix_ratio(opa));
+
+    int32_t x;
+    for(x = 0; x <= len - 8; x += 8) {
+        __m128i fg = _mm_loadu_si128((const __m128i *)&src[x]);
+        __m128i bg = _mm_loadu_si128((const __m128i *)&dest[x]);
+        _mm_storeu_si128((__m128i *)&dest[x], sse2_mix(fg, bg, mix));
+    }
+
+    if(x < len) swar_map_opa(&dest[x], &src[x], len - x, opa);
+}
+
+static void LV_ATTRIBUTE_FAST_MEM sse2_map_mask(lv_color_t * dest, const lv_color_t * src, int32_t len, lv_opa_t opa,
+                                                const lv_opa_t * mask)
+{
+    const __m128i opa_v = _mm_set1_epi16(opa);
+    const __m128i cover = _mm_set1_epi16(LV_OPA_COVER);
+    const __m128i below_max = _mm_set1_epi16(LV_OPA_MAX - 1);
+    const __m128i zero = _mm_setzero_si128();
+
+    int32_t x;
+    for(x = 0; x <= len - 8; x += 8) {
+        __m128i m = sse2_load_mask(&mask[x]);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi16(m, zero)) == 0xFFFF) continue;
+        __m128i fg = _mm_loadu_si128((const __m128i *)&src[x]);
+        if(opa <= LV_OPA_MAX) {
+            __m128i is_max = _mm_cmpgt_epi16(m, below_max);
+            __m128i scaled = _mm_srli_epi16(_mm_mullo_epi16(m, opa_v), 8);
+            m = _mm_or_si128(_mm_and_si128(is_max, opa_v), _mm_andnot_si128(is_max, scaled));
+        }
+        else if(_mm_movemask_epi8(_mm_cmpeq_epi16(m, cover)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i *)&dest[x], fg);
+            continue;
+        }
+        __m128i bg = _mm_loadu_si128((const __m128i *)&dest[x]);
+        _mm_storeu_si128((__m128i *)&dest[x], sse2_mix(fg, bg, sse2_mix_ratio(m)));
+    }
+
+    if(x < len) swar_map_mask(&dest[x], &src[x], len - x, opa, &mask[x]);
+}
+
+#endif /*_LV_DRAW_SW_BLEND_SSE2*/
@@ -0,0 +1,74 @@
+/**
+ * @file lv_draw_sw_blend_kernels.h
+ *
+ */
+
+#ifndef LV_DRAW_SW_BLEND_KERNELS_H
+#define LV_DRAW_SW_BLEND_KERNELS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_blend.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*The kernels reproduce the 16 bit `lv_color_mix()` on little endian systems*/
+#if LV_COLOR_DEPTH == 16 && LV_COLOR_MIX_ROUND_OFS == 0 && LV_BIG_ENDIAN_SYSTEM == 0
+#define _LV_DRAW_SW_BLEND_KERNELS 1
+#else
+#define _LV_DRAW_SW_BLEND_KERNELS 0
+#endif
+
+#if _LV_DRAW_SW_BLEND_KERNELS && defined(__SSE2__)
+#define _LV_DRAW_SW_BLEND_SSE2 1
+#else
+#define _LV_DRAW_SW_BLEND_SSE2 0
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Blend one row of `len` pixels with the normal blend mode. They give the same pixels as the
+ * per pixel code of `lv_draw_sw_blend_basic()`, including its rounding.
+ */
+typedef struct {
+    /*No mask, `opa < LV_OPA_MAX`*/
+    void (*fill_opa)(lv_color_t * dest, int32_t len, lv_color_t color, lv_opa_t opa);
+    void (*fill_mask)(lv_color_t * dest, int32_t len, lv_color_t color, lv_opa_t opa, const lv_opa_t * mask);
+    /*No mask, `opa < LV_OPA_MAX`*/
+    void (*map_opa)(lv_color_t * dest, const lv_color_t * src, int32_t len, lv_opa_t opa);
+    void (*map_mask)(lv_color_t * dest, const lv_color_t * src, int32_t len, lv_opa_t opa, const lv_opa_t * mask);
+} _lv_draw_sw_blend_kernel_table_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Select the fastest kernels available on this build. Called by `lv_draw_init()`.
+ */
+void _lv_draw_sw_blend_kernels_init(void);
+
+/**
+ * Get the row kernels selected with `lv_draw_sw_blend_set_kernels()`
+ * @return the kernels or NULL if blending pixel by pixel
+ */
+const _lv_draw_sw_blend_kernel_table_t * _lv_draw_sw_blend_get_kernel_table(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_BLEND_KERNELS_H*/
@@ -11,9 +11,27 @@
 #include "../../misc/lv_color.h"
 
 /**********************
- *   STATIC FUNCTIONS
+ *  STATIC VARIABLES
  **********************/
+static const uint8_t dither_ordered_threshold_matrix[8 * 8] = {
+    0,  48, 12, 60,  3, 51, 15, 63,
+    32, 16, 44, 28, 35, 19, 47, 31,
+    8,  56,  4, 52, 11, 59,  7, 55,
+    40, 24, 36, 20, 43, 27, 39, 23,
+    2,  50, 14, 62,  1, 49, 13, 61,
+    34, 18, 46, 30, 33, 17, 45, 29,
+    10, 58,  6, 54,  9, 57,  5, 53,
+    42, 26, 38, 22, 41, 25, 37, 21
+}; /* Shift by 6 to normalize */
 
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+const uint8_t * lv_dither_ordered_row(lv_coord_t y)
+{
+    return &dither_ordered_threshold_matrix[(y & 7) * 8];
+}
 
 #if _DITHER_GRADIENT
 
@@ -28,16 +46,6 @@ void LV_ATTRIBUTE_FAST_MEM lv_dither_none(lv_grad_t * grad, lv_coord_t x, lv_coo
     grad->filled = 1;
 }
 
-static const uint8_t dither_ordered_threshold_matrix[8 * 8] = {
-    0,  48, 12, 60,  3, 51, 15, 63,
-    32, 16, 44, 28, 35, 19, 47, 31,
-    8,  56,  4, 52, 11, 59,  7, 55,
-    40, 24, 36, 20, 43, 27, 39, 23,
-    2,  50, 14, 62,  1, 49, 13, 61,
-    34, 18, 46, 30, 33, 17, 45, 29,
-    10, 58,  6, 54,  9, 57,  5, 53,
-    42, 26, 38, 22, 41, 25, 37, 21
-}; /* Shift by 6 to normalize */
 
 
 void LV_ATTRIBUTE_FAST_MEM lv_dither_ordered_hor(lv_grad_t * grad, lv_coord_t x, lv_coord_t y, lv_coord_t w)
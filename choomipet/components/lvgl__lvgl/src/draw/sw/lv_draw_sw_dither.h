@@ -43,6 +43,14 @@ typedef void (*lv_dither_func_t)(struct _lv_gradient_cache_t * grad, lv_coord_t
 /**********************
  *    PROTOTYPES
  **********************/
+
+/**
+ * Get a row of the 8x8 ordered (Bayer) dither matrix used for gradients.
+ * Lets other quantizers, e.g. a display driver reducing RGB565 to RGB444, share the same pattern.
+ * @param y     the pixel's row, only its 3 lower bits are used
+ * @return      8 thresholds in 0..63, index it with `x & 7`
+ */
+const uint8_t * lv_dither_ordered_row(lv_coord_t y);
 #if LV_DRAW_COMPLEX
 #if _DITHER_GRADIENT
 void /* LV_ATTRIBUTE_FAST_MEM */ lv_dither_none(struct _lv_gradient_cache_t * grad, lv_coord_t x, lv_coord_t y,
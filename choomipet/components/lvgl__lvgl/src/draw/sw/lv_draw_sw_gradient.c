@@ -9,6 +9,7 @@
 #include "lv_draw_sw_gradient.h"
 #include "../../misc/lv_gc.h"
 #include "../../misc/lv_types.h"
+#include "../../core/lv_refr.h"
 
 /*********************
  *      DEFINES
@@ -28,45 +29,71 @@
     #define ALIGN(X)    (((X) + 3) & ~3)
 #endif
 
-#if LV_GRAD_CACHE_DEF_SIZE != 0 && LV_GRAD_CACHE_DEF_SIZE < 256
-    #error "LV_GRAD_CACHE_DEF_SIZE is too small"
-#endif
+/*Roughly how many maps a cache holds. Sets the size of its hash table*/
+#define GRAD_CACHE_SLOTS    8
+
+/*Number of threads which can have a cache. The others draw without cache*/
+#define GRAD_CACHE_THREADS_MAX  8
 
 /**********************
- *  STATIC PROTOTYPES
+ *      TYPEDEFS
  **********************/
-static lv_grad_t * next_in_cache(lv_grad_t * item);
+/*Everything the map depends on. Descriptors with the same stops share the map wherever they are*/
+typedef struct {
+    lv_coord_t size;        /*Length of the map*/
+    lv_coord_t w;           /*Size of the object while dithering, the map is written line by line*/
+    lv_coord_t h;
+    uint8_t dir;
+    uint8_t dither;
+    uint8_t stops_count;
+    lv_gradient_stop_t stops[LV_GRADIENT_MAX_STOPS];
+} grad_key_t;
 
-typedef lv_res_t (*op_cache_t)(lv_grad_t * c, void * ctx);
-static lv_res_t iterate_cache(op_cache_t func, void * ctx, lv_grad_t ** out);
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void make_key(grad_key_t * key, const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h);
 static size_t get_cache_item_size(lv_grad_t * c);
-static lv_grad_t * allocate_item(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h);
-static lv_res_t find_oldest_item_life(lv_grad_t * c, void * ctx);
-static lv_res_t kill_oldest_item(lv_grad_t * c, void * ctx);
-static lv_res_t find_item(lv_grad_t * c, void * ctx);
-static void free_item(lv_grad_t * c);
-static  uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h);
+static lv_grad_t * allocate_item(const grad_key_t * key, lv_coord_t w, lv_coord_t h);
+static void /* LV_ATTRIBUTE_FAST_MEM */ fill_map(const lv_grad_dsc_t * dsc, lv_grad_color_t * map, lv_coord_t size);
+static lv_lru_t * get_cache(void);
+static void free_caches(void);
+static void evicted_cb(void * v);
 
 
 /**********************
  *   STATIC VARIABLE
  **********************/
-static size_t    grad_cache_size = 0;
-static uint8_t * grad_cache_end = 0;
+static size_t grad_cache_size = LV_GRAD_CACHE_DEF_SIZE;
+static uint32_t grad_cache_gen = 1;
+static uint32_t grad_hit_cnt;
+static uint32_t grad_miss_cnt;
+static uint32_t grad_evict_cnt;
+static uint32_t grad_used_size;
+static LV_RENDER_LOCAL uint32_t grad_cache_local_gen;
+static lv_lru_t * grad_caches[GRAD_CACHE_THREADS_MAX];     /*The cache of every thread, to free them from any*/
+static LV_RENDER_LOCAL lv_grad_t * grad_in_use;    /*Returned by `lv_gradient_get()` and not cleaned up yet*/
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
-union void_cast {
-    const void * ptr;
-    const uint32_t value;
-};
-
-static uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t size, lv_coord_t w)
+static void make_key(grad_key_t * key, const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
 {
-    union void_cast v;
-    v.ptr = g;
-    return (v.value ^ size ^ (w >> 1)); /*Yes, this is correct, it's like a hash that changes if the width changes*/
+    lv_memset_00(key, sizeof(grad_key_t));
+    key->size = g->dir == LV_GRAD_DIR_HOR ? w : h;
+    key->dir = g->dir;
+#if _DITHER_GRADIENT
+    key->dither = g->dither;
+    if(g->dither != LV_DITHER_NONE) {
+        key->w = w;
+        key->h = h;
+    }
+#endif
+    key->stops_count = g->stops_count;
+    for(uint8_t i = 0; i < g->stops_count; i++) {
+        key->stops[i].color = g->stops[i].color;
+        key->stops[i].frac = g->stops[i].frac;
+    }
 }
 
 static size_t get_cache_item_size(lv_grad_t * c)
@@ -81,151 +108,164 @@ static size_t get_cache_item_size(lv_grad_t * c)
     return s;
 }
 
-static lv_grad_t * next_in_cache(lv_grad_t * item)
+static lv_grad_t * allocate_item(const grad_key_t * key, lv_coord_t w, lv_coord_t h)
 {
-    if(grad_cache_size == 0) return NULL;
-
-    if(item == NULL)
-        return (lv_grad_t *)LV_GC_ROOT(_lv_grad_cache_mem);
-
-    size_t s = get_cache_item_size(item);
-    /*Compute the size for this cache item*/
-    if((uint8_t *)item + s >= grad_cache_end) return NULL;
-    else return (lv_grad_t *)((uint8_t *)item + s);
-}
+    lv_coord_t size = key->size;
+    lv_coord_t map_size = size;
+#if _DITHER_GRADIENT
+    /* The map is being used horizontally (width) while dithering, else only `size` is used */
+    if(key->dither != LV_DITHER_NONE) map_size = LV_MAX(w, h);
+#else
+    LV_UNUSED(w);
+    LV_UNUSED(h);
+#endif
 
-static lv_res_t iterate_cache(op_cache_t func, void * ctx, lv_grad_t ** out)
-{
-    lv_grad_t * first = next_in_cache(NULL);
-    while(first != NULL && first->life) {
-        if((*func)(first, ctx) == LV_RES_OK) {
-            if(out != NULL) *out = first;
-            return LV_RES_OK;
-        }
-        first = next_in_cache(first);
-    }
-    return LV_RES_INV;
-}
+    size_t req_size = ALIGN(sizeof(lv_grad_t)) + ALIGN(map_size * sizeof(lv_color_t));
+#if _DITHER_GRADIENT
+    req_size += ALIGN(size * sizeof(lv_color32_t));
+#if LV_DITHER_ERROR_DIFFUSION == 1
+    req_size += ALIGN(key->w * sizeof(lv_scolor24_t));
+#endif
+#endif
 
-static lv_res_t find_oldest_item_life(lv_grad_t * c, void * ctx)
-{
-    uint32_t * min_life = (uint32_t *)ctx;
-    if(c->life < *min_life) *min_life = c->life;
-    return LV_RES_INV;
-}
+    lv_grad_t * item = lv_mem_alloc(req_size);
+    LV_ASSERT_MALLOC(item);
+    if(item == NULL) return NULL;
 
-static void free_item(lv_grad_t * c)
-{
-    size_t size = get_cache_item_size(c);
-    size_t next_items_size = (size_t)(grad_cache_end - (uint8_t *)c) - size;
-    grad_cache_end -= size;
-    if(next_items_size) {
-        uint8_t * old = (uint8_t *)c;
-        lv_memcpy(c, ((uint8_t *)c) + size, next_items_size);
-        /* Then need to fix all internal pointers too */
-        while((uint8_t *)c != grad_cache_end) {
-            c->map = (lv_color_t *)(((uint8_t *)c->map) - size);
+    item->filled = 0;
+    item->not_cached = 1;
+    item->alloc_size = map_size;
+    item->size = size;
+    uint8_t * p = (uint8_t *)item;
+    item->map = (lv_color_t *)(p + ALIGN(sizeof(*item)));
 #if _DITHER_GRADIENT
-            c->hmap = (lv_color32_t *)(((uint8_t *)c->hmap) - size);
+    item->hmap = (lv_color32_t *)(p + ALIGN(sizeof(*item)) + ALIGN(map_size * sizeof(lv_color_t)));
 #if LV_DITHER_ERROR_DIFFUSION == 1
-            c->error_acc = (lv_scolor24_t *)(((uint8_t *)c->error_acc) - size);
+    item->error_acc = (lv_scolor24_t *)(p + ALIGN(sizeof(*item)) + ALIGN(size * sizeof(lv_color32_t)) +
+                                        ALIGN(map_size * sizeof(lv_color_t)));
+    item->w = key->w;
 #endif
 #endif
-            c = (lv_grad_t *)(((uint8_t *)c) + get_cache_item_size(c));
-        }
-        lv_memset_00(old + next_items_size, size);
-    }
+    return item;
 }
 
-static lv_res_t kill_oldest_item(lv_grad_t * c, void * ctx)
+/**
+ * Fill `map` with the same colors as `lv_gradient_calculate()` gives for [0; size).
+ * The stops are walked once instead of searched for every pixel,
+ * and the mix of a segment is stepped without division.
+ */
+static void LV_ATTRIBUTE_FAST_MEM fill_map(const lv_grad_dsc_t * dsc, lv_grad_color_t * map, lv_coord_t size)
 {
-    uint32_t * min_life = (uint32_t *)ctx;
-    if(c->life == *min_life) {
-        /*Found, let's kill it*/
-        free_item(c);
-        return LV_RES_OK;
+    uint8_t last = dsc->stops_count - 1;
+    int32_t min = (dsc->stops[0].frac * size) >> 8;
+    int32_t max = (dsc->stops[last].frac * size) >> 8;
+    lv_grad_color_t c;
+
+    /*Clip out-of-bounds first*/
+    int32_t i;
+    GRAD_CONV(c, dsc->stops[0].color);
+    for(i = 0; i < size && i <= min; i++) map[i] = c;
+
+    /*A pixel belongs to the first stop not before it. As `i` is right after the furthest stop so far,
+     *the pixels up to the current stop belong to it (none if the stops go backward)*/
+    int32_t mid_end = LV_MIN(max, size);
+    int32_t prev = min;
+    for(uint8_t s = 1; s <= last && i < mid_end; s++) {
+        int32_t cur = (dsc->stops[s].frac * size) >> 8;
+        int32_t seg_end = LV_MIN(cur + 1, mid_end);
+        if(i < seg_end) {
+            lv_color32_t one, two;
+            one.full = lv_color_to32(dsc->stops[s - 1].color);
+            two.full = lv_color_to32(dsc->stops[s].color);
+
+            /*mix = (i - prev) * 255 / d, stepped by 255 / d and its remainder*/
+            int32_t d = cur - prev;
+            int32_t step_q = 255 / d;
+            int32_t step_r = 255 % d;
+            int32_t q = ((i - prev) * 255) / d;
+            int32_t r = ((i - prev) * 255) % d;
+            for(; i < seg_end; i++) {
+                lv_opa_t mix = (lv_opa_t)q;
+                lv_opa_t imix = 255 - mix;
+                lv_grad_color_t px = GRAD_CM(LV_UDIV255(two.ch.red * mix   + one.ch.red * imix),
+                                             LV_UDIV255(two.ch.green * mix + one.ch.green * imix),
+                                             LV_UDIV255(two.ch.blue * mix  + one.ch.blue * imix));
+                map[i] = px;
+                q += step_q;
+                r += step_r;
+                if(r >= d) {
+                    r -= d;
+                    q++;
+                }
+            }
+        }
+        prev = cur;
     }
-    return LV_RES_INV;
+
+    GRAD_CONV(c, dsc->stops[last].color);
+    for(; i < size; i++) map[i] = c;
 }
 
-static lv_res_t find_item(lv_grad_t * c, void * ctx)
+static lv_lru_t * get_cache(void)
 {
-    uint32_t * k = (uint32_t *)ctx;
-    if(c->key == *k) return LV_RES_OK;
-    return LV_RES_INV;
+    _lv_refr_lock();
+    uint32_t gen = grad_cache_gen;
+    size_t cache_size = grad_cache_size;
+    _lv_refr_unlock();
+    if(grad_cache_local_gen == gen) return LV_GC_ROOT(_lv_grad_cache_lru);
+
+    /*Created with an earlier size, or not yet. An earlier one was freed by `free_caches()`.
+     *The rendering threads have a cache each*/
+    LV_GC_ROOT(_lv_grad_cache_lru) = NULL;
+    grad_cache_local_gen = gen;
+    if(cache_size == 0) return NULL;
+
+    size_t average_size = LV_MAX(cache_size / GRAD_CACHE_SLOTS, 1);
+    lv_lru_t * lru = lv_lru_create(cache_size, average_size, evicted_cb, NULL);
+    LV_ASSERT_MALLOC(lru);
+    if(lru == NULL) return NULL;
+
+    _lv_refr_lock();
+    uint32_t i = 0;
+    while(i < GRAD_CACHE_THREADS_MAX && grad_caches[i]) i++;
+    if(i < GRAD_CACHE_THREADS_MAX) grad_caches[i] = lru;
+    else lv_lru_del(lru);
+    _lv_refr_unlock();
+    if(i == GRAD_CACHE_THREADS_MAX) return NULL;
+
+    LV_GC_ROOT(_lv_grad_cache_lru) = lru;
+    return lru;
 }
 
-static lv_grad_t * allocate_item(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
+/**
+ * Free the cache of every thread. The threads notice it from the generation and create a new one.
+ */
+static void free_caches(void)
 {
-    lv_coord_t size = g->dir == LV_GRAD_DIR_HOR ? w : h;
-    lv_coord_t map_size = LV_MAX(w, h); /* The map is being used horizontally (width) unless
-                                           no dithering is selected where it's used vertically */
-
-    size_t req_size = ALIGN(sizeof(lv_grad_t)) + ALIGN(map_size * sizeof(lv_color_t));
-#if _DITHER_GRADIENT
-    req_size += ALIGN(size * sizeof(lv_color32_t));
-#if LV_DITHER_ERROR_DIFFUSION == 1
-    req_size += ALIGN(w * sizeof(lv_scolor24_t));
-#endif
-#endif
-
-    size_t act_size = (size_t)(grad_cache_end - LV_GC_ROOT(_lv_grad_cache_mem));
-    lv_grad_t * item = NULL;
-    if(req_size + act_size < grad_cache_size) {
-        item = (lv_grad_t *)grad_cache_end;
-        item->not_cached = 0;
-    }
-    else {
-        /*Need to evict items from cache until we find enough space to allocate this one */
-        if(req_size <= grad_cache_size) {
-            while(act_size + req_size > grad_cache_size) {
-                uint32_t oldest_life = UINT32_MAX;
-                iterate_cache(&find_oldest_item_life, &oldest_life, NULL);
-                iterate_cache(&kill_oldest_item, &oldest_life, NULL);
-                act_size = (size_t)(grad_cache_end - LV_GC_ROOT(_lv_grad_cache_mem));
-            }
-            item = (lv_grad_t *)grad_cache_end;
-            item->not_cached = 0;
-        }
-        else {
-            /*The cache is too small. Allocate the item manually and free it later.*/
-            item = lv_mem_alloc(req_size);
-            LV_ASSERT_MALLOC(item);
-            if(item == NULL) return NULL;
-            item->not_cached = 1;
+    _lv_refr_lock();
+    uint32_t i;
+    for(i = 0; i < GRAD_CACHE_THREADS_MAX; i++) {
+        if(grad_caches[i]) {
+            lv_lru_del(grad_caches[i]);
+            grad_caches[i] = NULL;
         }
     }
+    grad_cache_gen++;
+    _lv_refr_unlock();
+    LV_GC_ROOT(_lv_grad_cache_lru) = NULL;
+}
 
-    item->key = compute_key(g, size, w);
-    item->life = 1;
-    item->filled = 0;
-    item->alloc_size = map_size;
-    item->size = size;
-    if(item->not_cached) {
-        uint8_t * p = (uint8_t *)item;
-        item->map = (lv_color_t *)(p + ALIGN(sizeof(*item)));
-#if _DITHER_GRADIENT
-        item->hmap = (lv_color32_t *)(p + ALIGN(sizeof(*item)) + ALIGN(map_size * sizeof(lv_color_t)));
-#if LV_DITHER_ERROR_DIFFUSION == 1
-        item->error_acc = (lv_scolor24_t *)(p + ALIGN(sizeof(*item)) + ALIGN(size * sizeof(lv_grad_color_t)) +
-                                            ALIGN(map_size * sizeof(lv_color_t)));
-        item->w = w;
-#endif
-#endif
-    }
-    else {
-        item->map = (lv_color_t *)(grad_cache_end + ALIGN(sizeof(*item)));
-#if _DITHER_GRADIENT
-        item->hmap = (lv_color32_t *)(grad_cache_end + ALIGN(sizeof(*item)) + ALIGN(map_size * sizeof(lv_color_t)));
-#if LV_DITHER_ERROR_DIFFUSION == 1
-        item->error_acc = (lv_scolor24_t *)(grad_cache_end + ALIGN(sizeof(*item)) + ALIGN(size * sizeof(lv_grad_color_t)) +
-                                            ALIGN(map_size * sizeof(lv_color_t)));
-        item->w = w;
-#endif
-#endif
-        grad_cache_end += req_size;
+static void evicted_cb(void * v)
+{
+    grad_evict_cnt++;
+    grad_used_size -= get_cache_item_size(v);
+
+    /*Drawn now, it's freed by `lv_gradient_cleanup()`*/
+    if(v == grad_in_use) {
+        grad_in_use->not_cached = 1;
+        return;
     }
-    return item;
+    lv_mem_free(v);
 }
 
 
@@ -234,18 +274,41 @@ static lv_grad_t * allocate_item(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord
  **********************/
 void lv_gradient_free_cache(void)
 {
-    lv_mem_free(LV_GC_ROOT(_lv_grad_cache_mem));
-    LV_GC_ROOT(_lv_grad_cache_mem) = grad_cache_end = NULL;
-    grad_cache_size = 0;
+    free_caches();
+}
+
+bool _lv_gradient_evict_lru(void)
+{
+    lv_lru_t * lru = LV_GC_ROOT(_lv_grad_cache_lru);
+    if(lru == NULL || lru->free_memory == lru->total_memory) return false;
+
+    _lv_refr_lock();
+    lv_lru_remove_lru_item(lru);
+    _lv_refr_unlock();
+    return true;
 }
 
 void lv_gradient_set_cache_size(size_t max_bytes)
 {
-    lv_mem_free(LV_GC_ROOT(_lv_grad_cache_mem));
-    grad_cache_end = LV_GC_ROOT(_lv_grad_cache_mem) = lv_mem_alloc(max_bytes);
-    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_grad_cache_mem));
-    lv_memset_00(LV_GC_ROOT(_lv_grad_cache_mem), max_bytes);
+    free_caches();
+
+    _lv_refr_lock();
     grad_cache_size = max_bytes;
+    grad_hit_cnt = 0;
+    grad_miss_cnt = 0;
+    grad_evict_cnt = 0;
+    _lv_refr_unlock();
+}
+
+void lv_gradient_cache_monitor(lv_grad_cache_monitor_t * mon_p)
+{
+    _lv_refr_lock();
+    mon_p->hit_cnt = grad_hit_cnt;
+    mon_p->miss_cnt = grad_miss_cnt;
+    mon_p->evict_cnt = grad_evict_cnt;
+    mon_p->used_size = grad_used_size;
+    mon_p->total_size = grad_cache_size;
+    _lv_refr_unlock();
 }
 
 lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
@@ -253,43 +316,53 @@ lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
     /* No gradient, no cache */
     if(g->dir == LV_GRAD_DIR_NONE) return NULL;
 
-    /* Step 0: Check if the cache exist (else create it) */
-    static bool inited = false;
-    if(!inited) {
-        lv_gradient_set_cache_size(LV_GRAD_CACHE_DEF_SIZE);
-        inited = true;
-    }
-
-    /* Step 1: Search cache for the given key */
-    lv_coord_t size = g->dir == LV_GRAD_DIR_HOR ? w : h;
-    uint32_t key = compute_key(g, size, w);
+    /* Step 1: Search the cache for the same stops, size and dithering */
+    grad_key_t key;
+    make_key(&key, g, w, h);
+    lv_lru_t * lru = get_cache();
     lv_grad_t * item = NULL;
-    if(iterate_cache(&find_item, &key, &item) == LV_RES_OK) {
-        item->life++; /* Don't forget to bump the counter */
+    if(lru) lv_lru_get(lru, &key, sizeof(key), (void **)&item);
+    if(item) {
+#if _DITHER_GRADIENT && LV_DITHER_ERROR_DIFFUSION == 1
+        /* Diffuse the error from the top again, as with a new map */
+        lv_memset_00(item->error_acc, item->w * sizeof(lv_scolor24_t));
+#endif
+        _lv_refr_lock();
+        grad_hit_cnt++;
+        _lv_refr_unlock();
+        grad_in_use = item;
         return item;
     }
 
     /* Step 2: Need to allocate an item for it */
-    item = allocate_item(g, w, h);
+    item = allocate_item(&key, w, h);
     if(item == NULL) {
-        LV_LOG_WARN("Faild to allcoate item for teh gradient");
+        LV_LOG_WARN("Failed to allocate item for the gradient");
         return item;
     }
 
     /* Step 3: Fill it with the gradient, as expected */
 #if _DITHER_GRADIENT
-    for(lv_coord_t i = 0; i < item->size; i++) {
-        item->hmap[i] = lv_gradient_calculate(g, item->size, i);
-    }
+    fill_map(g, item->hmap, item->size);
 #if LV_DITHER_ERROR_DIFFUSION == 1
-    lv_memset_00(item->error_acc, w * sizeof(lv_scolor24_t));
+    lv_memset_00(item->error_acc, item->w * sizeof(lv_scolor24_t));
 #endif
 #else
-    for(lv_coord_t i = 0; i < item->size; i++) {
-        item->map[i] = lv_gradient_calculate(g, item->size, i);
-    }
+    fill_map(g, item->map, item->size);
 #endif
 
+    /* Step 4: Keep it for the next bands and frames. If it doesn't fit it's freed after drawing */
+    size_t item_size = get_cache_item_size(item);
+    _lv_refr_lock();
+    grad_miss_cnt++;
+    if(lru && item_size <= lru->total_memory &&
+       lv_lru_set(lru, &key, sizeof(key), item, item_size) == LV_LRU_OK) {
+        item->not_cached = 0;
+        grad_used_size += item_size;
+    }
+    _lv_refr_unlock();
+
+    grad_in_use = item;
     return item;
 }
 
@@ -340,6 +413,7 @@ lv_grad_color_t LV_ATTRIBUTE_FAST_MEM lv_gradient_calculate(const lv_grad_dsc_t
 
 void lv_gradient_cleanup(lv_grad_t * grad)
 {
+    if(grad == grad_in_use) grad_in_use = NULL;
     if(grad->not_cached) {
         lv_mem_free(grad);
     }
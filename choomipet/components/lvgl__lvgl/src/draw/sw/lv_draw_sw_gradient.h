@@ -38,27 +38,31 @@ typedef lv_color_t lv_grad_color_t;
  *  it's possible to cache the computation in this structure instance.
  *  Whenever possible, this structure is reused instead of recomputing the gradient map */
 typedef struct _lv_gradient_cache_t {
-    uint32_t        key;          /**< A discriminating key that's built from the drawing operation.
-                                   * If the key does not match, the cache item is not used */
-    uint32_t        life : 30;    /**< A life counter that's incremented on usage. Higher counter is
-                                   * less likely to be evicted from the cache */
     uint32_t        filled : 1;   /**< Used to skip dithering in it if already done */
     uint32_t        not_cached: 1; /**< The cache was too small so this item is not managed by the cache*/
     lv_color_t   *  map;          /**< The computed gradient low bitdepth color map, points into the
-                                   * cache's buffer, no free needed */
+                                   * item's allocation, no free needed */
     lv_coord_t      alloc_size;   /**< The map allocated size in colors */
     lv_coord_t      size;         /**< The computed gradient color map size, in colors */
 #if _DITHER_GRADIENT
     lv_color32_t  * hmap;         /**< If dithering, we need to store the current, high bitdepth gradient
-                                   * map too, points to the cache's buffer, no free needed */
+                                   * map too, points to the item's allocation, no free needed */
 #if LV_DITHER_ERROR_DIFFUSION == 1
     lv_scolor24_t * error_acc;    /**< Error diffusion dithering algorithm requires storing the last error
-                                   * drawn, points to the cache's buffer, no free needed  */
+                                   * drawn, points to the item's allocation, no free needed  */
     lv_coord_t      w;            /**< The error array width in pixels */
 #endif
 #endif
 } lv_grad_t;
 
+typedef struct {
+    uint32_t hit_cnt;       /**< Maps found in the cache*/
+    uint32_t miss_cnt;      /**< Maps which had to be computed*/
+    uint32_t evict_cnt;     /**< Maps dropped to make room for others*/
+    uint32_t used_size;     /**< RAM kept by the cached maps*/
+    uint32_t total_size;    /**< Memory size of the cache. Each rendering thread has one of this size*/
+} lv_grad_cache_monitor_t;
+
 
 /**********************
  *      PROTOTYPES
@@ -73,19 +77,42 @@ lv_grad_color_t /* LV_ATTRIBUTE_FAST_MEM */ lv_gradient_calculate(const lv_grad_
                                                                   lv_coord_t frac);
 
 /**
- * Set the gradient cache size
- * @param max_bytes Max cahce size
+ * Set the gradient cache size. The least recently used maps are dropped when it's full.
+ * @param max_bytes Max cache size, 0: don't cache the maps
  */
 void lv_gradient_set_cache_size(size_t max_bytes);
 
-/** Free the gradient cache */
+/**
+ * Free the gradient cache of every thread, e.g. when the rendering threads are stopped. Called by `lv_deinit()`.
+ * The size is kept: the caches fill again as gradients are drawn.
+ */
 void lv_gradient_free_cache(void);
 
-/** Get a gradient cache from the given parameters */
+/**
+ * Drop the least recently used gradient of the calling thread's cache to free memory, see `lv_mem_alloc()`.
+ * The gradient being drawn is freed by `lv_gradient_cleanup()`.
+ * @return false if the cache is empty
+ */
+bool _lv_gradient_evict_lru(void);
+
+/**
+ * Get the statistics of the gradient cache
+ * @param mon_p     pointer to a `lv_grad_cache_monitor_t` variable, the result will be stored here
+ */
+void lv_gradient_cache_monitor(lv_grad_cache_monitor_t * mon_p);
+
+/**
+ * Get the color map of a gradient from the cache or compute it.
+ * Gradients with the same stops, direction, dithering and size share a map.
+ * @param gradient  the gradient
+ * @param w         width of the object
+ * @param h         height of the object
+ * @return          the map, release it with `lv_gradient_cleanup()`. NULL if no gradient or out of memory
+ */
 lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * gradient, lv_coord_t w, lv_coord_t h);
 
 /**
- * Clean up the gradient item after it was get with `lv_grad_get_from_cache`.
+ * Clean up the gradient item after it was get with `lv_gradient_get`.
  * @param grad      pointer to a gradient
  */
 void lv_gradient_cleanup(lv_grad_t * grad);
@@ -11,7 +11,9 @@
 #include "../../misc/lv_txt_ap.h"
 #include "../../core/lv_refr.h"
 #include "../../misc/lv_assert.h"
+#include "../../misc/lv_gc.h"
 #include "lv_draw_sw_dither.h"
+#include <string.h>
 
 /*********************
  *      DEFINES
@@ -19,12 +21,30 @@
 #define SHADOW_UPSCALE_SHIFT    6
 #define SHADOW_ENHANCE          1
 #define SPLIT_LIMIT             50
+#define SHADOW_CACHE_SLOTS      16  /*Most corners in the shadow cache*/
 
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/*A shadow corner depends only on these. The sides of the blurred rectangle are clamped to
+ *2 * (sw + r) because the farther edges and corners don't reach into the corner*/
+typedef struct {
+    lv_coord_t sw;
+    lv_coord_t r;
+    lv_coord_t w;
+    lv_coord_t h;
+} shadow_key_t;
+
+/*A corner in the shadow cache: `size` opacities from `ofs` in `sh_cache_mem`*/
+typedef struct {
+    shadow_key_t key;
+    uint32_t ofs;
+    uint32_t size;
+    uint32_t last_use;
+} shadow_cache_entry_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -40,6 +60,14 @@ static void /* LV_ATTRIBUTE_FAST_MEM */ draw_shadow(lv_draw_ctx_t * draw_ctx, co
 static void /* LV_ATTRIBUTE_FAST_MEM */ shadow_draw_corner_buf(const lv_area_t * coords, uint16_t * sh_buf,
                                                                lv_coord_t s, lv_coord_t r);
 static void /* LV_ATTRIBUTE_FAST_MEM */ shadow_blur_corner(lv_coord_t size, lv_coord_t sw, uint16_t * sh_ups_buf);
+static int32_t shadow_get_core(const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords, lv_area_t * core_area);
+static void shadow_make_key(shadow_key_t * key, const lv_area_t * core_area, lv_coord_t sw, int32_t r);
+static lv_opa_t * shadow_get_corner(const lv_area_t * core_area, lv_coord_t sw, int32_t r);
+#if LV_SHADOW_CACHE_DEF
+    static const lv_opa_t * shadow_cache_get(const shadow_key_t * key);
+    static void shadow_cache_add(const shadow_key_t * key, const lv_opa_t * map, uint32_t size);
+    static void shadow_cache_evict(uint32_t i);
+#endif
 #endif
 
 void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area, const lv_area_t * inner_area,
@@ -52,10 +80,25 @@ static void draw_border_simple(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer
 /**********************
  *  STATIC VARIABLES
  **********************/
-#if defined(LV_SHADOW_CACHE_SIZE) && LV_SHADOW_CACHE_SIZE > 0
-    static uint8_t sh_cache[LV_SHADOW_CACHE_SIZE * LV_SHADOW_CACHE_SIZE];
-    static int32_t sh_cache_size = -1;
-    static int32_t sh_cache_r = -1;
+#if LV_DRAW_COMPLEX
+    static const lv_draw_sw_shadow_corner_t * sh_baked;
+    static uint32_t sh_baked_cnt;
+    static uint32_t sh_baked_hit_cnt;
+    static uint32_t sh_miss_cnt;
+#endif
+
+#if LV_SHADOW_CACHE_DEF
+    /*Like the single corner of the original cache, the corners are kept in a static array and not in the heap,
+     *so caching them doesn't change how the heap is laid out. They are packed from the beginning in the order
+     *of `sh_cache`*/
+    static uint8_t sh_cache_mem[LV_SHADOW_CACHE_MEM_SIZE];
+    static shadow_cache_entry_t sh_cache[SHADOW_CACHE_SLOTS];
+    static uint32_t sh_cache_cnt;
+    static uint32_t sh_cache_used;
+    static uint32_t sh_cache_life;
+    static uint32_t sh_cache_mem_size = LV_SHADOW_CACHE_MEM_SIZE;
+    static uint32_t sh_hit_cnt;
+    static uint32_t sh_evict_cnt;
 #endif
 
 /**********************
@@ -92,6 +135,102 @@ void lv_draw_sw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, con
     draw_bg_img(draw_ctx, dsc, coords);
 }
 
+void lv_draw_sw_shadow_cache_set_mem_size(uint32_t new_size)
+{
+#if LV_SHADOW_CACHE_DEF
+    if(new_size > sizeof(sh_cache_mem)) {
+        LV_LOG_WARN("The shadow cache can't be larger than LV_SHADOW_CACHE_MEM_SIZE");
+        new_size = sizeof(sh_cache_mem);
+    }
+    _lv_refr_lock();
+    sh_cache_cnt = 0;
+    sh_cache_used = 0;
+    sh_cache_mem_size = new_size;
+    sh_hit_cnt = 0;
+    sh_evict_cnt = 0;
+    _lv_refr_unlock();
+#else
+    LV_UNUSED(new_size);
+    LV_LOG_WARN("Can't change cache size because it's disabled by LV_SHADOW_CACHE_SIZE = 0");
+#endif
+}
+
+void lv_draw_sw_shadow_cache_free(void)
+{
+#if LV_SHADOW_CACHE_DEF
+    _lv_refr_lock();
+    sh_cache_cnt = 0;
+    sh_cache_used = 0;
+    _lv_refr_unlock();
+#endif
+}
+
+void lv_draw_sw_shadow_cache_monitor(lv_draw_sw_shadow_cache_monitor_t * mon_p)
+{
+    lv_memset_00(mon_p, sizeof(lv_draw_sw_shadow_cache_monitor_t));
+#if LV_DRAW_COMPLEX
+    _lv_refr_lock();
+    mon_p->baked_cnt = sh_baked_hit_cnt;
+    mon_p->miss_cnt = sh_miss_cnt;
+#if LV_SHADOW_CACHE_DEF
+    mon_p->hit_cnt = sh_hit_cnt;
+    mon_p->evict_cnt = sh_evict_cnt;
+    mon_p->used_size = sh_cache_used;
+    mon_p->total_size = sh_cache_mem_size;
+#endif
+    _lv_refr_unlock();
+#endif
+}
+
+void lv_draw_sw_shadow_set_baked(const lv_draw_sw_shadow_corner_t * corners, uint32_t cnt)
+{
+#if LV_DRAW_COMPLEX
+    _lv_refr_lock();
+    sh_baked = corners;
+    sh_baked_cnt = corners ? cnt : 0;
+    sh_baked_hit_cnt = 0;
+    _lv_refr_unlock();
+#else
+    LV_UNUSED(corners);
+    LV_UNUSED(cnt);
+#endif
+}
+
+bool lv_draw_sw_shadow_bake(const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords,
+                            lv_draw_sw_shadow_corner_t * corner)
+{
+    lv_memset_00(corner, sizeof(lv_draw_sw_shadow_corner_t));
+#if LV_DRAW_COMPLEX
+    if(dsc->shadow_width == 0) return false;
+
+    lv_area_t core_area;
+    int32_t r_sh = shadow_get_core(dsc, coords, &core_area);
+    int32_t corner_size = dsc->shadow_width + r_sh;
+    if(corner_size <= 0) return false;
+
+    lv_opa_t * map = lv_mem_alloc(corner_size * corner_size);
+    if(map == NULL) return false;
+
+    uint16_t * sh_buf = lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
+    shadow_draw_corner_buf(&core_area, sh_buf, dsc->shadow_width, r_sh);
+    lv_memcpy(map, sh_buf, corner_size * corner_size);
+    lv_mem_buf_release(sh_buf);
+
+    shadow_key_t key;
+    shadow_make_key(&key, &core_area, dsc->shadow_width, r_sh);
+    corner->width = key.sw;
+    corner->radius = key.r;
+    corner->core_w = key.w;
+    corner->core_h = key.h;
+    corner->map = map;
+    return true;
+#else
+    LV_UNUSED(dsc);
+    LV_UNUSED(coords);
+    return false;
+#endif
+}
+
 
 /**********************
  *   STATIC FUNCTIONS
@@ -117,7 +256,12 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
 
     lv_grad_dir_t grad_dir = dsc->bg_grad.dir;
     lv_color_t bg_color    = grad_dir == LV_GRAD_DIR_NONE ? dsc->bg_color : dsc->bg_grad.stops[0].color;
-    if(bg_color.full == dsc->bg_grad.stops[1].color.full) grad_dir = LV_GRAD_DIR_NONE;
+    /*Draw a plain background if every stop has the same color*/
+    uint8_t stop_i;
+    for(stop_i = 1; stop_i < dsc->bg_grad.stops_count; stop_i++) {
+        if(dsc->bg_grad.stops[stop_i].color.full != bg_color.full) break;
+    }
+    if(stop_i >= dsc->bg_grad.stops_count) grad_dir = LV_GRAD_DIR_NONE;
 
     bool mask_any = lv_draw_mask_is_any(&bg_coords);
     lv_draw_sw_blend_dsc_t blend_dsc = {0};
@@ -161,7 +305,9 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
     blend_area.x1 = clipped_coords.x1;
     blend_area.x2 = clipped_coords.x2;
 
+    lv_draw_mask_runs_t mask_runs;
     blend_dsc.mask_buf = mask_buf;
+    blend_dsc.mask_runs = &mask_runs;
     blend_dsc.blend_area = &blend_area;
     blend_dsc.mask_area = &blend_area;
     blend_dsc.opa = LV_OPA_COVER;
@@ -226,7 +372,7 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
             /* Initialize the mask to opa instead of 0xFF and blend with LV_OPA_COVER.
              * It saves calculating the final opa in lv_draw_sw_blend*/
             lv_memset(mask_buf, opa, clipped_w);
-            blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, clipped_coords.x1, h, clipped_w);
+            blend_dsc.mask_res = lv_draw_mask_apply_runs(mask_buf, clipped_coords.x1, h, clipped_w, &mask_runs);
             if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
 
 #if _DITHER_GRADIENT
@@ -248,7 +394,7 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
         /* Initialize the mask to opa instead of 0xFF and blend with LV_OPA_COVER.
          * It saves calculating the final opa in lv_draw_sw_blend*/
         lv_memset(mask_buf, opa, clipped_w);
-        blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, blend_area.x1, top_y, clipped_w);
+        blend_dsc.mask_res = lv_draw_mask_apply_runs(mask_buf, blend_area.x1, top_y, clipped_w, &mask_runs);
         if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
 
         if(top_y >= clipped_coords.y1) {
@@ -299,7 +445,7 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
             /*If there is no other mask do not apply mask as in the center there is no radius to mask*/
             if(mask_any_center) {
                 lv_memset(mask_buf, opa, clipped_w);
-                blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, clipped_coords.x1, h, clipped_w);
+                blend_dsc.mask_res = lv_draw_mask_apply_runs(mask_buf, clipped_coords.x1, h, clipped_w, &mask_runs);
             }
 
             blend_area.y1 = h;
@@ -444,10 +590,7 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
 
     /*Calculate the rectangle which is blurred to get the shadow in `shadow_area`*/
     lv_area_t core_area;
-    core_area.x1 = coords->x1  + dsc->shadow_ofs_x - dsc->shadow_spread;
-    core_area.x2 = coords->x2  + dsc->shadow_ofs_x + dsc->shadow_spread;
-    core_area.y1 = coords->y1  + dsc->shadow_ofs_y - dsc->shadow_spread;
-    core_area.y2 = coords->y2  + dsc->shadow_ofs_y + dsc->shadow_spread;
+    int32_t r_sh = shadow_get_core(dsc, coords, &core_area);
 
     /*Calculate the bounding box of the shadow*/
     lv_area_t shadow_area;
@@ -474,39 +617,10 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
     lv_coord_t short_side = LV_MIN(lv_area_get_width(&bg_area), lv_area_get_height(&bg_area));
     if(r_bg > short_side >> 1) r_bg = short_side >> 1;
 
-    /*Get the clamped radius*/
-    int32_t r_sh = dsc->radius;
-    short_side = LV_MIN(lv_area_get_width(&core_area), lv_area_get_height(&core_area));
-    if(r_sh > short_side >> 1) r_sh = short_side >> 1;
-
-
     /*Get how many pixels are affected by the blur on the corners*/
     int32_t corner_size = dsc->shadow_width  + r_sh;
 
-    lv_opa_t * sh_buf;
-
-#if LV_SHADOW_CACHE_SIZE
-    if(sh_cache_size == corner_size && sh_cache_r == r_sh) {
-        /*Use the cache if available*/
-        sh_buf = lv_mem_buf_get(corner_size * corner_size);
-        lv_memcpy(sh_buf, sh_cache, corner_size * corner_size);
-    }
-    else {
-        /*A larger buffer is required for calculation*/
-        sh_buf = lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
-        shadow_draw_corner_buf(&core_area, (uint16_t *)sh_buf, dsc->shadow_width, r_sh);
-
-        /*Cache the corner if it fits into the cache size*/
-        if((uint32_t)corner_size * corner_size < sizeof(sh_cache)) {
-            lv_memcpy(sh_cache, sh_buf, corner_size * corner_size);
-            sh_cache_size = corner_size;
-            sh_cache_r = r_sh;
-        }
-    }
-#else
-    sh_buf = lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
-    shadow_draw_corner_buf(&core_area, (uint16_t *)sh_buf, dsc->shadow_width, r_sh);
-#endif
+    lv_opa_t * sh_buf = shadow_get_corner(&core_area, dsc->shadow_width, r_sh);
 
     /*Skip a lot of masking if the background will cover the shadow that would be masked out*/
     bool mask_any = lv_draw_mask_is_any(&shadow_area);
@@ -1109,6 +1223,153 @@ static void LV_ATTRIBUTE_FAST_MEM shadow_blur_corner(lv_coord_t size, lv_coord_t
 
     lv_mem_buf_release(sh_ups_blur_buf);
 }
+
+/**
+ * Get the rectangle which is blurred to get the shadow
+ * @param dsc the style of the rectangle
+ * @param coords the coordinates of the rectangle
+ * @param core_area the blurred rectangle is stored here
+ * @return the radius of the blurred rectangle, clamped to its half short side
+ */
+static int32_t shadow_get_core(const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords, lv_area_t * core_area)
+{
+    core_area->x1 = coords->x1  + dsc->shadow_ofs_x - dsc->shadow_spread;
+    core_area->x2 = coords->x2  + dsc->shadow_ofs_x + dsc->shadow_spread;
+    core_area->y1 = coords->y1  + dsc->shadow_ofs_y - dsc->shadow_spread;
+    core_area->y2 = coords->y2  + dsc->shadow_ofs_y + dsc->shadow_spread;
+
+    int32_t r_sh = dsc->radius;
+    lv_coord_t short_side = LV_MIN(lv_area_get_width(core_area), lv_area_get_height(core_area));
+    if(r_sh > short_side >> 1) r_sh = short_side >> 1;
+    return r_sh;
+}
+
+static void shadow_make_key(shadow_key_t * key, const lv_area_t * core_area, lv_coord_t sw, int32_t r)
+{
+    int32_t side_max = 2 * (sw + r);
+    key->sw = sw;
+    key->r = r;
+    key->w = LV_MIN(lv_area_get_width(core_area), side_max);
+    key->h = LV_MIN(lv_area_get_height(core_area), side_max);
+}
+
+/**
+ * Get the blurred top right corner of a shadow from the baked corners, from the cache or by blurring it.
+ * The new corners are cached if they are not larger than `LV_SHADOW_CACHE_SIZE`.
+ * @param core_area the rectangle to blur
+ * @param sw shadow width
+ * @param r radius of `core_area`, clamped to its half short side
+ * @return `(sw + r)^2` opacities in a buffer from `lv_mem_buf_get()`
+ */
+static lv_opa_t * shadow_get_corner(const lv_area_t * core_area, lv_coord_t sw, int32_t r)
+{
+    int32_t corner_size = sw + r;
+    uint32_t map_size = corner_size * corner_size;
+
+    shadow_key_t key;
+    shadow_make_key(&key, core_area, sw, r);
+
+    /*A larger buffer is required for calculation*/
+    lv_opa_t * sh_buf = lv_mem_buf_get(map_size * sizeof(uint16_t));
+
+    /*The strips rendered in parallel share the corners*/
+    _lv_refr_lock();
+    uint32_t i;
+    for(i = 0; i < sh_baked_cnt; i++) {
+        const lv_draw_sw_shadow_corner_t * baked = &sh_baked[i];
+        if(baked->width == key.sw && baked->radius == key.r && baked->core_w == key.w && baked->core_h == key.h) {
+            lv_memcpy(sh_buf, baked->map, map_size);
+            sh_baked_hit_cnt++;
+            _lv_refr_unlock();
+            return sh_buf;
+        }
+    }
+
+#if LV_SHADOW_CACHE_DEF
+    bool cacheable = corner_size <= LV_SHADOW_CACHE_SIZE;
+    if(cacheable) {
+        const lv_opa_t * cached = shadow_cache_get(&key);
+        if(cached) {
+            lv_memcpy(sh_buf, cached, map_size);
+            sh_hit_cnt++;
+            _lv_refr_unlock();
+            return sh_buf;
+        }
+    }
+#endif
+    sh_miss_cnt++;
+    _lv_refr_unlock();
+
+    shadow_draw_corner_buf(core_area, (uint16_t *)sh_buf, sw, r);
+
+#if LV_SHADOW_CACHE_DEF
+    if(cacheable) {
+        _lv_refr_lock();
+        shadow_cache_add(&key, sh_buf, map_size);
+        _lv_refr_unlock();
+    }
+#endif
+
+    return sh_buf;
+}
+
+#if LV_SHADOW_CACHE_DEF
+static const lv_opa_t * shadow_cache_get(const shadow_key_t * key)
+{
+    uint32_t i;
+    for(i = 0; i < sh_cache_cnt; i++) {
+        const shadow_key_t * k = &sh_cache[i].key;
+        if(k->sw == key->sw && k->r == key->r && k->w == key->w && k->h == key->h) {
+            sh_cache[i].last_use = ++sh_cache_life;
+            return &sh_cache_mem[sh_cache[i].ofs];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Put a corner into the shadow cache, dropping the least recently used ones until it fits
+ */
+static void shadow_cache_add(const shadow_key_t * key, const lv_opa_t * map, uint32_t size)
+{
+    /*Too large, or another strip has just added it*/
+    if(size > sh_cache_mem_size || shadow_cache_get(key)) return;
+
+    while(sh_cache_cnt == SHADOW_CACHE_SLOTS || sh_cache_used + size > sh_cache_mem_size) {
+        uint32_t oldest = 0;
+        uint32_t i;
+        for(i = 1; i < sh_cache_cnt; i++) {
+            if(sh_cache[i].last_use < sh_cache[oldest].last_use) oldest = i;
+        }
+        shadow_cache_evict(oldest);
+    }
+
+    shadow_cache_entry_t * e = &sh_cache[sh_cache_cnt++];
+    e->key = *key;
+    e->ofs = sh_cache_used;
+    e->size = size;
+    e->last_use = ++sh_cache_life;
+    lv_memcpy(&sh_cache_mem[e->ofs], map, size);
+    sh_cache_used += size;
+}
+
+/**
+ * Drop a corner from the shadow cache and move the ones after it down, so the free memory stays in one piece
+ */
+static void shadow_cache_evict(uint32_t i)
+{
+    uint32_t ofs = sh_cache[i].ofs;
+    uint32_t size = sh_cache[i].size;
+    memmove(&sh_cache_mem[ofs], &sh_cache_mem[ofs + size], sh_cache_used - ofs - size);
+    for(; i + 1 < sh_cache_cnt; i++) {
+        sh_cache[i] = sh_cache[i + 1];
+        sh_cache[i].ofs -= size;
+    }
+    sh_cache_cnt--;
+    sh_cache_used -= size;
+    sh_evict_cnt++;
+}
+#endif
 #endif
 
 static void draw_outline(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
@@ -1175,6 +1436,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
     lv_draw_sw_blend_dsc_t blend_dsc;
     lv_memset_00(&blend_dsc, sizeof(blend_dsc));
     blend_dsc.mask_buf = lv_mem_buf_get(draw_area_w);;
+    lv_draw_mask_runs_t mask_runs;
+    blend_dsc.mask_runs = &mask_runs;
 
 
     /*Create mask for the outer area*/
@@ -1221,7 +1484,7 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
             blend_area.y2 = h;
 
             lv_memset_ff(blend_dsc.mask_buf, draw_area_w);
-            blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, draw_area.x1, h, draw_area_w);
+            blend_dsc.mask_res = lv_draw_mask_apply_runs(blend_dsc.mask_buf, draw_area.x1, h, draw_area_w, &mask_runs);
             lv_draw_sw_blend(draw_ctx, &blend_dsc);
         }
 
@@ -1294,7 +1557,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
             if(top_y < draw_area.y1 && bottom_y > draw_area.y2) continue;   /*This line is clipped now*/
 
             lv_memset_ff(blend_dsc.mask_buf, draw_area_w);
-            blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, top_y, draw_area_w);
+            blend_dsc.mask_res = lv_draw_mask_apply_runs(blend_dsc.mask_buf, blend_area.x1, top_y, draw_area_w,
+                                                         &mask_runs);
 
             if(top_y >= draw_area.y1) {
                 blend_area.y1 = top_y;
@@ -1321,7 +1585,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = lv_draw_mask_apply_runs(blend_dsc.mask_buf, blend_area.x1, h, blend_w,
+                                                                 &mask_runs);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -1332,7 +1597,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = lv_draw_mask_apply_runs(blend_dsc.mask_buf, blend_area.x1, h, blend_w,
+                                                                 &mask_runs);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -1350,7 +1616,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = lv_draw_mask_apply_runs(blend_dsc.mask_buf, blend_area.x1, h, blend_w,
+                                                                 &mask_runs);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -1361,7 +1628,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = lv_draw_mask_apply_runs(blend_dsc.mask_buf, blend_area.x1, h, blend_w,
+                                                                 &mask_runs);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
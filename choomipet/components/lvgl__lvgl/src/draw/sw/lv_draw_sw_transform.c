@@ -61,13 +61,31 @@ static void rgb565a8_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src
                            int32_t x_end, lv_color_t * cbuf, uint8_t * abuf);
 #endif
 
+/**
+ * Sample a row with bilinear anti-aliasing
+ * @param xs_ups_tab    NULL: step `xs_ups` and `ys_ups` by `xs_step` and `ys_step`;
+ *                      else the upscaled X coordinate of every pixel while `ys_ups` stays the same
+ */
 static void argb_and_rgb_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                             int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
-                            int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf);
+                            const int32_t * xs_ups_tab, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf,
+                            lv_img_cf_t cf);
+
+static bool transform_axis_aligned(point_transform_dsc_t * t, const lv_area_t * dest_area, const uint8_t * src,
+                                   lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
+                                   const lv_draw_img_dsc_t * draw_dsc, lv_img_cf_t cf,
+                                   lv_color_t * cbuf, lv_opa_t * abuf);
+
+static void fill_index_tab(int32_t * tab, int32_t cnt, int32_t start, int32_t step, int32_t limit, int32_t mul);
+
+static void gather_rows(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride, lv_img_cf_t cf,
+                        const int32_t * col, const int32_t * row, lv_coord_t dest_w, lv_coord_t dest_h,
+                        lv_color_t * cbuf, lv_opa_t * abuf);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static bool fast_paths = true;
 
 /**********************
  *      MACROS
@@ -105,6 +123,11 @@ void lv_draw_sw_transform(lv_draw_ctx_t * draw_ctx, const lv_area_t * dest_area,
     tr_dsc.pivot_x_256 = tr_dsc.pivot.x * 256;
     tr_dsc.pivot_y_256 = tr_dsc.pivot.y * 256;
 
+    if(fast_paths &&
+       transform_axis_aligned(&tr_dsc, dest_area, src_buf, src_w, src_h, src_stride, draw_dsc, cf, cbuf, abuf)) {
+        return;
+    }
+
     lv_coord_t dest_w = lv_area_get_width(dest_area);
     lv_coord_t dest_h = lv_area_get_height(dest_area);
     lv_coord_t y;
@@ -145,7 +168,8 @@ void lv_draw_sw_transform(lv_draw_ctx_t * draw_ctx, const lv_area_t * dest_area,
             }
         }
         else {
-            argb_and_rgb_aa(src_buf, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step_256, ys_step_256, dest_w, cbuf, abuf, cf);
+            argb_and_rgb_aa(src_buf, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step_256, ys_step_256, NULL, dest_w,
+                            cbuf, abuf, cf);
         }
 
         cbuf += dest_w;
@@ -153,6 +177,16 @@ void lv_draw_sw_transform(lv_draw_ctx_t * draw_ctx, const lv_area_t * dest_area,
     }
 }
 
+void lv_draw_sw_transform_set_fast_paths(bool en)
+{
+    fast_paths = en;
+}
+
+bool lv_draw_sw_transform_get_fast_paths(void)
+{
+    return fast_paths;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -267,7 +301,8 @@ static void rgb565a8_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src
 
 static void argb_and_rgb_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                             int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
-                            int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf)
+                            const int32_t * xs_ups_tab, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf,
+                            lv_img_cf_t cf)
 {
     int32_t xs_ups_start = xs_ups;
     int32_t ys_ups_start = ys_ups;
@@ -302,8 +337,13 @@ static void argb_and_rgb_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t sr
 
     lv_coord_t x;
     for(x = 0; x < x_end; x++) {
-        xs_ups = xs_ups_start + ((xs_step * x) >> 8);
-        ys_ups = ys_ups_start + ((ys_step * x) >> 8);
+        if(xs_ups_tab) {
+            xs_ups = xs_ups_tab[x];
+        }
+        else {
+            xs_ups = xs_ups_start + ((xs_step * x) >> 8);
+            ys_ups = ys_ups_start + ((ys_step * x) >> 8);
+        }
 
         int32_t xs_int = xs_ups >> 8;
         int32_t ys_int = ys_ups >> 8;
@@ -466,6 +506,200 @@ static void argb_and_rgb_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t sr
     }
 }
 
+/**
+ * Transform without per-pixel affine math if there is no rotation or the rotation is a right angle without zoom.
+ * A destination row then maps to a source row (or column) and the destination columns map to the same
+ * source columns (or rows) in every row, so the source indices are computed once per column and once per row.
+ * @return          false: not an axis-aligned transform or out of memory, use the generic path
+ */
+static bool transform_axis_aligned(point_transform_dsc_t * t, const lv_area_t * dest_area, const uint8_t * src,
+                                   lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
+                                   const lv_draw_img_dsc_t * draw_dsc, lv_img_cf_t cf,
+                                   lv_color_t * cbuf, lv_opa_t * abuf)
+{
+    switch(cf) {
+        case LV_IMG_CF_TRUE_COLOR:
+        case LV_IMG_CF_TRUE_COLOR_ALPHA:
+        case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED:
+#if LV_COLOR_DEPTH == 16
+        case LV_IMG_CF_RGB565A8:
+#endif
+            break;
+        default:
+            return false;
+    }
+
+    int32_t angle = draw_dsc->angle % 3600;
+    if(angle < 0) angle += 3600;
+    bool right_angle = draw_dsc->zoom == LV_IMG_ZOOM_NONE && (angle == 900 || angle == 1800 || angle == 2700);
+    if(draw_dsc->angle != 0 && !right_angle) return false;
+
+    lv_coord_t dest_w = lv_area_get_width(dest_area);
+    lv_coord_t dest_h = lv_area_get_height(dest_area);
+    int32_t * col = lv_mem_buf_get(dest_w * sizeof(int32_t));
+    int32_t * row = lv_mem_buf_get(dest_h * sizeof(int32_t));
+    if(col == NULL || row == NULL) {
+        if(col) lv_mem_buf_release(col);
+        if(row) lv_mem_buf_release(row);
+        return false;
+    }
+
+    /*The sin and cos of the generic path are not exact (1023 instead of 1024) so right angles are remapped
+     *exactly, and without AA as every destination pixel is exactly on a source pixel*/
+    if(right_angle) {
+        int32_t dx1 = dest_area->x1 - t->pivot.x;
+        int32_t dy1 = dest_area->y1 - t->pivot.y;
+        if(angle == 900) {
+            fill_index_tab(col, dest_w, t->pivot.y - dx1, -1, src_h, src_stride);
+            fill_index_tab(row, dest_h, t->pivot.x + dy1, 1, src_w, 1);
+        }
+        else if(angle == 1800) {
+            fill_index_tab(col, dest_w, t->pivot.x - dx1, -1, src_w, 1);
+            fill_index_tab(row, dest_h, t->pivot.y - dy1, -1, src_h, src_stride);
+        }
+        else {
+            fill_index_tab(col, dest_w, t->pivot.y + dx1, 1, src_h, src_stride);
+            fill_index_tab(row, dest_h, t->pivot.x - dy1, -1, src_w, 1);
+        }
+        gather_rows(src, src_h, src_stride, cf, col, row, dest_w, dest_h, cbuf, abuf);
+    }
+    /*Zoom only: step the columns as the generic path does, but only once*/
+    else {
+        int32_t xs1_ups, ys1_ups, xs2_ups, ys2_ups;
+        transform_point_upscaled(t, dest_area->x1, dest_area->y1, &xs1_ups, &ys1_ups);
+        transform_point_upscaled(t, dest_area->x2, dest_area->y1, &xs2_ups, &ys2_ups);
+        int32_t xs_step_256 = 0;
+        if(dest_w > 1) xs_step_256 = (256 * (xs2_ups - xs1_ups)) / (dest_w - 1);
+
+        lv_coord_t x;
+        lv_coord_t y;
+        for(x = 0; x < dest_w; x++) {
+            col[x] = xs1_ups + 0x80 + ((xs_step_256 * x) >> 8);
+        }
+
+        if(draw_dsc->antialias) {
+            for(y = 0; y < dest_h; y++) {
+                transform_point_upscaled(t, dest_area->x1, dest_area->y1 + y, &xs1_ups, &ys1_ups);
+                argb_and_rgb_aa(src, src_w, src_h, src_stride, 0, ys1_ups + 0x80, 0, 0, col, dest_w, cbuf, abuf, cf);
+                cbuf += dest_w;
+                abuf += dest_w;
+            }
+        }
+        else {
+            /*Nearest neighbor: with a zoom of N the same source row is repeated N times and only copied*/
+            for(x = 0; x < dest_w; x++) {
+                int32_t xs_int = col[x] >> 8;
+                col[x] = xs_int >= 0 && xs_int < src_w ? xs_int : -1;
+            }
+            for(y = 0; y < dest_h; y++) {
+                transform_point_upscaled(t, dest_area->x1, dest_area->y1 + y, &xs1_ups, &ys1_ups);
+                int32_t ys_int = (ys1_ups + 0x80) >> 8;
+                row[y] = ys_int >= 0 && ys_int < src_h ? ys_int * src_stride : -1;
+            }
+            gather_rows(src, src_h, src_stride, cf, col, row, dest_w, dest_h, cbuf, abuf);
+        }
+    }
+
+    lv_mem_buf_release(row);
+    lv_mem_buf_release(col);
+    return true;
+}
+
+/**
+ * Fill `tab[i]` with `(start + i * step) * mul` or -1 where `start + i * step` is out of `[0..limit)`
+ */
+static void fill_index_tab(int32_t * tab, int32_t cnt, int32_t start, int32_t step, int32_t limit, int32_t mul)
+{
+    int32_t i;
+    int32_t v = start;
+    for(i = 0; i < cnt; i++) {
+        tab[i] = v >= 0 && v < limit ? v * mul : -1;
+        v += step;
+    }
+}
+
+/**
+ * Copy the source pixels `row[y] + col[x]` (in pixels from the start of the image) to the buffers.
+ * A negative `row[y]` or `col[x]` means the pixel is out of the image. A row equal to the previous one is copied.
+ */
+static void gather_rows(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride, lv_img_cf_t cf,
+                        const int32_t * col, const int32_t * row, lv_coord_t dest_w, lv_coord_t dest_h,
+                        lv_color_t * cbuf, lv_opa_t * abuf)
+{
+    lv_color_t ck = _LV_COLOR_ZERO_INITIALIZER;
+    if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
+        lv_disp_t * d = _lv_refr_get_disp_refreshing();
+        ck = d->driver->color_chroma_key;
+    }
+
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = 0; y < dest_h; y++, cbuf += dest_w, abuf += dest_w) {
+        if(y > 0 && row[y] == row[y - 1]) {
+            lv_memcpy(cbuf, cbuf - dest_w, dest_w * sizeof(lv_color_t));
+            lv_memcpy(abuf, abuf - dest_w, dest_w);
+            continue;
+        }
+        if(row[y] < 0) {
+            lv_memset_00(abuf, dest_w);
+            continue;
+        }
+
+        switch(cf) {
+            case LV_IMG_CF_TRUE_COLOR_ALPHA: {
+                    const uint8_t * src_row = src + row[y] * LV_IMG_PX_SIZE_ALPHA_BYTE;
+                    for(x = 0; x < dest_w; x++) {
+                        if(col[x] < 0) {
+                            abuf[x] = 0x00;
+                            continue;
+                        }
+                        const uint8_t * src_tmp = src_row + col[x] * LV_IMG_PX_SIZE_ALPHA_BYTE;
+#if LV_COLOR_DEPTH == 1 || LV_COLOR_DEPTH == 8
+                        cbuf[x].full = src_tmp[0];
+#elif LV_COLOR_DEPTH == 16
+                        cbuf[x].full = src_tmp[0] + (src_tmp[1] << 8);
+#elif LV_COLOR_DEPTH == 32
+                        cbuf[x].full = *((uint32_t *)src_tmp);
+#endif
+                        abuf[x] = src_tmp[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+                    }
+                    break;
+                }
+            /*Only with 16 bit colors, else transform_axis_aligned() leaves it to the generic path*/
+            case LV_IMG_CF_RGB565A8: {
+                    const lv_color_t * src_row = (const lv_color_t *)src + row[y];
+                    const lv_opa_t * a_row = src + src_stride * src_h * sizeof(lv_color_t) + row[y];
+                    for(x = 0; x < dest_w; x++) {
+                        if(col[x] < 0) {
+                            abuf[x] = 0x00;
+                            continue;
+                        }
+                        cbuf[x] = src_row[col[x]];
+                        abuf[x] = a_row[col[x]];
+                    }
+                    break;
+                }
+            default: {
+                    const lv_color_t * src_row = (const lv_color_t *)src + row[y];
+                    for(x = 0; x < dest_w; x++) {
+                        if(col[x] < 0) {
+                            abuf[x] = 0x00;
+                            continue;
+                        }
+                        cbuf[x] = src_row[col[x]];
+                        abuf[x] = 0xff;
+                    }
+                    if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
+                        for(x = 0; x < dest_w; x++) {
+                            if(cbuf[x].full == ck.full) abuf[x] = 0x00;
+                        }
+                    }
+                    break;
+                }
+        }
+    }
+}
+
 static void transform_point_upscaled(point_transform_dsc_t * t, int32_t xin, int32_t yin, int32_t * xout,
                                      int32_t * yout)
 {
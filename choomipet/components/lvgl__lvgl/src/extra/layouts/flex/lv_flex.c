@@ -58,6 +58,9 @@ static int32_t find_track_end(lv_obj_t * cont, flex_t * f, int32_t item_start_id
                               lv_coord_t item_gap, track_t * t);
 static void children_repos(lv_obj_t * cont, flex_t * f, int32_t item_first_id, int32_t item_last_id, lv_coord_t abs_x,
                            lv_coord_t abs_y, lv_coord_t max_main_size, lv_coord_t item_gap, track_t * t);
+static bool continue_track(lv_obj_t * cont, flex_t * f, int32_t item_first_id, lv_coord_t abs_x, lv_coord_t abs_y,
+                           lv_coord_t item_gap);
+static void place_item(lv_obj_t * item, lv_coord_t x, lv_coord_t y);
 static void place_content(lv_flex_align_t place, lv_coord_t max_size, lv_coord_t content_size, lv_coord_t item_cnt,
                           lv_coord_t * start_pos, lv_coord_t * gap);
 static lv_obj_t * get_next_item(lv_obj_t * cont, bool rev, int32_t * item_id);
@@ -118,7 +121,7 @@ void lv_obj_set_flex_align(lv_obj_t * obj, lv_flex_align_t main_place, lv_flex_a
 void lv_obj_set_flex_grow(lv_obj_t * obj, uint8_t grow)
 {
     lv_obj_set_style_flex_grow(obj, grow, 0);
-    lv_obj_mark_layout_as_dirty(lv_obj_get_parent(obj));
+    _lv_obj_mark_layout_as_dirty_from(lv_obj_get_parent(obj), obj);
 }
 
 
@@ -256,7 +259,12 @@ static void flex_update(lv_obj_t * cont, void * user_data)
     int32_t track_first_item;
     int32_t next_track_first_item;
 
-    if(track_cross_place != LV_FLEX_ALIGN_START) {
+    /*If only the last items changed (e.g. were added) maybe they can be placed after the others*/
+    int32_t dirty_from = cont->spec_attr->layout_dirty_from;
+    bool continued = dirty_from > 0 && track_cross_place == LV_FLEX_ALIGN_START && !rtl &&
+                     continue_track(cont, &f, dirty_from, abs_x, abs_y, item_gap);
+
+    if(!continued && track_cross_place != LV_FLEX_ALIGN_START) {
         track_first_item = f.rev ? cont->spec_attr->child_cnt - 1 : 0;
         track_t t;
         while(track_first_item < (int32_t)cont->spec_attr->child_cnt && track_first_item >= 0) {
@@ -276,6 +284,7 @@ static void flex_update(lv_obj_t * cont, void * user_data)
     }
 
     track_first_item = f.rev ? cont->spec_attr->child_cnt - 1 : 0;
+    if(continued) track_first_item = cont->spec_attr->child_cnt;  /*The others are placed already*/
 
     if(rtl && !f.row) {
         *cross_pos += total_track_cross_size;
@@ -512,29 +521,7 @@ static void children_repos(lv_obj_t * cont, flex_t * f, int32_t item_first_id, i
 
         if(f->row && rtl) main_pos -= area_get_main_size(&item->coords);
 
-
-        /*Handle percentage value of translate*/
-        lv_coord_t tr_x = lv_obj_get_style_translate_x(item, LV_PART_MAIN);
-        lv_coord_t tr_y = lv_obj_get_style_translate_y(item, LV_PART_MAIN);
-        lv_coord_t w = lv_obj_get_width(item);
-        lv_coord_t h = lv_obj_get_height(item);
-        if(LV_COORD_IS_PCT(tr_x)) tr_x = (w * LV_COORD_GET_PCT(tr_x)) / 100;
-        if(LV_COORD_IS_PCT(tr_y)) tr_y = (h * LV_COORD_GET_PCT(tr_y)) / 100;
-
-        lv_coord_t diff_x = abs_x - item->coords.x1 + tr_x;
-        lv_coord_t diff_y = abs_y - item->coords.y1 + tr_y;
-        diff_x += f->row ? main_pos : cross_pos;
-        diff_y += f->row ? cross_pos : main_pos;
-
-        if(diff_x || diff_y) {
-            lv_obj_invalidate(item);
-            item->coords.x1 += diff_x;
-            item->coords.x2 += diff_x;
-            item->coords.y1 += diff_y;
-            item->coords.y2 += diff_y;
-            lv_obj_invalidate(item);
-            lv_obj_move_children_by(item, diff_x, diff_y, false);
-        }
+        place_item(item, abs_x + (f->row ? main_pos : cross_pos), abs_y + (f->row ? cross_pos : main_pos));
 
         if(!(f->row && rtl)) main_pos += area_get_main_size(&item->coords) + item_gap + place_gap;
         else main_pos -= item_gap + place_gap;
@@ -543,6 +530,93 @@ static void children_repos(lv_obj_t * cont, flex_t * f, int32_t item_first_id, i
     }
 }
 
+/**
+ * Place the items from `item_first_id` after the others if only they changed since the last update
+ * and they can't move or resize the others: all the items are in one track, placed to the start with no grow.
+ * The items before `item_first_id` are where the last update placed them.
+ * @return true: the items are placed; false: all the items need to be placed
+ */
+static bool continue_track(lv_obj_t * cont, flex_t * f, int32_t item_first_id, lv_coord_t abs_x, lv_coord_t abs_y,
+                           lv_coord_t item_gap)
+{
+    if(f->rev || f->main_place != LV_FLEX_ALIGN_START || f->cross_place != LV_FLEX_ALIGN_START) return false;
+
+    /*Can't wrap if the size if auto, see find_track_end()*/
+    if(f->wrap) {
+        lv_coord_t main_set = f->row ? lv_obj_get_style_width(cont, LV_PART_MAIN) :
+                              lv_obj_get_style_height(cont, LV_PART_MAIN);
+        if(main_set != LV_SIZE_CONTENT) return false;
+    }
+
+    /*The grow items were sized by the layout. They and the new tracks can't be kept*/
+    lv_obj_t * prev = NULL;
+    int32_t item_id;
+    for(item_id = 0; item_id < item_first_id; item_id++) {
+        lv_obj_t * item = cont->spec_attr->children[item_id];
+        if(item_id > 0 && lv_obj_has_flag(item, LV_OBJ_FLAG_FLEX_IN_NEW_TRACK)) return false;
+        if(lv_obj_has_flag_any(item, LV_OBJ_FLAG_IGNORE_LAYOUT | LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_FLOATING)) continue;
+        if(item->w_layout || item->h_layout) return false;
+        prev = item;
+    }
+
+    /*Continue where the last placed item ends*/
+    lv_coord_t main_pos = 0;
+    if(prev) {
+        lv_coord_t tr;
+        if(f->row) {
+            tr = lv_obj_get_style_translate_x(prev, LV_PART_MAIN);
+            if(LV_COORD_IS_PCT(tr)) tr = (lv_obj_get_width(prev) * LV_COORD_GET_PCT(tr)) / 100;
+            main_pos = prev->coords.x2 + 1 - tr - abs_x + item_gap;
+        }
+        else {
+            tr = lv_obj_get_style_translate_y(prev, LV_PART_MAIN);
+            if(LV_COORD_IS_PCT(tr)) tr = (lv_obj_get_height(prev) * LV_COORD_GET_PCT(tr)) / 100;
+            main_pos = prev->coords.y2 + 1 - tr - abs_y + item_gap;
+        }
+    }
+
+    for(item_id = item_first_id; item_id < (int32_t)cont->spec_attr->child_cnt; item_id++) {
+        lv_obj_t * item = cont->spec_attr->children[item_id];
+        if(lv_obj_has_flag(item, LV_OBJ_FLAG_FLEX_IN_NEW_TRACK)) return false;
+        if(lv_obj_has_flag_any(item, LV_OBJ_FLAG_IGNORE_LAYOUT | LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_FLOATING)) continue;
+        if(lv_obj_get_style_flex_grow(item, LV_PART_MAIN)) return false;
+
+        item->w_layout = 0;
+        item->h_layout = 0;
+        place_item(item, abs_x + (f->row ? main_pos : 0), abs_y + (f->row ? 0 : main_pos));
+        main_pos += (f->row ? lv_obj_get_width(item) : lv_obj_get_height(item)) + item_gap;
+    }
+
+    return true;
+}
+
+/**
+ * Move an item to a position considering its translation
+ */
+static void place_item(lv_obj_t * item, lv_coord_t x, lv_coord_t y)
+{
+    /*Handle percentage value of translate*/
+    lv_coord_t tr_x = lv_obj_get_style_translate_x(item, LV_PART_MAIN);
+    lv_coord_t tr_y = lv_obj_get_style_translate_y(item, LV_PART_MAIN);
+    lv_coord_t w = lv_obj_get_width(item);
+    lv_coord_t h = lv_obj_get_height(item);
+    if(LV_COORD_IS_PCT(tr_x)) tr_x = (w * LV_COORD_GET_PCT(tr_x)) / 100;
+    if(LV_COORD_IS_PCT(tr_y)) tr_y = (h * LV_COORD_GET_PCT(tr_y)) / 100;
+
+    lv_coord_t diff_x = x - item->coords.x1 + tr_x;
+    lv_coord_t diff_y = y - item->coords.y1 + tr_y;
+
+    if(diff_x || diff_y) {
+        lv_obj_invalidate(item);
+        item->coords.x1 += diff_x;
+        item->coords.x2 += diff_x;
+        item->coords.y1 += diff_y;
+        item->coords.y2 += diff_y;
+        lv_obj_invalidate(item);
+        lv_obj_move_children_by(item, diff_x, diff_y, false);
+    }
+}
+
 /**
  * Tell a start coordinate and gap for a placement type.
  */
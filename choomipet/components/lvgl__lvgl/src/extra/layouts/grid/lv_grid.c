@@ -40,6 +40,13 @@ typedef struct {
     lv_coord_t grid_h;
 } _lv_grid_calc_t;
 
+/*The tracks of the last update, kept by the container*/
+typedef struct {
+    uint32_t col_num;
+    uint32_t row_num;
+    uint32_t valid : 1;
+} tracks_cache_t;
+
 
 /**********************
  *  GLOBAL PROTOTYPES
@@ -51,6 +58,8 @@ typedef struct {
 static void grid_update(lv_obj_t * cont, void * user_data);
 static void calc(lv_obj_t * obj, _lv_grid_calc_t * calc);
 static void calc_free(_lv_grid_calc_t * calc);
+static bool calc_is_cached(lv_obj_t * cont, const _lv_grid_calc_t * c);
+static bool tracks_keep(lv_coord_t * kept, const lv_coord_t * calc, uint32_t num);
 static void calc_cols(lv_obj_t * cont, _lv_grid_calc_t * c);
 static void calc_rows(lv_obj_t * cont, _lv_grid_calc_t * c);
 static void item_repos(lv_obj_t * item, _lv_grid_calc_t * c, item_repos_hint_t * hint);
@@ -169,7 +178,7 @@ void lv_obj_set_grid_cell(lv_obj_t * obj, lv_grid_align_t x_align, uint8_t col_p
     lv_obj_set_style_grid_cell_row_span(obj, row_span, 0);
     lv_obj_set_style_grid_cell_y_align(obj, y_align, 0);
 
-    lv_obj_mark_layout_as_dirty(lv_obj_get_parent(obj));
+    _lv_obj_mark_layout_as_dirty_from(lv_obj_get_parent(obj), obj);
 }
 
 
@@ -364,8 +373,9 @@ static void grid_update(lv_obj_t * cont, void * user_data)
     hint.grid_abs.x = pad_left + cont->coords.x1 - lv_obj_get_scroll_x(cont);
     hint.grid_abs.y = pad_top + cont->coords.y1 - lv_obj_get_scroll_y(cont);
 
-    uint32_t i;
-    for(i = 0; i < cont->spec_attr->child_cnt; i++) {
+    /*With the same tracks only the changed children (and the ones after them) need to be placed*/
+    uint32_t i = calc_is_cached(cont, &c) ? cont->spec_attr->layout_dirty_from : 0;
+    for(; i < cont->spec_attr->child_cnt; i++) {
         lv_obj_t * item = cont->spec_attr->children[i];
         item_repos(item, &c, &hint);
     }
@@ -430,6 +440,52 @@ static void calc_free(_lv_grid_calc_t * calc)
     lv_mem_buf_release(calc->h);
 }
 
+/**
+ * Tell whether the last update of the container calculated the same tracks and keep these for the next one
+ * @param cont an object that has a grid
+ * @param c    the calculated tracks
+ * @return     true: the tracks are the same as in the last update
+ */
+static bool calc_is_cached(lv_obj_t * cont, const _lv_grid_calc_t * c)
+{
+    uint32_t track_num = 2 * (c->col_num + c->row_num);
+    tracks_cache_t * cache = _lv_obj_get_layout_cache(cont, LV_LAYOUT_GRID,
+                                                      sizeof(tracks_cache_t) + sizeof(lv_coord_t) * track_num);
+    if(cache == NULL) return false;
+
+    bool same = cache->valid && cache->col_num == c->col_num && cache->row_num == c->row_num;
+    cache->col_num = c->col_num;
+    cache->row_num = c->row_num;
+    cache->valid = 1;
+
+    /*x, w of the columns, then y, h of the rows*/
+    lv_coord_t * tracks = (lv_coord_t *)(cache + 1);
+    if(!tracks_keep(tracks, c->x, c->col_num)) same = false;
+    if(!tracks_keep(tracks + c->col_num, c->w, c->col_num)) same = false;
+    tracks += 2 * c->col_num;
+    if(!tracks_keep(tracks, c->y, c->row_num)) same = false;
+    if(!tracks_keep(tracks + c->row_num, c->h, c->row_num)) same = false;
+
+    return same;
+}
+
+/**
+ * Copy calculated track values to the kept ones
+ * @return true: they were the same
+ */
+static bool tracks_keep(lv_coord_t * kept, const lv_coord_t * calc, uint32_t num)
+{
+    bool same = true;
+    uint32_t i;
+    for(i = 0; i < num; i++) {
+        if(kept[i] != calc[i]) {
+            kept[i] = calc[i];
+            same = false;
+        }
+    }
+    return same;
+}
+
 static void calc_cols(lv_obj_t * cont, _lv_grid_calc_t * c)
 {
     const lv_coord_t * col_templ = get_col_dsc(cont);
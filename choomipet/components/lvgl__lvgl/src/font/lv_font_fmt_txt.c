@@ -50,14 +50,20 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
  *  STATIC VARIABLES
  **********************/
 #if LV_USE_FONT_COMPRESSED
-    static uint32_t rle_rdp;
-    static const uint8_t * rle_in;
-    static uint8_t rle_bpp;
-    static uint8_t rle_prev_v;
-    static uint8_t rle_cnt;
-    static rle_state_t rle_state;
+    static LV_RENDER_LOCAL uint32_t rle_rdp;
+    static LV_RENDER_LOCAL const uint8_t * rle_in;
+    static LV_RENDER_LOCAL uint8_t rle_bpp;
+    static LV_RENDER_LOCAL uint8_t rle_prev_v;
+    static LV_RENDER_LOCAL uint8_t rle_cnt;
+    static LV_RENDER_LOCAL rle_state_t rle_state;
 #endif /*LV_USE_FONT_COMPRESSED*/
 
+#if LV_USE_PARALLEL_RENDER
+    /*The cache of a font is shared by the rendering threads, each of them caches the last font it used instead*/
+    static LV_RENDER_LOCAL const lv_font_fmt_txt_dsc_t * local_cache_fdsc;
+    static LV_RENDER_LOCAL lv_font_fmt_txt_glyph_cache_t local_cache;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -92,7 +98,7 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
     /*Handle compressed bitmap*/
     else {
 #if LV_USE_FONT_COMPRESSED
-        static size_t last_buf_size = 0;
+        static LV_RENDER_LOCAL size_t last_buf_size = 0;
         if(LV_GC_ROOT(_lv_font_decompr_buf) == NULL) last_buf_size = 0;
 
         uint32_t gsize = gdsc->box_w * gdsc->box_h;
@@ -211,9 +217,21 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
     if(letter == '\0') return 0;
 
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    lv_font_fmt_txt_glyph_cache_t * cache = fdsc->cache;
+
+#if LV_USE_PARALLEL_RENDER
+    if(cache) {
+        if(local_cache_fdsc != fdsc) {
+            local_cache_fdsc = fdsc;
+            local_cache.last_letter = 0;    /*Never looked up*/
+            local_cache.last_glyph_id = 0;
+        }
+        cache = &local_cache;
+    }
+#endif
 
     /*Check the cache first*/
-    if(fdsc->cache && letter == fdsc->cache->last_letter) return fdsc->cache->last_glyph_id;
+    if(cache && letter == cache->last_letter) return cache->last_glyph_id;
 
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
@@ -252,16 +270,16 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
         }
 
         /*Update the cache*/
-        if(fdsc->cache) {
-            fdsc->cache->last_letter = letter;
-            fdsc->cache->last_glyph_id = glyph_id;
+        if(cache) {
+            cache->last_letter = letter;
+            cache->last_glyph_id = glyph_id;
         }
         return glyph_id;
     }
 
-    if(fdsc->cache) {
-        fdsc->cache->last_letter = letter;
-        fdsc->cache->last_glyph_id = 0;
+    if(cache) {
+        cache->last_letter = letter;
+        cache->last_glyph_id = 0;
     }
     return 0;
 
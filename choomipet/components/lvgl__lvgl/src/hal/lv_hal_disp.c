@@ -277,6 +277,7 @@ void lv_disp_drv_update(lv_disp_t * disp, lv_disp_drv_t * new_drv)
     lv_memset_00(disp->inv_areas, sizeof(disp->inv_areas));
     lv_memset_00(disp->inv_area_joined, sizeof(disp->inv_area_joined));
     disp->inv_p = 0;
+    disp->inv_tiles_used = 0;
     if(disp->act_scr != NULL) lv_obj_invalidate(disp->act_scr);
 
     lv_obj_tree_walk(NULL, invalidate_layout_cb, NULL);
@@ -320,6 +321,15 @@ void lv_disp_remove(lv_disp_t * disp)
     _lv_ll_remove(&LV_GC_ROOT(_lv_disp_ll), disp);
     _lv_ll_clear(&disp->sync_areas);
     if(disp->refr_timer) lv_timer_del(disp->refr_timer);
+    if(disp->inv_tiles) lv_mem_free(disp->inv_tiles);
+    if(disp->render_ctx) {
+        uint32_t i;
+        for(i = 0; i < disp->render_ctx_cnt; i++) {
+            disp->driver->draw_ctx_deinit(disp->driver,
+                                          (lv_draw_ctx_t *)((uint8_t *)disp->render_ctx + i * disp->driver->draw_ctx_size));
+        }
+        lv_mem_free(disp->render_ctx);
+    }
     lv_mem_free(disp);
 
     if(was_default) lv_disp_set_default(_lv_ll_get_head(&LV_GC_ROOT(_lv_disp_ll)));
@@ -70,6 +70,13 @@ typedef enum {
     LV_DISP_ROT_270
 } lv_disp_rot_t;
 
+/**
+ * A job of `lv_disp_drv_t::render_cb`
+ * @param job_data  the data passed to `render_cb`
+ * @param idx       index of the job
+ */
+typedef void (*lv_disp_render_job_t)(void * job_data, uint32_t idx);
+
 /**
  * Display Driver structure to be registered by HAL.
  * Only its pointer will be saved in `lv_disp_t` so it should be declared as
@@ -99,6 +106,7 @@ typedef struct _lv_disp_drv_t {
     uint32_t rotated : 2;            /**< 1: turn the display by 90 degree. @warning Does not update coordinates for you!*/
     uint32_t screen_transp : 1;      /**Handle if the screen doesn't have a solid (opa == LV_OPA_COVER) background.
                                        * Use only if required because it's slower.*/
+    uint32_t cull_occluded : 1;      /**< 1: Don't draw objects hidden behind opaque objects in front of them*/
 
     uint32_t dpi : 10;              /** DPI (dot per inch) of the display. Default value is `LV_DPI_DEF`.*/
 
@@ -137,6 +145,43 @@ typedef struct _lv_disp_drv_t {
     /** OPTIONAL: called when start rendering */
     void (*render_start_cb)(struct _lv_disp_drv_t * disp_drv);
 
+    /** OPTIONAL: Called when the full-width band `area` is scrolled vertically by `dy` pixels (positive: down)
+     * and only the scrolled content is drawn there. Return true if the display moves the already flushed pixels
+     * itself (e.g. hardware vertical scrolling); LVGL then redraws only the rows scrolled in and the driver has to
+     * map the rows of later flushes into the moved frame memory. Return false to redraw the whole band.*/
+    bool (*vscroll_cb)(struct _lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_coord_t dy);
+
+    /** OPTIONAL: Call `job(job_data, i)` for every `i` from 0 to `job_cnt - 1` on different threads (the calling one
+     * included) and return when all of them returned. Used if `render_strips` is set.
+     * The jobs send the draw events of the objects: the event handlers must not change any object.
+     * Every thread keeps a gradient cache: call `lv_gradient_free_cache()` when the threads are stopped*/
+    void (*render_cb)(struct _lv_disp_drv_t * disp_drv, lv_disp_render_job_t job, void * job_data, uint32_t job_cnt);
+
+    /** OPTIONAL: Lock (`lock == true`) or unlock the data the jobs of `render_cb` share, e.g. the LVGL heap.
+     * A thread must be able to lock it again while holding it. Used if `render_strips` is set*/
+    void (*render_lock_cb)(struct _lv_disp_drv_t * disp_drv, bool lock);
+
+    /** Refresh period of the panel in microseconds (e.g. 16667 for 60 Hz), 0 if unknown.
+     * If set, frames are paced to a whole number of panel refreshes chosen from the measured frame time
+     * and animations advance by the paced frame period. See `lv_refr_get_pacing()`*/
+    uint32_t panel_period_us;
+
+    /** Size of the dirty tiles in pixels (8, 16, 32...: a power of two), 0 to disable.
+     * If more than `LV_INV_BUF_SIZE` areas are invalidated before a refresh, the areas are collected in
+     * a bitmap of tiles and the runs of dirty tiles are redrawn instead of the whole screen*/
+    uint8_t inv_tile_size;
+
+    /** Bytes of the LVGL heap for recorded draw calls, 0 to disable retained drawing.
+     * The rectangles, labels and images an object draws are recorded once it was drawn unchanged,
+     * and later refreshes replay them instead of sending the draw events to the object.
+     * Objects drawing anything else (lines, arcs, masks...) or having draw event handlers added with
+     * `lv_obj_add_event_cb()` are always drawn directly*/
+    uint32_t retained_mem;
+
+    /** Split each part of the screen into this many horizontal strips and render them in parallel with `render_cb`,
+     * 0 or 1 to render on the calling thread only. Requires `LV_USE_PARALLEL_RENDER 1`*/
+    uint8_t render_strips;
+
     /** On CHROMA_KEYED images this color will be transparent.
      * `LV_COLOR_CHROMA_KEY` by default. (lv_conf.h)*/
     lv_color_t color_chroma_key;
@@ -152,6 +197,32 @@ typedef struct _lv_disp_drv_t {
 
 } lv_disp_drv_t;
 
+/**
+ * Frame pacing state of a display, used if `panel_period_us` is set in its driver.
+ */
+typedef struct {
+    uint32_t next_tick;         /**< The next frame is due at this tick ...*/
+    uint16_t next_frac_us;      /**< ... plus this many microseconds*/
+    uint8_t div;                /**< Panel refreshes per frame, 0 until the first frame*/
+    uint8_t overruns;           /**< Frames that missed their slot in the current window*/
+    uint8_t window_cnt;         /**< Frames drawn in the current window*/
+    uint8_t resync : 1;         /**< 1: the grid restarted at this frame, no jitter sample*/
+    uint8_t last_up : 1;        /**< 1: the last rate change was to a faster rate*/
+    uint16_t settle_cnt;        /**< Frames in a row that would have fitted the next faster rate*/
+    uint16_t hold;              /**< Frames to wait before trying a faster rate again*/
+    uint16_t backoff;           /**< `hold` after the next fall back*/
+    uint16_t since_change;      /**< Frames drawn since the last rate change*/
+    uint32_t cost_peak_us;      /**< Recent longest frame (render + wait for the flush), decays by 1/8 per frame*/
+
+    /*Statistics*/
+    uint32_t frames;
+    uint32_t dropped;           /**< Slots given up because a frame ran past its slot*/
+    uint32_t rate_changes;
+    uint32_t jitter_cnt;
+    uint32_t jitter_sum_us;
+    uint32_t jitter_max_us;
+} lv_disp_pacing_t;
+
 /**
  * Display structure.
  * @note `lv_disp_drv_t` should be the first member of the structure.
@@ -188,11 +259,24 @@ typedef struct _lv_disp_t {
     uint16_t inv_p;
     int32_t inv_en_cnt;
 
+    /** Dirty tiles, used after `inv_areas` overflowed if the driver sets `inv_tile_size`*/
+    uint32_t * inv_tiles;           /**< One bit per tile, `inv_tile_words` words per row of tiles*/
+    uint16_t inv_tile_words;
+    uint16_t inv_tile_rows;
+    uint8_t inv_tile_shift;         /**< log2 of the tile size `inv_tiles` was allocated for*/
+    uint8_t inv_tiles_used : 1;     /**< 1: the invalidated areas are in `inv_tiles`, not in `inv_areas`*/
+
     /** Double buffer sync areas */
     lv_ll_t sync_areas;
 
     /*Miscellaneous data*/
     uint32_t last_activity_time;        /**< Last time when there was activity on this display*/
+
+    lv_disp_pacing_t pacing;            /**< Frame pacing state, see `lv_disp_drv_t::panel_period_us`*/
+
+    /** Draw contexts of the strips rendered in parallel, `render_ctx_cnt` times `lv_disp_drv_t::draw_ctx_size` bytes*/
+    void * render_ctx;
+    uint8_t render_ctx_cnt;
 } lv_disp_t;
 
 /**********************
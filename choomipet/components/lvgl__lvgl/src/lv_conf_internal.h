@@ -293,7 +293,7 @@
 
     /*Allow buffering some shadow calculation.
     *LV_SHADOW_CACHE_SIZE is the max. shadow size to buffer, where shadow size is `shadow_width + radius`
-    *Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost*/
+    *A cached shadow has a shadow size^2 RAM cost*/
     #ifndef LV_SHADOW_CACHE_SIZE
         #ifdef CONFIG_LV_SHADOW_CACHE_SIZE
             #define LV_SHADOW_CACHE_SIZE CONFIG_LV_SHADOW_CACHE_SIZE
@@ -302,6 +302,16 @@
         #endif
     #endif
 
+    /*RAM the cached shadows can use [bytes], a static array and not from the heap. The least recently used ones
+     *are dropped first*/
+    #ifndef LV_SHADOW_CACHE_MEM_SIZE
+        #ifdef CONFIG_LV_SHADOW_CACHE_MEM_SIZE
+            #define LV_SHADOW_CACHE_MEM_SIZE CONFIG_LV_SHADOW_CACHE_MEM_SIZE
+        #else
+            #define LV_SHADOW_CACHE_MEM_SIZE (LV_SHADOW_CACHE_SIZE * LV_SHADOW_CACHE_SIZE)
+        #endif
+    #endif
+
     /* Set number of maximally cached circle data.
     * The circumference of 1/4 circle are saved for anti-aliasing
     * radius * 4 bytes are used per circle (the most often used radiuses are saved)
@@ -347,6 +357,7 @@
  *If only the built-in image formats are used there is no real advantage of caching. (I.e. if no new image decoder is added)
  *With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
  *However the opened images might consume additional RAM.
+ *It's the number of images expected in the cache, how many are kept depends on LV_IMG_CACHE_DEF_MEM_SIZE.
  *0: to disable caching*/
 #ifndef LV_IMG_CACHE_DEF_SIZE
     #ifdef CONFIG_LV_IMG_CACHE_DEF_SIZE
@@ -356,6 +367,27 @@
     #endif
 #endif
 
+/*RAM the opened images can keep in the image cache [bytes].
+ *The images decoded to RAM count with their decoded size, the least recently used ones are closed first*/
+#ifndef LV_IMG_CACHE_DEF_MEM_SIZE
+    #ifdef CONFIG_LV_IMG_CACHE_DEF_MEM_SIZE
+        #define LV_IMG_CACHE_DEF_MEM_SIZE CONFIG_LV_IMG_CACHE_DEF_MEM_SIZE
+    #else
+        #define LV_IMG_CACHE_DEF_MEM_SIZE (32 * 1024)
+    #endif
+#endif
+
+/*Decode the run-length encoded images (`LV_IMG_CF_RLE_...`) into RAM at once if they take at most this many bytes.
+ *Such images can be kept in the image cache, rotated and zoomed. The larger ones are decoded row by row while drawn,
+ *only the visible rows. 0: always row by row*/
+#ifndef LV_IMG_RLE_DECODE_MAX_SIZE
+    #ifdef CONFIG_LV_IMG_RLE_DECODE_MAX_SIZE
+        #define LV_IMG_RLE_DECODE_MAX_SIZE CONFIG_LV_IMG_RLE_DECODE_MAX_SIZE
+    #else
+        #define LV_IMG_RLE_DECODE_MAX_SIZE (8 * 1024)
+    #endif
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #ifndef LV_GRADIENT_MAX_STOPS
@@ -369,6 +401,7 @@
 /*Default gradient buffer size.
  *When LVGL calculates the gradient "maps" it can save them into a cache to avoid calculating them again.
  *LV_GRAD_CACHE_DEF_SIZE sets the size of this cache in bytes.
+ *The maps are cached by their stops and size. When it's full the least recently used ones are dropped.
  *If the cache is too small the map will be allocated only while it's required for the drawing.
  *0 mean no caching.*/
 #ifndef LV_GRAD_CACHE_DEF_SIZE
@@ -412,6 +445,30 @@
     #endif
 #endif
 
+/*1: Allow rendering the parts of the screen in horizontal strips on several threads
+ *(`render_strips`, `render_cb` and `render_lock_cb` in the display driver).
+ *The state of the drawing functions is kept per thread with the compiler's thread local storage.
+ *Requires LV_COLOR_SCREEN_TRANSP 0 and LV_ENABLE_GC 0*/
+#ifndef LV_USE_PARALLEL_RENDER
+    #ifdef CONFIG_LV_USE_PARALLEL_RENDER
+        #define LV_USE_PARALLEL_RENDER CONFIG_LV_USE_PARALLEL_RENDER
+    #else
+        #define LV_USE_PARALLEL_RENDER 0
+    #endif
+#endif
+
+/*1: Cache the frequently drawn style properties (e.g. background, border, radius, padding and text)
+ *of the objects per part and state instead of looking them up in the styles every time.
+ *Needs about 120 bytes (32 bit) per drawn part of the objects with several styles.
+ *Styles changed at run time still need to be reported with `lv_obj_report_style_change()`*/
+#ifndef LV_USE_OBJ_STYLE_CACHE
+    #ifdef CONFIG_LV_USE_OBJ_STYLE_CACHE
+        #define LV_USE_OBJ_STYLE_CACHE CONFIG_LV_USE_OBJ_STYLE_CACHE
+    #else
+        #define LV_USE_OBJ_STYLE_CACHE 0
+    #endif
+#endif
+
 /*-------------
  * GPU
  *-----------*/
@@ -2525,6 +2582,13 @@ LV_EXPORT_CONST_INT(LV_DPI_DEF);
     #define LV_LOG_TRACE_ANIM       0
 #endif  /*LV_USE_LOG*/
 
+/*Variables of the drawing functions: one instance per thread when the screen is rendered in parallel*/
+#if LV_USE_PARALLEL_RENDER
+    #define LV_RENDER_LOCAL _Thread_local
+#else
+    #define LV_RENDER_LOCAL
+#endif
+
 
 /*If running without lv_conf.h add typedefs with default value*/
 #ifdef LV_CONF_SKIP
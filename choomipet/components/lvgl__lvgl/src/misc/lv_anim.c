@@ -24,11 +24,30 @@
 /**********************
  *      TYPEDEFS
  **********************/
+/*How the value of an animation is calculated in a step*/
+typedef enum {
+    ANIM_PATH_LINEAR,
+    ANIM_PATH_EASE_IN,
+    ANIM_PATH_EASE_OUT,
+    ANIM_PATH_EASE_IN_OUT,
+    ANIM_PATH_OVERSHOOT,
+    ANIM_PATH_OTHER,        /*Call `path_cb` when applying the value*/
+    ANIM_PATH_START,        /*Starts in this step: the callbacks may change the values, step it alone*/
+    _ANIM_PATH_LAST,
+} anim_path_kind_t;
+
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void anim_timer(lv_timer_t * param);
+static void anim_refr(uint32_t elaps);
+static void anim_step(lv_anim_t * a, uint32_t elaps);
+static bool anim_batch_reserve(uint32_t cnt);
+static void anim_batch_free(void);
+static void anim_batch_eval(void);
+static bool anim_batch_is_current(uint32_t i);
+static void anim_batch_forget(lv_anim_t * a);
 static void anim_mark_list_change(void);
 static void anim_ready_handler(lv_anim_t * a);
 
@@ -39,6 +58,24 @@ static uint32_t last_timer_run;
 static bool anim_list_changed;
 static bool anim_run_round;
 static lv_timer_t * _lv_anim_tmr;
+static uint32_t step_id;        /*Number of the step being applied, 0: none*/
+static uint32_t step_cnt;
+
+/*The control points of the built-in bezier paths, see `lv_anim_path_ease_in()` etc.*/
+static const uint16_t path_bezier[][2] = {
+    [ANIM_PATH_EASE_IN] = {50, 100},
+    [ANIM_PATH_EASE_OUT] = {900, 950},
+    [ANIM_PATH_EASE_IN_OUT] = {50, 952},
+    [ANIM_PATH_OVERSHOOT] = {1000, 1300},
+};
+
+static const lv_anim_path_cb_t path_cbs[] = {
+    [ANIM_PATH_LINEAR] = lv_anim_path_linear,
+    [ANIM_PATH_EASE_IN] = lv_anim_path_ease_in,
+    [ANIM_PATH_EASE_OUT] = lv_anim_path_ease_out,
+    [ANIM_PATH_EASE_IN_OUT] = lv_anim_path_ease_in_out,
+    [ANIM_PATH_OVERSHOOT] = lv_anim_path_overshoot,
+};
 
 /**********************
  *      MACROS
@@ -57,6 +94,7 @@ static lv_timer_t * _lv_anim_tmr;
 void _lv_anim_core_init(void)
 {
     _lv_ll_init(&LV_GC_ROOT(_lv_anim_ll), sizeof(lv_anim_t));
+    lv_memset_00(&LV_GC_ROOT(_lv_anim_batch), sizeof(_lv_anim_batch_t));
     _lv_anim_tmr = lv_timer_create(anim_timer, LV_DISP_DEF_REFR_PERIOD, NULL);
     anim_mark_list_change(); /*Turn off the animation timer*/
     anim_list_changed = false;
@@ -147,6 +185,7 @@ bool lv_anim_del(void * var, lv_anim_exec_xcb_t exec_cb)
 
         if((a->var == var || var == NULL) && (a->exec_cb == exec_cb || exec_cb == NULL)) {
             _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
+            anim_batch_forget(a);
             if(a->deleted_cb != NULL) a->deleted_cb(a);
             lv_mem_free(a);
             anim_mark_list_change(); /*Read by `anim_timer`. It need to know if a delete occurred in
@@ -162,6 +201,8 @@ bool lv_anim_del(void * var, lv_anim_exec_xcb_t exec_cb)
 
 void lv_anim_del_all(void)
 {
+    _lv_anim_batch_t * batch = &LV_GC_ROOT(_lv_anim_batch);
+    if(batch->applying) batch->cnt = batch->next;
     _lv_ll_clear(&LV_GC_ROOT(_lv_anim_ll));
     anim_mark_list_change();
 }
@@ -183,6 +224,11 @@ struct _lv_timer_t * lv_anim_get_timer(void)
     return _lv_anim_tmr;
 }
 
+uint32_t _lv_anim_get_step_id(void)
+{
+    return step_id;
+}
+
 uint16_t lv_anim_count_running(void)
 {
     uint16_t cnt = 0;
@@ -209,6 +255,18 @@ void lv_anim_refr_now(void)
     anim_timer(NULL);
 }
 
+void _lv_anim_refr_at(uint32_t frame_time, uint32_t period)
+{
+    /*Animations started after the frame time already hold their start value*/
+    if((int32_t)(frame_time - last_timer_run) > 0) {
+        anim_refr(frame_time - last_timer_run);
+        last_timer_run = frame_time;
+    }
+
+    lv_timer_set_period(_lv_anim_tmr, period);
+    lv_timer_reset(_lv_anim_tmr);
+}
+
 int32_t lv_anim_path_linear(const lv_anim_t * a)
 {
     /*Calculate the current step*/
@@ -351,63 +409,287 @@ static void anim_timer(lv_timer_t * param)
 {
     LV_UNUSED(param);
 
-    uint32_t elaps = lv_tick_elaps(last_timer_run);
+    anim_refr(lv_tick_elaps(last_timer_run));
+    last_timer_run = lv_tick_get();
+}
 
+/**
+ * Step every animation by `elaps` milliseconds.
+ * @param elaps time since the last step
+ */
+static void anim_refr(uint32_t elaps)
+{
+    _lv_anim_batch_t * batch = &LV_GC_ROOT(_lv_anim_batch);
     /*Flip the run round*/
     anim_run_round = anim_run_round ? false : true;
 
-    lv_anim_t * a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
+    step_cnt++;
+    if(step_cnt == 0) step_cnt = 1;
+    uint32_t step_id_prev = step_id;
+    step_id = step_cnt;
 
-    while(a != NULL) {
-        /*It can be set by `lv_anim_del()` typically in `end_cb`. If set then an animation delete
-         * happened in `anim_ready_handler` which could make this linked list reading corrupt
-         * because the list is changed meanwhile
-         */
-        anim_list_changed = false;
-
-        if(a->run_round != anim_run_round) {
-            a->run_round = anim_run_round; /*The list readying might be reset so need to know which anim has run already*/
-
-            /*The animation will run now for the first time. Call `start_cb`*/
-            int32_t new_act_time = a->act_time + elaps;
-            if(!a->start_cb_called && a->act_time <= 0 && new_act_time >= 0) {
-                if(a->early_apply == 0 && a->get_value_cb) {
-                    int32_t v_ofs = a->get_value_cb(a);
-                    a->start_value += v_ofs;
-                    a->end_value += v_ofs;
-                }
-                if(a->start_cb) a->start_cb(a);
-                a->start_cb_called = 1;
-            }
-            a->act_time += elaps;
-            if(a->act_time >= 0) {
-                if(a->act_time > a->time) a->act_time = a->time;
-
-                int32_t new_value;
-                new_value = a->path_cb(a);
-
-                if(new_value != a->current_value) {
-                    a->current_value = new_value;
-                    /*Apply the calculated value*/
-                    if(a->exec_cb) a->exec_cb(a->var, new_value);
-                }
-
-                /*If the time is elapsed the animation is ready*/
-                if(a->act_time >= a->time) {
-                    anim_ready_handler(a);
-                }
+    uint32_t cnt = 0;
+    lv_anim_t * a;
+    _LV_LL_READ(&LV_GC_ROOT(_lv_anim_ll), a) cnt++;
+
+    if(batch->applying || cnt == 0 || !anim_batch_reserve(cnt)) {
+        /*Step the animations one by one.
+         *It's also the way if a callback refreshes the animations while a step is applied.*/
+        a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
+        while(a != NULL) {
+            /*It can be set by `lv_anim_del()` typically in `end_cb`. If set then an animation delete
+             * happened in `anim_ready_handler` which could make this linked list reading corrupt
+             * because the list is changed meanwhile
+             */
+            anim_list_changed = false;
+
+            if(a->run_round != anim_run_round) {
+                a->run_round = anim_run_round; /*The list readying might be reset so need to know which anim has run already*/
+                anim_step(a, elaps);
             }
+
+            /*If the linked list changed due to anim. delete then it's not safe to continue
+             *the reading of the list from here -> start from the head*/
+            if(anim_list_changed)
+                a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
+            else
+                a = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
         }
+        /*Refreshed from a callback of a step: every animation is stepped already, don't apply the rest of it*/
+        if(batch->applying) batch->cnt = batch->next;
+        step_id = step_id_prev;
+        return;
+    }
 
-        /*If the linked list changed due to anim. delete then it's not safe to continue
-         *the reading of the list from here -> start from the head*/
-        if(anim_list_changed)
-            a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-        else
-            a = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
+    /*Advance the time of every animation. No callbacks are called so the list doesn't change.*/
+    batch->cnt = 0;
+    _LV_LL_READ(&LV_GC_ROOT(_lv_anim_ll), a) {
+        a->run_round = anim_run_round;
+
+        uint32_t i = batch->cnt;
+        int32_t new_act_time = a->act_time + elaps;
+        if(!a->start_cb_called && a->act_time <= 0 && new_act_time >= 0) {
+            batch->kinds[i] = ANIM_PATH_START;
+        }
+        else {
+            a->act_time = new_act_time;
+            if(a->act_time < 0) continue;
+            if(a->act_time > a->time) a->act_time = a->time;
+
+            if(a->path_cb == lv_anim_path_linear) batch->kinds[i] = ANIM_PATH_LINEAR;
+            else if(a->path_cb == lv_anim_path_ease_in) batch->kinds[i] = ANIM_PATH_EASE_IN;
+            else if(a->path_cb == lv_anim_path_ease_out) batch->kinds[i] = ANIM_PATH_EASE_OUT;
+            else if(a->path_cb == lv_anim_path_ease_in_out) batch->kinds[i] = ANIM_PATH_EASE_IN_OUT;
+            else if(a->path_cb == lv_anim_path_overshoot) batch->kinds[i] = ANIM_PATH_OVERSHOOT;
+            else batch->kinds[i] = ANIM_PATH_OTHER;
+
+            batch->act_time[i] = a->act_time;
+            batch->time[i] = a->time;
+            batch->start[i] = a->start_value;
+            batch->diff[i] = a->end_value - a->start_value;
+            batch->value[i] = lv_map(a->act_time, 0, a->time, 0, LV_ANIM_RESOLUTION);
+        }
+        batch->anims[i] = a;
+        batch->cnt++;
     }
 
-    last_timer_run = lv_tick_get();
+    anim_batch_eval();
+
+    /*Apply the values in the order of the list*/
+    batch->applying = true;
+    for(batch->next = 0; batch->next < batch->cnt;) {
+        uint32_t i = batch->next++;
+        a = batch->anims[i];
+        if(a == NULL) continue;
+
+        if(batch->kinds[i] == ANIM_PATH_START) {
+            anim_step(a, elaps);
+            continue;
+        }
+
+        int32_t new_value;
+        if(batch->kinds[i] != ANIM_PATH_OTHER && anim_batch_is_current(i)) {
+            new_value = batch->value[i];
+        }
+        else {
+            /*Changed by a callback of this step (e.g. restarted or retargeted): calculate it now*/
+            if(a->act_time < 0) continue;
+            if(a->act_time > a->time) a->act_time = a->time;
+            new_value = a->path_cb(a);
+        }
+
+        if(new_value != a->current_value) {
+            a->current_value = new_value;
+            /*Apply the calculated value*/
+            if(a->exec_cb) a->exec_cb(a->var, new_value);
+        }
+
+        /*If the time is elapsed the animation is ready*/
+        if(a->act_time >= a->time) {
+            anim_ready_handler(a);
+        }
+    }
+    batch->applying = false;
+    if(_lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll)) == NULL) anim_batch_free();
+    step_id = step_id_prev;
+}
+
+/**
+ * Step an animation by `elaps` milliseconds and apply its new value
+ * @param a     pointer to an animation descriptor
+ * @param elaps time since the last step
+ */
+static void anim_step(lv_anim_t * a, uint32_t elaps)
+{
+    /*The animation will run now for the first time. Call `start_cb`*/
+    int32_t new_act_time = a->act_time + elaps;
+    if(!a->start_cb_called && a->act_time <= 0 && new_act_time >= 0) {
+        if(a->early_apply == 0 && a->get_value_cb) {
+            int32_t v_ofs = a->get_value_cb(a);
+            a->start_value += v_ofs;
+            a->end_value += v_ofs;
+        }
+        if(a->start_cb) a->start_cb(a);
+        a->start_cb_called = 1;
+    }
+    a->act_time += elaps;
+    if(a->act_time >= 0) {
+        if(a->act_time > a->time) a->act_time = a->time;
+
+        int32_t new_value;
+        new_value = a->path_cb(a);
+
+        if(new_value != a->current_value) {
+            a->current_value = new_value;
+            /*Apply the calculated value*/
+            if(a->exec_cb) a->exec_cb(a->var, new_value);
+        }
+
+        /*If the time is elapsed the animation is ready*/
+        if(a->act_time >= a->time) {
+            anim_ready_handler(a);
+        }
+    }
+}
+
+/**
+ * Make the arrays of the batch large enough for the animations of a step.
+ * They are kept between the steps and reallocated only if there are more animations.
+ * @param cnt number of animations
+ * @return false: out of memory
+ */
+static bool anim_batch_reserve(uint32_t cnt)
+{
+    _lv_anim_batch_t * batch = &LV_GC_ROOT(_lv_anim_batch);
+    if(cnt <= batch->size) return true;
+    if(cnt > UINT16_MAX) return false;
+
+    /*Grow by 8 animations at once. The old arrays hold nothing of interest between the steps.*/
+    uint32_t size = (cnt + 7) & ~7U;
+    anim_batch_free();
+
+    /*One allocation for all the arrays, the largest elements first*/
+    batch->anims = lv_mem_alloc(size * (sizeof(lv_anim_t *) + 5 * sizeof(int32_t) + sizeof(uint16_t) +
+                                        sizeof(uint8_t)));
+    if(batch->anims == NULL) return false;
+    batch->act_time = (int32_t *)(batch->anims + size);
+    batch->time = batch->act_time + size;
+    batch->start = batch->time + size;
+    batch->diff = batch->start + size;
+    batch->value = batch->diff + size;
+    batch->order = (uint16_t *)(batch->value + size);
+    batch->kinds = (uint8_t *)(batch->order + size);
+    batch->size = size;
+    return true;
+}
+
+/**
+ * Free the arrays of the batch, when no animation is left
+ */
+static void anim_batch_free(void)
+{
+    _lv_anim_batch_t * batch = &LV_GC_ROOT(_lv_anim_batch);
+    lv_mem_free(batch->anims);
+    lv_memset_00(batch, sizeof(_lv_anim_batch_t));
+}
+
+/**
+ * Calculate the value of the animations on the built-in paths, grouped by path.
+ * The new values replace the progress in the `value` array of the batch.
+ */
+static void anim_batch_eval(void)
+{
+    _lv_anim_batch_t * batch = &LV_GC_ROOT(_lv_anim_batch);
+    /*Sort the indices by kind*/
+    uint32_t kind_start[_ANIM_PATH_LAST + 1];
+    lv_memset_00(kind_start, sizeof(kind_start));
+    uint32_t i;
+    for(i = 0; i < batch->cnt; i++) kind_start[batch->kinds[i] + 1]++;
+    for(i = 1; i <= _ANIM_PATH_LAST; i++) kind_start[i] += kind_start[i - 1];
+    uint32_t kind_end[_ANIM_PATH_LAST];
+    lv_memcpy(kind_end, kind_start, sizeof(kind_end));
+    for(i = 0; i < batch->cnt; i++) batch->order[kind_end[batch->kinds[i]]++] = (uint16_t)i;
+
+    const uint16_t * order = batch->order;
+    const int32_t * start = batch->start;
+    const int32_t * diff = batch->diff;
+    int32_t * value = batch->value;
+
+    /*Same as `lv_anim_path_linear()`*/
+    for(i = kind_start[ANIM_PATH_LINEAR]; i < kind_start[ANIM_PATH_LINEAR + 1]; i++) {
+        uint32_t j = order[i];
+        value[j] = ((value[j] * diff[j]) >> LV_ANIM_RES_SHIFT) + start[j];
+    }
+
+    /*Same as `lv_bezier3(t, 0, u1, u2, LV_BEZIER_VAL_MAX)` in `lv_anim_path_ease_in()` etc.*/
+    uint32_t kind;
+    for(kind = ANIM_PATH_EASE_IN; kind <= ANIM_PATH_OVERSHOOT; kind++) {
+        uint32_t u1 = path_bezier[kind][0];
+        uint32_t u2 = path_bezier[kind][1];
+        for(i = kind_start[kind]; i < kind_start[kind + 1]; i++) {
+            uint32_t j = order[i];
+            uint32_t tj = value[j];
+            uint32_t t_rem  = LV_BEZIER_VAL_MAX - tj;
+            uint32_t t_rem2 = (t_rem * t_rem) >> 10;
+            uint32_t t2     = (tj * tj) >> 10;
+            uint32_t t3     = (t2 * tj) >> 10;
+            int32_t step = (int32_t)(((3 * t_rem2 * tj * u1) >> 20) + ((3 * t_rem * t2 * u2) >> 20) + t3);
+            value[j] = ((step * diff[j]) >> LV_BEZIER_VAL_SHIFT) + start[j];
+        }
+    }
+}
+
+/**
+ * Tell whether the value calculated by `anim_batch_eval()` for an animation is still valid,
+ * i.e. a callback of the step didn't change the animation since it was collected
+ * @param i     index of the animation in the batch
+ * @return      true: the value can be applied
+ */
+static bool anim_batch_is_current(uint32_t i)
+{
+    _lv_anim_batch_t * batch = &LV_GC_ROOT(_lv_anim_batch);
+    const lv_anim_t * a = batch->anims[i];
+    return a->path_cb == path_cbs[batch->kinds[i]] && a->act_time == batch->act_time[i] &&
+           a->time == batch->time[i] && a->start_value == batch->start[i] &&
+           a->end_value - a->start_value == batch->diff[i];
+}
+
+/**
+ * Drop a deleted animation from the step being applied
+ * @param a pointer to an animation descriptor
+ */
+static void anim_batch_forget(lv_anim_t * a)
+{
+    _lv_anim_batch_t * batch = &LV_GC_ROOT(_lv_anim_batch);
+    if(!batch->applying) return;
+
+    uint32_t i;
+    for(i = batch->next; i < batch->cnt; i++) {
+        if(batch->anims[i] == a) {
+            batch->anims[i] = NULL;
+            break;
+        }
+    }
 }
 
 /**
@@ -430,6 +712,7 @@ static void anim_ready_handler(lv_anim_t * a)
         /*Delete the animation from the list.
          * This way the `ready_cb` will see the animations like it's animation is ready deleted*/
         _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
+        anim_batch_forget(a);
         /*Flag that the list has changed*/
         anim_mark_list_change();
 
@@ -463,8 +746,10 @@ static void anim_ready_handler(lv_anim_t * a)
 static void anim_mark_list_change(void)
 {
     anim_list_changed = true;
-    if(_lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll)) == NULL)
+    if(_lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll)) == NULL) {
         lv_timer_pause(_lv_anim_tmr);
+        if(!LV_GC_ROOT(_lv_anim_batch).applying) anim_batch_free();
+    }
     else
         lv_timer_resume(_lv_anim_tmr);
 }
@@ -98,6 +98,27 @@ typedef struct _lv_anim_t {
     uint8_t start_cb_called : 1;    /**< Indicates that the `start_cb` was already called*/
 } lv_anim_t;
 
+/**
+ * The animations of a step, in the order of the list. The values of the built-in paths are calculated
+ * for all the animations of a path in one loop from the arrays, before any value is applied.
+ * A value is used only if the animation wasn't changed by a callback meanwhile.
+ * The arrays are kept between the steps and freed when no animation is left.
+ */
+typedef struct {
+    lv_anim_t ** anims;     /**< NULL if deleted while the step is applied*/
+    uint8_t * kinds;        /**< How the value is calculated*/
+    int32_t * act_time;
+    int32_t * time;
+    int32_t * start;
+    int32_t * diff;         /**< End value - start value*/
+    int32_t * value;        /**< Progress [0..1024], then the new value*/
+    uint16_t * order;       /**< Indices grouped by kind*/
+    uint32_t cnt;
+    uint32_t size;          /**< Number of animations the arrays can hold*/
+    uint32_t next;          /**< First animation not applied yet*/
+    bool applying;
+} _lv_anim_batch_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -419,6 +440,23 @@ uint32_t lv_anim_speed_to_time(uint32_t speed, int32_t start, int32_t end);
  */
 void lv_anim_refr_now(void);
 
+/**
+ * Advance the animations to the time a frame is shown instead of the current tick.
+ * Called by the frame pacing of the display refresh, so the drawn values belong to evenly spaced
+ * frame times. The animation timer is restarted with `period` and runs on its own only when no
+ * paced frame is drawn.
+ * @param frame_time    tick of the frame being drawn
+ * @param period        the paced frame period [ms]
+ */
+void _lv_anim_refr_at(uint32_t frame_time, uint32_t period);
+
+/**
+ * Tell which animation step is being applied, e.g. to do the work of an object changed by several
+ * animations only once in a step.
+ * @return 0: no step is being applied, else a number that differs from the previous steps
+ */
+uint32_t _lv_anim_get_step_id(void);
+
 /**
  * Calculate the current value of an animation applying linear characteristic
  * @param a     pointer to an animation
@@ -544,9 +544,9 @@ void lv_point_transform(lv_point_t * p, int32_t angle, int32_t zoom, const lv_po
         return;
     }
 
-    static int32_t angle_prev = INT32_MIN;
-    static int32_t sinma;
-    static int32_t cosma;
+    static LV_RENDER_LOCAL int32_t angle_prev = INT32_MIN;
+    static LV_RENDER_LOCAL int32_t sinma;
+    static LV_RENDER_LOCAL int32_t cosma;
     if(angle_prev != angle) {
         int32_t angle_limited = angle;
         if(angle_limited > 3600) angle_limited -= 3600;
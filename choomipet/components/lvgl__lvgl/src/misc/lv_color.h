@@ -441,19 +441,23 @@ static inline lv_color_t LV_ATTRIBUTE_FAST_MEM lv_color_mix(lv_color_t c1, lv_co
     lv_color_t ret;
 
 #if LV_COLOR_DEPTH == 16 && LV_COLOR_MIX_ROUND_OFS == 0
-#if LV_COLOR_16_SWAP == 1
-    c1.full = c1.full << 8 | c1.full >> 8;
-    c2.full = c2.full << 8 | c2.full >> 8;
-#endif
     /*Source: https://stackoverflow.com/a/50012418/1999969*/
     mix = (uint32_t)((uint32_t)mix + 4) >> 3;
+#if LV_COLOR_16_SWAP == 0
     uint32_t bg = (uint32_t)((uint32_t)c2.full | ((uint32_t)c2.full << 16)) &
                   0x7E0F81F; /*0b00000111111000001111100000011111*/
     uint32_t fg = (uint32_t)((uint32_t)c1.full | ((uint32_t)c1.full << 16)) & 0x7E0F81F;
     uint32_t result = ((((fg - bg) * mix) >> 5) + bg) & 0x7E0F81F;
     ret.full = (uint16_t)((result >> 16) | result);
-#if LV_COLOR_16_SWAP == 1
-    ret.full = ret.full << 8 | ret.full >> 8;
+#else
+    /*Same trick on the swapped layout (gggBBBBB RRRRRGGG) without swapping back and forth:
+     *shifting the doubled pixel right by 3 puts R at bit 0, the two halves of G next to each other
+     *at bit 10 and B at bit 21, leaving the same 5 bit gaps as the native layout*/
+    uint32_t bg = (((uint32_t)c2.full | ((uint32_t)c2.full << 16)) >> 3) &
+                  0x3E0FC1F; /*0b00000011111000001111110000011111*/
+    uint32_t fg = (((uint32_t)c1.full | ((uint32_t)c1.full << 16)) >> 3) & 0x3E0FC1F;
+    uint32_t result = ((((fg - bg) * mix) >> 5) + bg) & 0x3E0FC1F;
+    ret.full = (uint16_t)((result << 3) | (result >> 13));
 #endif
 #elif LV_COLOR_DEPTH != 1
     /*LV_COLOR_DEPTH == 8, 16 or 32*/
@@ -28,6 +28,7 @@ struct _lv_lru_item_t {
     size_t value_length;
     size_t key_length;
     uint64_t access_count;
+    uint32_t weight;
     struct _lv_lru_item_t * next;
 };
 
@@ -75,11 +76,11 @@ lv_lru_t * lv_lru_create(size_t cache_size, size_t average_length, lv_lru_free_t
 {
     // create the cache
     lv_lru_t * cache = (lv_lru_t *) lv_mem_alloc(sizeof(lv_lru_t));
-    lv_memset_00(cache, sizeof(lv_lru_t));
     if(!cache) {
         LV_LOG_WARN("LRU Cache unable to create cache object");
         return NULL;
     }
+    lv_memset_00(cache, sizeof(lv_lru_t));
     cache->hash_table_size = cache_size / average_length;
     cache->average_item_length = average_length;
     cache->free_memory = cache_size;
@@ -90,12 +91,12 @@ lv_lru_t * lv_lru_create(size_t cache_size, size_t average_length, lv_lru_free_t
 
     // size the hash table to a guestimate of the number of slots required (assuming a perfect hash)
     cache->items = (lv_lru_item_t **) lv_mem_alloc(sizeof(lv_lru_item_t *) * cache->hash_table_size);
-    lv_memset_00(cache->items, sizeof(lv_lru_item_t *) * cache->hash_table_size);
     if(!cache->items) {
         LV_LOG_WARN("LRU Cache unable to create cache hash table");
         lv_mem_free(cache);
         return NULL;
     }
+    lv_memset_00(cache->items, sizeof(lv_lru_item_t *) * cache->hash_table_size);
     return cache;
 }
 
@@ -165,8 +166,14 @@ lv_lru_res_t lv_lru_set(lv_lru_t * cache, const void * key, size_t key_length, v
     else {
         // insert a new item
         item = lv_lru_pop_or_create_item(cache);
-        item->value = value;
+        if(!item) return LV_LRU_MISSING_CACHE;
         item->key = lv_mem_alloc(key_length);
+        if(!item->key) {
+            item->next = cache->free_items;
+            cache->free_items = item;
+            return LV_LRU_MISSING_KEY;
+        }
+        item->value = value;
         memcpy(item->key, key, key_length);
         item->value_length = value_length;
         item->key_length = key_length;
@@ -177,7 +184,7 @@ lv_lru_res_t lv_lru_set(lv_lru_t * cache, const void * key, size_t key_length, v
         else
             cache->items[hash_index] = item;
     }
-    item->access_count = ++cache->access_count;
+    item->access_count = ++cache->access_count + item->weight;
 
     // remove as many items as necessary to free enough space
     if(required > 0 && (size_t) required > cache->free_memory) {
@@ -203,7 +210,7 @@ lv_lru_res_t lv_lru_get(lv_lru_t * cache, const void * key, size_t key_size, voi
 
     if(item) {
         *value = item->value;
-        item->access_count = ++cache->access_count;
+        item->access_count = ++cache->access_count + item->weight;
     }
     else {
         *value = NULL;
@@ -234,6 +241,25 @@ lv_lru_res_t lv_lru_remove(lv_lru_t * cache, const void * key, size_t key_size)
     return LV_LRU_OK;
 }
 
+lv_lru_res_t lv_lru_set_weight(lv_lru_t * cache, const void * key, size_t key_size, uint32_t weight)
+{
+    test_for_missing_cache();
+    test_for_missing_key();
+
+    uint32_t hash_index = lv_lru_hash(cache, key, key_size);
+    lv_lru_item_t * item = cache->items[hash_index];
+
+    while(item && lv_lru_cmp_keys(item, key, key_size))
+        item = (lv_lru_item_t *) item->next;
+
+    if(item) {
+        item->access_count = item->access_count - item->weight + weight;
+        item->weight = weight;
+    }
+
+    return LV_LRU_OK;
+}
+
 void lv_lru_remove_lru_item(lv_lru_t * cache)
 {
     lv_lru_item_t * min_item = NULL, *min_prev = NULL;
@@ -342,7 +368,7 @@ static lv_lru_item_t * lv_lru_pop_or_create_item(lv_lru_t * cache)
     }
     else {
         item = (lv_lru_item_t *) lv_mem_alloc(sizeof(lv_lru_item_t));
-        lv_memset_00(item, sizeof(lv_lru_item_t));
+        if(item) lv_memset_00(item, sizeof(lv_lru_item_t));
     }
 
     return item;
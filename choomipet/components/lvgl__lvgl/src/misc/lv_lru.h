@@ -71,6 +71,12 @@ lv_lru_res_t lv_lru_get(lv_lru_t * cache, const void * key, size_t key_size, voi
 
 lv_lru_res_t lv_lru_remove(lv_lru_t * cache, const void * key, size_t key_size);
 
+/**
+ * Keep an item as if it was used `weight` more times at every access.
+ * E.g. to keep the items which are slow to create longer than the others.
+ */
+lv_lru_res_t lv_lru_set_weight(lv_lru_t * cache, const void * key, size_t key_size, uint32_t weight);
+
 /**
  * remove the least recently used item
  *
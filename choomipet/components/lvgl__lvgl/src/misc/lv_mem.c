@@ -12,6 +12,11 @@
 #include "lv_gc.h"
 #include "lv_assert.h"
 #include "lv_log.h"
+#include "../draw/lv_img_cache.h"
+#include "../draw/sw/lv_draw_sw_gradient.h"
+#if LV_USE_PARALLEL_RENDER
+    #include "../core/lv_refr.h"
+#endif
 
 #if LV_MEM_CUSTOM != 0
     #include LV_MEM_CUSTOM_INCLUDE
@@ -39,6 +44,15 @@
 
 #define ZERO_MEM_SENTINEL  0xa1b2c3d4
 
+/*The threads rendering in parallel share the heap*/
+#if LV_USE_PARALLEL_RENDER && LV_MEM_CUSTOM == 0
+    #define HEAP_LOCK()      _lv_refr_lock()
+    #define HEAP_UNLOCK()    _lv_refr_unlock()
+#else
+    #define HEAP_LOCK()
+    #define HEAP_UNLOCK()
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -49,6 +63,7 @@
 #if LV_MEM_CUSTOM == 0
     static void lv_mem_walker(void * ptr, size_t size, int used, void * user);
 #endif
+static bool evict_cached(void);
 
 /**********************
  *  STATIC VARIABLES
@@ -130,12 +145,22 @@ void * lv_mem_alloc(size_t size)
         return &zero_mem;
     }
 
+    HEAP_LOCK();
 #if LV_MEM_CUSTOM == 0
     void * alloc = lv_tlsf_malloc(tlsf, size);
 #else
     void * alloc = LV_MEM_CUSTOM_ALLOC(size);
 #endif
 
+    /*Make room by dropping the least recently used cached images and gradients*/
+    while(alloc == NULL && evict_cached()) {
+#if LV_MEM_CUSTOM == 0
+        alloc = lv_tlsf_malloc(tlsf, size);
+#else
+        alloc = LV_MEM_CUSTOM_ALLOC(size);
+#endif
+    }
+
     if(alloc == NULL) {
         LV_LOG_INFO("couldn't allocate memory (%lu bytes)", (unsigned long)size);
 #if LV_LOG_LEVEL <= LV_LOG_LEVEL_INFO
@@ -159,6 +184,7 @@ void * lv_mem_alloc(size_t size)
 #endif
         MEM_TRACE("allocated at %p", alloc);
     }
+    HEAP_UNLOCK();
     return alloc;
 }
 
@@ -176,9 +202,11 @@ void lv_mem_free(void * data)
 #  if LV_MEM_ADD_JUNK
     lv_memset(data, 0xbb, lv_tlsf_block_size(data));
 #  endif
+    HEAP_LOCK();
     size_t size = lv_tlsf_free(tlsf, data);
     if(cur_used > size) cur_used -= size;
     else cur_used = 0;
+    HEAP_UNLOCK();
 #else
     LV_MEM_CUSTOM_FREE(data);
 #endif
@@ -203,7 +231,13 @@ void * lv_mem_realloc(void * data_p, size_t new_size)
     if(data_p == &zero_mem) return lv_mem_alloc(new_size);
 
 #if LV_MEM_CUSTOM == 0
+    HEAP_LOCK();
     void * new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
+    /*`data_p` is kept if it fails*/
+    while(new_p == NULL && evict_cached()) {
+        new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
+    }
+    HEAP_UNLOCK();
 #else
     void * new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
 #endif
@@ -547,6 +581,24 @@ void LV_ATTRIBUTE_FAST_MEM lv_memset_ff(void * dst, size_t len)
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Drop the least recently used image or gradient kept between frames when an allocation fails.
+ * The images are preferred as they are usually larger.
+ * @return false if there was nothing to drop
+ */
+static bool evict_cached(void)
+{
+    /*Closing an image doesn't allocate, but a decoder might*/
+    static LV_RENDER_LOCAL bool evicting;
+    if(evicting) return false;
+
+    evicting = true;
+    bool res = _lv_img_cache_evict_lru() || _lv_gradient_evict_lru();
+    evicting = false;
+    if(res) LV_LOG_INFO("out of memory, a cached image or gradient is dropped");
+    return res;
+}
+
 #if LV_MEM_CUSTOM == 0
 static void lv_mem_walker(void * ptr, size_t size, int used, void * user)
 {
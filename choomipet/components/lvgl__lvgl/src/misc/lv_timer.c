@@ -17,6 +17,7 @@
  *********************/
 #define IDLE_MEAS_PERIOD 500 /*[ms]*/
 #define DEF_PERIOD 500
+#define HEAP_SIZE_MIN 8
 
 /**********************
  *      TYPEDEFS
@@ -25,16 +26,23 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static bool lv_timer_exec(lv_timer_t * timer);
+static void lv_timer_exec(lv_timer_t * timer);
 static uint32_t lv_timer_time_remaining(lv_timer_t * timer);
+static bool timer_before(const lv_timer_t * a, const lv_timer_t * b);
+static void heap_set(uint32_t idx, lv_timer_t * timer);
+static void heap_sift_up(uint32_t idx);
+static void heap_sift_down(uint32_t idx);
+static void heap_push(lv_timer_t * timer);
+static void heap_remove(lv_timer_t * timer);
+static void heap_update(lv_timer_t * timer);
+static void heap_park(lv_timer_t * timer);
+static void heap_unpark_all(void);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static bool lv_timer_run = false;
 static uint8_t idle_last = 0;
-static bool timer_deleted;
-static bool timer_created;
 
 /**********************
  *      MACROS
@@ -55,6 +63,7 @@ static bool timer_created;
 void _lv_timer_core_init(void)
 {
     _lv_ll_init(&LV_GC_ROOT(_lv_timer_ll), sizeof(lv_timer_t));
+    lv_memset_00(&LV_GC_ROOT(_lv_timer_heap), sizeof(_lv_timer_heap_t));
 
     /*Initially enable the lv_timer handling*/
     lv_timer_enable(true);
@@ -95,39 +104,24 @@ uint32_t LV_ATTRIBUTE_TIMER_HANDLER lv_timer_handler(void)
         }
     }
 
-    /*Run all timer from the list*/
-    lv_timer_t * next;
-    do {
-        timer_deleted             = false;
-        timer_created             = false;
-        LV_GC_ROOT(_lv_timer_act) = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-        while(LV_GC_ROOT(_lv_timer_act)) {
-            /*The timer might be deleted if it runs only once ('repeat_count = 1')
-             *So get next element until the current is surely valid*/
-            next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), LV_GC_ROOT(_lv_timer_act));
-
-            if(lv_timer_exec(LV_GC_ROOT(_lv_timer_act))) {
-                /*If a timer was created or deleted then this or the next item might be corrupted*/
-                if(timer_created || timer_deleted) {
-                    TIMER_TRACE("Start from the first timer again because a timer was created or deleted");
-                    break;
-                }
-            }
-
-            LV_GC_ROOT(_lv_timer_act) = next; /*Load the next timer*/
-        }
-    } while(LV_GC_ROOT(_lv_timer_act));
+    /*Run the due timers in the order they are due. The ones already called are parked until the end
+     *so a timer runs at most once even if it's due again at once (e.g. `period == 0`)*/
+    _lv_timer_heap_t * heap = &LV_GC_ROOT(_lv_timer_heap);
+    while(heap->cnt) {
+        lv_timer_t * timer = heap->timers[0];
+        if(timer->repeat_count != 0 && lv_timer_time_remaining(timer) != 0) break;
 
-    uint32_t time_till_next = LV_NO_TIMER_READY;
-    next = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-    while(next) {
-        if(!next->paused) {
-            uint32_t delay = lv_timer_time_remaining(next);
-            if(delay < time_till_next)
-                time_till_next = delay;
-        }
+        heap_park(timer);
+        LV_GC_ROOT(_lv_timer_act) = timer;
+        lv_timer_exec(timer);
+    }
+    LV_GC_ROOT(_lv_timer_act) = NULL;
+    heap_unpark_all();
 
-        next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), next); /*Find the next timer*/
+    uint32_t time_till_next = LV_NO_TIMER_READY;
+    if(heap->cnt) {
+        lv_timer_t * timer = heap->timers[0];
+        time_till_next = timer->repeat_count == 0 ? 0 : lv_timer_time_remaining(timer);
     }
 
     busy_time += lv_tick_elaps(handler_start);
@@ -167,6 +161,17 @@ lv_timer_t * lv_timer_create_basic(void)
 lv_timer_t * lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void * user_data)
 {
     lv_timer_t * new_timer = NULL;
+    _lv_timer_heap_t * heap = &LV_GC_ROOT(_lv_timer_heap);
+
+    /*Every timer has a slot in the queue, so pausing, resuming and parking never allocate*/
+    if(heap->timer_cnt == heap->size) {
+        uint32_t new_size = heap->size ? heap->size * 2 : HEAP_SIZE_MIN;
+        lv_timer_t ** new_timers = lv_mem_realloc(heap->timers, new_size * sizeof(lv_timer_t *));
+        LV_ASSERT_MALLOC(new_timers);
+        if(new_timers == NULL) return NULL;
+        heap->timers = new_timers;
+        heap->size = new_size;
+    }
 
     new_timer = _lv_ll_ins_head(&LV_GC_ROOT(_lv_timer_ll));
     LV_ASSERT_MALLOC(new_timer);
@@ -178,8 +183,10 @@ lv_timer_t * lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void * us
     new_timer->paused = 0;
     new_timer->last_run = lv_tick_get();
     new_timer->user_data = user_data;
+    new_timer->create_id = heap->create_cnt++;
 
-    timer_created = true;
+    heap->timer_cnt++;
+    heap_push(new_timer);
 
     return new_timer;
 }
@@ -201,7 +208,11 @@ void lv_timer_set_cb(lv_timer_t * timer, lv_timer_cb_t timer_cb)
 void lv_timer_del(lv_timer_t * timer)
 {
     _lv_ll_remove(&LV_GC_ROOT(_lv_timer_ll), timer);
-    timer_deleted = true;
+    heap_remove(timer);
+    LV_GC_ROOT(_lv_timer_heap).timer_cnt--;
+
+    /*Tell the timer handler if the running timer deleted itself*/
+    if(LV_GC_ROOT(_lv_timer_act) == timer) LV_GC_ROOT(_lv_timer_act) = NULL;
 
     lv_mem_free(timer);
 }
@@ -212,12 +223,16 @@ void lv_timer_del(lv_timer_t * timer)
  */
 void lv_timer_pause(lv_timer_t * timer)
 {
+    if(timer->paused) return;
     timer->paused = true;
+    heap_remove(timer);
 }
 
 void lv_timer_resume(lv_timer_t * timer)
 {
+    if(!timer->paused) return;
     timer->paused = false;
+    heap_push(timer);
 }
 
 /**
@@ -228,6 +243,7 @@ void lv_timer_resume(lv_timer_t * timer)
 void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 {
     timer->period = period;
+    heap_update(timer);
 }
 
 /**
@@ -237,6 +253,7 @@ void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 void lv_timer_ready(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get() - timer->period - 1;
+    heap_update(timer);
 }
 
 /**
@@ -247,6 +264,7 @@ void lv_timer_ready(lv_timer_t * timer)
 void lv_timer_set_repeat_count(lv_timer_t * timer, int32_t repeat_count)
 {
     timer->repeat_count = repeat_count;
+    heap_update(timer);
 }
 
 /**
@@ -257,6 +275,7 @@ void lv_timer_set_repeat_count(lv_timer_t * timer, int32_t repeat_count)
 void lv_timer_reset(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get();
+    heap_update(timer);
 }
 
 /**
@@ -293,37 +312,28 @@ lv_timer_t * lv_timer_get_next(lv_timer_t * timer)
  **********************/
 
 /**
- * Execute timer if its remaining time is zero
+ * Execute a due timer and delete it if its repeat count is over
  * @param timer pointer to lv_timer
- * @return true: execute, false: not executed
  */
-static bool lv_timer_exec(lv_timer_t * timer)
+static void lv_timer_exec(lv_timer_t * timer)
 {
-    if(timer->paused) return false;
-
-    bool exec = false;
-    if(lv_timer_time_remaining(timer) == 0) {
-        /* Decrement the repeat count before executing the timer_cb.
-         * If any timer is deleted `if(timer->repeat_count == 0)` is not executed below
-         * but at least the repeat count is zero and the timer can be deleted in the next round*/
-        int32_t original_repeat_count = timer->repeat_count;
-        if(timer->repeat_count > 0) timer->repeat_count--;
-        timer->last_run = lv_tick_get();
-        TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
-        if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
-        TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
-        LV_ASSERT_MEM_INTEGRITY();
-        exec = true;
-    }
+    /* Decrement the repeat count before executing the timer_cb.
+     * If the timer is deleted `if(timer->repeat_count == 0)` is not executed below
+     * but at least the repeat count is zero and the timer can be deleted in the next round*/
+    int32_t original_repeat_count = timer->repeat_count;
+    if(timer->repeat_count > 0) timer->repeat_count--;
+    timer->last_run = lv_tick_get();
+    TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
+    if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
+    TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
+    LV_ASSERT_MEM_INTEGRITY();
 
-    if(timer_deleted == false) { /*The timer might be deleted by itself as well*/
+    if(LV_GC_ROOT(_lv_timer_act) == timer) { /*The timer might be deleted by itself as well*/
         if(timer->repeat_count == 0) { /*The repeat count is over, delete the timer*/
             TIMER_TRACE("deleting timer with %p callback because the repeat count is over", *((void **)&timer->timer_cb));
             lv_timer_del(timer);
         }
     }
-
-    return exec;
 }
 
 /**
@@ -339,3 +349,138 @@ static uint32_t lv_timer_time_remaining(lv_timer_t * timer)
         return 0;
     return timer->period - elp;
 }
+
+/**
+ * Tell if a timer is due before an other. Timers with an exhausted repeat count come first
+ * to be deleted. The due times are compared by their difference so they can wrap around.
+ * @param a pointer to lv_timer
+ * @param b pointer to an other lv_timer
+ * @return true: `a` must run before `b`
+ */
+static bool timer_before(const lv_timer_t * a, const lv_timer_t * b)
+{
+    if((a->repeat_count == 0) != (b->repeat_count == 0)) return a->repeat_count == 0;
+
+    int32_t diff = (int32_t)((a->last_run + a->period) - (b->last_run + b->period));
+    if(diff != 0) return diff < 0;
+
+    /*Same as the order of the timer list: the newest first*/
+    return (int32_t)(a->create_id - b->create_id) > 0;
+}
+
+static void heap_set(uint32_t idx, lv_timer_t * timer)
+{
+    LV_GC_ROOT(_lv_timer_heap).timers[idx] = timer;
+    timer->heap_idx = idx;
+}
+
+static void heap_sift_up(uint32_t idx)
+{
+    lv_timer_t ** timers = LV_GC_ROOT(_lv_timer_heap).timers;
+    lv_timer_t * timer = timers[idx];
+    while(idx > 0) {
+        uint32_t parent = (idx - 1) / 2;
+        if(!timer_before(timer, timers[parent])) break;
+        heap_set(idx, timers[parent]);
+        idx = parent;
+    }
+    heap_set(idx, timer);
+}
+
+static void heap_sift_down(uint32_t idx)
+{
+    _lv_timer_heap_t * heap = &LV_GC_ROOT(_lv_timer_heap);
+    lv_timer_t * timer = heap->timers[idx];
+    while(1) {
+        uint32_t child = idx * 2 + 1;
+        if(child >= heap->cnt) break;
+        if(child + 1 < heap->cnt && timer_before(heap->timers[child + 1], heap->timers[child])) child++;
+        if(!timer_before(heap->timers[child], timer)) break;
+        heap_set(idx, heap->timers[child]);
+        idx = child;
+    }
+    heap_set(idx, timer);
+}
+
+/**
+ * Add a timer to the heap. The first parked timer moves after the last one to make room.
+ * @param timer pointer to lv_timer which is not in the queue
+ */
+static void heap_push(lv_timer_t * timer)
+{
+    _lv_timer_heap_t * heap = &LV_GC_ROOT(_lv_timer_heap);
+    if(heap->ran_cnt) heap_set(heap->cnt + heap->ran_cnt, heap->timers[heap->cnt]);
+    heap_set(heap->cnt, timer);
+    heap->cnt++;
+    heap_sift_up(heap->cnt - 1);
+}
+
+/**
+ * Remove a timer from the heap or from the parked timers
+ * @param timer pointer to lv_timer
+ */
+static void heap_remove(lv_timer_t * timer)
+{
+    _lv_timer_heap_t * heap = &LV_GC_ROOT(_lv_timer_heap);
+    uint32_t idx = timer->heap_idx;
+    if(idx == LV_TIMER_IDX_NONE) return;
+    timer->heap_idx = LV_TIMER_IDX_NONE;
+
+    if(idx >= heap->cnt) {
+        /*Parked: fill the gap with the last parked timer*/
+        heap->ran_cnt--;
+        uint32_t last = heap->cnt + heap->ran_cnt;
+        if(idx != last) heap_set(idx, heap->timers[last]);
+        return;
+    }
+
+    /*Fill the gap with the last timer of the heap and move it to its place*/
+    heap->cnt--;
+    if(idx != heap->cnt) {
+        lv_timer_t * moved = heap->timers[heap->cnt];
+        heap_set(idx, moved);
+        heap_sift_up(idx);
+        heap_sift_down(moved->heap_idx);
+    }
+
+    /*The parked timers start right after the heap*/
+    if(heap->ran_cnt) heap_set(heap->cnt, heap->timers[heap->cnt + heap->ran_cnt]);
+}
+
+/**
+ * Restore the order of the heap after the due time or the repeat count of a timer has changed.
+ * Parked timers are sorted in when the handler finishes.
+ * @param timer pointer to lv_timer
+ */
+static void heap_update(lv_timer_t * timer)
+{
+    uint32_t idx = timer->heap_idx;
+    if(idx >= LV_GC_ROOT(_lv_timer_heap).cnt) return;
+    heap_sift_up(idx);
+    heap_sift_down(timer->heap_idx);
+}
+
+/**
+ * Move a timer from the heap after it, to not run it again in this `lv_timer_handler()` call
+ * @param timer pointer to lv_timer in the heap
+ */
+static void heap_park(lv_timer_t * timer)
+{
+    _lv_timer_heap_t * heap = &LV_GC_ROOT(_lv_timer_heap);
+    heap_remove(timer);
+    heap_set(heap->cnt + heap->ran_cnt, timer);
+    heap->ran_cnt++;
+}
+
+/**
+ * Sort the parked timers into the heap
+ */
+static void heap_unpark_all(void)
+{
+    _lv_timer_heap_t * heap = &LV_GC_ROOT(_lv_timer_heap);
+    while(heap->ran_cnt) {
+        heap->ran_cnt--;
+        heap->cnt++;
+        heap_sift_up(heap->cnt - 1);
+    }
+}
@@ -26,6 +26,7 @@ extern "C" {
 #endif
 
 #define LV_NO_TIMER_READY 0xFFFFFFFF
+#define LV_TIMER_IDX_NONE 0xFFFFFFFF
 
 /**********************
  *      TYPEDEFS
@@ -48,8 +49,23 @@ typedef struct _lv_timer_t {
     void * user_data; /**< Custom user data*/
     int32_t repeat_count; /**< 1: One time;  -1 : infinity;  n>0: residual times*/
     uint32_t paused : 1;
+    uint32_t heap_idx; /**< Position in the timer queue, `LV_TIMER_IDX_NONE` while paused*/
+    uint32_t create_id; /**< Timers due at the same time run in reverse order of creation*/
 } lv_timer_t;
 
+/**
+ * The queue of the timers which are not paused: a binary min-heap ordered by the time they are due.
+ * While `lv_timer_handler()` runs, the timers it already called are parked after the heap until it returns.
+ */
+typedef struct {
+    lv_timer_t ** timers;   /**< `cnt` timers of the heap, then `ran_cnt` parked ones*/
+    uint32_t cnt;
+    uint32_t ran_cnt;
+    uint32_t size;          /**< Allocated slots, at least the number of timers*/
+    uint32_t timer_cnt;     /**< All timers, paused ones too*/
+    uint32_t create_cnt;
+} _lv_timer_heap_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -1,38 +1,519 @@
+#include <assert.h>
+#include <string.h>
 #include "LVGL_Driver.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#if LVGL_FLUSH_QUEUE_DEPTH < 1 || LVGL_FLUSH_QUEUE_DEPTH > EXAMPLE_LCD_TRANS_QUEUE_DEPTH
+#error "LVGL_FLUSH_QUEUE_DEPTH must be between 1 and EXAMPLE_LCD_TRANS_QUEUE_DEPTH"
+#endif
+#if LVGL_FLUSH_SWAP_BYTES && (LV_COLOR_DEPTH != 16 || LV_COLOR_16_SWAP)
+#error "LVGL_FLUSH_SWAP_BYTES needs LV_COLOR_DEPTH 16 with LV_COLOR_16_SWAP 0"
+#endif
+#if LVGL_FLUSH_DIFF && (LVGL_FLUSH_DIFF_SEG_PX < 4 || LVGL_FLUSH_DIFF_SEG_PX > EXAMPLE_LCD_H_RES)
+#error "LVGL_FLUSH_DIFF_SEG_PX must be between 4 and EXAMPLE_LCD_H_RES"
+#endif
+#if LV_USE_PARALLEL_RENDER && (LVGL_RENDER_THREADS < 2 || LVGL_RENDER_THREADS > 8)
+#error "LVGL_RENDER_THREADS must be between 2 and 8"
+#endif
+#if EXAMPLE_LCD_BITS_PER_PIXEL != 16 && (EXAMPLE_LCD_BITS_PER_PIXEL != 12 || LV_COLOR_DEPTH != 16 || LVGL_FLUSH_SWAP_BYTES)
+#error "EXAMPLE_LCD_BITS_PER_PIXEL 12 packs LVGL's RGB565 bands, it needs LV_COLOR_DEPTH 16 and no LVGL_FLUSH_SWAP_BYTES"
+#endif
 
 static const char *TAG_LVGL = "WS_LVGL";
 
-static lv_color_t buf1[ LVGL_BUF_LEN ];
-static lv_color_t buf2[ LVGL_BUF_LEN];
+// Band buffers: one is being rendered by LVGL, the others are queued or on the SPI bus
+static lv_color_t flush_bufs[LVGL_FLUSH_QUEUE_DEPTH + 1][ LVGL_BUF_LEN ];
 // static lv_color_t* buf1 = (lv_color_t*) heap_caps_malloc(LVGL_BUF_LEN , MALLOC_CAP_SPIRAM);
 // static lv_color_t* buf2 = (lv_color_t*) heap_caps_malloc(LVGL_BUF_LEN , MALLOC_CAP_SPIRAM);
+
+typedef struct {
+    lv_area_t area;
+    lv_color_t *buf;            // NULL: scroll command, `area` is the scrolling band
+    lv_coord_t scroll_ofs;      // scroll command: first band row shows row `scroll_ofs` of the band's frame memory
+    uint32_t seq;               // flush_stats.bands after this band was queued
+} flush_band_t;
+
+// Part of a band sent as one frame memory window: its rows go to consecutive lines, its pixels are contiguous
+typedef struct {
+    lv_area_t area;
+    lv_coord_t gram_y;          // frame memory line of area.y1
+    lv_color_t *buf;
+} flush_piece_t;
+
+#if LVGL_FLUSH_DIFF
+// The rounder keeps band rows whole segments wide, only the last segment of a line may be narrower
+#define FLUSH_MIN_ROW_PX    (EXAMPLE_LCD_H_RES % LVGL_FLUSH_DIFF_SEG_PX ? EXAMPLE_LCD_H_RES % LVGL_FLUSH_DIFF_SEG_PX : LVGL_FLUSH_DIFF_SEG_PX)
+// At most one piece per band row
+#define FLUSH_MAX_PIECES    (LVGL_BUF_LEN / FLUSH_MIN_ROW_PX)
+#define DIFF_SEGS_PER_LINE  ((EXAMPLE_LCD_H_RES + LVGL_FLUSH_DIFF_SEG_PX - 1) / LVGL_FLUSH_DIFF_SEG_PX)
+#else
+// Before, inside (split at the wrap) and after the scrolling area
+#define FLUSH_MAX_PIECES    4
+#endif
+
+static QueueHandle_t flush_queue;           // rendered bands waiting for the SPI bus
+static QueueHandle_t free_queue;            // band buffers LVGL may render into
+static SemaphoreHandle_t flush_done_sem;    // given when a band's RAMWR has left the bus
+static lvgl_flush_stats_t flush_stats;
+#if LVGL_FLUSH_DIFF
+// Shadow of the panel: a hash per LVGL_FLUSH_DIFF_SEG_PX pixel segment of every frame memory line, 0 = unknown
+static uint32_t diff_shadow[EXAMPLE_LCD_V_RES][DIFF_SEGS_PER_LINE];
+static volatile bool diff_reset;            // set by LVGL_Flush_Reset_Shadow(), cleared by the flush task
+#endif
+#if LV_USE_PARALLEL_RENDER
+// One worker per strip but the first, which the LVGL task renders itself
+static TaskHandle_t render_tasks[LVGL_RENDER_THREADS - 1];
+static SemaphoreHandle_t render_done_sem;   // given by each worker when its strips are drawn
+static SemaphoreHandle_t render_mutex;      // LVGL's heap and shared state while the strips are drawn
+static struct {
+    lv_disp_render_job_t job;
+    void *job_data;
+    uint32_t job_cnt;
+} render_jobs;                              // written by the LVGL task before the workers are notified
+#endif
+static TaskHandle_t lvgl_task;              // task in LVGL_Run(), notified by LVGL_Wakeup()
+static lvgl_loop_stats_t loop_stats;
+static volatile uint32_t wakeup_t0;         // esp_timer time (us, bit 0 set) of the oldest wakeup LVGL_Run() has not seen yet, 0 = none
+static volatile uint32_t pixel_wait_t0;     // a wakeup LVGL_Run() has seen, until the flush task sends a later band
+static uint32_t pixel_wait_seq;             // flush_stats.bands when LVGL_Run() saw it
+#if LVGL_HW_VSCROLL
+static lv_area_t vscroll_area;              // LVGL side: the band scrolled by the panel
+static lv_coord_t vscroll_ofs;              // LVGL side: its current offset, 0 = not scrolled
+#endif
     
 
 lv_disp_draw_buf_t disp_buf;                                                 // contains internal graphic buffer(s) called draw buffer(s)
 lv_disp_drv_t disp_drv;                                                      // contains callback functions
     
+#if !LV_TICK_CUSTOM
 void example_increase_lvgl_tick(void *arg)
 {
     /* Tell LVGL how many milliseconds has elapsed */
     lv_tick_inc(EXAMPLE_LVGL_TICK_PERIOD_MS);
 }
+#endif
 
 bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
 {
-    lv_disp_drv_t *disp_driver = (lv_disp_drv_t *)user_ctx;
-    lv_disp_flush_ready(disp_driver);
-    return false;
+    // Called from the SPI ISR: wake the flush task, LVGL itself was released when the band was queued
+    BaseType_t high_task_woken = pdFALSE;
+    xSemaphoreGiveFromISR(flush_done_sem, &high_task_woken);
+    return high_task_woken == pdTRUE;
+}
+
+#if EXAMPLE_LCD_BITS_PER_PIXEL == 12
+/*
+ * Packs a rendered RGB565 band in place into the panel's RGB444 stream, two
+ * pixels in three bytes (R1G1 B1R2 G2B2). The write position never overtakes
+ * the read position, so no second buffer is needed.
+ */
+static void lvgl_pack_rgb444(lv_color_t *buf, const lv_area_t *area)
+{
+    uint8_t *out = (uint8_t *) buf;
+    uint32_t i = 0;
+
+    for (lv_coord_t y = area->y1; y <= area->y2; y++) {
+#if LVGL_FLUSH_RGB444_DITHER
+        const uint8_t *thr = lv_dither_ordered_row(y);      // same 8x8 pattern as LVGL's gradients, in screen space
+#endif
+        for (lv_coord_t x = area->x1; x <= area->x2; x++, i++) {
+            uint32_t c = buf[i].full;
+#if LV_COLOR_16_SWAP
+            c = (c << 8 | c >> 8) & 0xFFFF;
+#endif
+#if LVGL_FLUSH_RGB444_DITHER
+            uint32_t t = thr[x & 7];
+            uint32_t r = LV_MIN(((c >> 11) + (t >> 5)) >> 1, 15);
+            uint32_t g = LV_MIN((((c >> 5) & 0x3F) + (t >> 4)) >> 2, 15);
+            uint32_t b = LV_MIN(((c & 0x1F) + (t >> 5)) >> 1, 15);
+            uint32_t px = r << 8 | g << 4 | b;
+#else
+            uint32_t px = (c >> 4 & 0xF00) | (c >> 3 & 0x0F0) | (c >> 1 & 0x00F);
+#endif
+            if (i & 1) {
+                out[0] |= px >> 8;
+                out[1] = px & 0xFF;
+                out += 2;
+            } else {
+                out[0] = px >> 4;
+                out[1] = (px & 0xF) << 4;
+                out += 1;
+            }
+        }
+    }
+}
+#endif
+
+/*
+ * Splits a band into runs of rows that are consecutive in frame memory. Outside
+ * the scrolling area rows map to themselves; inside it row y is stored at
+ * line top + (y - top + ofs) mod height, so a band is cut where that wraps.
+ */
+static int lvgl_map_band(lv_color_t *buf, const lv_area_t *band, const lv_area_t *vscroll, lv_coord_t ofs, flush_piece_t *pieces)
+{
+    int n = 0;
+
+    for (lv_coord_t y = band->y1; y <= band->y2; ) {
+        lv_coord_t end, gram_y;
+        if (y < vscroll->y1) {
+            end = LV_MIN(band->y2, vscroll->y1 - 1);
+            gram_y = y;
+        } else if (y > vscroll->y2) {
+            end = band->y2;
+            gram_y = y;
+        } else {
+            lv_coord_t h = lv_area_get_height(vscroll);
+            lv_coord_t idx = (y - vscroll->y1 + ofs) % h;
+            end = LV_MIN(band->y2, y + LV_MIN(h - idx, vscroll->y2 - y + 1) - 1);
+            gram_y = vscroll->y1 + idx;
+        }
+        if (n > 0 && pieces[n - 1].gram_y + lv_area_get_height(&pieces[n - 1].area) == gram_y) {
+            pieces[n - 1].area.y2 = end;
+        } else {
+            pieces[n++] = (flush_piece_t) {
+                .area = { band->x1, y, band->x2, end },
+                .gram_y = gram_y,
+                .buf = buf + (y - band->y1) * lv_area_get_width(band),
+            };
+        }
+        y = end + 1;
+    }
+    return n;
+}
+
+#if LVGL_FLUSH_DIFF
+/* Hash of a segment, seeded with its columns so partial writes of a segment never match each other */
+static uint32_t lvgl_diff_hash(const lv_color_t *px, lv_coord_t x1, lv_coord_t x2)
+{
+    uint32_t h = 2166136261u ^ ((uint32_t) x1 << 16 | (uint32_t) x2);
+    for (lv_coord_t x = x1; x <= x2; x++, px++) {
+        h = (h ^ px->full) * 16777619u;
+    }
+    return h | 1;
+}
+
+/*
+ * Compares every row of the mapped pieces with the shadow, segment by segment,
+ * and keeps only the span from the first to the last changed segment. The kept
+ * spans are compacted to the start of the band buffer (never ahead of the rows
+ * still to be read); rows with the same span on consecutive lines share a piece.
+ */
+static int lvgl_diff_band(lv_color_t *buf, const lv_area_t *band, const flush_piece_t *mapped, int mapped_cnt, flush_piece_t *pieces)
+{
+    lv_coord_t w = lv_area_get_width(band);
+    lv_color_t *dst = buf;
+    flush_piece_t *cur = NULL;
+    int n = 0;
+
+    for (int i = 0; i < mapped_cnt; i++) {
+        for (lv_coord_t y = mapped[i].area.y1; y <= mapped[i].area.y2; y++) {
+            lv_coord_t gram_y = mapped[i].gram_y + y - mapped[i].area.y1;
+            const lv_color_t *row = buf + (y - band->y1) * w;
+            uint32_t *shadow = diff_shadow[gram_y];
+            int first = -1, last = -1;
+
+            for (int seg = band->x1 / LVGL_FLUSH_DIFF_SEG_PX; seg <= band->x2 / LVGL_FLUSH_DIFF_SEG_PX; seg++) {
+                lv_coord_t x1 = LV_MAX(seg * LVGL_FLUSH_DIFF_SEG_PX, band->x1);
+                lv_coord_t x2 = LV_MIN(seg * LVGL_FLUSH_DIFF_SEG_PX + LVGL_FLUSH_DIFF_SEG_PX - 1, band->x2);
+                uint32_t h = lvgl_diff_hash(row + x1 - band->x1, x1, x2);
+                if (shadow[seg] != h) {
+                    shadow[seg] = h;
+                    if (first < 0) {
+                        first = seg;
+                    }
+                    last = seg;
+                }
+            }
+            if (first < 0) {
+                flush_stats.diff_skipped_px += w;
+                cur = NULL;
+                continue;
+            }
+
+            lv_coord_t x1 = LV_MAX(first * LVGL_FLUSH_DIFF_SEG_PX, band->x1);
+            lv_coord_t x2 = LV_MIN(last * LVGL_FLUSH_DIFF_SEG_PX + LVGL_FLUSH_DIFF_SEG_PX - 1, band->x2);
+            flush_stats.diff_skipped_px += w - (x2 - x1 + 1);
+            if (cur && cur->area.x1 == x1 && cur->area.x2 == x2 && cur->gram_y + lv_area_get_height(&cur->area) == gram_y) {
+                cur->area.y2 = y;
+            } else {
+                cur = &pieces[n++];
+                *cur = (flush_piece_t) { .area = { x1, y, x2, y }, .gram_y = gram_y, .buf = dst };
+            }
+            memmove(dst, row + x1 - band->x1, (x2 - x1 + 1) * sizeof(lv_color_t));
+            dst += x2 - x1 + 1;
+        }
+    }
+    return n;
 }
 
+/* Widens invalidated areas to whole shadow segments, so every segment LVGL renders can be compared */
+static void example_lvgl_rounder_cb(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    area->x1 = area->x1 / LVGL_FLUSH_DIFF_SEG_PX * LVGL_FLUSH_DIFF_SEG_PX;
+    area->x2 = LV_MIN((area->x2 / LVGL_FLUSH_DIFF_SEG_PX + 1) * LVGL_FLUSH_DIFF_SEG_PX - 1, drv->hor_res - 1);
+}
+#endif
+
+/* Waits until all pieces of a band have left the bus and gives its buffer back to LVGL */
+static void lvgl_release_band(lv_color_t *buf, int pieces)
+{
+    while (pieces--) {
+        xSemaphoreTake(flush_done_sem, portMAX_DELAY);
+    }
+    xQueueSend(free_queue, &buf, portMAX_DELAY);
+}
+
+/*
+ * Sends queued bands to the panel. The esp_lcd SPI IO drains its queue before
+ * every CASET/RASET, so bands go out strictly one after another; this task
+ * keeps the bus fed while LVGL renders ahead into the remaining buffers.
+ * A band is prepared (packed to RGB444 if enabled) while the previous one is
+ * still on the bus, and that previous buffer is released only afterwards.
+ * Scroll commands are queued between the bands, so every band is mapped with
+ * the scroll offset the panel has when it arrives. With LVGL_FLUSH_DIFF only
+ * the parts of a band that differ from the shadow of the panel are sent.
+ */
+static void lvgl_flush_task(void *arg)
+{
+    esp_lcd_panel_handle_t panel_handle = (esp_lcd_panel_handle_t) arg;
+    flush_band_t band;
+    lv_color_t *on_bus = NULL;
+    int on_bus_pieces = 0;
+    lv_area_t vscroll = { .y1 = 0, .y2 = -1 };      // no scrolling area yet
+    lv_coord_t ofs = 0;
+    static flush_piece_t pieces[FLUSH_MAX_PIECES];
+#if LVGL_FLUSH_DIFF
+    flush_piece_t mapped[4];
+#endif
+
+    while (1) {
+        if (xQueueReceive(flush_queue, &band, on_bus ? 0 : portMAX_DELAY) != pdTRUE) {
+            // Nothing to prepare: wait for the band on the bus and give its buffer back
+            lvgl_release_band(on_bus, on_bus_pieces);
+            on_bus = NULL;
+            continue;
+        }
+#if LVGL_HW_VSCROLL
+        if (band.buf == NULL) {
+            // VSCRDEF/VSCSAD wait for the bands already on the bus, later bands use the new mapping
+            if (band.area.y1 != vscroll.y1 || band.area.y2 != vscroll.y2) {
+                esp_lcd_st7789t_vscroll_define(panel_handle, band.area.y1 + Offset_Y, lv_area_get_height(&band.area));
+                vscroll = band.area;
+            }
+            esp_lcd_st7789t_vscroll_start(panel_handle, band.scroll_ofs);
+            ofs = band.scroll_ofs;
+            continue;
+        }
+#endif
+#if LVGL_FLUSH_DIFF
+        int64_t diff_t0 = esp_timer_get_time();
+        if (diff_reset) {
+            diff_reset = false;
+            memset(diff_shadow, 0, sizeof(diff_shadow));
+        }
+        int mapped_cnt = lvgl_map_band(band.buf, &band.area, &vscroll, ofs, mapped);
+        int n = lvgl_diff_band(band.buf, &band.area, mapped, mapped_cnt, pieces);
+        flush_stats.diff_px += lv_area_get_size(&band.area);
+        flush_stats.diff_us += esp_timer_get_time() - diff_t0;
+#else
+        int n = lvgl_map_band(band.buf, &band.area, &vscroll, ofs, pieces);
+#endif
+#if EXAMPLE_LCD_BITS_PER_PIXEL == 12
+        int64_t t0 = esp_timer_get_time();
+        for (int i = 0; i < n; i++) {
+            lvgl_pack_rgb444(pieces[i].buf, &pieces[i].area);
+        }
+        flush_stats.pack_us += esp_timer_get_time() - t0;
+#endif
+        if (on_bus) {
+            lvgl_release_band(on_bus, on_bus_pieces);
+        }
+        uint32_t wait_t0 = pixel_wait_t0;
+        if (wait_t0 && (int32_t)(band.seq - pixel_wait_seq) > 0) {
+            // First band rendered after a wakeup: its pixels are going on the bus now
+            uint32_t us = ((uint32_t) esp_timer_get_time() | 1) - wait_t0;
+            pixel_wait_t0 = 0;
+            loop_stats.latency_cnt++;
+            loop_stats.latency_us += us;
+            if (us > loop_stats.latency_max_us) {
+                loop_stats.latency_max_us = us;
+            }
+        }
+        // copy a buffer's content to a specific area of the display
+        for (int i = 0; i < n; i++) {
+            const lv_area_t *a = &pieces[i].area;
+            lv_coord_t y = pieces[i].gram_y;
+            esp_lcd_panel_draw_bitmap(panel_handle, a->x1 + Offset_X, y + Offset_Y, a->x2 + Offset_X + 1, y + lv_area_get_height(a) + Offset_Y, pieces[i].buf);
+        }
+        flush_stats.windows += n;
+        on_bus = band.buf;
+        on_bus_pieces = n;
+    }
+}
+
+#if LVGL_FLUSH_SWAP_BYTES
+/* Post-render pass turning LVGL's little-endian RGB565 into the panel's MSB-first order */
+static void lvgl_swap_band(lv_color_t *buf, uint32_t px_cnt)
+{
+    for (uint32_t i = 0; i < px_cnt; i++) {
+        buf[i].full = (uint16_t)(buf[i].full << 8 | buf[i].full >> 8);
+    }
+}
+#endif
+
 void example_lvgl_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
 {
-    esp_lcd_panel_handle_t panel_handle = (esp_lcd_panel_handle_t) drv->user_data;
-    int offsetx1 = area->x1;
-    int offsetx2 = area->x2;
-    int offsety1 = area->y1;
-    int offsety2 = area->y2;
-    // copy a buffer's content to a specific area of the display
-    esp_lcd_panel_draw_bitmap(panel_handle, offsetx1 + Offset_X, offsety1 + Offset_Y, offsetx2 + Offset_X + 1, offsety2 + Offset_Y + 1, color_map);
+    flush_band_t band = {
+        .area = *area,
+        .buf = color_map,
+        .seq = flush_stats.bands + 1,
+    };
+    lv_color_t *next_buf = NULL;
+
+#if LVGL_FLUSH_SWAP_BYTES
+    int64_t swap_t0 = esp_timer_get_time();
+    lvgl_swap_band(color_map, lv_area_get_size(area));
+    flush_stats.swap_us += esp_timer_get_time() - swap_t0;
+#endif
+
+    // At most LVGL_FLUSH_QUEUE_DEPTH buffers are outside LVGL, so this only waits behind queued scroll commands
+    xQueueSend(flush_queue, &band, portMAX_DELAY);
+    flush_stats.bands++;
+
+    if (xQueueReceive(free_queue, &next_buf, 0) != pdTRUE) {
+        int64_t t0 = esp_timer_get_time();
+        xQueueReceive(free_queue, &next_buf, portMAX_DELAY);
+        flush_stats.blocked_us += esp_timer_get_time() - t0;
+        flush_stats.stalls++;
+    }
+    uint32_t in_flight = LVGL_FLUSH_QUEUE_DEPTH - uxQueueMessagesWaiting(free_queue);
+    if (in_flight > flush_stats.max_in_flight) {
+        flush_stats.max_in_flight = in_flight;
+    }
+
+    // LVGL swaps to the other draw buffer after this callback, make that the free one
+    if (drv->draw_buf->buf1 == color_map) {
+        drv->draw_buf->buf2 = next_buf;
+    } else {
+        drv->draw_buf->buf1 = next_buf;
+    }
+    lv_disp_flush_ready(drv);
+}
+
+#if LVGL_HW_VSCROLL
+static void lvgl_queue_vscroll(void)
+{
+    flush_band_t cmd = {
+        .area = vscroll_area,
+        .buf = NULL,
+        .scroll_ofs = vscroll_ofs,
+    };
+    xQueueSend(flush_queue, &cmd, portMAX_DELAY);
+}
+
+/*
+ * LVGL scrolls a full-width band: move its pixels with the panel's vertical
+ * scrolling instead of redrawing them. Only one band can scroll at a time, a
+ * different one is accepted once the previous one is back at offset 0.
+ */
+static bool example_lvgl_vscroll_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_coord_t dy)
+{
+    if (area->y1 != vscroll_area.y1 || area->y2 != vscroll_area.y2) {
+        if (vscroll_ofs != 0) {
+            // Put the old band's lines back in order and let LVGL redraw it along with the new one
+            vscroll_ofs = 0;
+            lvgl_queue_vscroll();
+            _lv_inv_area(disp, &vscroll_area);
+            return false;
+        }
+        vscroll_area = *area;
+    }
+    lv_coord_t h = lv_area_get_height(area);
+    vscroll_ofs = ((vscroll_ofs - dy) % h + h) % h;
+    lvgl_queue_vscroll();
+    flush_stats.vscrolls++;
+    return true;
+}
+#endif
+
+void LVGL_Get_Flush_Stats(lvgl_flush_stats_t *stats)
+{
+    *stats = flush_stats;
+}
+
+void LVGL_Get_Loop_Stats(lvgl_loop_stats_t *stats)
+{
+    *stats = loop_stats;
+}
+
+void LVGL_Wakeup(void)
+{
+    if (lvgl_task == NULL) {
+        return;
+    }
+    if (wakeup_t0 == 0) {
+        wakeup_t0 = (uint32_t) esp_timer_get_time() | 1;
+    }
+    xTaskNotifyGive(lvgl_task);
+}
+
+bool LVGL_Wakeup_From_ISR(void)
+{
+    BaseType_t high_task_woken = pdFALSE;
+    if (lvgl_task == NULL) {
+        return false;
+    }
+    if (wakeup_t0 == 0) {
+        wakeup_t0 = (uint32_t) esp_timer_get_time() | 1;
+    }
+    vTaskNotifyGiveFromISR(lvgl_task, &high_task_woken);
+    return high_task_woken == pdTRUE;
+}
+
+/*
+ * Runs LVGL's timers and then blocks until the next one is due, or until
+ * LVGL_Wakeup(). When nothing is animating or invalid LVGL pauses its refresh
+ * timer and the task sleeps indefinitely, which lets the idle task enter light
+ * sleep (CONFIG_PM_ENABLE, CONFIG_FREERTOS_USE_TICKLESS_IDLE). The tick comes
+ * from esp_timer (LV_TICK_CUSTOM), so LVGL's clock keeps running while asleep.
+ * Other tasks never call LVGL: they hand work to cycle_cb (see UI_Cmd.h) and
+ * wake the loop.
+ */
+void LVGL_Run(void (*cycle_cb)(void))
+{
+    lvgl_task = xTaskGetCurrentTaskHandle();
+
+    while (1) {
+        if (cycle_cb) {
+            cycle_cb();
+        }
+        uint32_t ms = lv_timer_handler();
+        if (pixel_wait_t0 && flush_stats.bands == pixel_wait_seq && disp->inv_p == 0) {
+            pixel_wait_t0 = 0;      // the wakeup changed nothing on screen
+        }
+
+        // Round up: waking before the timer is due would only go straight back to sleep
+        TickType_t ticks = ms == LV_NO_TIMER_READY ? portMAX_DELAY : (ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+        uint32_t events = ulTaskNotifyTake(pdTRUE, ticks);
+        loop_stats.wakeups++;
+        if (events) {
+            loop_stats.event_wakeups++;
+            uint32_t t0 = wakeup_t0;
+            wakeup_t0 = 0;
+            if (t0 && pixel_wait_t0 == 0) {
+                pixel_wait_seq = flush_stats.bands;
+                pixel_wait_t0 = t0;
+            }
+        }
+    }
+}
+
+void LVGL_Flush_Reset_Shadow(void)
+{
+#if LVGL_FLUSH_DIFF
+    diff_reset = true;
+#endif
 }
 
 /* Rotate display and touch, when rotated screen in LVGL. Called when driver parameters are updated. */
@@ -64,6 +545,47 @@ void example_lvgl_port_update_callback(lv_disp_drv_t *drv)
     }
 }
 
+#if LV_USE_PARALLEL_RENDER
+/* Worker `arg`: draws the strips arg, arg + LVGL_RENDER_THREADS, ... of every band */
+static void lvgl_render_task(void *arg)
+{
+    uint32_t first = (uint32_t)(uintptr_t)arg;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        for (uint32_t i = first; i < render_jobs.job_cnt; i += LVGL_RENDER_THREADS) {
+            render_jobs.job(render_jobs.job_data, i);
+        }
+        xSemaphoreGive(render_done_sem);
+    }
+}
+
+/* Render the strips of a band on the LVGL task and the workers, return when all are drawn */
+static void example_lvgl_render_cb(lv_disp_drv_t *drv, lv_disp_render_job_t job, void *job_data, uint32_t job_cnt)
+{
+    render_jobs.job = job;
+    render_jobs.job_data = job_data;
+    render_jobs.job_cnt = job_cnt;
+    for (int i = 0; i < LVGL_RENDER_THREADS - 1; i++) {
+        xTaskNotifyGive(render_tasks[i]);
+    }
+    for (uint32_t i = 0; i < job_cnt; i += LVGL_RENDER_THREADS) {
+        job(job_data, i);
+    }
+    for (int i = 0; i < LVGL_RENDER_THREADS - 1; i++) {
+        xSemaphoreTake(render_done_sem, portMAX_DELAY);
+    }
+}
+
+static void example_lvgl_render_lock_cb(lv_disp_drv_t *drv, bool lock)
+{
+    if (lock) {
+        xSemaphoreTakeRecursive(render_mutex, portMAX_DELAY);
+    } else {
+        xSemaphoreGiveRecursive(render_mutex);
+    }
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 lv_disp_t *disp;
 void LVGL_Init(void)
@@ -71,7 +593,16 @@ void LVGL_Init(void)
     ESP_LOGI(TAG_LVGL, "Initialize LVGL library");
     lv_init();
     
-    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, LVGL_BUF_LEN );                              // initialize LVGL draw buffers
+    // LVGL starts rendering into flush_bufs[0]; buf2 is replaced by a free buffer on the first flush
+    flush_queue = xQueueCreate(LVGL_FLUSH_QUEUE_DEPTH, sizeof(flush_band_t));
+    free_queue = xQueueCreate(LVGL_FLUSH_QUEUE_DEPTH, sizeof(lv_color_t *));
+    flush_done_sem = xSemaphoreCreateCounting(FLUSH_MAX_PIECES, 0);      // one band is on the bus at a time, in up to FLUSH_MAX_PIECES pieces
+    assert(flush_queue && free_queue && flush_done_sem);
+    for (int i = 1; i <= LVGL_FLUSH_QUEUE_DEPTH; i++) {
+        lv_color_t *buf = flush_bufs[i];
+        xQueueSend(free_queue, &buf, 0);
+    }
+    lv_disp_draw_buf_init(&disp_buf, flush_bufs[0], flush_bufs[0], LVGL_BUF_LEN );            // initialize LVGL draw buffers
 
     ESP_LOGI(TAG_LVGL, "Register display driver to LVGL");
     lv_disp_drv_init(&disp_drv);                                                                        // Create a new screen object and initialize the associated device
@@ -80,12 +611,40 @@ void LVGL_Init(void)
     // disp_drv.rotated = LV_DISP_ROT_90; // 图像旋转                                                            // Vertical axis pixel count
     disp_drv.flush_cb = example_lvgl_flush_cb;                                                          // Function : copy a buffer's content to a specific area of the display
     disp_drv.drv_update_cb = example_lvgl_port_update_callback;                                         // Function : Rotate display and touch, when rotated screen in LVGL. Called when driver parameters are updated. 
+#if LVGL_FLUSH_DIFF
+    disp_drv.rounder_cb = example_lvgl_rounder_cb;                                                      // Function : align invalidated areas to the shadow's segments
+#endif
+#if LVGL_HW_VSCROLL
+    disp_drv.vscroll_cb = example_lvgl_vscroll_cb;                                                      // Function : move scrolled content with the panel's vertical scrolling
+#endif
+    disp_drv.panel_period_us = 1000000 / EXAMPLE_LCD_REFRESH_HZ;                                       // Pace frames to 60/30/20... fps by the measured frame time, see lv_refr_get_pacing()
+    disp_drv.inv_tile_size = 8;                                                                         // More than LV_INV_BUF_SIZE dirty areas continue in 8x8 tiles instead of a full screen redraw
+    disp_drv.cull_occluded = 1;                                                                         // Skip objects hidden behind opaque objects in front of them (stacked faces, bubbles)
+    disp_drv.retained_mem = 4 * 1024;                                                                   // Replay the recorded draw calls of unchanged widgets redrawn under an animation
+#if LV_USE_PARALLEL_RENDER
+    render_done_sem = xSemaphoreCreateCounting(LVGL_RENDER_THREADS - 1, 0);
+    render_mutex = xSemaphoreCreateRecursiveMutex();
+    assert(render_done_sem && render_mutex);
+    for (int i = 0; i < LVGL_RENDER_THREADS - 1; i++) {
+        xTaskCreate(lvgl_render_task, "lvgl_render", LVGL_RENDER_TASK_STACK, (void *)(uintptr_t)(i + 1),
+                    LVGL_RENDER_TASK_PRIORITY, &render_tasks[i]);
+        assert(render_tasks[i]);
+    }
+    disp_drv.render_strips = LVGL_RENDER_THREADS;                                                       // Render every band in strips on the LVGL task and the render workers
+    disp_drv.render_cb = example_lvgl_render_cb;
+    disp_drv.render_lock_cb = example_lvgl_render_lock_cb;
+#endif
     disp_drv.draw_buf = &disp_buf;                                                                      // LVGL will use this buffer(s) to draw the screens contents
     disp_drv.user_data = panel_handle;                
     ESP_LOGI(TAG_LVGL,"Register display indev to LVGL");                                                  // Custom display driver user data
     disp = lv_disp_drv_register(&disp_drv);                                                  // Create screen objects
+
+    ESP_LOGI(TAG_LVGL, "Start flush task, %d bands in flight", LVGL_FLUSH_QUEUE_DEPTH);
+    xTaskCreate(lvgl_flush_task, "lvgl_flush", LVGL_FLUSH_TASK_STACK, panel_handle, LVGL_FLUSH_TASK_PRIORITY, NULL);
     
     /********************* LVGL *********************/
+#if !LV_TICK_CUSTOM
+    // With LV_TICK_CUSTOM LVGL reads esp_timer_get_time() itself and lv_tick_inc() does not exist
     ESP_LOGI(TAG_LVGL, "Install LVGL tick timer");
     // Tick interface for LVGL (using esp_timer to generate 2ms periodic event)
     const esp_timer_create_args_t lvgl_tick_timer_args = {
@@ -96,5 +655,6 @@ void LVGL_Init(void)
     esp_timer_handle_t lvgl_tick_timer = NULL;
     ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
     ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, EXAMPLE_LVGL_TICK_PERIOD_MS * 1000));
+#endif
 
 }
@@ -13,6 +13,69 @@
 #define LVGL_BUF_LEN  (EXAMPLE_LCD_H_RES * 20)
 #define EXAMPLE_LVGL_TICK_PERIOD_MS    2
 
+// Bands that may be queued or on the SPI bus while LVGL renders the next one (1 .. EXAMPLE_LCD_TRANS_QUEUE_DEPTH).
+// One extra band buffer is allocated for LVGL to render into, so the pool is LVGL_FLUSH_QUEUE_DEPTH + 1 buffers.
+#ifndef LVGL_FLUSH_QUEUE_DEPTH
+#define LVGL_FLUSH_QUEUE_DEPTH         3
+#endif
+// Pixel byte order. LV_COLOR_16_SWAP 1 (main/lv_conf.h) renders MSB-first RGB565, the panel's native SPI order,
+// and bands are DMA'd untouched. With LV_COLOR_16_SWAP 0 the panel is switched to little-endian RAM access,
+// or, with LVGL_FLUSH_SWAP_BYTES 1, example_lvgl_flush_cb byte-swaps every band before it is queued.
+#ifndef LVGL_FLUSH_SWAP_BYTES
+#define LVGL_FLUSH_SWAP_BYTES          0
+#endif
+#define LVGL_PANEL_LITTLE_ENDIAN       (!LV_COLOR_16_SWAP && !LVGL_FLUSH_SWAP_BYTES)
+// With EXAMPLE_LCD_BITS_PER_PIXEL 12 the flush task packs each band to RGB444; 1 applies LVGL's 8x8 ordered
+// dither while dropping the low bits, 0 truncates (best for flat cartoon colors)
+#ifndef LVGL_FLUSH_RGB444_DITHER
+#define LVGL_FLUSH_RGB444_DITHER       0
+#endif
+// 1: vertically scrolled full-width containers are moved with the panel's hardware scrolling (VSCRDEF/VSCSAD)
+// and LVGL redraws only the rows scrolled in; the flush task then remaps every band into the scrolled frame memory
+#ifndef LVGL_HW_VSCROLL
+#define LVGL_HW_VSCROLL                1
+#endif
+// 1: keep a hash of every LVGL_FLUSH_DIFF_SEG_PX pixel segment of the panel's frame memory and send only the
+// changed span of each rendered row, in one CASET/RASET window per run of rows with the same span.
+// Invalidated areas are widened to whole segments. Costs EXAMPLE_LCD_V_RES * ceil(H_RES / SEG_PX) * 4 bytes of RAM.
+#ifndef LVGL_FLUSH_DIFF
+#define LVGL_FLUSH_DIFF                0
+#endif
+#ifndef LVGL_FLUSH_DIFF_SEG_PX
+#define LVGL_FLUSH_DIFF_SEG_PX         16
+#endif
+#define LVGL_FLUSH_TASK_PRIORITY       6
+#define LVGL_FLUSH_TASK_STACK          3072
+// Threads rendering a band in horizontal strips with LV_USE_PARALLEL_RENDER 1 (main/lv_conf.h): the LVGL task
+// draws one strip, LVGL_RENDER_THREADS - 1 worker tasks the others. Only pays off on a dual-core target
+#ifndef LVGL_RENDER_THREADS
+#define LVGL_RENDER_THREADS            2
+#endif
+#define LVGL_RENDER_TASK_PRIORITY      5
+#define LVGL_RENDER_TASK_STACK         4096
+
+typedef struct {
+    uint32_t bands;          // bands handed to the flush task
+    uint32_t stalls;         // bands after which LVGL had to wait for a free buffer
+    uint64_t blocked_us;     // total time LVGL spent waiting for a free buffer
+    uint32_t max_in_flight;  // peak number of bands queued or on the bus
+    uint64_t swap_us;        // total time spent byte-swapping bands (LVGL_FLUSH_SWAP_BYTES only)
+    uint64_t pack_us;        // total time the flush task spent packing bands to RGB444 (12 bpp only)
+    uint32_t vscrolls;       // scroll steps done by the panel instead of a redraw (LVGL_HW_VSCROLL only)
+    uint32_t windows;        // CASET/RASET/RAMWR windows sent
+    uint64_t diff_px;        // rendered pixels compared with the shadow (LVGL_FLUSH_DIFF only)
+    uint64_t diff_skipped_px;// of those, pixels not sent because the panel already shows them
+    uint64_t diff_us;        // total time the flush task spent hashing and compacting bands
+} lvgl_flush_stats_t;
+
+typedef struct {
+    uint32_t wakeups;        // times LVGL_Run() woke up to call lv_timer_handler()
+    uint32_t event_wakeups;  // of those, woken early by LVGL_Wakeup() / LVGL_Wakeup_From_ISR()
+    uint32_t latency_cnt;    // wakeups whose changes reached the bus
+    uint64_t latency_us;     // total time from LVGL_Wakeup() to the first band of the following refresh going on the bus
+    uint32_t latency_max_us;
+} lvgl_loop_stats_t;
+
 extern lv_disp_draw_buf_t disp_buf;                                                 // contains internal graphic buffer(s) called draw buffer(s)
 extern lv_disp_drv_t disp_drv;                                                      // contains callback functions
 extern lv_disp_t *disp;    
@@ -21,6 +84,15 @@ bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd
 void example_lvgl_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map);
 /* Rotate display and touch, when rotated screen in LVGL. Called when driver parameters are updated. */
 void example_lvgl_port_update_callback(lv_disp_drv_t *drv);
+#if !LV_TICK_CUSTOM
 void example_increase_lvgl_tick(void *arg);
+#endif
 
+void LVGL_Get_Flush_Stats(lvgl_flush_stats_t *stats); // Counters of the flush pipeline, sampled without locking from any task
+void LVGL_Flush_Reset_Shadow(void);      // The panel lost its frame memory (or it is to be verified): send the next bands in full (LVGL_FLUSH_DIFF only)
+void LVGL_Get_Loop_Stats(lvgl_loop_stats_t *stats);   // Counters of LVGL_Run(), sampled without locking from any task
+void LVGL_Wakeup(void);                   // Something for the UI happened: run lv_timer_handler() now instead of at its next timer
+bool LVGL_Wakeup_From_ISR(void);          // Same from an ISR, returns true if a context switch is needed
+void LVGL_Run(void (*cycle_cb)(void));    // LVGL main loop of the calling task: sleeps until the next LVGL timer is due or LVGL_Wakeup(), never returns.
+                                          // cycle_cb (optional) runs on this task before every lv_timer_handler(), e.g. to apply queued UI commands
 void LVGL_Init(void);                     // Call this function to initialize the screen (must be called in the main function) !!!!!
\ No newline at end of file
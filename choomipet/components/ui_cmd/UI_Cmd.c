@@ -0,0 +1,314 @@
+#include <stdatomic.h>
+#include <string.h>
+#include "UI_Cmd.h"
+#include "ST7789.h"
+#include "LVGL_Driver.h"
+
+#if UI_CMD_QUEUE_LEN < 2 || (UI_CMD_QUEUE_LEN & (UI_CMD_QUEUE_LEN - 1))
+#error "UI_CMD_QUEUE_LEN must be a power of two"
+#endif
+
+static const char *TAG_UI = "UI_CMD";
+
+/*
+ * Bounded multi-producer ring of the animations: every cell carries a sequence
+ * number. A cell with seq == pos is free for the producer that claims position
+ * pos, the claiming producer publishes it with seq = pos + 1, and the consumer
+ * hands it back for the next lap with seq = pos + UI_CMD_QUEUE_LEN.
+ */
+typedef struct {
+    atomic_uint seq;
+    ui_cmd_t cmd;
+} ui_cmd_cell_t;
+
+/*
+ * Set commands only matter by their last value, so each (type, target) has a
+ * latest-value slot instead: a producer claims a free cell of the pool, fills
+ * it and swaps its index into the slot, handing the cell it displaced back to
+ * the pool. The consumer swaps the slot back to empty and owns the cell it got
+ * until it frees it. A burst keeps only its last command, whatever its length.
+ */
+typedef struct {
+    atomic_bool busy;
+    ui_cmd_t cmd;
+} ui_cmd_pool_cell_t;
+
+#define UI_CMD_SLOT_EMOTION(target)    (target)
+#define UI_CMD_SLOT_TEXT(target)       (UI_TARGET_MAX + (target))
+#define UI_CMD_SLOT_BACKLIGHT          (2 * UI_TARGET_MAX)
+#define UI_CMD_SLOTS                   (2 * UI_TARGET_MAX + 1)
+
+// Every slot may hold a cell and the consumer one more while it applies it
+_Static_assert(UI_CMD_QUEUE_LEN > UI_CMD_SLOTS + 1, "UI_CMD_QUEUE_LEN too small for the latest-value slots");
+
+static ui_cmd_cell_t cmd_ring[UI_CMD_QUEUE_LEN];
+static atomic_uint cmd_enqueue_pos;         // next position a producer claims
+static unsigned int cmd_dequeue_pos;        // LVGL task only
+static ui_cmd_pool_cell_t cmd_pool[UI_CMD_QUEUE_LEN];
+static atomic_uint cmd_slots[UI_CMD_SLOTS]; // index + 1 of the latest cell, 0 if empty
+static atomic_uint stat_posted;
+static atomic_uint stat_dropped;
+static atomic_uint stat_coalesced;
+static ui_cmd_stats_t cmd_stats;            // LVGL task side of the counters
+static lv_obj_t *targets[UI_TARGET_MAX];
+
+// Stand-in expressions until the expression art exists: the pet is tinted per emotion
+static const struct {
+    uint32_t color;
+    lv_opa_t opa;
+} emotion_tint[UI_EMOTION_MAX] = {
+    [UI_EMOTION_NEUTRAL] = { 0x000000, LV_OPA_TRANSP },
+    [UI_EMOTION_HAPPY]   = { 0xFFC000, LV_OPA_30 },
+    [UI_EMOTION_SAD]     = { 0x2060FF, LV_OPA_40 },
+    [UI_EMOTION_ANGRY]   = { 0xFF2000, LV_OPA_40 },
+    [UI_EMOTION_SLEEPY]  = { 0x404040, LV_OPA_50 },
+};
+
+/* The latest-value slot of a set command, -1 for the commands that go through the ring */
+static int ui_cmd_slot(const ui_cmd_t *cmd)
+{
+    switch (cmd->type) {
+    case UI_CMD_SET_EMOTION:
+        return UI_CMD_SLOT_EMOTION(cmd->target);
+    case UI_CMD_SHOW_TEXT:
+        return UI_CMD_SLOT_TEXT(cmd->target);
+    case UI_CMD_SET_BACKLIGHT:
+        return UI_CMD_SLOT_BACKLIGHT;
+    default:
+        return -1;
+    }
+}
+
+static bool ui_cmd_post_latest(atomic_uint *slot, const ui_cmd_t *cmd)
+{
+    for (unsigned int i = 0; i < UI_CMD_QUEUE_LEN; i++) {
+        ui_cmd_pool_cell_t *cell = &cmd_pool[i];
+        if (atomic_load_explicit(&cell->busy, memory_order_relaxed) ||
+            atomic_exchange_explicit(&cell->busy, true, memory_order_acquire)) {
+            continue;
+        }
+        cell->cmd = *cmd;
+        unsigned int old = atomic_exchange_explicit(slot, i + 1, memory_order_acq_rel);
+        if (old) {
+            // Not taken by the LVGL task yet: this command replaces it
+            atomic_store_explicit(&cmd_pool[old - 1].busy, false, memory_order_release);
+            atomic_fetch_add_explicit(&stat_coalesced, 1, memory_order_relaxed);
+        }
+        atomic_fetch_add_explicit(&stat_posted, 1, memory_order_relaxed);
+        LVGL_Wakeup();
+        return true;
+    }
+    // Only when more tasks than free cells post at the very same time
+    atomic_fetch_add_explicit(&stat_dropped, 1, memory_order_relaxed);
+    return false;
+}
+
+bool UI_Cmd_Post(const ui_cmd_t *cmd)
+{
+    int slot = ui_cmd_slot(cmd);
+    if (slot >= 0) {
+        if (cmd->target >= UI_TARGET_MAX) {
+            return false;
+        }
+        return ui_cmd_post_latest(&cmd_slots[slot], cmd);
+    }
+
+    unsigned int pos = atomic_load_explicit(&cmd_enqueue_pos, memory_order_relaxed);
+    ui_cmd_cell_t *cell;
+
+    while (1) {
+        cell = &cmd_ring[pos & (UI_CMD_QUEUE_LEN - 1)];
+        unsigned int seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int dif = (int)(seq - pos);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&cmd_enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            // The consumer has not freed this cell yet: the ring is full
+            atomic_fetch_add_explicit(&stat_dropped, 1, memory_order_relaxed);
+            return false;
+        } else {
+            pos = atomic_load_explicit(&cmd_enqueue_pos, memory_order_relaxed);
+        }
+    }
+    cell->cmd = *cmd;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    atomic_fetch_add_explicit(&stat_posted, 1, memory_order_relaxed);
+    LVGL_Wakeup();
+    return true;
+}
+
+bool UI_Set_Emotion(ui_emotion_t emotion)
+{
+    ui_cmd_t cmd = { .type = UI_CMD_SET_EMOTION, .target = UI_TARGET_PET, .value = emotion };
+    return UI_Cmd_Post(&cmd);
+}
+
+bool UI_Show_Text(ui_target_t target, const char *text)
+{
+    if (text == NULL) {
+        return false;
+    }
+    ui_cmd_t cmd = { .type = UI_CMD_SHOW_TEXT, .target = target };
+    strncpy(cmd.text, text, sizeof(cmd.text) - 1);
+    return UI_Cmd_Post(&cmd);
+}
+
+bool UI_Start_Anim(ui_anim_t anim)
+{
+    ui_cmd_t cmd = { .type = UI_CMD_START_ANIM, .target = UI_TARGET_PET, .value = anim };
+    return UI_Cmd_Post(&cmd);
+}
+
+bool UI_Set_Backlight(uint8_t level)
+{
+    ui_cmd_t cmd = { .type = UI_CMD_SET_BACKLIGHT, .value = level };
+    return UI_Cmd_Post(&cmd);
+}
+
+/* Single consumer: takes the oldest published animation, false if there is none */
+static bool ui_cmd_take(ui_cmd_t *cmd)
+{
+    ui_cmd_cell_t *cell = &cmd_ring[cmd_dequeue_pos & (UI_CMD_QUEUE_LEN - 1)];
+    unsigned int seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+    if (seq != cmd_dequeue_pos + 1) {
+        return false;
+    }
+    *cmd = cell->cmd;
+    atomic_store_explicit(&cell->seq, cmd_dequeue_pos + UI_CMD_QUEUE_LEN, memory_order_release);
+    cmd_dequeue_pos++;
+    return true;
+}
+
+/* Single consumer: takes the latest command of a slot, false if there is none */
+static bool ui_cmd_take_latest(atomic_uint *slot, ui_cmd_t *cmd)
+{
+    unsigned int idx = atomic_exchange_explicit(slot, 0, memory_order_acquire);
+    if (idx == 0) {
+        return false;
+    }
+    *cmd = cmd_pool[idx - 1].cmd;
+    atomic_store_explicit(&cmd_pool[idx - 1].busy, false, memory_order_release);
+    return true;
+}
+
+static void ui_anim_translate_y(void *obj, int32_t v)
+{
+    lv_obj_set_style_translate_y(obj, v, 0);
+}
+
+/* v is an angle: three full sine periods left and right, back in the middle at the end */
+static void ui_anim_shake(void *obj, int32_t v)
+{
+    lv_obj_set_style_translate_x(obj, (lv_trigo_sin((int16_t)(v % 360)) * 6) >> LV_TRIGO_SHIFT, 0);
+}
+
+static void ui_start_anim(lv_obj_t *obj, ui_anim_t anim)
+{
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, obj);
+    if (anim == UI_ANIM_JUMP) {
+        lv_anim_set_exec_cb(&a, ui_anim_translate_y);
+        lv_anim_set_values(&a, 0, -16);
+        lv_anim_set_time(&a, 150);
+        lv_anim_set_playback_time(&a, 150);
+        lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
+    } else {
+        lv_anim_set_exec_cb(&a, ui_anim_shake);
+        lv_anim_set_values(&a, 0, 3 * 360);
+        lv_anim_set_time(&a, 360);
+    }
+    lv_anim_start(&a);
+}
+
+static void ui_cmd_apply(const ui_cmd_t *cmd)
+{
+    lv_obj_t *obj = cmd->target < UI_TARGET_MAX ? targets[cmd->target] : NULL;
+
+    switch (cmd->type) {
+    case UI_CMD_SET_EMOTION:
+        if (obj && cmd->value < UI_EMOTION_MAX) {
+            lv_obj_set_style_img_recolor(obj, lv_color_hex(emotion_tint[cmd->value].color), 0);
+            lv_obj_set_style_img_recolor_opa(obj, emotion_tint[cmd->value].opa, 0);
+        }
+        break;
+    case UI_CMD_SHOW_TEXT:
+        if (obj) {
+            lv_label_set_text(obj, cmd->text);
+        }
+        break;
+    case UI_CMD_START_ANIM:
+        if (obj && cmd->value < UI_ANIM_MAX) {
+            ui_start_anim(obj, (ui_anim_t) cmd->value);
+        }
+        break;
+    case UI_CMD_SET_BACKLIGHT:
+        BK_Light(cmd->value);
+        break;
+    default:
+        ESP_LOGW(TAG_UI, "unknown command %u", cmd->type);
+        break;
+    }
+}
+
+/*
+ * Applies the latest value of every set slot, then at most one ring's worth of
+ * animations in order. Anything left in the ring is handled in the next LVGL
+ * cycle, which starts right away.
+ */
+void UI_Cmd_Process(void)
+{
+    ui_cmd_t cmd;
+    int n = 0;
+    int anims = 0;
+
+    for (int i = 0; i < UI_CMD_SLOTS; i++) {
+        if (ui_cmd_take_latest(&cmd_slots[i], &cmd)) {
+            ui_cmd_apply(&cmd);
+            n++;
+        }
+    }
+    while (anims < UI_CMD_QUEUE_LEN && ui_cmd_take(&cmd)) {
+        ui_cmd_apply(&cmd);
+        anims++;
+    }
+    n += anims;
+    cmd_stats.applied += n;
+    if ((uint32_t) n > cmd_stats.max_pending) {
+        cmd_stats.max_pending = n;
+    }
+    if (anims == UI_CMD_QUEUE_LEN) {
+        LVGL_Wakeup();
+    }
+}
+
+void UI_Cmd_Get_Stats(ui_cmd_stats_t *stats)
+{
+    *stats = cmd_stats;
+    stats->posted = atomic_load_explicit(&stat_posted, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&stat_dropped, memory_order_relaxed);
+    stats->coalesced = atomic_load_explicit(&stat_coalesced, memory_order_relaxed);
+}
+
+void UI_Cmd_Bind(ui_target_t target, lv_obj_t *obj)
+{
+    if (target < UI_TARGET_MAX) {
+        targets[target] = obj;
+    }
+}
+
+void UI_Cmd_Init(void)
+{
+    for (unsigned int i = 0; i < UI_CMD_QUEUE_LEN; i++) {
+        atomic_init(&cmd_ring[i].seq, i);
+        atomic_init(&cmd_pool[i].busy, false);
+    }
+    for (unsigned int i = 0; i < UI_CMD_SLOTS; i++) {
+        atomic_init(&cmd_slots[i], 0);
+    }
+    atomic_init(&cmd_enqueue_pos, 0);
+    cmd_dequeue_pos = 0;
+}
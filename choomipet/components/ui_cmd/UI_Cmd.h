@@ -0,0 +1,78 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+// Animations that may be waiting for the LVGL task (power of two), a full queue rejects new ones.
+// Set commands keep only their latest value per target, in as many cells.
+#ifndef UI_CMD_QUEUE_LEN
+#define UI_CMD_QUEUE_LEN               16
+#endif
+// Longest text of UI_Show_Text(), including the terminating NUL; longer texts are cut
+#ifndef UI_CMD_TEXT_MAX
+#define UI_CMD_TEXT_MAX                96
+#endif
+
+typedef enum {
+    UI_TARGET_PET,           // jiumi image: emotions and animations
+    UI_TARGET_REPLY,         // label under the pet: AI reply text
+    UI_TARGET_TITLE,         // label at the top
+    UI_TARGET_MAX,
+} ui_target_t;
+
+typedef enum {
+    UI_EMOTION_NEUTRAL,
+    UI_EMOTION_HAPPY,
+    UI_EMOTION_SAD,
+    UI_EMOTION_ANGRY,
+    UI_EMOTION_SLEEPY,
+    UI_EMOTION_MAX,
+} ui_emotion_t;
+
+typedef enum {
+    UI_ANIM_JUMP,            // hop up and back down
+    UI_ANIM_SHAKE,           // wiggle left and right
+    UI_ANIM_MAX,
+} ui_anim_t;
+
+typedef enum {
+    UI_CMD_SET_EMOTION,      // value: ui_emotion_t, only the latest per target is applied
+    UI_CMD_SHOW_TEXT,        // text, only the latest per target is applied
+    UI_CMD_START_ANIM,       // value: ui_anim_t, queued; restarts a running one of the same kind
+    UI_CMD_SET_BACKLIGHT,    // value: 0 .. 100, only the latest is applied
+} ui_cmd_type_t;
+
+typedef struct {
+    uint8_t type;            // ui_cmd_type_t
+    uint8_t target;          // ui_target_t
+    uint16_t value;
+    char text[UI_CMD_TEXT_MAX];
+} ui_cmd_t;
+
+typedef struct {
+    uint32_t posted;         // commands accepted
+    uint32_t dropped;        // commands rejected because the queue was full
+    uint32_t applied;        // commands carried out on the LVGL task
+    uint32_t coalesced;      // set commands replaced by a later one for the same target before being applied
+    uint32_t max_pending;    // most commands taken in one LVGL cycle
+} ui_cmd_stats_t;
+
+/*
+ * Any task may post: posting never blocks and takes no lock. A set command
+ * replaces the pending one of its target, so the last of a burst is never
+ * lost; an animation is copied into a lock-free ring. lv_anim_start() deletes
+ * a running animation of the same object and kind, so of a burst of the same
+ * animation only the last one plays to its end. Posting wakes LVGL_Run(), the
+ * LVGL task applies the commands in UI_Cmd_Process() before each
+ * lv_timer_handler(), so LVGL itself is only ever touched from that task.
+ */
+bool UI_Cmd_Post(const ui_cmd_t *cmd);                 // false if the target is invalid or the queue is full
+bool UI_Set_Emotion(ui_emotion_t emotion);
+bool UI_Show_Text(ui_target_t target, const char *text); // false if text is NULL
+bool UI_Start_Anim(ui_anim_t anim);
+bool UI_Set_Backlight(uint8_t level);
+
+void UI_Cmd_Get_Stats(ui_cmd_stats_t *stats);          // Counters of the command queue, sampled without locking from any task
+void UI_Cmd_Bind(ui_target_t target, lv_obj_t *obj);   // LVGL task: the widget a target's commands apply to
+void UI_Cmd_Process(void);                             // LVGL task: apply the queued commands, pass to LVGL_Run()
+void UI_Cmd_Init(void);                                // Call before any task posts
@@ -1,7 +1,12 @@
 #include <stdio.h>
 #include "ST7789.h"
 #include "LVGL_Driver.h"
+#include "UI_Cmd.h"
+#include "Asset_Pack.h"
 #include "lvgl.h"
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#endif
 
 // 声明外部图片资源
 LV_IMG_DECLARE(jiumi_img);
@@ -20,10 +25,14 @@ void app_task(void *pvParameter)
     // 初始化LVGL
     LVGL_Init();
 
+    // 映射 flash_test 分区中的资源包（tools/asset_pack.py 生成），像素直接从flash读取，不复制到内存
+    Asset_Pack_Init();
+
     // Create an image widget and set the image source
-    // 在172×320分辨率的1.47寸LCD屏幕上显示64×64像素的测试图片
+    // 在172×320分辨率的1.47寸LCD屏幕上显示64×64像素的测试图片；资源包中有 "jiumi" 时优先使用，无需重新烧录固件即可换图
     lv_obj_t *img = lv_img_create(lv_scr_act());
-    lv_img_set_src(img, &jiumi_img);
+    const lv_img_dsc_t *pet = Asset_Get("jiumi");
+    lv_img_set_src(img, pet ? pet : &jiumi_img);
     lv_obj_center(img);  // 将图片居中显示在屏幕上
     
     // Create a label below the image with screen info
@@ -40,12 +49,13 @@ void app_task(void *pvParameter)
     
     printf("Jiumi image loaded and displayed on LCD\n");
 
-    // 主循环
-    while (1) {
-        // LVGL任务处理器
-        vTaskDelay(pdMS_TO_TICKS(10));
-        lv_timer_handler();
-    }
+    // 网络/音频任务通过 UI_Cmd.h 投递命令，只由本任务修改这些控件
+    UI_Cmd_Bind(UI_TARGET_PET, img);
+    UI_Cmd_Bind(UI_TARGET_REPLY, label);
+    UI_Cmd_Bind(UI_TARGET_TITLE, title);
+
+    // 主循环：休眠到下一个LVGL定时器到期或LVGL_Wakeup()，界面静止时不再唤醒；每轮先执行队列中的界面命令
+    LVGL_Run(UI_Cmd_Process);
 }
 
 /**
@@ -54,6 +64,17 @@ void app_task(void *pvParameter)
  */
 void app_main(void)
 {
+#if CONFIG_PM_ENABLE
+    // 所有任务都阻塞时进入浅睡眠（需要 CONFIG_FREERTOS_USE_TICKLESS_IDLE）
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_XTAL_FREQ,
+        .light_sleep_enable = true,
+    };
+    ESP_ERROR_CHECK(esp_pm_configure(&pm_config));
+#endif
+    // 命令队列先于所有任务初始化，其他任务可随时投递界面命令
+    UI_Cmd_Init();
     // 创建应用任务
     xTaskCreate(app_task, "app_task", 8192, NULL, 5, NULL);
 }
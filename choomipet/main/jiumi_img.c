@@ -20,6 +20,17 @@
 #define LV_ATTRIBUTE_IMG_JIUMI_IMG
 #endif
 
+// 像素按 LV_COLOR_16_SWAP 在编译期排好字节序：为 1 时高字节在前，与 ST7789 的 SPI 顺序一致，刷新时无需再转换
+#if LV_COLOR_16_SWAP == 0
+#define JIUMI_PX(c)     (uint8_t)((c) & 0xFF), (uint8_t)((c) >> 8)
+#else
+#define JIUMI_PX(c)     (uint8_t)((c) >> 8), (uint8_t)((c) & 0xFF)
+#endif
+#define JIUMI_PX8(c)    JIUMI_PX(c), JIUMI_PX(c), JIUMI_PX(c), JIUMI_PX(c), JIUMI_PX(c), JIUMI_PX(c), JIUMI_PX(c), JIUMI_PX(c)
+#define JIUMI_ROW(c)    JIUMI_PX8(c), JIUMI_PX8(c), JIUMI_PX8(c), JIUMI_PX8(c), JIUMI_PX8(c), JIUMI_PX8(c), JIUMI_PX8(c), JIUMI_PX8(c)
+#define JIUMI_ROW4(c)   JIUMI_ROW(c), JIUMI_ROW(c), JIUMI_ROW(c), JIUMI_ROW(c)
+#define JIUMI_ROW16(c)  JIUMI_ROW4(c), JIUMI_ROW4(c), JIUMI_ROW4(c), JIUMI_ROW4(c)
+
 // 适用于172×320分辨率1.47寸LCD屏幕的测试图片
 // 创建一个100×100像素的彩色测试图案，适合在该屏幕上清晰显示
 const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_IMG_JIUMI_IMG uint8_t jiumi_img_map[] = {
@@ -31,44 +42,16 @@ const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_IMG_JIUMI_IMG uint8_t jiumi_img_map[]
     // 下半部分：蓝色渐变到黄色
     
     // 第1-16行：红色区域 (RGB565: 0xF800)
-    0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8,
-    0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8,
-    0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8,
-    0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8,
-    0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8,
-    0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8,
-    0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8,
-    0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8, 0x00,0xF8,
+    JIUMI_ROW16(0xF800),
     
     // 第17-32行：绿色区域 (RGB565: 0x07E0)
-    0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07,
-    0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07,
-    0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07,
-    0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07,
-    0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07,
-    0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07,
-    0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07,
-    0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07, 0xE0,0x07,
+    JIUMI_ROW16(0x07E0),
     
     // 第33-48行：蓝色区域 (RGB565: 0x001F)
-    0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00,
-    0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00,
-    0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00,
-    0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00,
-    0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00,
-    0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00,
-    0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00,
-    0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00, 0x1F,0x00,
+    JIUMI_ROW16(0x001F),
     
     // 第49-64行：黄色区域 (RGB565: 0xFFE0)
-    0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF,
-    0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF,
-    0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF,
-    0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF,
-    0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF,
-    0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF,
-    0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF,
-    0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF, 0xE0,0xFF,
+    JIUMI_ROW16(0xFFE0),
 };
 
 const lv_img_dsc_t jiumi_img = {
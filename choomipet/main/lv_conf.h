@@ -26,8 +26,12 @@
 /*Color depth: 1 (1 byte per pixel), 8 (RGB332), 16 (RGB565), 32 (ARGB8888)*/
 #define LV_COLOR_DEPTH 16
 
-/*Swap the 2 bytes of RGB565 color. Useful if the display has an 8-bit interface (e.g. SPI)*/
-#define LV_COLOR_16_SWAP 0
+/*Swap the 2 bytes of RGB565 color. Useful if the display has an 8-bit interface (e.g. SPI)
+ *1: render MSB-first pixels, the ST7789's native SPI order, so flushed bands need no conversion.
+ *The simulator builds a LV_COLOR_16_SWAP 0 variant for comparison, hence the guard.*/
+#ifndef LV_COLOR_16_SWAP
+#define LV_COLOR_16_SWAP 1
+#endif
 
 /*Enable features to draw on transparent background.
  *It's required if opa, and transform_* style properties are used.
@@ -48,8 +52,18 @@
 /*1: use custom malloc/free, 0: use the built-in `lv_mem_alloc()` and `lv_mem_free()`*/
 #define LV_MEM_CUSTOM 0
 #if LV_MEM_CUSTOM == 0
-    /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)*/
-    #define LV_MEM_SIZE (48U * 1024U)          /*[bytes]*/
+    /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)
+     *The caches and records kept between frames can take up to 18 kB of it: images 12 kB (LV_IMG_CACHE_DEF_MEM_SIZE,
+     *RLE images decoded to RAM included), gradients 2 kB, retained drawing 4 kB (`retained_mem`). The shadow corners
+     *have a static array of their own (LV_SHADOW_CACHE_MEM_SIZE).
+     *When an allocation fails the least recently used images and then gradients are dropped and it is retried,
+     *but the retained drawing is not, so keep them below about 40 % of the heap: the rest is for
+     *the widgets, the style caches (about 110 bytes per drawn object with 2 or more styles, see
+     *LV_USE_OBJ_STYLE_CACHE) and the layers and masks allocated while drawing.
+     *The simulator's timer benchmark builds a variant with room for 1000 timers, hence the guard.*/
+    #ifndef LV_MEM_SIZE
+    #define LV_MEM_SIZE (64U * 1024U)          /*[bytes]*/
+    #endif
 
     /*Set an address for the memory pool instead of allocating it as a normal array. Can be in external SRAM too.*/
     #define LV_MEM_ADR 0     /*0: unused*/
@@ -111,8 +125,12 @@
 
     /*Allow buffering some shadow calculation.
     *LV_SHADOW_CACHE_SIZE is the max. shadow size to buffer, where shadow size is `shadow_width + radius`
-    *Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost*/
-    #define LV_SHADOW_CACHE_SIZE 0
+    *A cached shadow has a shadow size^2 RAM cost*/
+    #define LV_SHADOW_CACHE_SIZE 48
+
+    /*RAM the cached shadows can use [bytes], a static array and not from the heap. The least recently used ones
+     *are dropped first*/
+    #define LV_SHADOW_CACHE_MEM_SIZE (6 * 1024)
 
     /* Set number of maximally cached circle data.
     * The circumference of 1/4 circle are saved for anti-aliasing
@@ -141,19 +159,30 @@
  *If only the built-in image formats are used there is no real advantage of caching. (I.e. if no new image decoder is added)
  *With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
  *However the opened images might consume additional RAM.
+ *It's the number of images expected in the cache, how many are kept depends on LV_IMG_CACHE_DEF_MEM_SIZE.
  *0: to disable caching*/
-#define LV_IMG_CACHE_DEF_SIZE 0
+#define LV_IMG_CACHE_DEF_SIZE 8
+
+/*RAM the opened images can keep in the image cache [bytes].
+ *The images decoded to RAM count with their decoded size, the least recently used ones are closed first*/
+#define LV_IMG_CACHE_DEF_MEM_SIZE (12 * 1024)
+
+/*Decode the run-length encoded images (`LV_IMG_CF_RLE_...`) into RAM at once if they take at most this many bytes.
+ *Such images can be kept in the image cache, rotated and zoomed. The larger ones are decoded row by row while drawn,
+ *only the visible rows. 0: always row by row*/
+#define LV_IMG_RLE_DECODE_MAX_SIZE (8 * 1024)
 
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
-#define LV_GRADIENT_MAX_STOPS 2
+#define LV_GRADIENT_MAX_STOPS 4
 
 /*Default gradient buffer size.
  *When LVGL calculates the gradient "maps" it can save them into a cache to avoid calculating them again.
  *LV_GRAD_CACHE_DEF_SIZE sets the size of this cache in bytes.
+ *The maps are cached by their stops and size. When it's full the least recently used ones are dropped.
  *If the cache is too small the map will be allocated only while it's required for the drawing.
  *0 mean no caching.*/
-#define LV_GRAD_CACHE_DEF_SIZE 0
+#define LV_GRAD_CACHE_DEF_SIZE (2 * 1024)
 
 /*Allow dithering the gradients (to achieve visual smooth color gradients on limited color depth display)
  *LV_DITHER_GRADIENT implies allocating one or two more lines of the object's rendering surface
@@ -170,6 +199,19 @@
  *Only used if software rotation is enabled in the display driver.*/
 #define LV_DISP_ROT_MAX_BUF (10*1024)
 
+/*1: Allow rendering the parts of the screen in horizontal strips on several threads
+ *(`render_strips`, `render_cb` and `render_lock_cb` in the display driver).
+ *The ESP32-C6 has a single core; dual-core variants and the simulator's parallel build set 1, hence the guard.*/
+#ifndef LV_USE_PARALLEL_RENDER
+#define LV_USE_PARALLEL_RENDER 0
+#endif
+
+/*1: Cache the frequently drawn style properties (e.g. background, border, radius, padding and text)
+ *of the main part of the objects instead of looking them up in the styles every time.
+ *Needs about 110 bytes (32 bit) per drawn object with several styles, allocated from the heap.
+ *Styles changed at run time still need to be reported with `lv_obj_report_style_change()`*/
+#define LV_USE_OBJ_STYLE_CACHE 1
+
 /*-------------
  * GPU
  *-----------*/
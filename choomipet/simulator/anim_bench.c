@@ -0,0 +1,206 @@
+/**
+ * @file anim_bench.c
+ * Steps the pet's idle animations on a headless 172x320 display: bobbing
+ * faces, blinking eyes and drifting particles with several properties
+ * animated per object. Runs them once with the built-in paths, which are
+ * evaluated in batches, and once with wrappers of the same paths, which are
+ * called one by one, compares every applied value and reports the time of
+ * an animation step (host CPU). One animation retargets another one from its
+ * callback and once refreshes the animations in the middle of a step.
+ */
+
+#include <stdio.h>
+#include "lvgl.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define OBJS            24
+#define STEPS           500
+#define STEP_MS         17
+
+static uint32_t applied;
+static uint32_t value_hash;
+static lv_obj_t *drift_obj;
+static uint32_t step_now;
+static uint32_t retarget_calls;
+
+static void bench_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    (void)area;
+    (void)color_p;
+    lv_disp_flush_ready(drv);
+}
+
+static void record(int32_t v)
+{
+    applied++;
+    value_hash = (value_hash ^ (uint32_t)v) * 16777619u;
+}
+
+static void y_cb(void *obj, int32_t v)
+{
+    record(v);
+    lv_obj_set_style_translate_y(obj, (lv_coord_t)v, 0);
+}
+
+static void x_cb(void *obj, int32_t v)
+{
+    record(v);
+    lv_obj_set_style_translate_x(obj, (lv_coord_t)v, 0);
+}
+
+static void opa_cb(void *obj, int32_t v)
+{
+    record(v);
+    lv_obj_set_style_opa(obj, (lv_opa_t)v, 0);
+}
+
+static void bg_opa_cb(void *obj, int32_t v)
+{
+    record(v);
+    lv_obj_set_style_bg_opa(obj, (lv_opa_t)v, 0);
+}
+
+/* Moves the end of a particle's drift, which is stepped after it */
+static void retarget_cb(void *obj, int32_t v)
+{
+    (void)obj;
+    record(v);
+    lv_anim_t *drift = lv_anim_get(drift_obj, y_cb);
+    if (drift) {
+        drift->end_value = -60 - v;
+    }
+    if (++retarget_calls == STEPS / 2) {
+        _lv_anim_refr_at(step_now + 1, STEP_MS);
+    }
+}
+
+/* The same curves through a function of their own: evaluated one by one */
+static int32_t wrap_linear(const lv_anim_t *a)
+{
+    return lv_anim_path_linear(a);
+}
+
+static int32_t wrap_ease_in_out(const lv_anim_t *a)
+{
+    return lv_anim_path_ease_in_out(a);
+}
+
+static int32_t wrap_ease_out(const lv_anim_t *a)
+{
+    return lv_anim_path_ease_out(a);
+}
+
+static int32_t wrap_overshoot(const lv_anim_t *a)
+{
+    return lv_anim_path_overshoot(a);
+}
+
+static void start(lv_obj_t *obj, lv_anim_exec_xcb_t exec_cb, lv_anim_path_cb_t path, int32_t from, int32_t to,
+                  uint32_t time, uint32_t delay, bool playback)
+{
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, obj);
+    lv_anim_set_exec_cb(&a, exec_cb);
+    lv_anim_set_path_cb(&a, path);
+    lv_anim_set_values(&a, from, to);
+    lv_anim_set_time(&a, time);
+    lv_anim_set_delay(&a, delay);
+    if (playback) {
+        lv_anim_set_playback_time(&a, time);
+    }
+    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_start(&a);
+}
+
+/* Creates the objects and their animations, returns the tick the animations start at */
+static uint32_t create_scene(bool wrapped)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_anim_del_all();
+    uint32_t tick = lv_tick_get();
+    lv_anim_path_cb_t linear = wrapped ? wrap_linear : lv_anim_path_linear;
+    lv_anim_path_cb_t ease_in_out = wrapped ? wrap_ease_in_out : lv_anim_path_ease_in_out;
+    lv_anim_path_cb_t ease_out = wrapped ? wrap_ease_out : lv_anim_path_ease_out;
+    lv_anim_path_cb_t overshoot = wrapped ? wrap_overshoot : lv_anim_path_overshoot;
+
+    for (int i = 0; i < OBJS; i++) {
+        lv_obj_t *obj = lv_obj_create(lv_scr_act());
+        lv_obj_set_size(obj, 20 + i % 3 * 8, 20);
+        lv_obj_set_pos(obj, (i % 6) * 28, (i / 6) * 70 + 20);
+        switch (i % 3) {
+        case 0: // Face: bobbing and breathing
+            start(obj, y_cb, ease_in_out, 0, 6, 900 + i * 7, i * 13, true);
+            start(obj, bg_opa_cb, linear, LV_OPA_70, LV_OPA_COVER, 1200, 0, true);
+            break;
+        case 1: // Eye: blinking
+            start(obj, opa_cb, linear, LV_OPA_COVER, LV_OPA_TRANSP, 150, 2000 + i * 50, true);
+            start(obj, y_cb, ease_out, 0, 2, 300, 0, true);
+            break;
+        default: // Particle: drifting up and sideways, fading
+            start(obj, y_cb, ease_out, 0, -60, 1500 + i * 11, i * 31, false);
+            start(obj, x_cb, overshoot, -8, 8, 700 + i * 5, 0, true);
+            start(obj, opa_cb, linear, LV_OPA_COVER, LV_OPA_20, 1500 + i * 11, i * 31, false);
+            break;
+        }
+        if (i == 2) {
+            drift_obj = obj;
+        }
+        if (i == OBJS - 1) {
+            start(obj, retarget_cb, linear, 0, 10, 400, 0, true);
+        }
+    }
+    return tick;
+}
+
+static void run(bool wrapped, uint32_t *hash, uint32_t *cnt, double *us)
+{
+    // Both runs must step from the same start: redo it if the tick changed meanwhile
+    uint32_t now;
+    do {
+        now = create_scene(wrapped);
+    } while (lv_tick_get() != now);
+
+    applied = 0;
+    value_hash = 2166136261u;
+    retarget_calls = 0;
+    int64_t t = 0;
+    for (int s = 0; s < STEPS; s++) {
+        now += STEP_MS;
+        step_now = now;
+        int64_t t0 = sim_clock_ns();
+        _lv_anim_refr_at(now, STEP_MS);
+        t += sim_clock_ns() - t0;
+        // Drop the invalidated areas so every step starts from the same state
+        lv_disp_get_default()->inv_p = 0;
+    }
+    *hash = value_hash;
+    *cnt = applied;
+    *us = (double)t / STEPS / 1e3;
+}
+
+int main(void)
+{
+    int ret = 0;
+
+    sim_bench_init();
+    sim_bench_disp_drv.flush_cb = bench_flush_cb;
+
+    printf("animation steps, %d objects with %d animations, %d steps of %d ms (host CPU)\n",
+           OBJS, OBJS / 3 * 7 + 1, STEPS, STEP_MS);
+    uint32_t hash_one, hash_batch, cnt_one, cnt_batch;
+    double us_one, us_batch;
+    run(true, &hash_one, &cnt_one, &us_one);
+    run(false, &hash_batch, &cnt_batch, &us_batch);
+    printf("  path called per animation  %6.2f us/step  %6u values applied\n", us_one, (unsigned)cnt_one);
+    printf("  built-in paths in batches  %6.2f us/step  %6u values applied  (%5.1f %%)%s\n", us_batch,
+           (unsigned)cnt_batch, 100.0 * us_batch / us_one,
+           hash_one != hash_batch || cnt_one != cnt_batch ? "  MISMATCH" : "");
+    if (hash_one != hash_batch || cnt_one != cnt_batch || cnt_one == 0) {
+        ret = 1;
+    }
+    return ret;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file asset_pack_bench.c
+ * Builds asset packs of 16 to 1024 entries in memory, checks that every
+ * lookup finds its own entry and times Asset_Get_Frame() against a linear
+ * scan of the same index.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "Asset_Pack.h"
+#include "sim.h"
+
+#define LOOKUPS         200000
+#define FRAMES_EVERY    4           // every 4th name is an 8 frame animation, the others stills
+#define FRAMES          8
+
+typedef struct {
+    char name[ASSET_PACK_NAME_MAX];
+    uint16_t frame;
+} bench_key_t;
+
+static int key_cmp(const void *a, const void *b)
+{
+    const bench_key_t *ka = a, *kb = b;
+    int c = strncmp(ka->name, kb->name, ASSET_PACK_NAME_MAX);
+    return c ? c : (int)ka->frame - (int)kb->frame;
+}
+
+/* A pack of `count` 2x2 RGB565 images; names are scrambled so the index order differs from creation order */
+static uint8_t *build_pack(int count, bench_key_t *keys, size_t *size_out)
+{
+    int n = 0;
+    for (int i = 0; n < count; i++) {
+        int frames = i % FRAMES_EVERY == 0 ? FRAMES : 1;
+        for (int f = 0; f < frames && n < count; f++, n++) {
+            snprintf(keys[n].name, sizeof(keys[n].name), "%s_%05u", i % 3 ? "pet" : "ui", (unsigned)((i * 7919u) % 100003u));
+            keys[n].frame = (uint16_t)f;
+        }
+    }
+    qsort(keys, count, sizeof(bench_key_t), key_cmp);
+
+    uint32_t px_size = 2 * 2 * 2;
+    uint32_t blobs = sizeof(asset_pack_header_t) + count * sizeof(asset_pack_entry_t);
+    size_t size = blobs + (size_t)count * px_size;
+    uint8_t *pack = aligned_alloc(64, (size + 63) / 64 * 64);
+    if (pack == NULL) {
+        return NULL;
+    }
+    memset(pack, 0, size);
+    asset_pack_header_t *hdr = (asset_pack_header_t *)pack;
+    *hdr = (asset_pack_header_t) {
+        .magic = ASSET_PACK_MAGIC,
+        .version = ASSET_PACK_VERSION,
+        .count = (uint16_t)count,
+        .size = (uint32_t)size,
+        .flags = LV_COLOR_16_SWAP ? ASSET_PACK_FLAG_COLOR_16_SWAP : 0,
+        .entry_size = sizeof(asset_pack_entry_t),
+    };
+    asset_pack_entry_t *index = (asset_pack_entry_t *)(hdr + 1);
+    for (int i = 0; i < count; i++) {
+        int first = i;
+        while (first > 0 && strcmp(keys[first - 1].name, keys[i].name) == 0) {
+            first--;
+        }
+        int last = i;
+        while (last + 1 < count && strcmp(keys[last + 1].name, keys[i].name) == 0) {
+            last++;
+        }
+        memcpy(index[i].name, keys[i].name, ASSET_PACK_NAME_MAX);
+        index[i].frame = keys[i].frame;
+        index[i].frames = (uint16_t)(last - first + 1);
+        index[i].header = (lv_img_header_t) { .cf = LV_IMG_CF_TRUE_COLOR, .w = 2, .h = 2 };
+        index[i].offset = blobs + i * px_size;
+        index[i].size = px_size;
+    }
+    *size_out = size;
+    return pack;
+}
+
+/* Reference: what a lookup costs without the sorted index */
+static int linear_find(const asset_pack_entry_t *index, int count, const bench_key_t *key)
+{
+    for (int i = 0; i < count; i++) {
+        if (strncmp(key->name, index[i].name, ASSET_PACK_NAME_MAX) == 0 && key->frame == index[i].frame) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int bench(int count)
+{
+    bench_key_t *keys = calloc(count, sizeof(bench_key_t));
+    size_t size;
+    uint8_t *pack = keys ? build_pack(count, keys, &size) : NULL;
+    if (pack == NULL || Asset_Pack_Load(pack, size) != ESP_OK || Asset_Count() != count) {
+        printf("  %5d entries: pack rejected\n", count);
+        return 1;
+    }
+    const asset_pack_entry_t *index = (const asset_pack_entry_t *)((asset_pack_header_t *)pack + 1);
+
+    // Every entry must be found at its own pixels, a missing frame must not be
+    int errors = 0;
+    for (int i = 0; i < count; i++) {
+        const lv_img_dsc_t *dsc = Asset_Get_Frame(keys[i].name, keys[i].frame);
+        if (dsc == NULL || dsc->data != pack + index[i].offset || dsc->header.w != 2 ||
+            Asset_Frame_Count(keys[i].name) != index[i].frames) {
+            errors++;
+        }
+        if (Asset_Get_Frame(keys[i].name, index[i].frames) != NULL) {
+            errors++;
+        }
+    }
+
+    volatile uintptr_t sink = 0;
+    int64_t t0 = sim_clock_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        const bench_key_t *k = &keys[(i * 40503u) % count];
+        sink += (uintptr_t)Asset_Get_Frame(k->name, k->frame);
+    }
+    int64_t t1 = sim_clock_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        sink += (uintptr_t)Asset_Get("missing_asset");
+    }
+    int64_t t2 = sim_clock_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        const bench_key_t *k = &keys[(i * 40503u) % count];
+        sink += (uintptr_t)linear_find(index, count, k);
+    }
+    int64_t t3 = sim_clock_ns();
+    (void)sink;
+
+    printf("  %5d entries  %6.1f ns hit  %6.1f ns miss  %8.1f ns linear scan%s\n", count,
+           (double)(t1 - t0) / LOOKUPS, (double)(t2 - t1) / LOOKUPS, (double)(t3 - t2) / LOOKUPS,
+           errors ? "  LOOKUP ERRORS" : "");
+    free(pack);
+    free(keys);
+    return errors ? 1 : 0;
+}
+
+int main(void)
+{
+    static const int counts[] = { 16, 64, 256, 1024 };
+    int ret = 0;
+
+    sim_clock_init();
+    esp_log_level_set("*", ESP_LOG_WARN);
+    printf("asset pack lookups, %d per measurement (host CPU)\n", LOOKUPS);
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        ret |= bench(counts[i]);
+    }
+    return ret;
+}
@@ -0,0 +1,365 @@
+/**
+ * @file blend_bench.c
+ * Compares the blend kernels of lv_draw_sw_blend.c (one pixel at a time, SWAR and
+ * SSE2 where the host has it) on the host CPU:
+ *  - bit-exactness: random fills and maps with opacity and masks on random areas
+ *    (all alignments of the pixels and masks) and every opacity against every
+ *    mask value must give the same pixels as the scalar code,
+ *  - throughput of the four kernels on a varied 172x40 band with a sprite-like
+ *    alpha mask,
+ *  - the render time of translucent sprites over a pet background on a headless
+ *    172x320 display, every frame identical.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "src/draw/sw/lv_draw_sw.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define BAND_H          40
+#define RANDOM_CASES    20000
+#define BENCH_REPEAT    200
+#define FRAMES          30
+#define RUNS            5
+#define SPRITES         6
+#define SPRITE_SIZE     48
+
+static lv_color_t band_ref[HOR_RES * BAND_H], band[HOR_RES * BAND_H], band_init[HOR_RES * BAND_H];
+static lv_color_t src_px[HOR_RES * BAND_H + 1];
+static lv_opa_t mask_ref[HOR_RES * BAND_H + 3], mask_px[HOR_RES * BAND_H + 3];
+
+static lv_color_t bg_px[VER_RES * HOR_RES];
+static uint8_t sprite_px[SPRITE_SIZE * SPRITE_SIZE * LV_IMG_PX_SIZE_ALPHA_BYTE];
+static lv_img_dsc_t bg_img, sprite_img;
+
+static const struct {
+    lv_draw_sw_blend_kernels_t kernels;
+    const char *name;
+} kernel_sets[] = {
+    { LV_DRAW_SW_BLEND_KERNELS_SCALAR, "scalar" },
+    { LV_DRAW_SW_BLEND_KERNELS_SWAR, "swar" },
+    { LV_DRAW_SW_BLEND_KERNELS_SSE2, "sse2" },
+};
+#define KERNEL_SETS (sizeof(kernel_sets) / sizeof(kernel_sets[0]))
+
+typedef enum {
+    OP_FILL_OPA,
+    OP_FILL_MASK,
+    OP_MAP_OPA,
+    OP_MAP_MASK,
+    OP_CNT,
+} op_t;
+
+static const char *op_names[OP_CNT] = { "fill opa", "fill mask", "map opa", "map mask" };
+
+static uint32_t seed = 1;
+
+static uint32_t rnd(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+/* Blend like the draw functions do: through the blend function of a draw context on the band */
+static void blend(lv_color_t *dest, const lv_area_t *area, op_t op, lv_color_t color, lv_opa_t opa,
+                  const lv_color_t *src, lv_opa_t *mask)
+{
+    static lv_draw_sw_ctx_t ctx;
+    static lv_area_t band_area = { 0, 0, HOR_RES - 1, BAND_H - 1 };
+    lv_draw_sw_init_ctx(&sim_bench_disp_drv, &ctx.base_draw);
+    ctx.base_draw.buf = dest;
+    ctx.base_draw.buf_area = &band_area;
+    ctx.base_draw.clip_area = &band_area;
+
+    lv_draw_sw_blend_dsc_t dsc;
+    lv_memset_00(&dsc, sizeof(dsc));
+    dsc.blend_area = area;
+    dsc.color = color;
+    dsc.opa = opa;
+    dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+    if (op == OP_MAP_OPA || op == OP_MAP_MASK) {
+        dsc.src_buf = src;
+    }
+    if (op == OP_FILL_MASK || op == OP_MAP_MASK) {
+        dsc.mask_buf = mask;
+        dsc.mask_area = area;
+        dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+    }
+    lv_draw_sw_blend_basic(&ctx.base_draw, &dsc);
+}
+
+static lv_color_t rnd_color(void)
+{
+    lv_color_t c;
+    c.full = (uint16_t)rnd();
+    return c;
+}
+
+/* Mostly the values the kernels treat specially: transparent, cover and around LV_OPA_MAX */
+static lv_opa_t rnd_opa(void)
+{
+    static const lv_opa_t special[] = { 0, 1, 2, 4, 128, 251, 252, 253, 254, 255 };
+    return rnd() % 2 ? special[rnd() % sizeof(special)] : (lv_opa_t)rnd();
+}
+
+/* Random cases on random areas; every mask byte is set, so its offset gives any alignment */
+static int check_random(lv_draw_sw_blend_kernels_t kernels)
+{
+    int errors = 0;
+    seed = 1;
+    for (int i = 0; i < RANDOM_CASES; i++) {
+        lv_area_t area;
+        area.x1 = rnd() % HOR_RES;
+        area.x2 = area.x1 + rnd() % (HOR_RES - area.x1);
+        area.y1 = rnd() % BAND_H;
+        area.y2 = area.y1 + rnd() % LV_MIN(8, BAND_H - area.y1);
+        op_t op = rnd() % OP_CNT;
+        lv_color_t color = rnd_color();
+        lv_opa_t opa = rnd_opa();
+        for (int p = 0; p < HOR_RES * BAND_H; p++) {
+            band_ref[p] = rnd_color();
+            src_px[p] = rnd_color();
+            mask_ref[p] = rnd() % 3 ? rnd_opa() : (lv_opa_t)rnd();
+        }
+        // Masks and sources are taken from their start: vary their alignment
+        int shift = rnd() % 4;
+        lv_opa_t *mask = &mask_px[shift];
+        const lv_color_t *src = &src_px[shift & 1];
+        memcpy(band, band_ref, sizeof(band));
+
+        memcpy(mask, mask_ref, HOR_RES * BAND_H);
+        lv_draw_sw_blend_set_kernels(LV_DRAW_SW_BLEND_KERNELS_SCALAR);
+        blend(band_ref, &area, op, color, opa, src, mask);
+        memcpy(mask, mask_ref, HOR_RES * BAND_H);
+        lv_draw_sw_blend_set_kernels(kernels);
+        blend(band, &area, op, color, opa, src, mask);
+
+        if (memcmp(band, band_ref, sizeof(band)) != 0) {
+            if (errors++ < 3) {
+                printf("    %s, opa %u, area %d,%d %d,%d differs\n", op_names[op], opa, area.x1, area.y1, area.x2,
+                       area.y2);
+            }
+        }
+    }
+    return errors;
+}
+
+/* Every opacity against every mask value (along a row), with random pixels */
+static int check_sweep(lv_draw_sw_blend_kernels_t kernels)
+{
+    int errors = 0;
+    seed = 2;
+    for (int opa = 0; opa < 256; opa++) {
+        for (op_t op = 0; op < OP_CNT; op++) {
+            lv_area_t area = { 0, 0, 255 % HOR_RES, 1 };
+            for (int p = 0; p < HOR_RES * BAND_H; p++) {
+                band_ref[p] = rnd_color();
+                src_px[p] = rnd_color();
+                mask_ref[p] = (lv_opa_t)(p + opa);
+            }
+            lv_color_t color = rnd_color();
+            memcpy(band, band_ref, sizeof(band));
+            memcpy(mask_px, mask_ref, sizeof(mask_ref));
+            lv_draw_sw_blend_set_kernels(LV_DRAW_SW_BLEND_KERNELS_SCALAR);
+            blend(band_ref, &area, op, color, (lv_opa_t)opa, src_px, mask_px);
+            memcpy(mask_px, mask_ref, sizeof(mask_ref));
+            lv_draw_sw_blend_set_kernels(kernels);
+            blend(band, &area, op, color, (lv_opa_t)opa, src_px, mask_px);
+            if (memcmp(band, band_ref, sizeof(band)) != 0 && errors++ < 3) {
+                printf("    %s, opa %d differs\n", op_names[op], opa);
+            }
+        }
+    }
+    return errors;
+}
+
+/* A soft edged disc: mostly cover or transparent, antialiased on the edge */
+static void make_sprite_mask(lv_opa_t *mask)
+{
+    for (int y = 0; y < BAND_H; y++) {
+        for (int x = 0; x < HOR_RES; x++) {
+            int dx = x % 48 - 24, dy = y - BAND_H / 2;
+            int d = dx * dx + dy * dy;
+            mask[y * HOR_RES + x] = d < 17 * 17 ? LV_OPA_COVER : d > 19 * 19 ? LV_OPA_TRANSP : (lv_opa_t)(255 - (d - 289) * 3);
+        }
+    }
+}
+
+/* Mpx/s of an operation on the whole band, best of RUNS */
+static double throughput(op_t op, lv_opa_t opa)
+{
+    static const lv_area_t area = { 0, 0, HOR_RES - 1, BAND_H - 1 };
+    int64_t best = INT64_MAX;
+    for (int run = 0; run < RUNS; run++) {
+        memcpy(band, band_init, sizeof(band));
+        int64_t t0 = sim_clock_ns();
+        for (int i = 0; i < BENCH_REPEAT; i++) {
+            blend(band, &area, op, lv_color_hex(0x40A0F0), opa, src_px, mask_px);
+        }
+        int64_t t = sim_clock_ns() - t0;
+        if (t < best) {
+            best = t;
+        }
+    }
+    return (double)HOR_RES * BAND_H * BENCH_REPEAT / 1e6 / ((double)best / 1e9);
+}
+
+static void make_scene(void)
+{
+    for (int y = 0; y < VER_RES; y++) {
+        for (int x = 0; x < HOR_RES; x++) {
+            bg_px[y * HOR_RES + x] = lv_color_hsv_to_rgb((uint16_t)(100 + y / 4), 40 + (x * 7 + y * 3) % 20, 60 + x / 8);
+        }
+    }
+    bg_img.header.cf = LV_IMG_CF_TRUE_COLOR;
+    bg_img.header.w = HOR_RES;
+    bg_img.header.h = VER_RES;
+    bg_img.data = (const uint8_t *)bg_px;
+    bg_img.data_size = sizeof(bg_px);
+
+    int r = SPRITE_SIZE / 2 - 2;
+    for (int y = 0; y < SPRITE_SIZE; y++) {
+        for (int x = 0; x < SPRITE_SIZE; x++) {
+            int dx = x - SPRITE_SIZE / 2, dy = y - SPRITE_SIZE / 2;
+            int d = dx * dx + dy * dy;
+            lv_color_t c = lv_color_hsv_to_rgb((uint16_t)(330 + x), 40, 95 - y / 2);
+            lv_opa_t a = d <= (r - 2) * (r - 2) ? LV_OPA_COVER : d <= r * r ? LV_OPA_70 : d <= (r + 2) * (r + 2) ? LV_OPA_30 : 0;
+            uint8_t *p = &sprite_px[(y * SPRITE_SIZE + x) * LV_IMG_PX_SIZE_ALPHA_BYTE];
+            memcpy(p, &c, sizeof(c));
+            p[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = a;
+        }
+    }
+    sprite_img.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    sprite_img.header.w = SPRITE_SIZE;
+    sprite_img.header.h = SPRITE_SIZE;
+    sprite_img.data = sprite_px;
+    sprite_img.data_size = sizeof(sprite_px);
+}
+
+/* The pet background, sprites (one of them translucent) and a translucent rounded panel */
+static double render(uint32_t *hashes)
+{
+    lv_obj_t *scr = lv_scr_act();
+    lv_obj_clean(scr);
+    lv_obj_t *bg = lv_img_create(scr);
+    lv_img_set_src(bg, &bg_img);
+    lv_obj_t *sprites[SPRITES];
+    for (int i = 0; i < SPRITES; i++) {
+        sprites[i] = lv_img_create(scr);
+        lv_img_set_src(sprites[i], &sprite_img);
+        if (i == 0) {
+            lv_obj_set_style_img_opa(sprites[i], LV_OPA_60, 0);
+        }
+    }
+    lv_obj_t *panel = lv_obj_create(scr);
+    lv_obj_set_size(panel, 150, 60);
+    lv_obj_set_pos(panel, 11, 250);
+    lv_obj_set_style_bg_opa(panel, LV_OPA_50, 0);
+    lv_obj_set_style_radius(panel, 16, 0);
+    lv_obj_set_style_border_width(panel, 0, 0);
+
+    int64_t best = INT64_MAX;
+    for (int run = 0; run < RUNS; run++) {
+        int64_t t = 0;
+        for (int f = 0; f < FRAMES; f++) {
+            for (int i = 0; i < SPRITES; i++) {
+                lv_obj_set_pos(sprites[i], (i * 53 + f * 3) % (HOR_RES - SPRITE_SIZE), 20 + i * 40 + f % 5);
+            }
+            lv_obj_invalidate(scr);
+            int64_t t0 = sim_clock_ns();
+            _lv_disp_refr_timer(lv_disp_get_default()->refr_timer);
+            t += sim_clock_ns() - t0;
+            hashes[f] = sim_bench_frame_hash();
+        }
+        if (t < best) {
+            best = t;
+        }
+    }
+    return (double)best / FRAMES / 1e6;
+}
+
+int main(void)
+{
+    static uint32_t reference[FRAMES], hashes[FRAMES];
+    int ret = 0;
+
+    lv_disp_t *disp = sim_bench_init();
+    lv_draw_sw_blend_kernels_t selected = lv_draw_sw_blend_get_kernels();
+
+    printf("blend kernels, RGB565 %s first, selected at init: %s (host CPU)\n", LV_COLOR_16_SWAP ? "MSB" : "LSB",
+           kernel_sets[selected].name);
+
+    // The blend functions need the display being refreshed
+    _lv_refr_set_disp_refreshing(disp);
+    for (size_t k = 1; k < KERNEL_SETS; k++) {
+        if (!lv_draw_sw_blend_set_kernels(kernel_sets[k].kernels)) {
+            printf("  %-6s not available\n", kernel_sets[k].name);
+            continue;
+        }
+        int random_errors = check_random(kernel_sets[k].kernels);
+        int sweep_errors = check_sweep(kernel_sets[k].kernels);
+        printf("  %-6s %d random cases, %d differ; opa x mask sweep, %d differ\n", kernel_sets[k].name, RANDOM_CASES,
+               random_errors, sweep_errors);
+        if (random_errors || sweep_errors) {
+            ret = 1;
+        }
+    }
+
+    seed = 3;
+    for (int p = 0; p < HOR_RES * BAND_H; p++) {
+        band_init[p] = lv_color_hsv_to_rgb((uint16_t)(p % HOR_RES), 50, 40 + p / HOR_RES);
+        src_px[p] = lv_color_hsv_to_rgb((uint16_t)(200 + p % 31), 60, 90 - p / HOR_RES);
+    }
+    make_sprite_mask(mask_px);
+    printf("  Mpx/s on a %dx%d band   %9s %9s %9s %9s\n", HOR_RES, BAND_H, op_names[0], op_names[1], op_names[2],
+           op_names[3]);
+    double base[OP_CNT];
+    for (size_t k = 0; k < KERNEL_SETS; k++) {
+        if (!lv_draw_sw_blend_set_kernels(kernel_sets[k].kernels)) {
+            continue;
+        }
+        printf("  %-24s", kernel_sets[k].name);
+        for (op_t op = 0; op < OP_CNT; op++) {
+            double rate = throughput(op, op == OP_FILL_OPA || op == OP_MAP_OPA ? LV_OPA_60 : LV_OPA_COVER);
+            if (k == 0) {
+                base[op] = rate;
+                printf(" %9.1f", rate);
+            } else {
+                printf(" %6.1f %3.1fx", rate, rate / base[op]);
+            }
+        }
+        printf("\n");
+    }
+    _lv_refr_set_disp_refreshing(NULL);
+
+    make_scene();
+    double scalar_ms = 0;
+    for (size_t k = 0; k < KERNEL_SETS; k++) {
+        if (!lv_draw_sw_blend_set_kernels(kernel_sets[k].kernels)) {
+            continue;
+        }
+        double ms = render(k == 0 ? reference : hashes);
+        int mismatch = 0;
+        for (int f = 0; k > 0 && f < FRAMES; f++) {
+            mismatch += reference[f] != hashes[f];
+        }
+        if (k == 0) {
+            scalar_ms = ms;
+            printf("  sprites over the pet    %-6s %6.3f ms/frame\n", kernel_sets[k].name, ms);
+        } else {
+            printf("  sprites over the pet    %-6s %6.3f ms/frame (%5.1f %%)%s\n", kernel_sets[k].name, ms,
+                   100.0 * ms / scalar_ms, mismatch ? "  MISMATCH" : "");
+        }
+        if (mismatch) {
+            printf("  %d of %d frames differ\n", mismatch, FRAMES);
+            ret = 1;
+        }
+    }
+    lv_draw_sw_blend_set_kernels(selected);
+    return ret;
+}
@@ -0,0 +1,294 @@
+/**
+ * @file grad_bench.c
+ * Redraws the pet's home screen with gradient backgrounds on a headless
+ * 172x320 display in every frame, in 40 line bands as the firmware does: a
+ * four stop sky behind the pet, a hill and two cards sharing a horizontal
+ * gradient. The sky's mood changes every 20 frames by rewriting its stops in
+ * place. The color maps are computed for every band (no cache, as with
+ * LV_GRAD_CACHE_DEF_SIZE 0) and kept in the gradient cache of its default
+ * size. The hits, misses, the RAM kept and the render time (host CPU) are
+ * compared and every frame must be identical.
+ *
+ * First many gradients with random stops (unsorted and repeated ones too) are
+ * filled by walking the stops and compared with lv_gradient_calculate() pixel
+ * by pixel, which searches the stops for every pixel, and both are timed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "lvgl.h"
+#include "src/draw/sw/lv_draw_sw_gradient.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#if LV_GRADIENT_MAX_STOPS < 4
+#error "grad_bench needs LV_GRADIENT_MAX_STOPS >= 4"
+#endif
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define FRAMES          60
+#define MOOD_FRAMES     20
+#define CHECK_GRADS     3000
+#define FILL_REPEAT     2000
+
+static uint32_t rnd_state = 0x2545F491;
+
+static lv_grad_dsc_t sky, hill, card;
+
+static uint32_t rnd(void)
+{
+    rnd_state = rnd_state * 1664525u + 1013904223u;
+    return rnd_state >> 8;
+}
+
+static lv_grad_color_t map_color(const lv_grad_t *grad, lv_coord_t i)
+{
+#if _DITHER_GRADIENT
+    return grad->hmap[i];
+#else
+    return grad->map[i];
+#endif
+}
+
+static bool same_color(lv_grad_color_t a, lv_grad_color_t b)
+{
+    return a.full == b.full;
+}
+
+static void random_grad(lv_grad_dsc_t *g)
+{
+    lv_memset_00(g, sizeof(*g));
+    g->dir = LV_GRAD_DIR_VER;
+    g->stops_count = (uint8_t)(2 + rnd() % (LV_GRADIENT_MAX_STOPS - 1));
+    bool sorted = rnd() % 4 != 0;
+    for (uint8_t s = 0; s < g->stops_count; s++) {
+        g->stops[s].color = lv_color_hex(rnd() & 0xFFFFFF);
+        g->stops[s].frac = (uint8_t)rnd();
+        /* Repeated stops give hard edges */
+        if (s > 0 && rnd() % 8 == 0) {
+            g->stops[s].frac = g->stops[s - 1].frac;
+        }
+    }
+    for (uint8_t s = 1; sorted && s < g->stops_count; s++) {
+        for (uint8_t t = s; t > 0 && g->stops[t - 1].frac > g->stops[t].frac; t--) {
+            lv_gradient_stop_t tmp = g->stops[t];
+            g->stops[t] = g->stops[t - 1];
+            g->stops[t - 1] = tmp;
+        }
+    }
+}
+
+/* The maps filled by walking the stops must match the stop search of every pixel. Returns the number which didn't */
+static int check_maps(void)
+{
+    int bad = 0;
+    lv_gradient_set_cache_size(0);
+    for (int n = 0; n < CHECK_GRADS; n++) {
+        lv_grad_dsc_t g;
+        random_grad(&g);
+        lv_coord_t size = (lv_coord_t)(1 + rnd() % VER_RES);
+        lv_grad_t *grad = lv_gradient_get(&g, 10, size);
+        if (grad == NULL) {
+            printf("  no memory for a map of %d\n", size);
+            return bad + 1;
+        }
+        for (lv_coord_t i = 0; i < size; i++) {
+            if (!same_color(map_color(grad, i), lv_gradient_calculate(&g, size, i))) {
+                printf("  %d stops, size %d: pixel %d differs\n", g.stops_count, size, i);
+                bad++;
+                break;
+            }
+        }
+        lv_gradient_cleanup(grad);
+    }
+    return bad;
+}
+
+/* Fill the sky's map of the full screen height with both methods [ns per map] */
+static void time_fill(double *search_ns, double *walk_ns)
+{
+    static lv_grad_color_t map[VER_RES];
+    uint32_t sum = 0;
+
+    int64_t t0 = sim_clock_ns();
+    for (int n = 0; n < FILL_REPEAT; n++) {
+        for (lv_coord_t i = 0; i < VER_RES; i++) {
+            map[i] = lv_gradient_calculate(&sky, VER_RES, i);
+        }
+        sum += map[n % VER_RES].full;
+    }
+    int64_t t1 = sim_clock_ns();
+    for (int n = 0; n < FILL_REPEAT; n++) {
+        lv_grad_t *grad = lv_gradient_get(&sky, HOR_RES, VER_RES);
+        sum += map_color(grad, n % VER_RES).full;
+        lv_gradient_cleanup(grad);
+    }
+    int64_t t2 = sim_clock_ns();
+
+    *search_ns = (double)(t1 - t0) / FILL_REPEAT;
+    *walk_ns = (double)(t2 - t1) / FILL_REPEAT;
+    if (sum == 0x5EED) {
+        printf("\n");
+    }
+}
+
+static void set_stops(lv_grad_dsc_t *g, lv_grad_dir_t dir, const uint32_t *colors, const uint8_t *fracs, uint8_t cnt)
+{
+    g->dir = dir;
+    g->stops_count = cnt;
+    for (uint8_t s = 0; s < cnt; s++) {
+        g->stops[s].color = lv_color_hex(colors[s]);
+        g->stops[s].frac = fracs[s];
+    }
+}
+
+static void set_mood(bool dusk)
+{
+    static const uint32_t day[] = { 0x4A90E2, 0x7EC8F0, 0xCDEBFA, 0xF4FAFF };
+    static const uint32_t evening[] = { 0x2B2D6E, 0x8A4F9E, 0xF08A5D, 0xFFD59A };
+    static const uint8_t fracs[] = { 0, 90, 190, 255 };
+    set_stops(&sky, LV_GRAD_DIR_VER, dusk ? evening : day, fracs, 4);
+}
+
+static lv_obj_t *add_rect(lv_obj_t *parent, int x, int y, int w, int h, int radius, const lv_grad_dsc_t *grad)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, w, h);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_radius(obj, radius, 0);
+    if (grad) {
+        lv_obj_set_style_bg_grad(obj, grad, 0);
+    } else {
+        lv_obj_set_style_bg_color(obj, lv_color_hex(0xF8C8A0), 0);
+    }
+    return obj;
+}
+
+static lv_obj_t *create_scene(lv_obj_t *scr)
+{
+    static const uint32_t hill_colors[] = { 0x8CCB6A, 0x5FA847, 0x3E7D34 };
+    static const uint8_t hill_fracs[] = { 0, 100, 255 };
+    static const uint32_t card_colors[] = { 0xFFFFFF, 0xFFF1D6 };
+    static const uint8_t card_fracs[] = { 0, 255 };
+    set_mood(false);
+    set_stops(&hill, LV_GRAD_DIR_VER, hill_colors, hill_fracs, 3);
+    set_stops(&card, LV_GRAD_DIR_HOR, card_colors, card_fracs, 2);
+
+    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_grad(scr, &sky, 0);
+    add_rect(scr, -20, 236, 212, 140, 70, &hill);
+    add_rect(scr, 11, 14, 150, 56, 12, &card);
+    add_rect(scr, 11, 80, 150, 56, 12, &card);
+    return add_rect(scr, 62, 190, 48, 48, 16, NULL);
+}
+
+typedef struct {
+    lv_grad_cache_monitor_t mon;
+    uint32_t used_max;
+    double ms;
+} result_t;
+
+static void run(size_t cache_size, uint32_t *hashes, result_t *res)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_gradient_set_cache_size(cache_size);
+    lv_obj_t *pet = create_scene(lv_scr_act());
+
+    lv_grad_cache_monitor_t mon0;
+    lv_gradient_cache_monitor(&mon0);
+    int64_t t = 0;
+    res->used_max = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        if (f % MOOD_FRAMES == 0) {
+            set_mood(f / MOOD_FRAMES % 2 == 1);
+        }
+        lv_obj_set_x(pet, 62 + (f % 12) * 2);
+        lv_obj_invalidate(lv_scr_act());
+        int64_t t0 = sim_clock_ns();
+        _lv_disp_refr_timer(lv_disp_get_default()->refr_timer);
+        t += sim_clock_ns() - t0;
+        hashes[f] = sim_bench_frame_hash();
+
+        lv_gradient_cache_monitor(&res->mon);
+        if (res->mon.used_size > res->used_max) {
+            res->used_max = res->mon.used_size;
+        }
+    }
+    res->mon.hit_cnt -= mon0.hit_cnt;
+    res->mon.miss_cnt -= mon0.miss_cnt;
+    res->mon.evict_cnt -= mon0.evict_cnt;
+    res->ms = (double)t / FRAMES / 1e6;
+}
+
+static void print_result(const char *name, const result_t *res, const result_t *ref, int mismatch)
+{
+    printf("  %-8s %6u hits %6u filled %5u evictions  %5u / %5u B  %6.3f ms/frame", name,
+           (unsigned)res->mon.hit_cnt, (unsigned)res->mon.miss_cnt, (unsigned)res->mon.evict_cnt,
+           (unsigned)res->used_max, (unsigned)res->mon.total_size, res->ms);
+    if (ref) {
+        printf("  (%5.1f %%)%s", 100.0 * res->ms / ref->ms, mismatch ? "  MISMATCH" : "");
+    }
+    printf("\n");
+}
+
+int main(void)
+{
+    static uint32_t reference[FRAMES], hashes[FRAMES];
+    int ret = 0;
+
+    sim_bench_init();
+
+    int bad = check_maps();
+    printf("gradient maps: %d random gradients of 2..%d stops%s\n", CHECK_GRADS, LV_GRADIENT_MAX_STOPS,
+           bad ? "" : ", the stop walk matches the stop search of every pixel");
+    if (bad) {
+        ret = 1;
+    }
+    set_mood(false);
+    double search_ns, walk_ns;
+    time_fill(&search_ns, &walk_ns);
+    printf("  %d pixel map of 4 stops: %8.0f ns searching the stops, %8.0f ns walking them (%5.1f %%)\n", VER_RES,
+           search_ns, walk_ns, 100.0 * walk_ns / search_ns);
+
+    printf("gradient cache, %dx%d in 40 line bands, 4 gradient backgrounds redrawn in %d frames (host CPU)\n",
+           HOR_RES, VER_RES, FRAMES);
+    static const struct {
+        const char *name;
+        size_t cache_size;
+    } modes[] = {
+        { "no cache", 0 },
+        { "cache", LV_GRAD_CACHE_DEF_SIZE },
+    };
+    result_t res[2];
+    for (int m = 0; m < 2; m++) {
+        run(modes[m].cache_size, m == 0 ? reference : hashes, &res[m]);
+        int mismatch = 0;
+        for (int f = 0; m > 0 && f < FRAMES; f++) {
+            mismatch += reference[f] != hashes[f];
+        }
+        print_result(modes[m].name, &res[m], m > 0 ? &res[0] : NULL, mismatch);
+        if (mismatch) {
+            printf("  %d of %d frames differ\n", mismatch, FRAMES);
+            ret = 1;
+        }
+        if (res[m].used_max > res[m].mon.total_size) {
+            printf("  the cache outgrew its memory size\n");
+            ret = 1;
+        }
+    }
+    lv_gradient_set_cache_size(LV_GRAD_CACHE_DEF_SIZE);
+
+    if (res[0].mon.hit_cnt) {
+        printf("  maps were reused without a cache\n");
+        ret = 1;
+    }
+    /* Two skies, the hill and the cards: each is filled once, the bands and frames after reuse it */
+    if (res[1].mon.miss_cnt > 4) {
+        printf("  the maps didn't stay in the cache\n");
+        ret = 1;
+    }
+    return ret;
+}
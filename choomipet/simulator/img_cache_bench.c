@@ -0,0 +1,241 @@
+/**
+ * @file img_cache_bench.c
+ * Redraws a screen on a headless 172x320 display in every frame: a pet sprite
+ * animated with run-length compressed frames (decoded to RAM by a decoder of
+ * this bench) among icons in the built-in format. The image cache is given no
+ * memory (every image is opened and closed in every draw, as with
+ * LV_IMG_CACHE_DEF_SIZE 0), room for two frames and its default memory size,
+ * and the decodes, hits, misses, evictions, the RAM kept and the render time
+ * (host CPU) are compared. Every frame must be identical and the cache must
+ * stay within its memory size.
+ */
+
+#include <stdio.h>
+#include "lvgl.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define FRAMES          120
+#define SPRITE_FRAMES   4
+#define SPRITE_SIZE     40
+#define ICONS           6
+#define ICON_SIZE       16
+#define DECODE_MS       5       // Told to the cache: a decode on the device
+
+/* A run is a 1 byte length and a 2 byte color */
+static uint8_t rle_data[SPRITE_FRAMES][SPRITE_SIZE * SPRITE_SIZE * 3];
+static lv_img_dsc_t sprite_frames[SPRITE_FRAMES];
+static lv_color_t icon_data[ICONS][ICON_SIZE * ICON_SIZE];
+static lv_img_dsc_t icons[ICONS];
+static lv_obj_t *sprite;
+static uint32_t decode_cnt;
+
+static bool is_rle(const void *src)
+{
+    return lv_img_src_get_type(src) == LV_IMG_SRC_VARIABLE &&
+           ((const lv_img_dsc_t *)src)->header.cf == LV_IMG_CF_USER_ENCODED_0;
+}
+
+static lv_res_t rle_info(lv_img_decoder_t *decoder, const void *src, lv_img_header_t *header)
+{
+    (void)decoder;
+    if (!is_rle(src)) {
+        return LV_RES_INV;
+    }
+    *header = ((const lv_img_dsc_t *)src)->header;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    return LV_RES_OK;
+}
+
+static lv_res_t rle_open(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc)
+{
+    (void)decoder;
+    if (!is_rle(dsc->src)) {
+        return LV_RES_INV;
+    }
+    const lv_img_dsc_t *img = dsc->src;
+    lv_color_t *px = lv_mem_alloc(img->header.w * img->header.h * sizeof(lv_color_t));
+    if (px == NULL) {
+        return LV_RES_INV;
+    }
+    lv_color_t *p = px;
+    for (uint32_t i = 0; i < img->data_size; i += 3) {
+        lv_color_t c;
+        c.full = (uint16_t)(img->data[i + 1] | img->data[i + 2] << 8);
+        for (int n = 0; n < img->data[i]; n++) {
+            *p++ = c;
+        }
+    }
+    dsc->img_data = (const uint8_t *)px;
+    dsc->time_to_open = DECODE_MS;
+    decode_cnt++;
+    return LV_RES_OK;
+}
+
+static void rle_close(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc)
+{
+    (void)decoder;
+    lv_mem_free((void *)dsc->img_data);
+}
+
+/* Run-length encodes a disc moving and changing its color from frame to frame */
+static void make_images(void)
+{
+    for (int f = 0; f < SPRITE_FRAMES; f++) {
+        uint8_t *d = rle_data[f];
+        lv_color_t bg = lv_color_hex(0xFFF0D0);
+        lv_color_t fg = lv_color_hsv_to_rgb((uint16_t)(f * 90), 70, 90);
+        int cx = 14 + f * 4, cy = 20, r = 12;
+        for (int y = 0; y < SPRITE_SIZE; y++) {
+            int x = 0;
+            while (x < SPRITE_SIZE) {
+                bool in = (x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r;
+                int n = 0;
+                while (x < SPRITE_SIZE && ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r) == in) {
+                    x++;
+                    n++;
+                }
+                lv_color_t c = in ? fg : bg;
+                *d++ = (uint8_t)n;
+                *d++ = (uint8_t)c.full;
+                *d++ = (uint8_t)(c.full >> 8);
+            }
+        }
+        sprite_frames[f].header.cf = LV_IMG_CF_USER_ENCODED_0;
+        sprite_frames[f].header.w = SPRITE_SIZE;
+        sprite_frames[f].header.h = SPRITE_SIZE;
+        sprite_frames[f].data_size = (uint32_t)(d - rle_data[f]);
+        sprite_frames[f].data = rle_data[f];
+    }
+
+    for (int i = 0; i < ICONS; i++) {
+        for (int p = 0; p < ICON_SIZE * ICON_SIZE; p++) {
+            icon_data[i][p] = lv_color_hsv_to_rgb((uint16_t)(i * 60 + p % ICON_SIZE * 4), 60, 40 + p / ICON_SIZE * 3);
+        }
+        icons[i].header.cf = LV_IMG_CF_TRUE_COLOR;
+        icons[i].header.w = ICON_SIZE;
+        icons[i].header.h = ICON_SIZE;
+        icons[i].data_size = sizeof(icon_data[i]);
+        icons[i].data = (const uint8_t *)icon_data[i];
+    }
+}
+
+/* The pet in the middle, the icons of its needs around it */
+static void create_scene(lv_obj_t *scr)
+{
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x80C0F0), 0);
+    sprite = lv_img_create(scr);
+    lv_img_set_src(sprite, &sprite_frames[0]);
+    lv_obj_set_pos(sprite, (HOR_RES - SPRITE_SIZE) / 2, 120);
+    for (int i = 0; i < ICONS; i++) {
+        lv_obj_t *icon = lv_img_create(scr);
+        lv_img_set_src(icon, &icons[i]);
+        lv_obj_set_pos(icon, 10 + i % 3 * 60, i < 3 ? 40 : 240);
+    }
+}
+
+typedef struct {
+    lv_img_cache_monitor_t mon;
+    uint32_t decodes;
+    uint32_t used_max;
+    double ms;
+} result_t;
+
+static void run(uint32_t mem_size, uint32_t *hashes, result_t *res)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_set_mem_size(mem_size);
+    create_scene(lv_scr_act());
+
+    lv_img_cache_monitor_t mon0;
+    lv_img_cache_monitor(&mon0);
+    uint32_t decodes0 = decode_cnt;
+    int64_t t = 0;
+    res->used_max = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        lv_img_set_src(sprite, &sprite_frames[f % SPRITE_FRAMES]);
+        lv_obj_invalidate(lv_scr_act());
+        int64_t t0 = sim_clock_ns();
+        _lv_disp_refr_timer(lv_disp_get_default()->refr_timer);
+        t += sim_clock_ns() - t0;
+        hashes[f] = sim_bench_frame_hash();
+
+        lv_img_cache_monitor(&res->mon);
+        if (res->mon.used_size > res->used_max) {
+            res->used_max = res->mon.used_size;
+        }
+    }
+    res->mon.hit_cnt -= mon0.hit_cnt;
+    res->mon.miss_cnt -= mon0.miss_cnt;
+    res->mon.evict_cnt -= mon0.evict_cnt;
+    res->decodes = decode_cnt - decodes0;
+    res->ms = (double)t / FRAMES / 1e6;
+}
+
+static void print_result(const char *name, const result_t *res, const result_t *ref, int mismatch)
+{
+    printf("  %-14s %5.2f decodes/frame  %5u hits %5u misses %5u evictions  %6u / %6u B  %6.3f ms/frame",
+           name, (double)res->decodes / FRAMES, (unsigned)res->mon.hit_cnt, (unsigned)res->mon.miss_cnt,
+           (unsigned)res->mon.evict_cnt, (unsigned)res->used_max, (unsigned)res->mon.total_size, res->ms);
+    if (ref) {
+        printf("  (%5.1f %%)%s", 100.0 * res->ms / ref->ms, mismatch ? "  MISMATCH" : "");
+    }
+    printf("\n");
+}
+
+int main(void)
+{
+    static uint32_t reference[FRAMES], hashes[FRAMES];
+    int ret = 0;
+
+    sim_bench_init();
+
+    lv_img_decoder_t *dec = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(dec, rle_info);
+    lv_img_decoder_set_open_cb(dec, rle_open);
+    lv_img_decoder_set_close_cb(dec, rle_close);
+    make_images();
+
+    const uint32_t frame_bytes = SPRITE_SIZE * SPRITE_SIZE * sizeof(lv_color_t);
+    printf("image cache, %dx%d, a %d frame compressed %dx%d sprite and %d icons redrawn in %d frames (host CPU)\n",
+           HOR_RES, VER_RES, SPRITE_FRAMES, SPRITE_SIZE, SPRITE_SIZE, ICONS, FRAMES);
+    static const struct {
+        const char *name;
+        uint32_t mem_size;
+    } modes[] = {
+        { "no cache", 1 },
+        { "two frames", 2 * SPRITE_SIZE * SPRITE_SIZE * sizeof(lv_color_t) + 2048 },
+        { "default size", LV_IMG_CACHE_DEF_MEM_SIZE },
+    };
+    result_t res[3];
+    for (int m = 0; m < 3; m++) {
+        run(modes[m].mem_size, m == 0 ? reference : hashes, &res[m]);
+        int mismatch = 0;
+        for (int f = 0; m > 0 && f < FRAMES; f++) {
+            mismatch += reference[f] != hashes[f];
+        }
+        print_result(modes[m].name, &res[m], m > 0 ? &res[0] : NULL, mismatch);
+        if (mismatch) {
+            printf("  %d of %d frames differ\n", mismatch, FRAMES);
+            ret = 1;
+        }
+        if (res[m].used_max > res[m].mon.total_size) {
+            printf("  the cache outgrew its memory size\n");
+            ret = 1;
+        }
+    }
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_DEF_MEM_SIZE);
+
+    // Every frame fits into the default size: only the first ones are decoded
+    if (LV_IMG_CACHE_DEF_MEM_SIZE >= SPRITE_FRAMES * (frame_bytes + 128) && res[2].decodes != SPRITE_FRAMES) {
+        printf("  the frames didn't stay in the cache\n");
+        ret = 1;
+    }
+    if (res[0].decodes < FRAMES) {
+        printf("  the frames were cached without memory\n");
+        ret = 1;
+    }
+    return ret;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file inv_tiles_bench.c
+ * Redraws many small blinking dots on a headless 172x320 display and compares
+ * the pixels LVGL renders and flushes per frame with the invalidated area list
+ * (full screen once more than LV_INV_BUF_SIZE areas are dirty) against 8x8
+ * and 16x16 dirty tiles. Every frame checks that each changed dot was flushed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "lvgl.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define FRAMES          50
+#define DOT_SIZE        4
+#define DOTS_MAX        96
+
+static uint8_t flushed[VER_RES][HOR_RES];
+static uint64_t flushed_px;
+static uint32_t flush_calls;
+
+static void bench_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    (void)color_p;
+    for (lv_coord_t y = area->y1; y <= area->y2; y++) {
+        memset(&flushed[y][area->x1], 1, lv_area_get_width(area));
+    }
+    flushed_px += lv_area_get_size(area);
+    flush_calls++;
+    lv_disp_flush_ready(drv);
+}
+
+typedef struct {
+    const char *name;
+    int dots;
+    lv_coord_t x1, y1, w, h;    // where the dots are placed
+} workload_t;
+
+static const workload_t workloads[] = {
+    { "scattered", 16, 0, 0, HOR_RES, VER_RES },
+    { "scattered", 32, 0, 0, HOR_RES, VER_RES },
+    { "scattered", 64, 0, 0, HOR_RES, VER_RES },
+    { "scattered", 96, 0, 0, HOR_RES, VER_RES },
+    { "clustered", 80, 54, 100, 64, 64 },     // sparkles around the pet
+    { "two rows", 80, 0, 150, HOR_RES, 24 },   // e.g. a typing indicator and a progress bar
+};
+
+static lv_obj_t *dots[DOTS_MAX];
+
+/* Returns the number of frames in which a changed dot was not completely flushed */
+static int run(const workload_t *w, uint8_t tile_size, uint64_t *px, uint32_t *calls, double *ms)
+{
+    static uint8_t dirty[VER_RES][HOR_RES];
+    uint32_t seed = 12345;
+    int errors = 0;
+
+    lv_obj_clean(lv_scr_act());
+    for (int i = 0; i < w->dots; i++) {
+        seed = seed * 1103515245u + 12345u;
+        lv_coord_t x = w->x1 + (lv_coord_t)((seed >> 8) % (uint32_t)(w->w - DOT_SIZE));
+        seed = seed * 1103515245u + 12345u;
+        lv_coord_t y = w->y1 + (lv_coord_t)((seed >> 8) % (uint32_t)(w->h - DOT_SIZE));
+        dots[i] = lv_obj_create(lv_scr_act());
+        lv_obj_remove_style_all(dots[i]);
+        lv_obj_set_style_bg_opa(dots[i], LV_OPA_COVER, 0);
+        lv_obj_set_style_bg_color(dots[i], lv_color_black(), 0);
+        lv_obj_set_pos(dots[i], x, y);
+        lv_obj_set_size(dots[i], DOT_SIZE, DOT_SIZE);
+    }
+    sim_bench_disp_drv.inv_tile_size = tile_size;
+    lv_refr_now(NULL);
+
+    *px = 0;
+    *calls = 0;
+    int64_t t = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        memset(dirty, 0, sizeof(dirty));
+        memset(flushed, 0, sizeof(flushed));
+        flushed_px = 0;
+        flush_calls = 0;
+        // Every dot blinks, in a different frame for each half so neighbours differ
+        for (int i = 0; i < w->dots; i++) {
+            if ((i + f) % 2 == 0) {
+                continue;
+            }
+            lv_obj_set_style_bg_color(dots[i], (f / 2) % 2 ? lv_color_white() : lv_color_black(), 0);
+            const lv_area_t *a = &dots[i]->coords;
+            for (lv_coord_t y = a->y1; y <= a->y2; y++) {
+                memset(&dirty[y][a->x1], 1, lv_area_get_width(a));
+            }
+        }
+        int64_t t0 = sim_clock_ns();
+        lv_refr_now(NULL);
+        t += sim_clock_ns() - t0;
+
+        for (int y = 0; y < VER_RES; y++) {
+            for (int x = 0; x < HOR_RES; x++) {
+                if (dirty[y][x] && !flushed[y][x]) {
+                    errors++;
+                    y = VER_RES;
+                    break;
+                }
+            }
+        }
+        *px += flushed_px;
+        *calls += flush_calls;
+    }
+    *ms = (double)t / FRAMES / 1e6;
+    return errors;
+}
+
+int main(void)
+{
+    static const uint8_t tile_sizes[] = { 0, 8, 16 };
+    int ret = 0;
+
+    sim_bench_init();
+    sim_bench_disp_drv.flush_cb = bench_flush_cb;
+
+    printf("dirty area tracking, %dx%d, %dx%d px dots, half of them change per frame, %d frames (host CPU)\n",
+           HOR_RES, VER_RES, DOT_SIZE, DOT_SIZE, FRAMES);
+    for (size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++) {
+        const workload_t *w = &workloads[i];
+        uint64_t list_px = 0;
+        for (size_t t = 0; t < sizeof(tile_sizes) / sizeof(tile_sizes[0]); t++) {
+            uint64_t px;
+            uint32_t calls;
+            double ms;
+            int errors = run(w, tile_sizes[t], &px, &calls, &ms);
+            char mode[16];
+            if (tile_sizes[t]) {
+                snprintf(mode, sizeof(mode), "%ux%u tiles", tile_sizes[t], tile_sizes[t]);
+            } else {
+                snprintf(mode, sizeof(mode), "area list");
+                list_px = px;
+            }
+            printf("  %-9s x%-3d %-11s %7.0f px/frame (%5.1f %% of the screen, %5.1f %% of the list)  %5.1f flushes/frame  %6.3f ms/frame%s\n",
+                   w->name, w->dots, mode, (double)px / FRAMES, 100.0 * px / FRAMES / (HOR_RES * VER_RES),
+                   list_px ? 100.0 * px / list_px : 0.0, (double)calls / FRAMES, ms, errors ? "  NOT REDRAWN" : "");
+            ret |= errors != 0;
+            // Beyond LV_INV_BUF_SIZE dirty dots the list redraws the screen, the tiles must do better
+            if (tile_sizes[t] && w->dots / 2 > LV_INV_BUF_SIZE && px >= list_px) {
+                printf("  tiles do not redraw less than the list\n");
+                ret = 1;
+            }
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file layout_bench.c
+ * Appends chat bubbles to a scrolled flex column and icons to a grid on a
+ * headless 172x320 display and updates the layout after every message, once
+ * normally (only the new children are placed and only the changed subtrees
+ * are visited) and once with the whole column and grid marked dirty, as every
+ * message did before. Reports the style scans (get_prop_core() calls) and the
+ * time of a layout update (host CPU) and checks that every child lands on the
+ * same coordinates in both runs.
+ */
+
+#include <stdio.h>
+#include "lvgl.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define MSGS            24
+#define ICONS_PER_MSG   3       // An icon to the grid after every 3rd message
+#define GRID_COLS       4
+#define GRID_ROWS       5
+#define REPEAT          3
+
+static lv_obj_t *chat;
+static lv_obj_t *grid;
+static lv_style_t bubble_style;
+static lv_style_t reply_style;
+static lv_style_t text_style;
+static lv_style_t icon_style;
+
+static const lv_coord_t col_dsc[] = { LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1),
+                                      LV_GRID_TEMPLATE_LAST };
+static const lv_coord_t row_dsc[] = { 18, 18, 18, 18, 18, LV_GRID_TEMPLATE_LAST };
+
+static void bench_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    (void)area;
+    (void)color_p;
+    lv_disp_flush_ready(drv);
+}
+
+static uint32_t hash_coords(uint32_t h, const lv_obj_t *obj)
+{
+    const lv_coord_t c[4] = { obj->coords.x1, obj->coords.y1, obj->coords.x2, obj->coords.y2 };
+    const uint8_t *p = (const uint8_t *)c;
+    for (size_t i = 0; i < sizeof(c); i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    for (uint32_t i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+        h = hash_coords(h, lv_obj_get_child(obj, i));
+    }
+    return h;
+}
+
+/* A status line, the pet with a few parts, the item grid and the chat below */
+static void create_scene(lv_obj_t *scr)
+{
+    lv_obj_t *status = lv_obj_create(scr);
+    lv_obj_set_size(status, HOR_RES, 24);
+    lv_obj_set_flex_flow(status, LV_FLEX_FLOW_ROW);
+    lv_label_set_text(lv_label_create(status), "Jiumi");
+    lv_label_set_text(lv_label_create(status), "12:00");
+
+    lv_obj_t *pet = lv_obj_create(scr);
+    lv_obj_set_pos(pet, 0, 24);
+    lv_obj_set_size(pet, 60, 110);
+    for (int i = 0; i < 6; i++) {
+        lv_obj_t *part = lv_obj_create(pet);
+        lv_obj_set_size(part, 10, 10);
+        lv_obj_set_pos(part, i * 6, i * 12);
+    }
+
+    grid = lv_obj_create(scr);
+    lv_obj_set_pos(grid, 60, 24);
+    lv_obj_set_size(grid, HOR_RES - 60, 110);
+    lv_obj_set_style_pad_all(grid, 2, 0);
+    lv_obj_set_style_pad_gap(grid, 2, 0);
+    lv_obj_set_grid_dsc_array(grid, col_dsc, row_dsc);
+
+    // No theme: its transitions on scrolling would pile up without timers
+    chat = lv_obj_create(scr);
+    lv_obj_remove_style_all(chat);
+    lv_obj_set_style_pad_all(chat, 4, 0);
+    lv_obj_set_pos(chat, 0, 134);
+    lv_obj_set_size(chat, HOR_RES, VER_RES - 134);
+    lv_obj_set_flex_flow(chat, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_style_pad_row(chat, 6, 0);
+}
+
+static void add_message(int m)
+{
+    static const char *const texts[] = {
+        "Feed me!", "Here you are.", "Yummy, thanks! Can we play now?", "Later, I am busy.",
+        "I will wait here and count the clouds.",
+    };
+    lv_obj_t *bubble = lv_obj_create(chat);
+    lv_obj_add_style(bubble, m % 2 ? &reply_style : &bubble_style, 0);
+    lv_obj_t *label = lv_label_create(bubble);
+    lv_obj_add_style(label, &text_style, 0);
+    lv_label_set_text_static(label, texts[m % 5]);
+
+    if (m % ICONS_PER_MSG == 0) {
+        int i = m / ICONS_PER_MSG;
+        lv_obj_t *icon = lv_obj_create(grid);
+        lv_obj_add_style(icon, &icon_style, 0);
+        lv_obj_set_grid_cell(icon, LV_GRID_ALIGN_STRETCH, i % GRID_COLS, 1, LV_GRID_ALIGN_CENTER,
+                             i / GRID_COLS % GRID_ROWS, 1);
+    }
+}
+
+static void run(bool full, uint32_t *hashes, uint32_t *scans, double *us)
+{
+    lv_obj_clean(lv_scr_act());
+    create_scene(lv_scr_act());
+    lv_obj_update_layout(lv_scr_act());
+
+    int64_t t = 0;
+    for (int m = 0; m < MSGS; m++) {
+        add_message(m);
+        if (full) {
+            lv_obj_mark_layout_as_dirty(chat);
+            lv_obj_mark_layout_as_dirty(grid);
+        }
+        uint32_t scans0 = _lv_obj_style_get_scan_cnt();
+        int64_t t0 = sim_clock_ns();
+        lv_obj_update_layout(lv_scr_act());
+        t += sim_clock_ns() - t0;
+        scans[m] = _lv_obj_style_get_scan_cnt() - scans0;
+
+        hashes[m] = hash_coords(2166136261u, lv_scr_act());
+        // Follow the chat like a chat app
+        lv_obj_scroll_to_y(chat, LV_COORD_MAX, LV_ANIM_OFF);
+        // Drop the invalidated areas, nothing is drawn
+        lv_disp_get_default()->inv_p = 0;
+    }
+    // The fastest of the repeated runs
+    if (*us == 0 || (double)t / MSGS / 1e3 < *us) {
+        *us = (double)t / MSGS / 1e3;
+    }
+}
+
+static double average(const uint32_t *v)
+{
+    uint32_t sum = 0;
+    for (int m = 0; m < MSGS; m++) {
+        sum += v[m];
+    }
+    return (double)sum / MSGS;
+}
+
+int main(void)
+{
+    static uint32_t reference[MSGS], hashes[MSGS];
+    static uint32_t scans_full[MSGS], scans_inc[MSGS];
+    int ret = 0;
+
+    sim_bench_init();
+    sim_bench_disp_drv.flush_cb = bench_flush_cb;
+
+    // The pet's bubbles on the left, the replies shifted to the right
+    lv_style_init(&bubble_style);
+    lv_style_set_width(&bubble_style, 130);
+    lv_style_set_height(&bubble_style, LV_SIZE_CONTENT);
+    lv_style_set_pad_all(&bubble_style, 4);
+    lv_style_set_bg_color(&bubble_style, lv_color_hex(0xFFE0C0));
+    lv_style_init(&reply_style);
+    lv_style_set_width(&reply_style, 130);
+    lv_style_set_height(&reply_style, LV_SIZE_CONTENT);
+    lv_style_set_pad_all(&reply_style, 4);
+    lv_style_set_bg_color(&reply_style, lv_color_hex(0xC0E0FF));
+    lv_style_set_translate_x(&reply_style, 10);
+    lv_style_init(&text_style);
+    lv_style_set_width(&text_style, LV_PCT(100));
+    lv_style_init(&icon_style);
+    lv_style_set_height(&icon_style, 14);
+
+    printf("layout updates, %d chat bubbles appended to a flex column, an icon to a grid per %d (host CPU)\n",
+           MSGS, ICONS_PER_MSG);
+    double us_full = 0, us_inc = 0;
+    int mismatch = 0;
+    for (int r = 0; r < REPEAT; r++) {
+        run(true, reference, scans_full, &us_full);
+        run(false, hashes, scans_inc, &us_inc);
+        for (int m = 0; m < MSGS; m++) {
+            mismatch += reference[m] != hashes[m];
+        }
+    }
+    printf("  whole column and grid  %5.0f scans/message (%4u..%4u)  %7.2f us/message\n", average(scans_full),
+           (unsigned)scans_full[0], (unsigned)scans_full[MSGS - 1], us_full);
+    printf("  changed children only  %5.0f scans/message (%4u..%4u)  %7.2f us/message  (%5.1f %%)%s\n",
+           average(scans_inc), (unsigned)scans_inc[0], (unsigned)scans_inc[MSGS - 1], us_inc,
+           100.0 * us_inc / us_full, mismatch ? "  MISMATCH" : "");
+    if (mismatch) {
+        printf("  %d of %d layouts differ\n", mismatch, MSGS * REPEAT);
+        ret = 1;
+    }
+    if (average(scans_inc) >= average(scans_full)) {
+        printf("  nothing was saved\n");
+        ret = 1;
+    }
+    return ret;
+}
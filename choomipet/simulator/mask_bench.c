@@ -0,0 +1,244 @@
+/**
+ * @file mask_bench.c
+ * Renders a screen of the pet UI with rounded corners everywhere (cards with
+ * borders, speech bubbles, a rounded container clipping its content, a progress
+ * arc) on a headless 172x320 display, with the masked lines blended
+ *  - byte by byte from the mask buffer, as before the mask spans,
+ *  - span by span from lv_draw_mask_apply_runs(): transparent spans skipped,
+ *    covered ones filled without the mask.
+ * Reports how the masked pixels split between the kinds of spans and the render
+ * time (host CPU, best of RUNS). Every frame must be identical in both modes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "src/draw/sw/lv_draw_sw.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define FRAMES          30
+#define RUNS            5
+#define MASK_LINES      20000
+
+static lv_obj_t *bubble;
+static lv_obj_t *arc;
+
+static const struct {
+    lv_draw_sw_blend_kernels_t kernels;
+    const char *name;
+} kernel_sets[] = {
+    { LV_DRAW_SW_BLEND_KERNELS_SCALAR, "scalar" },
+    { LV_DRAW_SW_BLEND_KERNELS_SWAR, "swar" },
+    { LV_DRAW_SW_BLEND_KERNELS_SSE2, "sse2" },
+};
+#define KERNEL_SETS (sizeof(kernel_sets) / sizeof(kernel_sets[0]))
+
+/* Masked pixels per kind of span while counting */
+static uint64_t span_px[3];
+static bool counting;
+
+/* Blend from the mask bytes only, as the drawing code did before the spans */
+static void blend_bytes(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
+{
+    lv_draw_sw_blend_dsc_t d = *dsc;
+    d.mask_runs = NULL;
+    lv_draw_sw_blend_basic(draw_ctx, &d);
+}
+
+/* Count the masked pixels of the blended lines by the kind of their span */
+static void blend_count(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
+{
+    if (counting && dsc->mask_runs && dsc->mask_buf && dsc->mask_res == LV_DRAW_MASK_RES_CHANGED) {
+        lv_area_t a;
+        if (_lv_area_intersect(&a, dsc->blend_area, draw_ctx->clip_area)) {
+            lv_coord_t x = dsc->mask_area->x1;
+            for (uint8_t i = 0; i < dsc->mask_runs->cnt; i++) {
+                lv_coord_t x1 = LV_MAX(x, a.x1);
+                lv_coord_t x2 = LV_MIN(x + dsc->mask_runs->run[i].len - 1, a.x2);
+                x += dsc->mask_runs->run[i].len;
+                if (x1 > x2) {
+                    continue;
+                }
+                switch (dsc->mask_runs->run[i].res) {
+                    case LV_DRAW_MASK_RES_TRANSP: span_px[0] += x2 - x1 + 1; break;
+                    case LV_DRAW_MASK_RES_FULL_COVER: span_px[1] += x2 - x1 + 1; break;
+                    default: span_px[2] += x2 - x1 + 1; break;
+                }
+            }
+        }
+    }
+    lv_draw_sw_blend_basic(draw_ctx, dsc);
+}
+
+static lv_obj_t *card(lv_obj_t *parent, lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, lv_color_t c)
+{
+    lv_obj_t *o = lv_obj_create(parent);
+    lv_obj_remove_style_all(o);
+    lv_obj_set_pos(o, x, y);
+    lv_obj_set_size(o, w, h);
+    lv_obj_set_style_bg_color(o, c, 0);
+    lv_obj_set_style_bg_opa(o, LV_OPA_COVER, 0);
+    lv_obj_set_style_radius(o, 12, 0);
+    lv_obj_set_style_border_width(o, 2, 0);
+    lv_obj_set_style_border_color(o, lv_color_darken(c, LV_OPA_30), 0);
+    return o;
+}
+
+static void make_screen(void)
+{
+    lv_obj_t *scr = lv_scr_act();
+    lv_obj_clean(scr);
+    lv_obj_set_style_bg_color(scr, lv_color_make(0xF6, 0xE7, 0xD2), 0);
+
+    /* The status cards */
+    for (int i = 0; i < 3; i++) {
+        lv_obj_t *c = card(scr, 6 + i * 56, 6, 48, 40, lv_color_hsv_to_rgb((uint16_t)(30 + i * 90), 35, 95));
+        lv_obj_set_style_radius(c, 10, 0);
+    }
+
+    /* The speech bubbles: an opaque one with a border and a translucent one */
+    bubble = card(scr, 10, 56, 150, 56, lv_color_white());
+    lv_obj_set_style_radius(bubble, 24, 0);
+    lv_obj_t *b2 = card(scr, 30, 120, 132, 44, lv_color_make(0x40, 0x80, 0xC0));
+    lv_obj_set_style_radius(b2, LV_RADIUS_CIRCLE, 0);
+    lv_obj_set_style_bg_opa(b2, LV_OPA_70, 0);
+    lv_obj_set_style_border_width(b2, 0, 0);
+
+    /* A rounded container clipping its content: every line of the children is masked */
+    lv_obj_t *box = card(scr, 8, 172, 156, 80, lv_color_make(0xFF, 0xF8, 0xE8));
+    lv_obj_set_style_clip_corner(box, true, 0);
+    lv_obj_set_style_radius(box, 18, 0);
+    for (int i = 0; i < 3; i++) {
+        lv_obj_t *row = lv_obj_create(box);
+        lv_obj_remove_style_all(row);
+        lv_obj_set_pos(row, 0, i * 28);
+        lv_obj_set_size(row, 156, 24);
+        lv_obj_set_style_bg_color(row, lv_color_hsv_to_rgb((uint16_t)(200 + i * 40), 30, 90), 0);
+        lv_obj_set_style_bg_opa(row, LV_OPA_COVER, 0);
+    }
+
+    /* The progress arc of the pet's mood */
+    arc = lv_arc_create(scr);
+    lv_obj_set_size(arc, 60, 60);
+    lv_obj_set_pos(arc, 56, 256);
+    lv_obj_remove_style(arc, NULL, LV_PART_KNOB);
+    lv_arc_set_value(arc, 40);
+}
+
+/* ns per line of a bordered bubble's masks (outer and inner radius) with and without the spans */
+static void mask_lines(double *apply_ns, double *runs_ns)
+{
+    static lv_opa_t line[HOR_RES];
+    lv_draw_mask_runs_t runs;
+    lv_area_t outer = { 10, 56, 159, 111 };
+    lv_area_t inner = { 12, 58, 157, 109 };
+    lv_draw_mask_radius_param_t outer_param, inner_param;
+    lv_draw_mask_radius_init(&outer_param, &outer, 24, false);
+    lv_draw_mask_radius_init(&inner_param, &inner, 22, true);
+    int16_t outer_id = lv_draw_mask_add(&outer_param, NULL);
+    int16_t inner_id = lv_draw_mask_add(&inner_param, NULL);
+
+    int64_t best_apply = INT64_MAX, best_runs = INT64_MAX;
+    volatile uint32_t sink = 0;
+    for (int run = 0; run < RUNS; run++) {
+        int64_t t0 = sim_clock_ns();
+        for (int i = 0; i < MASK_LINES; i++) {
+            memset(line, 0xFF, sizeof(line));
+            sink += lv_draw_mask_apply(line, 0, outer.y1 + i % 56, HOR_RES);
+        }
+        int64_t t1 = sim_clock_ns();
+        for (int i = 0; i < MASK_LINES; i++) {
+            memset(line, 0xFF, sizeof(line));
+            sink += lv_draw_mask_apply_runs(line, 0, outer.y1 + i % 56, HOR_RES, &runs);
+        }
+        int64_t t2 = sim_clock_ns();
+        best_apply = LV_MIN(best_apply, t1 - t0);
+        best_runs = LV_MIN(best_runs, t2 - t1);
+    }
+    (void)sink;
+    lv_draw_mask_remove_id(inner_id);
+    lv_draw_mask_remove_id(outer_id);
+    lv_draw_mask_free_param(&inner_param);
+    lv_draw_mask_free_param(&outer_param);
+    *apply_ns = (double)best_apply / MASK_LINES;
+    *runs_ns = (double)best_runs / MASK_LINES;
+}
+
+static double render(uint32_t *hashes)
+{
+    int64_t best = INT64_MAX;
+    for (int run = 0; run < RUNS; run++) {
+        int64_t t = 0;
+        for (int f = 0; f < FRAMES; f++) {
+            lv_obj_set_x(bubble, 10 + f % 4);
+            lv_arc_set_value(arc, 20 + f * 2);
+            lv_obj_invalidate(lv_scr_act());
+            int64_t t0 = sim_clock_ns();
+            _lv_disp_refr_timer(lv_disp_get_default()->refr_timer);
+            t += sim_clock_ns() - t0;
+            hashes[f] = sim_bench_frame_hash();
+        }
+        if (t < best) {
+            best = t;
+        }
+    }
+    return (double)best / FRAMES / 1e6;
+}
+
+int main(void)
+{
+    static uint32_t reference[FRAMES], hashes[FRAMES];
+    int ret = 0;
+
+    lv_disp_t *disp = sim_bench_init();
+    lv_draw_sw_ctx_t *draw_ctx = (lv_draw_sw_ctx_t *)disp->driver->draw_ctx;
+
+    make_screen();
+
+    draw_ctx->blend = blend_count;
+    counting = true;
+    uint32_t dummy[FRAMES];
+    render(dummy);
+    counting = false;
+    uint64_t total = span_px[0] + span_px[1] + span_px[2];
+    printf("mask spans, pet UI with rounded cards, bubbles, a clipping container and an arc (host CPU)\n");
+    printf("  masked pixels: %.1f %% transparent, %.1f %% covered, %.1f %% anti-aliased\n",
+           100.0 * span_px[0] / total, 100.0 * span_px[1] / total, 100.0 * span_px[2] / total);
+
+    double apply_ns, runs_ns;
+    mask_lines(&apply_ns, &runs_ns);
+    printf("  bubble masks per %d px line: %.0f ns applied, %.0f ns with the spans\n", HOR_RES, apply_ns, runs_ns);
+
+    lv_draw_sw_blend_kernels_t selected = lv_draw_sw_blend_get_kernels();
+    for (size_t k = 0; k < KERNEL_SETS; k++) {
+        if (!lv_draw_sw_blend_set_kernels(kernel_sets[k].kernels)) {
+            continue;
+        }
+        draw_ctx->blend = blend_bytes;
+        double bytes_ms = render(reference);
+        draw_ctx->blend = lv_draw_sw_blend_basic;
+        double runs_ms = render(hashes);
+
+        int mismatch = 0;
+        for (int f = 0; f < FRAMES; f++) {
+            mismatch += reference[f] != hashes[f];
+        }
+        printf("  %-6s kernels: mask bytes %6.3f ms/frame, mask spans %6.3f ms/frame (%5.1f %%)%s\n",
+               kernel_sets[k].name, bytes_ms, runs_ms, 100.0 * runs_ms / bytes_ms, mismatch ? "  MISMATCH" : "");
+        if (mismatch) {
+            printf("  %d of %d frames differ\n", mismatch, FRAMES);
+            ret = 1;
+        }
+    }
+    lv_draw_sw_blend_set_kernels(selected);
+
+    if (total == 0 || span_px[1] == 0) {
+        printf("  no covered spans were blended\n");
+        ret = 1;
+    }
+    return ret;
+}
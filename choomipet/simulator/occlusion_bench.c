@@ -0,0 +1,158 @@
+/**
+ * @file occlusion_bench.c
+ * Redraws stacked screens on a headless 172x320 display with and without
+ * occlusion culling (lv_disp_drv_t::cull_occluded) and compares the objects
+ * drawn and the render time per frame. The frames must be identical.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "lvgl.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define FRAMES          200
+
+static uint32_t draws;
+
+static void count_draw_cb(lv_event_t *e)
+{
+    (void)e;
+    draws++;
+}
+
+/* Counts the draws of obj */
+static lv_obj_t *counted(lv_obj_t *obj)
+{
+    lv_obj_add_event_cb(obj, count_draw_cb, LV_EVENT_DRAW_MAIN_BEGIN, NULL);
+    return obj;
+}
+
+static lv_obj_t *panel(lv_obj_t *parent, lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h,
+                       lv_coord_t radius, uint32_t color)
+{
+    lv_obj_t *obj = counted(lv_obj_create(parent));
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(obj, lv_color_hex(color), 0);
+    lv_obj_set_style_radius(obj, radius, 0);
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, w, h);
+    return obj;
+}
+
+static lv_obj_t *text(lv_obj_t *parent, lv_coord_t x, lv_coord_t y, const char *txt)
+{
+    lv_obj_t *label = counted(lv_label_create(parent));
+    lv_label_set_text(label, txt);
+    lv_obj_set_pos(label, x, y);
+    return label;
+}
+
+/* A face: two round eyes and a mouth on a rounded panel */
+static lv_obj_t *face(lv_obj_t *parent, lv_coord_t x, lv_coord_t y, uint32_t color)
+{
+    lv_obj_t *f = panel(parent, x, y, 110, 70, 16, color);
+    panel(f, 20, 16, 18, 18, LV_RADIUS_CIRCLE, 0x202020);
+    panel(f, 72, 16, 18, 18, LV_RADIUS_CIRCLE, 0x202020);
+    panel(f, 35, 46, 40, 8, 4, 0xC04040);
+    return f;
+}
+
+/* The pet: background, status row, body, one face per emotion stacked with the current one on
+ * top, and a speech bubble over the status row */
+static void scene_pet(lv_obj_t *scr)
+{
+    panel(scr, 0, 0, HOR_RES, VER_RES, 0, 0x80C0F0);
+    for (int i = 0; i < 4; i++) {
+        panel(scr, 8 + i * 40, 12, 32, 32, 6, 0x3060A0 + i * 0x101010);
+    }
+    lv_obj_t *body = panel(scr, 21, 110, 130, 170, 40, 0xF0D0A0);
+    static const uint32_t emotion_colors[] = { 0xF0E0C0, 0xE0F0C0, 0xC0E0F0, 0xF0C0E0, 0xFFE8C8 };
+    for (size_t i = 0; i < sizeof(emotion_colors) / sizeof(emotion_colors[0]); i++) {
+        face(body, 10, 20, emotion_colors[i]);
+    }
+    lv_obj_t *bubble = panel(scr, 4, 6, 164, 84, 12, 0xFFFFFF);
+    text(bubble, 10, 10, "Feed me!\nI am hungry.");
+}
+
+/* Chat history: rounded bubbles stacked like cards, each one mostly hiding the one before */
+static void scene_chat(lv_obj_t *scr)
+{
+    panel(scr, 0, 0, HOR_RES, VER_RES, 0, 0xE8E8E8);
+    for (int i = 0; i < 12; i++) {
+        lv_obj_t *b = panel(scr, 6 + (i % 2) * 10, 8 + i * 22, 150, 64, 10, i % 2 ? 0xFFFFFF : 0xC8F0C8);
+        text(b, 10, 8, i % 2 ? "How are you?" : "Fine, thanks");
+        text(b, 10, 32, "12:00");
+    }
+}
+
+/* Nothing to cull: labels on a plain screen, the cost of the pass alone */
+static void scene_labels(lv_obj_t *scr)
+{
+    for (int i = 0; i < 12; i++) {
+        text(scr, 8, 8 + i * 25, "Choomi Pet Display");
+    }
+}
+
+typedef struct {
+    const char *name;
+    void (*create)(lv_obj_t *scr);
+    bool culls;         // some object must be skipped
+} scene_t;
+
+static const scene_t scenes[] = {
+    { "pet", scene_pet, true },
+    { "chat", scene_chat, true },
+    { "labels", scene_labels, false },
+};
+
+static void run(const scene_t *s, bool cull, uint32_t *obj_draws, double *ms)
+{
+    lv_obj_clean(lv_scr_act());
+    s->create(lv_scr_act());
+    sim_bench_disp_drv.cull_occluded = cull;
+    lv_refr_now(NULL);
+
+    draws = 0;
+    int64_t t = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        lv_obj_invalidate(lv_scr_act());
+        int64_t t0 = sim_clock_ns();
+        lv_refr_now(NULL);
+        t += sim_clock_ns() - t0;
+    }
+    *obj_draws = draws / FRAMES;
+    *ms = (double)t / FRAMES / 1e6;
+}
+
+int main(void)
+{
+    static lv_color_t reference[VER_RES][HOR_RES];
+    int ret = 0;
+
+    sim_bench_init();
+
+    printf("occlusion culling, %dx%d, whole screen redrawn in 40 line parts, %d frames (host CPU)\n",
+           HOR_RES, VER_RES, FRAMES);
+    for (size_t i = 0; i < sizeof(scenes) / sizeof(scenes[0]); i++) {
+        const scene_t *s = &scenes[i];
+        uint32_t draws_off, draws_on;
+        double ms_off, ms_on;
+        run(s, false, &draws_off, &ms_off);
+        memcpy(reference, sim_bench_frame, sizeof(sim_bench_frame));
+        run(s, true, &draws_on, &ms_on);
+        bool same = memcmp(reference, sim_bench_frame, sizeof(sim_bench_frame)) == 0;
+        printf("  %-7s %4u object draws/frame, %4u culling (%5.1f %%)   %6.3f ms/frame, %6.3f ms culling%s\n",
+               s->name, (unsigned)draws_off, (unsigned)draws_on, draws_off ? 100.0 * draws_on / draws_off : 0.0,
+               ms_off, ms_on, same ? "" : "  MISMATCH");
+        ret |= !same;
+        if (s->culls && draws_on >= draws_off) {
+            printf("  nothing was culled\n");
+            ret = 1;
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,296 @@
+/**
+ * @file parallel_render_bench.c
+ * Renders an animated scene with rounded, shadowed, gradient, transparent and
+ * clipped widgets, labels, an arc, a line and a rotated image on a headless
+ * 172x320 display, once on one thread and then in 2..4 horizontal strips per
+ * band on a thread pool (lv_disp_drv_t::render_strips), and compares every
+ * frame pixel by pixel. Also reports the render time (host CPU: the speedup
+ * depends on the cores of the machine). Stops the pool at the end and checks
+ * that the gradient caches of all its threads are freed.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "lvgl.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define FRAMES          60
+#define THREADS_MAX     4
+
+#if !LV_USE_PARALLEL_RENDER
+#error "parallel_render_bench needs LV_USE_PARALLEL_RENDER 1"
+#endif
+
+/**********************
+ *  THREAD POOL
+ **********************/
+
+static pthread_t workers[THREADS_MAX - 1];
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t render_mutex;
+static uint32_t generation;     // incremented for every band
+static uint32_t pending;        // workers still drawing the band
+static uint32_t threads;        // strips are dealt round robin to this many threads
+static bool stopping;           // set to end the workers
+static lv_disp_render_job_t pool_job;
+static void *pool_job_data;
+static uint32_t pool_job_cnt;
+
+/* Worker `arg` draws the strips arg, arg + threads, ... of every band */
+static void *worker_main(void *arg)
+{
+    uint32_t first = (uint32_t)(uintptr_t)arg;
+    uint32_t seen = 0;
+    while (1) {
+        pthread_mutex_lock(&pool_lock);
+        while (generation == seen && !stopping) {
+            pthread_cond_wait(&pool_cond, &pool_lock);
+        }
+        seen = generation;
+        pthread_mutex_unlock(&pool_lock);
+        if (stopping) {
+            break;
+        }
+
+        for (uint32_t i = first; i < pool_job_cnt; i += threads) {
+            pool_job(pool_job_data, i);
+        }
+
+        pthread_mutex_lock(&pool_lock);
+        if (--pending == 0) {
+            pthread_cond_signal(&done_cond);
+        }
+        pthread_mutex_unlock(&pool_lock);
+    }
+    return NULL;
+}
+
+static void bench_render_cb(lv_disp_drv_t *drv, lv_disp_render_job_t job, void *job_data, uint32_t job_cnt)
+{
+    pthread_mutex_lock(&pool_lock);
+    pool_job = job;
+    pool_job_data = job_data;
+    pool_job_cnt = job_cnt;
+    pending = THREADS_MAX - 1;
+    generation++;
+    pthread_cond_broadcast(&pool_cond);
+    pthread_mutex_unlock(&pool_lock);
+
+    for (uint32_t i = 0; i < job_cnt; i += threads) {
+        job(job_data, i);
+    }
+
+    pthread_mutex_lock(&pool_lock);
+    while (pending) {
+        pthread_cond_wait(&done_cond, &pool_lock);
+    }
+    pthread_mutex_unlock(&pool_lock);
+}
+
+static void bench_render_lock_cb(lv_disp_drv_t *drv, bool lock)
+{
+    if (lock) {
+        pthread_mutex_lock(&render_mutex);
+    } else {
+        pthread_mutex_unlock(&render_mutex);
+    }
+}
+
+static void pool_init(void)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&render_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    for (uintptr_t i = 0; i < THREADS_MAX - 1; i++) {
+        pthread_create(&workers[i], NULL, worker_main, (void *)(i + 1));
+    }
+}
+
+/* Ends the workers and frees what LVGL keeps for each of them */
+static void pool_deinit(void)
+{
+    pthread_mutex_lock(&pool_lock);
+    stopping = true;
+    pthread_cond_broadcast(&pool_cond);
+    pthread_mutex_unlock(&pool_lock);
+    for (int i = 0; i < THREADS_MAX - 1; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    lv_gradient_free_cache();
+}
+
+/**********************
+ *  SCENE
+ **********************/
+
+/* A 32x32 two-tone disc rotated and zoomed by lv_img */
+static lv_color_t icon_px[32 * 32];
+static const lv_img_dsc_t icon = {
+    .header.cf = LV_IMG_CF_TRUE_COLOR,
+    .header.w = 32,
+    .header.h = 32,
+    .data_size = sizeof(icon_px),
+    .data = (const uint8_t *)icon_px,
+};
+
+static lv_obj_t *img;
+static lv_obj_t *arc;
+static lv_obj_t *sprite;
+static lv_obj_t *counter;
+
+static lv_obj_t *card(lv_obj_t *parent, lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, w, h);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+    return obj;
+}
+
+static void create_scene(lv_obj_t *scr)
+{
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x3060A0), 0);
+    lv_obj_set_style_bg_grad_color(scr, lv_color_hex(0xF0C080), 0);
+    lv_obj_set_style_bg_grad_dir(scr, LV_GRAD_DIR_VER, 0);
+
+    // Shadowed, bordered card with a horizontal gradient and wrapped text
+    lv_obj_t *bubble = card(scr, 8, 8, 156, 70);
+    lv_obj_set_style_radius(bubble, 14, 0);
+    lv_obj_set_style_shadow_width(bubble, 16, 0);
+    lv_obj_set_style_shadow_ofs_y(bubble, 4, 0);
+    lv_obj_set_style_bg_grad_color(bubble, lv_color_hex(0xFFE0F0), 0);
+    lv_obj_set_style_bg_grad_dir(bubble, LV_GRAD_DIR_HOR, 0);
+    lv_obj_t *label = lv_label_create(bubble);
+    lv_obj_set_width(label, 130);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
+    lv_label_set_text(label, "Parallel strips must draw exactly what one thread draws.");
+
+    // A clipped container: its rounded corners mask the child
+    lv_obj_t *clip = card(scr, 10, 90, 70, 70);
+    lv_obj_set_style_radius(clip, LV_RADIUS_CIRCLE, 0);
+    lv_obj_set_style_clip_corner(clip, true, 0);
+    lv_obj_set_style_pad_all(clip, 0, 0);
+    lv_obj_t *inner = lv_obj_create(clip);
+    lv_obj_remove_style_all(inner);
+    lv_obj_set_size(inner, 70, 35);
+    lv_obj_set_style_bg_opa(inner, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(inner, lv_color_hex(0xE04060), 0);
+
+    arc = lv_arc_create(scr);
+    lv_obj_set_pos(arc, 90, 88);
+    lv_obj_set_size(arc, 74, 74);
+
+    img = lv_img_create(scr);
+    lv_img_set_src(img, &icon);
+    lv_obj_set_pos(img, 30, 180);
+    lv_img_set_antialias(img, true);
+
+    static lv_point_t points[] = { { 0, 0 }, { 40, 30 }, { 80, 5 }, { 120, 40 } };
+    lv_obj_t *line = lv_line_create(scr);
+    lv_line_set_points(line, points, 4);
+    lv_obj_set_pos(line, 30, 230);
+    lv_obj_set_style_line_width(line, 5, 0);
+    lv_obj_set_style_line_rounded(line, true, 0);
+
+    // A semi-transparent button is drawn on a layer
+    lv_obj_t *btn = lv_btn_create(scr);
+    lv_obj_set_pos(btn, 100, 190);
+    lv_obj_set_size(btn, 60, 30);
+    lv_obj_set_style_opa(btn, LV_OPA_60, 0);
+    lv_obj_center(lv_label_create(btn));
+
+    counter = lv_label_create(scr);
+    lv_obj_set_pos(counter, 10, 290);
+
+    sprite = lv_obj_create(scr);
+    lv_obj_remove_style_all(sprite);
+    lv_obj_set_style_bg_opa(sprite, LV_OPA_70, 0);
+    lv_obj_set_style_bg_color(sprite, lv_color_hex(0xFFF060), 0);
+    lv_obj_set_style_radius(sprite, LV_RADIUS_CIRCLE, 0);
+    lv_obj_set_style_border_width(sprite, 2, 0);
+    lv_obj_set_size(sprite, 28, 28);
+}
+
+static void run(uint32_t strips, uint32_t retained_mem, lv_color_t (*frames)[VER_RES][HOR_RES], double *ms)
+{
+    lv_obj_clean(lv_scr_act());
+    threads = strips;
+    sim_bench_disp_drv.render_strips = (uint8_t)strips;
+    sim_bench_disp_drv.retained_mem = retained_mem;
+    create_scene(lv_scr_act());
+    lv_refr_now(NULL);
+
+    int64_t t = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        lv_img_set_angle(img, (int16_t)(f * 60));
+        lv_img_set_zoom(img, (uint16_t)(256 + (f % 20) * 16));
+        lv_arc_set_value(arc, (int16_t)(f * 100 / FRAMES));
+        lv_obj_set_pos(sprite, (f * 5) % (HOR_RES - 28), (f * 11) % (VER_RES - 28));
+        lv_label_set_text_fmt(counter, "Frame %d", f);
+        if (f % 10 == 0) {
+            lv_obj_invalidate(lv_scr_act());
+        }
+        int64_t t0 = sim_clock_ns();
+        lv_refr_now(NULL);
+        t += sim_clock_ns() - t0;
+        memcpy(frames[f], sim_bench_frame, sizeof(sim_bench_frame));
+    }
+    *ms = (double)t / FRAMES / 1e6;
+}
+
+int main(void)
+{
+    static lv_color_t reference[FRAMES][VER_RES][HOR_RES], frames[FRAMES][VER_RES][HOR_RES];
+    static const struct {
+        uint32_t strips;
+        uint32_t retained_mem;
+    } modes[] = { { 2, 0 }, { 3, 0 }, { 4, 0 }, { 4, 4 * 1024 } };
+    int ret = 0;
+
+    for (int i = 0; i < 32 * 32; i++) {
+        int dx = i % 32 - 16, dy = i / 32 - 16;
+        icon_px[i] = dx * dx + dy * dy > 15 * 15 ? lv_color_hex(0x202020) : dx > 0 ? lv_color_hex(0x40C040) : lv_color_hex(0xFFFFFF);
+    }
+    sim_bench_init();
+    pool_init();
+    sim_bench_disp_drv.cull_occluded = 1;
+    sim_bench_disp_drv.render_cb = bench_render_cb;
+    sim_bench_disp_drv.render_lock_cb = bench_render_lock_cb;
+
+    printf("parallel rendering, %dx%d, 40 line bands, %d frames (host CPU)\n", HOR_RES, VER_RES, FRAMES);
+    double ms_ref;
+    run(1, 0, reference, &ms_ref);
+    printf("  1 thread              %6.3f ms/frame\n", ms_ref);
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        double ms;
+        run(modes[m].strips, modes[m].retained_mem, frames, &ms);
+        int mismatch = 0;
+        for (int f = 0; f < FRAMES; f++) {
+            mismatch += memcmp(reference[f], frames[f], sizeof(sim_bench_frame)) != 0;
+        }
+        printf("  %u strips%-13s %6.3f ms/frame  (%5.1f %%)", (unsigned)modes[m].strips,
+               modes[m].retained_mem ? ", retained" : "", ms, 100.0 * ms / ms_ref);
+        if (mismatch) {
+            printf("  MISMATCH in %d frames", mismatch);
+            ret = 1;
+        }
+        printf("\n");
+    }
+
+    pool_deinit();
+    lv_grad_cache_monitor_t grad_mon;
+    lv_gradient_cache_monitor(&grad_mon);
+    if (grad_mon.used_size != 0) {
+        printf("  %u bytes of gradient caches left after stopping the threads\n", (unsigned)grad_mon.used_size);
+        ret = 1;
+    }
+    return ret;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file retained_bench.c
+ * Moves a small sprite over static widgets on a headless 172x320 display, so
+ * the widgets under it are redrawn in every frame, with and without retained
+ * drawing (lv_disp_drv_t::retained_mem) and compares the widgets recorded,
+ * the render time and the recorded bytes. A meter drawn by a draw event
+ * handler shows a value which changes without invalidating it: it must be
+ * drawn live, not replayed. Every frame must be identical.
+ */
+
+#include <stdio.h>
+#include "lvgl.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define FRAMES          300
+#define RETAINED_MEM    (4 * 1024)
+
+static int32_t mood;         // drawn by the meter, changes without invalidating it
+
+/* Fills the meter up to the current mood */
+static void meter_draw_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.bg_color = lv_color_hex(0xF07C8A);
+    lv_area_t area = obj->coords;
+    area.x2 = area.x1 + lv_area_get_width(&obj->coords) * mood / 100;
+    lv_draw_rect(lv_event_get_draw_ctx(e), &dsc, &area);
+}
+
+static lv_obj_t *text(lv_obj_t *parent, lv_coord_t x, lv_coord_t y, const char *txt)
+{
+    lv_obj_t *label = lv_label_create(parent);
+    lv_label_set_text(label, txt);
+    lv_obj_set_pos(label, x, y);
+    return label;
+}
+
+/* A 16x16 checker icon drawn by lv_img */
+static lv_color_t icon_px[16 * 16];
+static const lv_img_dsc_t icon = {
+    .header.cf = LV_IMG_CF_TRUE_COLOR,
+    .header.w = 16,
+    .header.h = 16,
+    .data_size = sizeof(icon_px),
+    .data = (const uint8_t *)icon_px,
+};
+
+static lv_obj_t *status;     // changed now and then, must be recorded again
+static lv_obj_t *meter;
+static lv_obj_t *sprite;
+
+/* The pet screen: status icons, a bubble, buttons with labels, a progress bar and a mood meter,
+ * with a sparkle flying over them */
+static void create_scene(lv_obj_t *scr)
+{
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x80C0F0), 0);
+    for (int i = 0; i < 4; i++) {
+        lv_obj_t *img = lv_img_create(scr);
+        lv_img_set_src(img, &icon);
+        lv_obj_set_pos(img, 8 + i * 24, 8);
+    }
+    status = text(scr, 110, 8, "12:00");
+
+    lv_obj_t *bubble = lv_obj_create(scr);
+    lv_obj_set_pos(bubble, 6, 34);
+    lv_obj_set_size(bubble, 160, 90);
+    lv_obj_clear_flag(bubble, LV_OBJ_FLAG_SCROLLABLE);
+    text(bubble, 0, 0, "Feed me!\nI am hungry.");
+
+    static const char *const names[] = { "Feed", "Play", "Sleep", "Chat" };
+    for (int i = 0; i < 4; i++) {
+        lv_obj_t *btn = lv_btn_create(scr);
+        lv_obj_set_pos(btn, 6 + (i % 2) * 84, 140 + (i / 2) * 50);
+        lv_obj_set_size(btn, 76, 40);
+        lv_obj_t *label = text(btn, 0, 0, names[i]);
+        lv_obj_center(label);
+    }
+
+    lv_obj_t *bar = lv_bar_create(scr);
+    lv_obj_set_pos(bar, 16, 260);
+    lv_obj_set_size(bar, 140, 12);
+    lv_bar_set_value(bar, 70, LV_ANIM_OFF);
+    text(scr, 16, 280, "Hunger 70 %");
+
+    meter = lv_obj_create(scr);
+    lv_obj_set_pos(meter, 110, 280);
+    lv_obj_set_size(meter, 50, 16);
+    lv_obj_add_event_cb(meter, meter_draw_cb, LV_EVENT_DRAW_MAIN, NULL);
+
+    sprite = lv_obj_create(scr);
+    lv_obj_remove_style_all(sprite);
+    lv_obj_set_style_bg_opa(sprite, LV_OPA_70, 0);
+    lv_obj_set_style_bg_color(sprite, lv_color_hex(0xFFF060), 0);
+    lv_obj_set_style_radius(sprite, LV_RADIUS_CIRCLE, 0);
+    lv_obj_set_size(sprite, 24, 24);
+}
+
+/* The widgets under obj (included) whose draws are recorded */
+static uint32_t recorded_cnt(lv_obj_t *obj)
+{
+    uint32_t cnt = obj->draw_list && obj->draw_list != LV_DRAW_LIST_FAILED;
+    for (uint32_t i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+        cnt += recorded_cnt(lv_obj_get_child(obj, i));
+    }
+    return cnt;
+}
+
+static void run(uint32_t retained_mem, uint32_t *hashes, uint32_t *recorded, double *ms, uint32_t *mem)
+{
+    lv_obj_clean(lv_scr_act());
+    sim_bench_disp_drv.retained_mem = retained_mem;
+    mood = 0;
+    create_scene(lv_scr_act());
+    lv_refr_now(NULL);
+
+    *recorded = 0;
+    *mem = 0;
+    int64_t t = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        // A zigzag over the whole screen
+        int x = (f * 3) % (2 * (HOR_RES - 24));
+        lv_obj_set_pos(sprite, x < HOR_RES - 24 ? x : 2 * (HOR_RES - 24) - x, (f * 7) % (VER_RES - 24));
+        if (f % 50 == 25) {
+            lv_label_set_text_fmt(status, "12:%02d", f / 50);
+        }
+        mood = (f * 7) % 101;
+        int64_t t0 = sim_clock_ns();
+        lv_refr_now(NULL);
+        t += sim_clock_ns() - t0;
+        hashes[f] = sim_bench_frame_hash();
+        if (_lv_draw_list_get_mem_used() > *mem) {
+            *mem = _lv_draw_list_get_mem_used();
+        }
+        if (meter->draw_list) {
+            *recorded = UINT32_MAX;
+        }
+        else if (recorded_cnt(lv_scr_act()) > *recorded) {
+            *recorded = recorded_cnt(lv_scr_act());
+        }
+    }
+    *ms = (double)t / FRAMES / 1e6;
+}
+
+int main(void)
+{
+    static uint32_t reference[FRAMES], hashes[FRAMES];
+    int ret = 0;
+
+    for (int i = 0; i < 16 * 16; i++) {
+        icon_px[i] = ((i / 16 + i) / 4) % 2 ? lv_color_hex(0xC04040) : lv_color_hex(0xFFFFFF);
+    }
+    sim_bench_init();
+
+    printf("retained drawing, %dx%d, a 24x24 sprite over 17 static widgets, %d frames (host CPU)\n",
+           HOR_RES, VER_RES, FRAMES);
+    uint32_t recorded_off, recorded_on, mem_off, mem_on;
+    double ms_off, ms_on;
+    run(0, reference, &recorded_off, &ms_off, &mem_off);
+    run(RETAINED_MEM, hashes, &recorded_on, &ms_on, &mem_on);
+    int mismatch = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        mismatch += reference[f] != hashes[f];
+    }
+    printf("  live                         %6.3f ms/frame\n", ms_off);
+    printf("  retained  %2u widgets recorded  %6.3f ms/frame  (%5.1f %%), %u of %u bytes recorded%s\n",
+           (unsigned)(recorded_on == UINT32_MAX ? 0 : recorded_on), ms_on, 100.0 * ms_on / ms_off, (unsigned)mem_on,
+           RETAINED_MEM, mismatch ? "  MISMATCH" : "");
+    ret |= mismatch != 0;
+    if (recorded_on == UINT32_MAX) {
+        printf("  the meter drawn by its draw event handler was recorded\n");
+        ret = 1;
+    }
+    else if (recorded_on == 0 || mem_on == 0) {
+        printf("  nothing was replayed\n");
+        ret = 1;
+    }
+    // The screen and the layers keep their lists until they change
+    lv_obj_clean(lv_scr_act());
+    lv_obj_invalidate(lv_scr_act());
+    lv_obj_invalidate(lv_layer_top());
+    lv_obj_invalidate(lv_layer_sys());
+    if (_lv_draw_list_get_mem_used() != 0) {
+        printf("  %u bytes not freed with the widgets\n", (unsigned)_lv_draw_list_get_mem_used());
+        ret = 1;
+    }
+    return ret;
+}
@@ -0,0 +1,315 @@
+/**
+ * @file rle_bench.c
+ * Run-length encodes a cartoon-like full screen background (RGB565) and a pet
+ * sprite with transparent corners (RGB565 + A8) like tools/asset_pack.py --rle
+ * and measures on the host CPU: the compression ratio, the decode throughput of
+ * whole rows in order, of random rows and of row slices (clipped draws) through
+ * lv_img_decoder_read_line, and the render time of a screen showing them raw
+ * and encoded. The background is drawn row by row from the encoded data, the
+ * sprite is decoded at once (under LV_IMG_RLE_DECODE_MAX_SIZE). Every frame
+ * must be identical. The background cut in half must decode its rows within
+ * the data and the rest as zeros.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "lvgl.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define SPRITE_SIZE     48
+#define FRAMES          60
+#define DECODE_ROUNDS   20
+#define RUNS            5
+
+static lv_color_t bg_px[VER_RES * HOR_RES];
+static uint8_t sprite_px[SPRITE_SIZE * SPRITE_SIZE * LV_IMG_PX_SIZE_ALPHA_BYTE];
+static uint8_t bg_rle[VER_RES * 4 + VER_RES * (HOR_RES * 3)];
+static uint8_t sprite_rle[SPRITE_SIZE * 4 + SPRITE_SIZE * (SPRITE_SIZE * 4)];
+static lv_img_dsc_t bg_raw, bg_enc, sprite_raw, sprite_enc;
+
+/* The format of lv_img_buf.h: a row index, then literal (c < 0x80) and run packets */
+static uint32_t rle_encode(uint8_t *out, const uint8_t *px, int w, int h, int px_size)
+{
+    uint32_t len = (uint32_t)h * 4;
+    for (int y = 0; y < h; y++) {
+        out[y * 4] = (uint8_t)len;
+        out[y * 4 + 1] = (uint8_t)(len >> 8);
+        out[y * 4 + 2] = (uint8_t)(len >> 16);
+        out[y * 4 + 3] = (uint8_t)(len >> 24);
+        const uint8_t *row = px + y * w * px_size;
+        int x = 0, lit = 0;
+        while (x < w) {
+            int n = 1;
+            while (x + n < w && n < 128 && memcmp(row + (x + n) * px_size, row + x * px_size, px_size) == 0) {
+                n++;
+            }
+            if (n == 1) {
+                lit++;
+            }
+            if (lit && (n > 1 || lit == 128 || x + 1 == w)) {
+                int start = n > 1 ? x - lit : x + 1 - lit;
+                out[len++] = (uint8_t)(lit - 1);
+                memcpy(out + len, row + start * px_size, lit * px_size);
+                len += lit * px_size;
+                lit = 0;
+            }
+            if (n > 1) {
+                out[len++] = (uint8_t)(0x80 | (n - 1));
+                memcpy(out + len, row + x * px_size, px_size);
+                len += px_size;
+            }
+            x += n;
+        }
+    }
+    return len;
+}
+
+static void set_dsc(lv_img_dsc_t *dsc, lv_img_cf_t cf, int w, int h, const uint8_t *data, uint32_t size)
+{
+    dsc->header.cf = cf;
+    dsc->header.w = w;
+    dsc->header.h = h;
+    dsc->data = data;
+    dsc->data_size = size;
+}
+
+/* Sky in bands, hills, a sun, a fence and a patch of grass noise: flat areas and some detail */
+static void make_images(void)
+{
+    uint32_t seed = 1;
+    for (int y = 0; y < VER_RES; y++) {
+        for (int x = 0; x < HOR_RES; x++) {
+            lv_color_t c = lv_color_hsv_to_rgb(200, 30 + y / 16 * 3, 100);
+            int hill = 200 + (x - 86) * (x - 86) / 120;
+            if ((x - 130) * (x - 130) + (y - 50) * (y - 50) < 400) {
+                c = lv_color_hex(0xFFE070);
+            }
+            if (y > hill) {
+                c = lv_color_hsv_to_rgb(100, 60, 70 - (y - hill) / 12 * 4);
+            }
+            if (y > 250 && y < 270 && x % 24 < 4) {
+                c = lv_color_hex(0xC08040);
+            }
+            if (y >= 290) {
+                seed = seed * 1103515245u + 12345u;
+                c = lv_color_hsv_to_rgb(95, 65, 45 + (seed >> 16) % 12);
+            }
+            bg_px[y * HOR_RES + x] = c;
+        }
+    }
+
+    int r = SPRITE_SIZE / 2 - 2;
+    for (int y = 0; y < SPRITE_SIZE; y++) {
+        for (int x = 0; x < SPRITE_SIZE; x++) {
+            int dx = x - SPRITE_SIZE / 2, dy = y - SPRITE_SIZE / 2;
+            int d2 = dx * dx + dy * dy;
+            lv_color_t c = lv_color_hex(0xF0A0C0);
+            lv_opa_t a = d2 <= r * r ? LV_OPA_COVER : d2 <= (r + 2) * (r + 2) ? LV_OPA_50 : LV_OPA_TRANSP;
+            if (d2 > (r - 2) * (r - 2)) {
+                c = lv_color_hex(0x603040);
+            }
+            if (dy > -8 && dy < -2 && (dx == -8 || dx == -7 || dx == 7 || dx == 8)) {
+                c = lv_color_black();
+            }
+            uint8_t *p = &sprite_px[(y * SPRITE_SIZE + x) * LV_IMG_PX_SIZE_ALPHA_BYTE];
+            memcpy(p, &c, sizeof(c));
+            p[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = a;
+        }
+    }
+
+    set_dsc(&bg_raw, LV_IMG_CF_TRUE_COLOR, HOR_RES, VER_RES, (const uint8_t *)bg_px, sizeof(bg_px));
+    set_dsc(&bg_enc, LV_IMG_CF_RLE_TRUE_COLOR, HOR_RES, VER_RES, bg_rle,
+            rle_encode(bg_rle, (const uint8_t *)bg_px, HOR_RES, VER_RES, sizeof(lv_color_t)));
+    set_dsc(&sprite_raw, LV_IMG_CF_TRUE_COLOR_ALPHA, SPRITE_SIZE, SPRITE_SIZE, sprite_px, sizeof(sprite_px));
+    set_dsc(&sprite_enc, LV_IMG_CF_RLE_TRUE_COLOR_ALPHA, SPRITE_SIZE, SPRITE_SIZE, sprite_rle,
+            rle_encode(sprite_rle, sprite_px, SPRITE_SIZE, SPRITE_SIZE, LV_IMG_PX_SIZE_ALPHA_BYTE));
+}
+
+typedef enum {
+    ROWS_IN_ORDER,
+    ROWS_RANDOM,
+    ROW_SLICES,
+} decode_mode_t;
+
+/* Decoded MB/s through the decoder's read_line, best of RUNS; checked against the raw pixels */
+static double decode_rate(const lv_img_dsc_t *enc, const lv_img_dsc_t *raw, decode_mode_t mode, int *errors)
+{
+    static uint8_t line[HOR_RES * LV_IMG_PX_SIZE_ALPHA_BYTE];
+    lv_img_decoder_dsc_t dsc;
+    int w = enc->header.w, h = enc->header.h;
+    uint32_t px_size = lv_img_cf_get_px_size(raw->header.cf) >> 3;
+    int64_t best = INT64_MAX;
+    uint64_t bytes = 0;
+
+    if (lv_img_decoder_open(&dsc, enc, lv_color_black(), 0) != LV_RES_OK) {
+        (*errors)++;
+        return 0;
+    }
+    // Small images are decoded at once in `open`: time that instead
+    if (dsc.img_data) {
+        if (memcmp(dsc.img_data, raw->data, raw->data_size) != 0) {
+            (*errors)++;
+        }
+        lv_img_decoder_close(&dsc);
+        for (int run = 0; run < RUNS; run++) {
+            int64_t t0 = sim_clock_ns();
+            for (int i = 0; i < DECODE_ROUNDS; i++) {
+                lv_img_decoder_open(&dsc, enc, lv_color_black(), 0);
+                lv_img_decoder_close(&dsc);
+            }
+            int64_t t = sim_clock_ns() - t0;
+            if (t < best) {
+                best = t;
+            }
+        }
+        return (double)raw->data_size * DECODE_ROUNDS / 1e6 / ((double)best / 1e9);
+    }
+    for (int run = 0; run < RUNS; run++) {
+        uint32_t seed = 7;
+        bytes = 0;
+        int64_t t0 = sim_clock_ns();
+        for (int i = 0; i < DECODE_ROUNDS * h; i++) {
+            int y = i % h, x = 0, len = w;
+            if (mode != ROWS_IN_ORDER) {
+                seed = seed * 1103515245u + 12345u;
+                y = (seed >> 8) % h;
+            }
+            if (mode == ROW_SLICES) {
+                x = (seed >> 20) % (w / 2);
+                len = w / 4;
+            }
+            lv_img_decoder_read_line(&dsc, x, y, len, line);
+            if (run == 0 && memcmp(line, raw->data + (y * w + x) * px_size, len * px_size) != 0) {
+                (*errors)++;
+            }
+            bytes += len * px_size;
+        }
+        int64_t t = sim_clock_ns() - t0;
+        if (t < best) {
+            best = t;
+        }
+    }
+    lv_img_decoder_close(&dsc);
+    return (double)bytes / 1e6 / ((double)best / 1e9);
+}
+
+/* Decode the background with `data_size` cut in half: the whole rows before the cut must match the raw pixels,
+ * the rows after it must be zeros. Return the number of wrong rows */
+static int decode_truncated(void)
+{
+    static uint8_t line[HOR_RES * sizeof(lv_color_t)];
+    static const uint8_t zeros[HOR_RES * sizeof(lv_color_t)];
+    lv_img_dsc_t cut = bg_enc;
+    lv_img_decoder_dsc_t dsc;
+    int errors = 0;
+
+    cut.data_size = VER_RES * 4 + (bg_enc.data_size - VER_RES * 4) / 2;
+    if (lv_img_decoder_open(&dsc, &cut, lv_color_black(), 0) != LV_RES_OK) {
+        return VER_RES;
+    }
+    for (int y = 0; y < VER_RES; y++) {
+        uint32_t ofs, next = bg_enc.data_size;
+        memcpy(&ofs, bg_enc.data + y * 4, 4);
+        if (y + 1 < VER_RES) {
+            memcpy(&next, bg_enc.data + (y + 1) * 4, 4);
+        }
+        memset(line, 0xAA, sizeof(line));
+        lv_img_decoder_read_line(&dsc, 0, y, HOR_RES, line);
+        if (next <= cut.data_size) {
+            errors += memcmp(line, bg_raw.data + y * sizeof(line), sizeof(line)) != 0;
+        } else if (ofs >= cut.data_size) {
+            errors += memcmp(line, zeros, sizeof(line)) != 0;
+        }
+    }
+    lv_img_decoder_close(&dsc);
+    return errors;
+}
+
+/* The background with the sprite walking over it */
+static double render(const lv_img_dsc_t *bg, const lv_img_dsc_t *sprite, uint32_t *hashes)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_obj_t *bg_img = lv_img_create(lv_scr_act());
+    lv_img_set_src(bg_img, bg);
+    lv_obj_t *pet = lv_img_create(lv_scr_act());
+    lv_img_set_src(pet, sprite);
+
+    int64_t best = INT64_MAX;
+    for (int run = 0; run < RUNS; run++) {
+        int64_t t = 0;
+        for (int f = 0; f < FRAMES; f++) {
+            lv_obj_set_pos(pet, f * 2, 200 + f % 8);
+            lv_obj_invalidate(lv_scr_act());
+            int64_t t0 = sim_clock_ns();
+            _lv_disp_refr_timer(lv_disp_get_default()->refr_timer);
+            t += sim_clock_ns() - t0;
+            hashes[f] = sim_bench_frame_hash();
+        }
+        if (t < best) {
+            best = t;
+        }
+    }
+    return (double)best / FRAMES / 1e6;
+}
+
+int main(void)
+{
+    static uint32_t reference[FRAMES], hashes[FRAMES];
+    int ret = 0;
+
+    sim_bench_init();
+    make_images();
+
+    printf("run-length encoded images, a %dx%d background and a %dx%d sprite (host CPU)\n",
+           HOR_RES, VER_RES, SPRITE_SIZE, SPRITE_SIZE);
+    static const struct {
+        const char *name;
+        const lv_img_dsc_t *enc, *raw;
+    } images[] = {
+        { "background", &bg_enc, &bg_raw },
+        { "sprite", &sprite_enc, &sprite_raw },
+    };
+    for (int i = 0; i < 2; i++) {
+        int errors = 0;
+        printf("  %-10s %6u -> %6u B (%5.1f %%)  decode", images[i].name, (unsigned)images[i].raw->data_size,
+               (unsigned)images[i].enc->data_size, 100.0 * images[i].enc->data_size / images[i].raw->data_size);
+        if (lv_img_buf_get_img_size(images[i].raw->header.w, images[i].raw->header.h, images[i].raw->header.cf) <=
+            LV_IMG_RLE_DECODE_MAX_SIZE) {
+            printf(" %7.1f MB/s at once", decode_rate(images[i].enc, images[i].raw, ROWS_IN_ORDER, &errors));
+        } else {
+            double in_order = decode_rate(images[i].enc, images[i].raw, ROWS_IN_ORDER, &errors);
+            double random = decode_rate(images[i].enc, images[i].raw, ROWS_RANDOM, &errors);
+            double slices = decode_rate(images[i].enc, images[i].raw, ROW_SLICES, &errors);
+            printf(" %7.1f MB/s rows, %7.1f MB/s random rows, %7.1f MB/s slices", in_order, random, slices);
+        }
+        printf("%s\n", errors ? "  MISMATCH" : "");
+        if (errors) {
+            printf("  %d decoded rows differ from the raw pixels\n", errors);
+            ret = 1;
+        }
+    }
+
+    int truncated = decode_truncated();
+    printf("  background cut in half: %s\n", truncated ? "MISMATCH" : "rows within the data, zeros after it");
+    if (truncated) {
+        printf("  %d decoded rows differ\n", truncated);
+        ret = 1;
+    }
+
+    double raw_ms = render(&bg_raw, &sprite_raw, reference);
+    double enc_ms = render(&bg_enc, &sprite_enc, hashes);
+    int mismatch = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        mismatch += reference[f] != hashes[f];
+    }
+    printf("  render     raw %6.3f ms/frame, encoded %6.3f ms/frame (%5.1f %%)%s\n",
+           raw_ms, enc_ms, 100.0 * enc_ms / raw_ms, mismatch ? "  MISMATCH" : "");
+    if (mismatch) {
+        printf("  %d of %d frames differ\n", mismatch, FRAMES);
+        ret = 1;
+    }
+    return ret;
+}
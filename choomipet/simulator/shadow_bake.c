@@ -0,0 +1,117 @@
+/**
+ * @file shadow_bake.c
+ * Blurs the shadow corners of the given rectangles with the simulator's LVGL
+ * and writes them as constant tables for lv_draw_sw_shadow_set_baked():
+ *
+ *   shadow_bake OUT.c NAME WxH,RADIUS,SHADOW_WIDTH[,SPREAD]...
+ *   shadow_bake main/ui_shadows.c ui_shadows 150x56,12,16 120x44,22,20,2
+ *
+ * OUT.c defines `const lv_draw_sw_shadow_corner_t NAME[]` and
+ * `const uint32_t NAME_cnt`, to be passed to lv_draw_sw_shadow_set_baked()
+ * after lv_init(). Rectangles sharing a corner are written once. Only the
+ * size of a rectangle matters: its position and the shadow offset don't
+ * change the corner.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "src/draw/sw/lv_draw_sw.h"
+
+#define CORNERS_MAX     64
+
+static lv_draw_sw_shadow_corner_t corners[CORNERS_MAX];
+static uint32_t corner_cnt;
+
+static bool same_corner(const lv_draw_sw_shadow_corner_t *a, const lv_draw_sw_shadow_corner_t *b)
+{
+    return a->width == b->width && a->radius == b->radius && a->core_w == b->core_w && a->core_h == b->core_h;
+}
+
+static void write_map(FILE *f, const char *name, uint32_t i)
+{
+    const lv_draw_sw_shadow_corner_t *c = &corners[i];
+    uint32_t size = (uint32_t)(c->width + c->radius);
+    fprintf(f, "\n/* shadow_width %d, radius %d, %dx%d blurred */\n", (int)c->width, (int)c->radius,
+            (int)c->core_w, (int)c->core_h);
+    fprintf(f, "static const lv_opa_t %s_%u_map[] = {\n", name, (unsigned)i);
+    for (uint32_t y = 0; y < size; y++) {
+        fprintf(f, "   ");
+        for (uint32_t x = 0; x < size; x++) {
+            fprintf(f, " %u,", c->map[y * size + x]);
+        }
+        fprintf(f, "\n");
+    }
+    fprintf(f, "};\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4) {
+        fprintf(stderr, "usage: %s OUT.c NAME WxH,RADIUS,SHADOW_WIDTH[,SPREAD]...\n", argv[0]);
+        return 2;
+    }
+    const char *path = argv[1];
+    const char *name = argv[2];
+
+    lv_init();
+    for (int a = 3; a < argc; a++) {
+        int w, h, radius, shadow_width, spread = 0;
+        if (sscanf(argv[a], "%dx%d,%d,%d,%d", &w, &h, &radius, &shadow_width, &spread) < 4 || w <= 0 || h <= 0) {
+            fprintf(stderr, "%s: bad rectangle \"%s\"\n", argv[0], argv[a]);
+            return 2;
+        }
+        lv_draw_rect_dsc_t dsc;
+        lv_draw_rect_dsc_init(&dsc);
+        dsc.radius = (lv_coord_t)radius;
+        dsc.shadow_width = (lv_coord_t)shadow_width;
+        dsc.shadow_spread = (lv_coord_t)spread;
+        lv_area_t coords = { 0, 0, (lv_coord_t)(w - 1), (lv_coord_t)(h - 1) };
+
+        lv_draw_sw_shadow_corner_t c;
+        if (!lv_draw_sw_shadow_bake(&dsc, &coords, &c)) {
+            fprintf(stderr, "%s: \"%s\" has no shadow or is too large\n", argv[0], argv[a]);
+            return 1;
+        }
+        bool dup = false;
+        for (uint32_t i = 0; i < corner_cnt; i++) {
+            dup |= same_corner(&corners[i], &c);
+        }
+        if (dup) {
+            lv_mem_free((void *)c.map);
+        } else if (corner_cnt < CORNERS_MAX) {
+            corners[corner_cnt++] = c;
+        } else {
+            fprintf(stderr, "%s: more than %d corners\n", argv[0], CORNERS_MAX);
+            return 1;
+        }
+    }
+
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        perror(path);
+        return 1;
+    }
+    fprintf(f, "/* Generated by simulator/shadow_bake, do not edit:\n *  shadow_bake %s %s", path, name);
+    for (int a = 3; a < argc; a++) {
+        fprintf(f, " %s", argv[a]);
+    }
+    fprintf(f, "\n */\n\n#include \"lvgl.h\"\n#include \"src/draw/sw/lv_draw_sw.h\"\n");
+    for (uint32_t i = 0; i < corner_cnt; i++) {
+        write_map(f, name, i);
+    }
+    fprintf(f, "\nconst lv_draw_sw_shadow_corner_t %s[] = {\n", name);
+    for (uint32_t i = 0; i < corner_cnt; i++) {
+        const lv_draw_sw_shadow_corner_t *c = &corners[i];
+        fprintf(f, "    { %d, %d, %d, %d, %s_%u_map },\n", (int)c->width, (int)c->radius, (int)c->core_w,
+                (int)c->core_h, name, (unsigned)i);
+    }
+    fprintf(f, "};\n\nconst uint32_t %s_cnt = %u;\n", name, (unsigned)corner_cnt);
+    if (fclose(f) != 0) {
+        perror(path);
+        return 1;
+    }
+    printf("%s: %u shadow corners\n", path, (unsigned)corner_cnt);
+    return 0;
+}
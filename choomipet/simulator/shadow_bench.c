@@ -0,0 +1,235 @@
+/**
+ * @file shadow_bench.c
+ * Redraws a screen of the pet UI with soft shadows on a headless 172x320
+ * display in every frame: two cards, a speech bubble, the pet's avatar and
+ * three buttons. The shadow corners are blurred in every draw (no cache, as
+ * with LV_SHADOW_CACHE_SIZE 0), kept in the shadow cache of its default
+ * memory size, and taken from tables baked at build time by shadow_bake
+ * (shadow_corners.c, see CMakeLists.txt). The hits, misses, the RAM kept and
+ * the render time (host CPU) are compared and every frame must be identical.
+ *
+ * First the rectangles of many sizes, radii, shadow widths and spreads are
+ * blurred one by one: the ones sharing a cache key must have the same corner.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "src/draw/sw/lv_draw_sw.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define FRAMES          60
+#define KEYS_MAX        512
+
+extern const lv_draw_sw_shadow_corner_t bench_shadows[];
+extern const uint32_t bench_shadows_cnt;
+
+/* Every rectangle with the same key must get the same corner. Returns the number of keys which didn't */
+static int check_keys(uint32_t *bakes, uint32_t *keys)
+{
+    static const lv_coord_t sides[] = { 6, 17, 40, 63, 90, 130 };
+    static const lv_coord_t widths[] = { 2, 7, 20 };
+    static const lv_coord_t radii[] = { 0, 6, 24, LV_RADIUS_CIRCLE };
+    static const lv_coord_t spreads[] = { 0, 4 };
+    static lv_draw_sw_shadow_corner_t seen[KEYS_MAX];
+    uint32_t seen_cnt = 0;
+    int bad = 0;
+
+    *bakes = 0;
+    for (size_t wi = 0; wi < sizeof(sides) / sizeof(sides[0]); wi++)
+    for (size_t hi = 0; hi < sizeof(sides) / sizeof(sides[0]); hi++)
+    for (size_t si = 0; si < sizeof(widths) / sizeof(widths[0]); si++)
+    for (size_t ri = 0; ri < sizeof(radii) / sizeof(radii[0]); ri++)
+    for (size_t pi = 0; pi < sizeof(spreads) / sizeof(spreads[0]); pi++) {
+        /* Large round corners don't fit the heap of the firmware */
+        if (radii[ri] == LV_RADIUS_CIRCLE && (sides[wi] > 63 || sides[hi] > 63)) {
+            continue;
+        }
+        lv_draw_rect_dsc_t dsc;
+        lv_draw_rect_dsc_init(&dsc);
+        dsc.radius = radii[ri];
+        dsc.shadow_width = widths[si];
+        dsc.shadow_spread = spreads[pi];
+        lv_area_t coords = { 10, 20, (lv_coord_t)(10 + sides[wi] - 1), (lv_coord_t)(20 + sides[hi] - 1) };
+        lv_draw_sw_shadow_corner_t c;
+        if (!lv_draw_sw_shadow_bake(&dsc, &coords, &c)) {
+            printf("  %dx%d radius %d shadow %d spread %d: not baked\n", sides[wi], sides[hi], radii[ri],
+                   widths[si], spreads[pi]);
+            bad++;
+            continue;
+        }
+        (*bakes)++;
+        size_t size = (size_t)(c.width + c.radius) * (c.width + c.radius);
+        uint32_t i;
+        for (i = 0; i < seen_cnt; i++) {
+            const lv_draw_sw_shadow_corner_t *s = &seen[i];
+            if (s->width == c.width && s->radius == c.radius && s->core_w == c.core_w && s->core_h == c.core_h) {
+                break;
+            }
+        }
+        if (i < seen_cnt) {
+            if (memcmp(seen[i].map, c.map, size) != 0) {
+                printf("  %dx%d radius %d shadow %d spread %d: other corner than with the same key\n", sides[wi],
+                       sides[hi], radii[ri], widths[si], spreads[pi]);
+                bad++;
+            }
+        } else if (seen_cnt < KEYS_MAX) {
+            /* Kept outside of the LVGL heap */
+            lv_opa_t *map = malloc(size);
+            memcpy(map, c.map, size);
+            seen[seen_cnt] = c;
+            seen[seen_cnt].map = map;
+            seen_cnt++;
+        }
+        lv_mem_free((void *)c.map);
+    }
+    for (uint32_t i = 0; i < seen_cnt; i++) {
+        free((void *)seen[i].map);
+    }
+    *keys = seen_cnt;
+    return bad;
+}
+
+static lv_obj_t *add_rect(lv_obj_t *parent, int x, int y, int w, int h, int radius, int shadow_width, int spread,
+                          uint32_t color)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, w, h);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(obj, lv_color_hex(color), 0);
+    lv_obj_set_style_radius(obj, radius, 0);
+    lv_obj_set_style_shadow_width(obj, shadow_width, 0);
+    lv_obj_set_style_shadow_spread(obj, spread, 0);
+    lv_obj_set_style_shadow_ofs_y(obj, 4, 0);
+    lv_obj_set_style_shadow_opa(obj, LV_OPA_50, 0);
+    lv_obj_set_style_shadow_color(obj, lv_color_hex(0x203040), 0);
+    return obj;
+}
+
+/* The rectangles baked by shadow_bake in CMakeLists.txt */
+static void create_scene(lv_obj_t *scr)
+{
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0xD8ECF8), 0);
+    add_rect(scr, 11, 14, 150, 56, 12, 16, 0, 0xFFFFFF);
+    add_rect(scr, 26, 96, 120, 44, 22, 20, 2, 0xFFF4D8);
+    add_rect(scr, 58, 164, 56, 56, LV_RADIUS_CIRCLE, 14, 0, 0xF8C8A0);
+    add_rect(scr, 11, 240, 150, 56, 12, 16, 0, 0xFFFFFF);
+    for (int i = 0; i < 3; i++) {
+        add_rect(scr, 16 + i * 50, 252, 40, 32, 16, 10, 0, 0x80B8E0);
+    }
+}
+
+typedef struct {
+    lv_draw_sw_shadow_cache_monitor_t mon;
+    uint32_t used_max;
+    double ms;
+} result_t;
+
+static void run(uint32_t mem_size, bool baked, uint32_t *hashes, result_t *res)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_draw_sw_shadow_cache_set_mem_size(mem_size);
+    lv_draw_sw_shadow_set_baked(baked ? bench_shadows : NULL, baked ? bench_shadows_cnt : 0);
+    create_scene(lv_scr_act());
+
+    lv_draw_sw_shadow_cache_monitor_t mon0;
+    lv_draw_sw_shadow_cache_monitor(&mon0);
+    int64_t t = 0;
+    res->used_max = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        lv_obj_invalidate(lv_scr_act());
+        int64_t t0 = sim_clock_ns();
+        _lv_disp_refr_timer(lv_disp_get_default()->refr_timer);
+        t += sim_clock_ns() - t0;
+        hashes[f] = sim_bench_frame_hash();
+
+        lv_draw_sw_shadow_cache_monitor(&res->mon);
+        if (res->mon.used_size > res->used_max) {
+            res->used_max = res->mon.used_size;
+        }
+    }
+    res->mon.hit_cnt -= mon0.hit_cnt;
+    res->mon.baked_cnt -= mon0.baked_cnt;
+    res->mon.miss_cnt -= mon0.miss_cnt;
+    res->mon.evict_cnt -= mon0.evict_cnt;
+    res->ms = (double)t / FRAMES / 1e6;
+}
+
+static void print_result(const char *name, const result_t *res, const result_t *ref, int mismatch)
+{
+    printf("  %-8s %6u hits %6u baked %6u blurred %5u evictions  %5u / %5u B  %6.3f ms/frame", name,
+           (unsigned)res->mon.hit_cnt, (unsigned)res->mon.baked_cnt, (unsigned)res->mon.miss_cnt,
+           (unsigned)res->mon.evict_cnt, (unsigned)res->used_max, (unsigned)res->mon.total_size, res->ms);
+    if (ref) {
+        printf("  (%5.1f %%)%s", 100.0 * res->ms / ref->ms, mismatch ? "  MISMATCH" : "");
+    }
+    printf("\n");
+}
+
+int main(void)
+{
+    static uint32_t reference[FRAMES], hashes[FRAMES];
+    int ret = 0;
+
+    sim_bench_init();
+
+    uint32_t bakes, keys;
+    int bad = check_keys(&bakes, &keys);
+    printf("shadow corners: %u rectangles blurred, %u keys%s\n", (unsigned)bakes, (unsigned)keys,
+           bad ? "" : ", the same corner for every key");
+    if (bad) {
+        ret = 1;
+    }
+
+    printf("shadow cache, %dx%d, 7 shadowed rectangles redrawn in %d frames, %u baked corners (host CPU)\n",
+           HOR_RES, VER_RES, FRAMES, (unsigned)bench_shadows_cnt);
+    static const struct {
+        const char *name;
+        uint32_t mem_size;
+        bool baked;
+    } modes[] = {
+        { "no cache", 0, false },
+        { "cache", LV_SHADOW_CACHE_MEM_SIZE, false },
+        { "baked", 0, true },
+    };
+    result_t res[3];
+    for (int m = 0; m < 3; m++) {
+        run(modes[m].mem_size, modes[m].baked, m == 0 ? reference : hashes, &res[m]);
+        int mismatch = 0;
+        for (int f = 0; m > 0 && f < FRAMES; f++) {
+            mismatch += reference[f] != hashes[f];
+        }
+        print_result(modes[m].name, &res[m], m > 0 ? &res[0] : NULL, mismatch);
+        if (mismatch) {
+            printf("  %d of %d frames differ\n", mismatch, FRAMES);
+            ret = 1;
+        }
+        if (res[m].used_max > res[m].mon.total_size) {
+            printf("  the cache outgrew its memory size\n");
+            ret = 1;
+        }
+    }
+    lv_draw_sw_shadow_cache_set_mem_size(LV_SHADOW_CACHE_MEM_SIZE);
+    lv_draw_sw_shadow_set_baked(NULL, 0);
+
+    if (res[0].mon.hit_cnt || res[0].mon.baked_cnt) {
+        printf("  shadows were reused without a cache\n");
+        ret = 1;
+    }
+    /* The 4 corners of the scene fit into the default size: only the first frame blurs them */
+    if (res[1].mon.miss_cnt > 4) {
+        printf("  the corners didn't stay in the cache\n");
+        ret = 1;
+    }
+    if (res[2].mon.miss_cnt) {
+        printf("  %u shadows were not baked, update shadow_bake in CMakeLists.txt\n", (unsigned)res[2].mon.miss_cnt);
+        ret = 1;
+    }
+    return ret;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file sim.h
+ * Host simulator internals: clock, recording panel IO and GRAM model.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ST7789 frame memory is 240x320 even though only 172 columns are glass */
+#define SIM_GRAM_W  240
+#define SIM_GRAM_H  320
+
+typedef struct {
+    uint64_t bus_bytes;         // every byte clocked out on MOSI: commands, parameters and pixels
+    uint64_t pixel_bytes;       // RAMWR / RAMWRC payload only
+    uint64_t pixels;            // pixels landed in GRAM
+    uint64_t bus_busy_ns;       // simulated time SCLK was running
+    uint64_t io_wait_ns;        // time callers spent blocked in panel IO waiting for queued DMA
+    uint32_t transactions;      // SPI transactions, polled and queued
+    uint32_t ramwr_count;       // RAMWR commands issued
+    uint32_t protocol_errors;   // malformed windows, writes outside GRAM, unknown pixel format
+    uint32_t pclk_hz;           // simulated SCLK frequency
+    uint8_t  colmod;            // last COLMOD value
+    uint8_t  madctl;            // last MADCTL value
+    uint8_t  ramctrl;           // last RAMCTRL second parameter, bit 3 selects little-endian RGB565
+    uint16_t vscroll_top;       // VSCRDEF top fixed area, in lines
+    uint16_t vscroll_height;    // VSCRDEF scrolling area, in lines
+    uint16_t vscroll_start;     // VSCSAD: frame memory line shown on the first scrolling line
+    uint32_t vscsad_count;      // VSCSAD commands issued
+} sim_lcd_stats_t;
+
+/* Host monotonic clock in nanoseconds since sim_clock_init() */
+void sim_clock_init(void);
+int64_t sim_clock_ns(void);
+void sim_sleep_until_ns(int64_t deadline_ns);
+
+/* Fills the flash_test partition with a file (an asset pack), false if it cannot be read or does not fit */
+bool sim_flash_load_assets(const char *path);
+
+/* Called from vTaskDelay() and around the wait in ulTaskNotifyTake() so the simulator can act on the calling task */
+void sim_task_yield_hook(void);
+
+void sim_lcd_get_stats(sim_lcd_stats_t *out);
+/* Time the calling thread has spent blocked in panel IO waiting for queued DMA */
+uint64_t sim_lcd_thread_io_wait_ns(void);
+/* GRAM pixel as 0x00RRGGBB, components expanded to 8 bit */
+uint32_t sim_lcd_gram_get_px(int x, int y);
+/* Pixel shown on glass row y: the GRAM pixel after vertical scrolling (VSCRDEF / VSCSAD) */
+uint32_t sim_lcd_glass_get_px(int x, int y);
+bool sim_lcd_dump_ppm(const char *path, int x_ofs, int y_ofs, int w, int h);
+
+#ifdef __cplusplus
+}
+#endif
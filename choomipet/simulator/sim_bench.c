@@ -0,0 +1,48 @@
+/**
+ * @file sim_bench.c
+ * The headless display shared by the benchmarks.
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+lv_disp_drv_t sim_bench_disp_drv;
+lv_color_t sim_bench_frame[SIM_BENCH_VER_RES][SIM_BENCH_HOR_RES];
+
+static lv_disp_draw_buf_t draw_buf;
+static lv_color_t buf[SIM_BENCH_HOR_RES * SIM_BENCH_BAND_H];
+
+static void frame_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    for (lv_coord_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&sim_bench_frame[y][area->x1], color_p, lv_area_get_width(area) * sizeof(lv_color_t));
+        color_p += lv_area_get_width(area);
+    }
+    lv_disp_flush_ready(drv);
+}
+
+lv_disp_t *sim_bench_init(void)
+{
+    sim_clock_init();
+    esp_log_level_set("*", ESP_LOG_WARN);
+    lv_init();
+    lv_disp_draw_buf_init(&draw_buf, buf, NULL, SIM_BENCH_HOR_RES * SIM_BENCH_BAND_H);
+    lv_disp_drv_init(&sim_bench_disp_drv);
+    sim_bench_disp_drv.hor_res = SIM_BENCH_HOR_RES;
+    sim_bench_disp_drv.ver_res = SIM_BENCH_VER_RES;
+    sim_bench_disp_drv.flush_cb = frame_flush_cb;
+    sim_bench_disp_drv.draw_buf = &draw_buf;
+    return lv_disp_drv_register(&sim_bench_disp_drv);
+}
+
+uint32_t sim_bench_frame_hash(void)
+{
+    const uint8_t *p = (const uint8_t *)sim_bench_frame;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(sim_bench_frame); i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
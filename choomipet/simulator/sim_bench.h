@@ -0,0 +1,32 @@
+/**
+ * @file sim_bench.h
+ * The headless display of the benchmarks: 172x320 like the glass, rendered in
+ * 40 line bands like the firmware, every flushed band copied into a frame.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_BENCH_HOR_RES   172
+#define SIM_BENCH_VER_RES   320
+#define SIM_BENCH_BAND_H    40
+
+/* The driver of the display, the benchmarks can change it (e.g. flush_cb, retained_mem) after sim_bench_init() */
+extern lv_disp_drv_t sim_bench_disp_drv;
+/* The pixels flushed by the default flush_cb */
+extern lv_color_t sim_bench_frame[SIM_BENCH_VER_RES][SIM_BENCH_HOR_RES];
+
+/* Starts the clock, keeps only the warnings in the log, initializes LVGL and registers the display */
+lv_disp_t *sim_bench_init(void);
+
+/* FNV-1a hash of sim_bench_frame, to compare the frames of two runs */
+uint32_t sim_bench_frame_hash(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,375 @@
+/**
+ * @file sim_esp.c
+ * esp_timer, logging, GPIO, LEDC, SPI bus and flash partition stand-ins for the host simulator.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "driver/spi_master.h"
+#include "esp_partition.h"
+#include "sim.h"
+
+/**********************
+ *  CLOCK
+ **********************/
+
+static struct timespec clock_origin;
+
+static int64_t timespec_ns(const struct timespec *ts)
+{
+    return (int64_t)ts->tv_sec * 1000000000LL + ts->tv_nsec;
+}
+
+void sim_clock_init(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &clock_origin);
+}
+
+int64_t sim_clock_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return timespec_ns(&now) - timespec_ns(&clock_origin);
+}
+
+void sim_sleep_until_ns(int64_t deadline_ns)
+{
+    int64_t abs_ns = deadline_ns + timespec_ns(&clock_origin);
+    struct timespec ts = {
+        .tv_sec = abs_ns / 1000000000LL,
+        .tv_nsec = abs_ns % 1000000000LL,
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/**********************
+ *  ESP_TIMER
+ **********************/
+
+struct esp_timer {
+    esp_timer_create_args_t args;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool armed;
+    bool periodic;
+    uint64_t period_us;
+    int64_t deadline_ns;
+    uint32_t generation;
+};
+
+int64_t esp_timer_get_time(void)
+{
+    return sim_clock_ns() / 1000;
+}
+
+static void *timer_thread(void *p)
+{
+    struct esp_timer *timer = p;
+    pthread_mutex_lock(&timer->lock);
+    while (1) {
+        while (!timer->armed) {
+            pthread_cond_wait(&timer->cond, &timer->lock);
+        }
+        uint32_t generation = timer->generation;
+        int64_t deadline = timer->deadline_ns;
+        pthread_mutex_unlock(&timer->lock);
+        sim_sleep_until_ns(deadline);
+        pthread_mutex_lock(&timer->lock);
+        if (!timer->armed || generation != timer->generation) {
+            continue;   // stopped or restarted while sleeping
+        }
+        if (timer->periodic) {
+            timer->deadline_ns += (int64_t)timer->period_us * 1000;
+        } else {
+            timer->armed = false;
+        }
+        pthread_mutex_unlock(&timer->lock);
+        timer->args.callback(timer->args.arg);
+        pthread_mutex_lock(&timer->lock);
+    }
+    return NULL;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct esp_timer *timer = calloc(1, sizeof(struct esp_timer));
+    if (timer == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->args = *create_args;
+    pthread_mutex_init(&timer->lock, NULL);
+    pthread_cond_init(&timer->cond, NULL);
+    if (pthread_create(&timer->thread, NULL, timer_thread, timer) != 0) {
+        free(timer);
+        return ESP_ERR_NO_MEM;
+    }
+    pthread_detach(timer->thread);
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+static esp_err_t timer_arm(esp_timer_handle_t timer, uint64_t timeout_us, bool periodic)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&timer->lock);
+    timer->armed = true;
+    timer->periodic = periodic;
+    timer->period_us = timeout_us;
+    timer->deadline_ns = sim_clock_ns() + (int64_t)timeout_us * 1000;
+    timer->generation++;
+    pthread_cond_signal(&timer->cond);
+    pthread_mutex_unlock(&timer->lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return timer_arm(timer, timeout_us, false);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    return timer_arm(timer, period, true);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&timer->lock);
+    bool was_armed = timer->armed;
+    timer->armed = false;
+    timer->generation++;
+    pthread_mutex_unlock(&timer->lock);
+    return was_armed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_timer_stop(timer);
+    pthread_cancel(timer->thread);
+    return ESP_OK;
+}
+
+/**********************
+ *  ERRORS AND LOGGING
+ **********************/
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                return "ESP_OK";
+    case ESP_FAIL:              return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+    default:                    return "UNKNOWN ERROR";
+    }
+}
+
+static esp_log_level_t log_level = ESP_LOG_INFO;
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    /* Per-tag levels are not modelled, "*" sets the global level */
+    if (tag && tag[0] == '*') {
+        log_level = level;
+    }
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+    if (level > log_level) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "%c (%lld) %s: ", letters[level], (long long)(esp_timer_get_time() / 1000), tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+/**********************
+ *  GPIO / LEDC / SPI
+ **********************/
+
+esp_err_t gpio_config(const gpio_config_t *pGPIOConfig)
+{
+    return pGPIOConfig ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    (void)gpio_num;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    (void)gpio_num;
+    (void)level;
+    return ESP_OK;
+}
+
+static uint32_t ledc_duty[LEDC_CHANNEL_3 + 1];
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *timer_conf)
+{
+    return timer_conf ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *ledc_conf)
+{
+    if (ledc_conf == NULL || ledc_conf->channel > LEDC_CHANNEL_3) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ledc_duty[ledc_conf->channel] = ledc_conf->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty)
+{
+    (void)speed_mode;
+    if (channel > LEDC_CHANNEL_3) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ledc_duty[channel] = duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    (void)speed_mode;
+    return channel > LEDC_CHANNEL_3 ? ESP_ERR_INVALID_ARG : ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    (void)speed_mode;
+    return channel > LEDC_CHANNEL_3 ? 0 : ledc_duty[channel];
+}
+
+static int spi_max_transfer_sz[SPI3_HOST + 1];
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config, spi_common_dma_t dma_chan)
+{
+    (void)dma_chan;
+    if (bus_config == NULL || host_id > SPI3_HOST) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (spi_max_transfer_sz[host_id]) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    /* 4092 bytes is the IDF default when max_transfer_sz is left at 0 */
+    spi_max_transfer_sz[host_id] = bus_config->max_transfer_sz > 0 ? bus_config->max_transfer_sz : 4092;
+    return ESP_OK;
+}
+
+int sim_spi_bus_max_transfer_sz(spi_host_device_t host_id)
+{
+    return host_id > SPI3_HOST ? 0 : spi_max_transfer_sz[host_id];
+}
+
+/**********************
+ *  PARTITIONS
+ **********************/
+
+/* flash_test in partitions.csv: right after the 2 MB factory app */
+static const esp_partition_t asset_partition = {
+    .type = ESP_PARTITION_TYPE_DATA,
+    .subtype = (esp_partition_subtype_t)0x40,
+    .address = 0x210000,
+    .size = 528 * 1024,
+    .label = "flash_test",
+};
+static uint8_t *asset_flash;
+
+static uint8_t *asset_flash_get(void)
+{
+    if (asset_flash == NULL) {
+        /* Flash is mapped in 64 KB MMU pages */
+        asset_flash = aligned_alloc(65536, asset_partition.size);
+        if (asset_flash) {
+            memset(asset_flash, 0xFF, asset_partition.size);
+        }
+    }
+    return asset_flash;
+}
+
+bool sim_flash_load_assets(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *flash = asset_flash_get();
+    if (f == NULL || flash == NULL) {
+        if (f) {
+            fclose(f);
+        }
+        return false;
+    }
+    size_t n = fread(flash, 1, asset_partition.size, f);
+    bool fits = n > 0 && fgetc(f) == EOF;
+    fclose(f);
+    return fits;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label)
+{
+    if (type != asset_partition.type || (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != asset_partition.subtype) ||
+        (label && strcmp(label, asset_partition.label) != 0)) {
+        return NULL;
+    }
+    return &asset_partition;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr, esp_partition_mmap_handle_t *out_handle)
+{
+    (void)memory;
+    uint8_t *flash = asset_flash_get();
+    if (partition != &asset_partition || offset > partition->size || size > partition->size - offset) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (flash == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    *out_ptr = flash + offset;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+    (void)handle;
+}
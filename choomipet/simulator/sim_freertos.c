@@ -0,0 +1,328 @@
+/**
+ * @file sim_freertos.c
+ * FreeRTOS task, queue and semaphore API on top of host threads.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "sim.h"
+
+struct sim_task {
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *arg;
+    char name[16];
+    pthread_mutex_t notify_lock;
+    pthread_cond_t notify_cond;
+    uint32_t notify_count;
+};
+
+static __thread struct sim_task *current_task;
+
+static void *task_entry(void *p)
+{
+    struct sim_task *task = p;
+    current_task = task;
+    task->fn(task->arg);
+    /* A FreeRTOS task must never return, but end the thread cleanly if it does */
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char *const pcName, const uint32_t usStackDepth,
+                       void *const pvParameters, UBaseType_t uxPriority, TaskHandle_t *const pxCreatedTask)
+{
+    (void)usStackDepth;
+    (void)uxPriority;
+    struct sim_task *task = calloc(1, sizeof(struct sim_task));
+    if (task == NULL) {
+        return pdFAIL;
+    }
+    task->fn = pxTaskCode;
+    task->arg = pvParameters;
+    strncpy(task->name, pcName ? pcName : "", sizeof(task->name) - 1);
+    pthread_mutex_init(&task->notify_lock, NULL);
+    pthread_cond_init(&task->notify_cond, NULL);
+    if (pthread_create(&task->thread, NULL, task_entry, task) != 0) {
+        free(task);
+        return pdFAIL;
+    }
+    pthread_detach(task->thread);
+    if (pxCreatedTask) {
+        *pxCreatedTask = task;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+    if (xTaskToDelete == NULL || xTaskToDelete == current_task) {
+        pthread_exit(NULL);
+    }
+    pthread_cancel(xTaskToDelete->thread);
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    sim_task_yield_hook();
+    sim_sleep_until_ns(sim_clock_ns() + (int64_t)xTicksToDelay * portTICK_PERIOD_MS * 1000000LL);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(sim_clock_ns() / (portTICK_PERIOD_MS * 1000000LL));
+}
+
+char *pcTaskGetName(TaskHandle_t xTaskToQuery)
+{
+    static char main_name[] = "main";
+    struct sim_task *task = xTaskToQuery ? xTaskToQuery : current_task;
+    return task ? task->name : main_name;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return current_task;
+}
+
+static void deadline_from_ticks(struct timespec *ts, TickType_t ticks)
+{
+    clock_gettime(CLOCK_REALTIME, ts);
+    int64_t ns = ts->tv_nsec + (int64_t)ticks * portTICK_PERIOD_MS * 1000000LL;
+    ts->tv_sec += ns / 1000000000LL;
+    ts->tv_nsec = ns % 1000000000LL;
+}
+
+/**********************
+ *  NOTIFICATIONS
+ **********************/
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    struct sim_task *task = current_task;
+    struct timespec deadline;
+    if (task == NULL) {
+        return 0;
+    }
+    sim_task_yield_hook();
+    deadline_from_ticks(&deadline, xTicksToWait == portMAX_DELAY ? 0 : xTicksToWait);
+    pthread_mutex_lock(&task->notify_lock);
+    while (task->notify_count == 0 && xTicksToWait != 0) {
+        if (xTicksToWait == portMAX_DELAY) {
+            pthread_cond_wait(&task->notify_cond, &task->notify_lock);
+        } else if (pthread_cond_timedwait(&task->notify_cond, &task->notify_lock, &deadline) != 0) {
+            break;
+        }
+    }
+    uint32_t count = task->notify_count;
+    if (count) {
+        task->notify_count = xClearCountOnExit ? 0 : count - 1;
+    }
+    pthread_mutex_unlock(&task->notify_lock);
+    sim_task_yield_hook();
+    return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    pthread_mutex_lock(&xTaskToNotify->notify_lock);
+    xTaskToNotify->notify_count++;
+    pthread_cond_signal(&xTaskToNotify->notify_cond);
+    pthread_mutex_unlock(&xTaskToNotify->notify_lock);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (pxHigherPriorityTaskWoken) {
+        *pxHigherPriorityTaskWoken = pdFALSE;
+    }
+    xTaskNotifyGive(xTaskToNotify);
+}
+
+/**********************
+ *  QUEUES
+ **********************/
+
+struct sim_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t *storage;
+    pthread_t holder;           // recursive mutex: the thread holding it `depth` times
+    UBaseType_t depth;
+};
+
+/* Waits on the queue condition, returns false once the tick budget is spent */
+static bool queue_wait(struct sim_queue *q, TickType_t ticks, const struct timespec *deadline)
+{
+    if (ticks == 0) {
+        return false;
+    }
+    if (ticks == portMAX_DELAY) {
+        pthread_cond_wait(&q->cond, &q->lock);
+        return true;
+    }
+    return pthread_cond_timedwait(&q->cond, &q->lock, deadline) == 0;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
+{
+    struct sim_queue *q = calloc(1, sizeof(struct sim_queue));
+    if (q == NULL || uxQueueLength == 0) {
+        free(q);
+        return NULL;
+    }
+    q->storage = uxItemSize ? calloc(uxQueueLength, uxItemSize) : NULL;
+    if (uxItemSize && q->storage == NULL) {
+        free(q);
+        return NULL;
+    }
+    q->length = uxQueueLength;
+    q->item_size = uxItemSize;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->cond, NULL);
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t xQueue)
+{
+    if (xQueue) {
+        free(xQueue->storage);
+        free(xQueue);
+    }
+}
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait)
+{
+    struct timespec deadline;
+    deadline_from_ticks(&deadline, xTicksToWait == portMAX_DELAY ? 0 : xTicksToWait);
+    pthread_mutex_lock(&xQueue->lock);
+    while (xQueue->count == xQueue->length) {
+        if (!queue_wait(xQueue, xTicksToWait, &deadline)) {
+            pthread_mutex_unlock(&xQueue->lock);
+            return pdFAIL;
+        }
+    }
+    if (xQueue->item_size) {
+        UBaseType_t slot = (xQueue->head + xQueue->count) % xQueue->length;
+        memcpy(xQueue->storage + slot * xQueue->item_size, pvItemToQueue, xQueue->item_size);
+    }
+    xQueue->count++;
+    pthread_cond_broadcast(&xQueue->cond);
+    pthread_mutex_unlock(&xQueue->lock);
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (pxHigherPriorityTaskWoken) {
+        *pxHigherPriorityTaskWoken = pdFALSE;
+    }
+    return xQueueSend(xQueue, pvItemToQueue, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+    struct timespec deadline;
+    deadline_from_ticks(&deadline, xTicksToWait == portMAX_DELAY ? 0 : xTicksToWait);
+    pthread_mutex_lock(&xQueue->lock);
+    while (xQueue->count == 0) {
+        if (!queue_wait(xQueue, xTicksToWait, &deadline)) {
+            pthread_mutex_unlock(&xQueue->lock);
+            return pdFAIL;
+        }
+    }
+    if (xQueue->item_size && pvBuffer) {
+        memcpy(pvBuffer, xQueue->storage + xQueue->head * xQueue->item_size, xQueue->item_size);
+    }
+    xQueue->head = (xQueue->head + 1) % xQueue->length;
+    xQueue->count--;
+    pthread_cond_broadcast(&xQueue->cond);
+    pthread_mutex_unlock(&xQueue->lock);
+    return pdPASS;
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue)
+{
+    pthread_mutex_lock(&xQueue->lock);
+    xQueue->head = 0;
+    xQueue->count = 0;
+    pthread_cond_broadcast(&xQueue->cond);
+    pthread_mutex_unlock(&xQueue->lock);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue)
+{
+    pthread_mutex_lock(&xQueue->lock);
+    UBaseType_t count = xQueue->count;
+    pthread_mutex_unlock(&xQueue->lock);
+    return count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(const QueueHandle_t xQueue)
+{
+    pthread_mutex_lock(&xQueue->lock);
+    UBaseType_t spaces = xQueue->length - xQueue->count;
+    pthread_mutex_unlock(&xQueue->lock);
+    return spaces;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount)
+{
+    QueueHandle_t q = xQueueCreate(uxMaxCount, 0);
+    if (q) {
+        q->count = uxInitialCount > uxMaxCount ? uxMaxCount : uxInitialCount;
+    }
+    return q;
+}
+
+/* A semaphore of one that the thread holding it may take again */
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return xSemaphoreCreateCounting(1, 1);
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t xMutex, TickType_t xTicksToWait)
+{
+    struct timespec deadline;
+    deadline_from_ticks(&deadline, xTicksToWait == portMAX_DELAY ? 0 : xTicksToWait);
+    pthread_mutex_lock(&xMutex->lock);
+    if (xMutex->depth == 0 || !pthread_equal(xMutex->holder, pthread_self())) {
+        while (xMutex->count == 0) {
+            if (!queue_wait(xMutex, xTicksToWait, &deadline)) {
+                pthread_mutex_unlock(&xMutex->lock);
+                return pdFAIL;
+            }
+        }
+        xMutex->count--;
+        xMutex->holder = pthread_self();
+    }
+    xMutex->depth++;
+    pthread_mutex_unlock(&xMutex->lock);
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t xMutex)
+{
+    pthread_mutex_lock(&xMutex->lock);
+    if (xMutex->depth == 0 || !pthread_equal(xMutex->holder, pthread_self())) {
+        pthread_mutex_unlock(&xMutex->lock);
+        return pdFAIL;
+    }
+    if (--xMutex->depth == 0) {
+        xMutex->count++;
+        pthread_cond_broadcast(&xMutex->cond);
+    }
+    pthread_mutex_unlock(&xMutex->lock);
+    return pdPASS;
+}
@@ -0,0 +1,516 @@
+/**
+ * @file sim_lcd_panel_io.c
+ * Recording SPI panel IO and ST7789 frame memory model.
+ *
+ * Every command, parameter and pixel byte handed to the IO is charged to a
+ * simulated SPI bus running at the configured pclk_hz. Polled transactions
+ * (tx_param and the command phase of tx_color) block the caller until the bus
+ * has clocked them out; color data is queued like the IDF SPI driver does and
+ * lands in the GRAM model from a separate "DMA" thread once its bus time has
+ * elapsed, which is also when on_color_trans_done fires. A buffer reused
+ * before its completion callback therefore shows up as corrupt pixels, just
+ * as it would on the glass.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_io_interface.h"
+#include "esp_lcd_panel_commands.h"
+#include "esp_log.h"
+#include "driver/spi_master.h"
+#include "sim.h"
+
+#define SIM_DMA_QUEUE_MAX 64
+
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    int64_t done_ns;
+    bool notify;        // last chunk of a tx_color, fires on_color_trans_done
+} sim_dma_trans_t;
+
+typedef struct {
+    esp_lcd_panel_io_t base;
+    unsigned int pclk_hz;
+    size_t queue_depth;
+    size_t cmd_bytes;
+    size_t param_bytes;
+    size_t max_chunk;
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void *user_ctx;
+    pthread_t dma_thread;
+    sim_dma_trans_t queue[SIM_DMA_QUEUE_MAX];
+    size_t q_head;
+    size_t q_count;
+    int64_t bus_free_ns;
+} sim_panel_io_t;
+
+static const char *TAG = "sim_panel_io";
+
+static __thread uint64_t thread_io_wait_ns;
+static pthread_mutex_t sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sim_cond = PTHREAD_COND_INITIALIZER;
+
+static struct {
+    uint32_t px[SIM_GRAM_H][SIM_GRAM_W];
+    int xs, xe, ys, ye;     // address window from CASET / RASET
+    int x, y;               // write pointer
+    uint8_t carry[3];       // bytes of a pixel group split across transactions
+    size_t carry_len;
+    uint32_t nibbles;       // RGB444 bit stream not yet landed in GRAM
+    int nibble_cnt;
+    sim_lcd_stats_t stats;
+} gram = {
+    .xe = SIM_GRAM_W - 1,
+    .ye = SIM_GRAM_H - 1,
+    .stats.colmod = 0x66,   // ST7789 reset default
+    .stats.ramctrl = 0xF0,  // ST7789 reset default: MSB first
+    .stats.vscroll_height = SIM_GRAM_H,
+};
+
+static esp_err_t sim_io_rx_param(esp_lcd_panel_io_t *io, int lcd_cmd, void *param, size_t param_size);
+static esp_err_t sim_io_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size);
+static esp_err_t sim_io_tx_color(esp_lcd_panel_io_t *io, int lcd_cmd, const void *color, size_t color_size);
+static esp_err_t sim_io_del(esp_lcd_panel_io_t *io);
+static esp_err_t sim_io_register_event_callbacks(esp_lcd_panel_io_t *io, const esp_lcd_panel_io_callbacks_t *cbs, void *user_ctx);
+static void *sim_dma_thread(void *arg);
+
+esp_err_t esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus, const esp_lcd_panel_io_spi_config_t *io_config, esp_lcd_panel_io_handle_t *ret_io)
+{
+    if (io_config == NULL || ret_io == NULL || io_config->pclk_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int max_transfer_sz = sim_spi_bus_max_transfer_sz((spi_host_device_t)bus);
+    if (max_transfer_sz <= 0) {
+        ESP_LOGE(TAG, "SPI bus %d not initialized", bus);
+        return ESP_ERR_INVALID_STATE;
+    }
+    sim_panel_io_t *sim_io = calloc(1, sizeof(sim_panel_io_t));
+    if (sim_io == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    sim_io->pclk_hz = io_config->pclk_hz;
+    sim_io->queue_depth = io_config->trans_queue_depth;
+    if (sim_io->queue_depth == 0 || sim_io->queue_depth > SIM_DMA_QUEUE_MAX) {
+        sim_io->queue_depth = SIM_DMA_QUEUE_MAX;
+    }
+    sim_io->cmd_bytes = (size_t)(io_config->lcd_cmd_bits + 7) / 8;
+    sim_io->param_bytes = (size_t)(io_config->lcd_param_bits + 7) / 8;
+    sim_io->max_chunk = (size_t)max_transfer_sz;
+    sim_io->on_color_trans_done = io_config->on_color_trans_done;
+    sim_io->user_ctx = io_config->user_ctx;
+    sim_io->base.rx_param = sim_io_rx_param;
+    sim_io->base.tx_param = sim_io_tx_param;
+    sim_io->base.tx_color = sim_io_tx_color;
+    sim_io->base.del = sim_io_del;
+    sim_io->base.register_event_callbacks = sim_io_register_event_callbacks;
+    if (pthread_create(&sim_io->dma_thread, NULL, sim_dma_thread, sim_io) != 0) {
+        free(sim_io);
+        return ESP_ERR_NO_MEM;
+    }
+    pthread_mutex_lock(&sim_lock);
+    gram.stats.pclk_hz = sim_io->pclk_hz;
+    pthread_mutex_unlock(&sim_lock);
+    *ret_io = &sim_io->base;
+    ESP_LOGD(TAG, "new panel io @%p, %u Hz, queue depth %zu", (void *)sim_io, sim_io->pclk_hz, sim_io->queue_depth);
+    return ESP_OK;
+}
+
+void sim_lcd_get_stats(sim_lcd_stats_t *out)
+{
+    pthread_mutex_lock(&sim_lock);
+    *out = gram.stats;
+    pthread_mutex_unlock(&sim_lock);
+}
+
+uint64_t sim_lcd_thread_io_wait_ns(void)
+{
+    return thread_io_wait_ns;
+}
+
+uint32_t sim_lcd_gram_get_px(int x, int y)
+{
+    if (x < 0 || y < 0 || x >= SIM_GRAM_W || y >= SIM_GRAM_H) {
+        return 0;
+    }
+    pthread_mutex_lock(&sim_lock);
+    uint32_t px = gram.px[y][x];
+    pthread_mutex_unlock(&sim_lock);
+    return px;
+}
+
+uint32_t sim_lcd_glass_get_px(int x, int y)
+{
+    pthread_mutex_lock(&sim_lock);
+    int top = gram.stats.vscroll_top, h = gram.stats.vscroll_height;
+    if (y >= top && y < top + h) {
+        y = top + (y - top + gram.stats.vscroll_start - top) % h;
+    }
+    pthread_mutex_unlock(&sim_lock);
+    return sim_lcd_gram_get_px(x, y);
+}
+
+bool sim_lcd_dump_ppm(const char *path, int x_ofs, int y_ofs, int w, int h)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        return false;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint32_t px = sim_lcd_glass_get_px(x + x_ofs, y + y_ofs);
+            uint8_t rgb[3] = {(uint8_t)(px >> 16), (uint8_t)(px >> 8), (uint8_t)px};
+            fwrite(rgb, 1, sizeof(rgb), f);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+/**********************
+ *  GRAM MODEL
+ *  (sim_lock held)
+ **********************/
+
+static int64_t bus_time_ns(const sim_panel_io_t *sim_io, size_t bytes)
+{
+    return (int64_t)((uint64_t)bytes * 8 * 1000000000ULL / sim_io->pclk_hz);
+}
+
+/* ST7789 vendor command, not in esp_lcd_panel_commands.h */
+#define ST7789_CMD_RAMCTRL      0xB0
+#define ST7789_RAMCTRL_ENDIAN   0x08    // second parameter: 65K pixels sent LSB first
+
+static uint16_t be16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void gram_put_px(uint32_t rgb)
+{
+    if (gram.xs > gram.xe || gram.ys > gram.ye || gram.xe >= SIM_GRAM_W || gram.ye >= SIM_GRAM_H) {
+        gram.stats.protocol_errors++;
+        return;
+    }
+    gram.px[gram.y][gram.x] = rgb;
+    gram.stats.pixels++;
+    if (++gram.x > gram.xe) {
+        gram.x = gram.xs;
+        if (++gram.y > gram.ye) {
+            gram.y = gram.ys;
+        }
+    }
+}
+
+static uint32_t rgb565_to_888(uint16_t c)
+{
+    uint32_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+    return ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+}
+
+static uint32_t rgb444_to_888(uint16_t c)
+{
+    uint32_t r = (c >> 8) & 0xF, g = (c >> 4) & 0xF, b = c & 0xF;
+    return ((r * 0x11) << 16) | ((g * 0x11) << 8) | (b * 0x11);
+}
+
+/* Bytes making up one pixel group on the wire for the current COLMOD */
+static size_t gram_group_bytes(void)
+{
+    switch (gram.stats.colmod & 0x07) {
+    case 0x05: return 2; // RGB565
+    case 0x06: return 3; // RGB666, one byte per component
+    default:   return 0;
+    }
+}
+
+static void gram_put_group(const uint8_t *g)
+{
+    switch (gram.stats.colmod & 0x07) {
+    case 0x05:
+        if (gram.stats.ramctrl & ST7789_RAMCTRL_ENDIAN) {
+            gram_put_px(rgb565_to_888((uint16_t)((g[1] << 8) | g[0])));
+        } else {
+            gram_put_px(rgb565_to_888(be16(g)));
+        }
+        break;
+    case 0x06:
+        gram_put_px(((uint32_t)(g[0] & 0xFC) << 16) | ((uint32_t)(g[1] & 0xFC) << 8) | (g[2] & 0xFC));
+        break;
+    }
+}
+
+static void gram_write(const uint8_t *data, size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    if ((gram.stats.colmod & 0x07) == 0x03) {
+        // RGB444 is a nibble stream: a pixel lands once its 12 bits are in, so odd counts end on half a byte
+        gram.stats.pixel_bytes += size;
+        for (size_t i = 0; i < size; i++) {
+            gram.nibbles = gram.nibbles << 8 | data[i];
+            gram.nibble_cnt += 2;
+            if (gram.nibble_cnt >= 3) {
+                gram.nibble_cnt -= 3;
+                gram_put_px(rgb444_to_888((uint16_t)((gram.nibbles >> (4 * gram.nibble_cnt)) & 0xFFF)));
+            }
+        }
+        return;
+    }
+    size_t group = gram_group_bytes();
+    if (group == 0) {
+        gram.stats.protocol_errors++;
+        return;
+    }
+    gram.stats.pixel_bytes += size;
+    if (gram.carry_len) {
+        size_t n = group - gram.carry_len < size ? group - gram.carry_len : size;
+        memcpy(gram.carry + gram.carry_len, data, n);
+        gram.carry_len += n;
+        data += n;
+        size -= n;
+        if (gram.carry_len < group) {
+            return;
+        }
+        gram_put_group(gram.carry);
+        gram.carry_len = 0;
+    }
+    for (; size >= group; size -= group, data += group) {
+        gram_put_group(data);
+    }
+    memcpy(gram.carry, data, size);
+    gram.carry_len = size;
+}
+
+static void gram_command(int lcd_cmd, const uint8_t *param, size_t param_size)
+{
+    switch (lcd_cmd) {
+    case LCD_CMD_CASET:
+        if (param_size < 4) {
+            gram.stats.protocol_errors++;
+            break;
+        }
+        gram.xs = be16(param);
+        gram.xe = be16(param + 2);
+        break;
+    case LCD_CMD_RASET:
+        if (param_size < 4) {
+            gram.stats.protocol_errors++;
+            break;
+        }
+        gram.ys = be16(param);
+        gram.ye = be16(param + 2);
+        break;
+    case LCD_CMD_RAMWR:
+        gram.stats.ramwr_count++;
+        gram.x = gram.xs;
+        gram.y = gram.ys;
+        gram.carry_len = 0;
+        gram.nibble_cnt = 0;
+        gram_write(param, param_size);
+        break;
+    case LCD_CMD_RAMWRC:
+        gram_write(param, param_size);
+        break;
+    case LCD_CMD_COLMOD:
+        if (param_size >= 1) {
+            gram.stats.colmod = param[0];
+        }
+        break;
+    case LCD_CMD_MADCTL:
+        if (param_size >= 1) {
+            gram.stats.madctl = param[0];
+        }
+        break;
+    case ST7789_CMD_RAMCTRL:
+        if (param_size >= 2) {
+            gram.stats.ramctrl = param[1];
+        }
+        break;
+    case LCD_CMD_VSCRDEF:
+        // top fixed, scrolling and bottom fixed areas must add up to the frame memory height
+        if (param_size < 6 || be16(param + 2) == 0 || be16(param) + be16(param + 2) + be16(param + 4) != SIM_GRAM_H) {
+            gram.stats.protocol_errors++;
+            break;
+        }
+        gram.stats.vscroll_top = be16(param);
+        gram.stats.vscroll_height = be16(param + 2);
+        break;
+    case LCD_CMD_VSCSAD:
+        if (param_size < 2 || be16(param) < gram.stats.vscroll_top ||
+            be16(param) >= gram.stats.vscroll_top + gram.stats.vscroll_height) {
+            gram.stats.protocol_errors++;
+            break;
+        }
+        gram.stats.vscroll_start = be16(param);
+        gram.stats.vscsad_count++;
+        break;
+    default:
+        break;
+    }
+}
+
+/**********************
+ *  PANEL IO
+ **********************/
+
+/* Like the IDF SPI panel IO, a polled transaction first drains the queue */
+static void sim_io_drain(sim_panel_io_t *sim_io)
+{
+    if (sim_io->q_count == 0) {
+        return;
+    }
+    int64_t t0 = sim_clock_ns();
+    while (sim_io->q_count) {
+        pthread_cond_wait(&sim_cond, &sim_lock);
+    }
+    uint64_t waited = (uint64_t)(sim_clock_ns() - t0);
+    gram.stats.io_wait_ns += waited;
+    thread_io_wait_ns += waited;
+}
+
+/* Charge a polled transaction to the bus, returns when it has been clocked out */
+static int64_t sim_io_polled(sim_panel_io_t *sim_io, size_t bytes)
+{
+    int64_t now = sim_clock_ns();
+    int64_t start = sim_io->bus_free_ns > now ? sim_io->bus_free_ns : now;
+    int64_t dur = bus_time_ns(sim_io, bytes);
+    sim_io->bus_free_ns = start + dur;
+    gram.stats.bus_bytes += bytes;
+    gram.stats.bus_busy_ns += (uint64_t)dur;
+    gram.stats.transactions++;
+    return sim_io->bus_free_ns;
+}
+
+/* Polled SPI transactions keep the CPU busy, so spin rather than sleep */
+static void spin_until_ns(int64_t deadline_ns)
+{
+    while (sim_clock_ns() < deadline_ns) {
+    }
+}
+
+static esp_err_t sim_io_rx_param(esp_lcd_panel_io_t *io, int lcd_cmd, void *param, size_t param_size)
+{
+    (void)io;
+    (void)lcd_cmd;
+    (void)param;
+    (void)param_size;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static esp_err_t sim_io_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size)
+{
+    sim_panel_io_t *sim_io = __containerof(io, sim_panel_io_t, base);
+    pthread_mutex_lock(&sim_lock);
+    sim_io_drain(sim_io);
+    size_t bytes = (lcd_cmd >= 0 ? sim_io->cmd_bytes : 0) + param_size * sim_io->param_bytes;
+    int64_t done = sim_io_polled(sim_io, bytes);
+    gram_command(lcd_cmd, param, param_size);
+    pthread_mutex_unlock(&sim_lock);
+    spin_until_ns(done);
+    return ESP_OK;
+}
+
+static esp_err_t sim_io_tx_color(esp_lcd_panel_io_t *io, int lcd_cmd, const void *color, size_t color_size)
+{
+    sim_panel_io_t *sim_io = __containerof(io, sim_panel_io_t, base);
+    const uint8_t *data = color;
+    int64_t cmd_done = 0;
+
+    pthread_mutex_lock(&sim_lock);
+    sim_io_drain(sim_io);
+    if (lcd_cmd >= 0) {
+        cmd_done = sim_io_polled(sim_io, sim_io->cmd_bytes);
+        gram_command(lcd_cmd, NULL, 0);
+    }
+    do {
+        size_t chunk = color_size > sim_io->max_chunk ? sim_io->max_chunk : color_size;
+        if (sim_io->q_count >= sim_io->queue_depth) {
+            int64_t t0 = sim_clock_ns();
+            while (sim_io->q_count >= sim_io->queue_depth) {
+                pthread_cond_wait(&sim_cond, &sim_lock);
+            }
+            uint64_t waited = (uint64_t)(sim_clock_ns() - t0);
+            gram.stats.io_wait_ns += waited;
+            thread_io_wait_ns += waited;
+        }
+        int64_t now = sim_clock_ns();
+        int64_t start = sim_io->bus_free_ns > now ? sim_io->bus_free_ns : now;
+        int64_t dur = bus_time_ns(sim_io, chunk);
+        sim_io->bus_free_ns = start + dur;
+        gram.stats.bus_bytes += chunk;
+        gram.stats.bus_busy_ns += (uint64_t)dur;
+        gram.stats.transactions++;
+
+        sim_dma_trans_t *t = &sim_io->queue[(sim_io->q_head + sim_io->q_count) % SIM_DMA_QUEUE_MAX];
+        t->data = data;
+        t->size = chunk;
+        t->done_ns = sim_io->bus_free_ns;
+        t->notify = chunk == color_size;
+        sim_io->q_count++;
+        pthread_cond_broadcast(&sim_cond);
+
+        data += chunk;
+        color_size -= chunk;
+    } while (color_size);
+    pthread_mutex_unlock(&sim_lock);
+    spin_until_ns(cmd_done);
+    return ESP_OK;
+}
+
+static esp_err_t sim_io_del(esp_lcd_panel_io_t *io)
+{
+    sim_panel_io_t *sim_io = __containerof(io, sim_panel_io_t, base);
+    pthread_mutex_lock(&sim_lock);
+    sim_io_drain(sim_io);
+    pthread_mutex_unlock(&sim_lock);
+    pthread_cancel(sim_io->dma_thread);
+    pthread_join(sim_io->dma_thread, NULL);
+    free(sim_io);
+    return ESP_OK;
+}
+
+static esp_err_t sim_io_register_event_callbacks(esp_lcd_panel_io_t *io, const esp_lcd_panel_io_callbacks_t *cbs, void *user_ctx)
+{
+    sim_panel_io_t *sim_io = __containerof(io, sim_panel_io_t, base);
+    pthread_mutex_lock(&sim_lock);
+    sim_io->on_color_trans_done = cbs->on_color_trans_done;
+    sim_io->user_ctx = user_ctx;
+    pthread_mutex_unlock(&sim_lock);
+    return ESP_OK;
+}
+
+static void *sim_dma_thread(void *arg)
+{
+    sim_panel_io_t *sim_io = arg;
+    esp_lcd_panel_io_event_data_t edata = {0};
+
+    pthread_mutex_lock(&sim_lock);
+    while (1) {
+        while (sim_io->q_count == 0) {
+            pthread_cond_wait(&sim_cond, &sim_lock);
+        }
+        sim_dma_trans_t t = sim_io->queue[sim_io->q_head];
+        pthread_mutex_unlock(&sim_lock);
+        sim_sleep_until_ns(t.done_ns);
+        pthread_mutex_lock(&sim_lock);
+
+        gram_write(t.data, t.size);
+        sim_io->q_head = (sim_io->q_head + 1) % SIM_DMA_QUEUE_MAX;
+        sim_io->q_count--;
+        pthread_cond_broadcast(&sim_cond);
+
+        if (t.notify && sim_io->on_color_trans_done) {
+            esp_lcd_panel_io_color_trans_done_cb_t cb = sim_io->on_color_trans_done;
+            void *user_ctx = sim_io->user_ctx;
+            pthread_mutex_unlock(&sim_lock);
+            cb(&sim_io->base, &edata, user_ctx);
+            pthread_mutex_lock(&sim_lock);
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,625 @@
+/**
+ * @file sim_main.c
+ * Host entry point: boots the firmware's app_main() against the recording
+ * panel IO, drives a display workload and reports frame rate, SPI traffic and
+ * per-frame render time.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "lvgl.h"
+#include "ST7789.h"
+#include "UI_Cmd.h"
+#include "Asset_Pack.h"
+#include "sim.h"
+
+void app_main(void);
+
+typedef enum {
+    SIM_SCENARIO_STATIC,        // the firmware UI as is, renders once
+    SIM_SCENARIO_FULLSCREEN,    // whole screen invalidated every refresh period
+    SIM_SCENARIO_BOUNCE,        // the pet image moves around the screen
+    SIM_SCENARIO_SCROLL,        // a full-width message list scrolls up and down
+    SIM_SCENARIO_IDLE,          // the pet blinks while its whole bounding box is redrawn every period
+    SIM_SCENARIO_TAP,           // a static UI driven by UI commands another task posts in bursts
+    SIM_SCENARIO_ANIM,          // the pet slides left and right with an lv_anim at a constant speed
+} sim_scenario_t;
+
+typedef enum {
+    SIM_PHASE_RUN,              // scenario running
+    SIM_PHASE_STOP,             // main() asks the app task to stop the scenario and flush
+    SIM_PHASE_STOPPED,
+    SIM_PHASE_REDRAW,           // main() asks the app task to redraw the whole screen
+    SIM_PHASE_REDRAWN,
+} sim_phase_t;
+
+static const char *const scenario_names[] = {
+    [SIM_SCENARIO_STATIC] = "static",
+    [SIM_SCENARIO_FULLSCREEN] = "fullscreen",
+    [SIM_SCENARIO_BOUNCE] = "bounce",
+    [SIM_SCENARIO_SCROLL] = "scroll",
+    [SIM_SCENARIO_IDLE] = "idle",
+    [SIM_SCENARIO_TAP] = "tap",
+    [SIM_SCENARIO_ANIM] = "anim",
+};
+
+// anim scenario: 120 px/s, a whole number of pixels per paced frame at every divisor of 60 Hz
+#define SIM_ANIM_RANGE      60
+#define SIM_ANIM_TIME       1000
+
+static struct {
+    sim_scenario_t scenario;
+    double seconds;
+    const char *dump_path;
+    const char *assets_path;
+    bool verbose;
+} opts = {
+    .scenario = SIM_SCENARIO_FULLSCREEN,
+    .seconds = 3.0,
+};
+
+/* Written by the app task, read by main() for the report */
+static pthread_mutex_t frame_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct {
+    bool installed;
+    lv_timer_cb_t refr_timer_cb;
+    int64_t blocked_ns_cur;     // LVGL waiting for flush_ready in the current refresh
+    uint32_t frames;
+    int64_t first_frame_ns;
+    int64_t frame_ns_sum;
+    int64_t frame_ns_max;
+    int64_t blocked_ns_sum;
+    sim_lcd_stats_t lcd_at_first_frame;
+    // anim scenario: how far the pet moved in each frame compared to the paced frame period
+    lv_coord_t anim_x;
+    int anim_dir;
+    uint32_t anim_period_us;    // paced period the next frame is due after
+    uint32_t anim_rate_changes;
+    uint32_t anim_dropped;
+    uint32_t anim_steps;
+    uint32_t anim_steps_even;
+} frames;
+
+/* Hand-over between main() and the app task, under frame_lock; main() wakes LVGL_Run() after each request */
+static struct {
+    sim_phase_t phase;
+    lv_timer_t *scenario_timer;     // app task only
+} control;
+
+/* Glass snapshots taken by main() for the redraw check */
+static uint32_t glass_before[EXAMPLE_LCD_V_RES][EXAMPLE_LCD_H_RES];
+static uint32_t glass_after[EXAMPLE_LCD_V_RES][EXAMPLE_LCD_H_RES];
+
+/**********************
+ *  INSTRUMENTATION
+ **********************/
+
+static void sim_wait_cb(lv_disp_drv_t *drv)
+{
+    (void)drv;
+    int64_t t0 = sim_clock_ns();
+    sim_sleep_until_ns(t0 + 20000);
+    frames.blocked_ns_cur += sim_clock_ns() - t0;
+}
+
+/*
+ * The animation is stepped to the paced frame times, so between two frames the
+ * pet must move by the animation's speed times the paced period (+-1 px of
+ * rounding), however late the refresh timer actually ran. Turns and frames
+ * after a rate change or dropped slots are not counted.
+ */
+static void sim_anim_check_step(lv_obj_t *img)
+{
+    lv_refr_pacing_t pacing;
+    lv_refr_get_pacing(NULL, &pacing);
+    lv_coord_t x = img->coords.x1;
+    lv_coord_t dx = x - frames.anim_x;
+    int dir = dx > 0 ? 1 : dx < 0 ? -1 : 0;
+    if (frames.anim_dir != 0 && dir == frames.anim_dir && frames.anim_period_us != 0) {
+        int32_t expected = (int32_t)(((int64_t)2 * SIM_ANIM_RANGE * frames.anim_period_us + SIM_ANIM_TIME * 500) / (SIM_ANIM_TIME * 1000));
+        frames.anim_steps++;
+        if (LV_ABS(LV_ABS(dx) - expected) <= 1) {
+            frames.anim_steps_even++;
+        }
+    }
+    bool skip = pacing.rate_changes != frames.anim_rate_changes || pacing.dropped != frames.anim_dropped;
+    frames.anim_x = x;
+    frames.anim_dir = dir;
+    frames.anim_period_us = skip ? 0 : pacing.period_us;
+    frames.anim_rate_changes = pacing.rate_changes;
+    frames.anim_dropped = pacing.dropped;
+}
+
+static void sim_anim_x(void *obj, int32_t v)
+{
+    lv_obj_set_x(obj, (lv_coord_t)v);
+}
+
+static void scenario_anim_create(lv_obj_t *img)
+{
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, img);
+    lv_anim_set_exec_cb(&a, sim_anim_x);
+    lv_anim_set_values(&a, -SIM_ANIM_RANGE, SIM_ANIM_RANGE);
+    lv_anim_set_time(&a, SIM_ANIM_TIME);
+    lv_anim_set_playback_time(&a, SIM_ANIM_TIME);
+    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_start(&a);
+}
+
+/* Wraps _lv_disp_refr_timer() to time each refresh that put pixels on the bus */
+static void sim_refr_timer_cb(lv_timer_t *timer)
+{
+    sim_lcd_stats_t before;
+    lvgl_flush_stats_t flush_before, flush_after;
+    sim_lcd_get_stats(&before);
+    LVGL_Get_Flush_Stats(&flush_before);
+    uint64_t io_wait_before = sim_lcd_thread_io_wait_ns();
+    frames.blocked_ns_cur = 0;
+    int64_t t0 = sim_clock_ns();
+
+    frames.refr_timer_cb(timer);
+
+    int64_t t1 = sim_clock_ns();
+    LVGL_Get_Flush_Stats(&flush_after);
+    if (flush_after.bands == flush_before.bands) {
+        return;
+    }
+    int64_t frame_ns = t1 - t0;
+    int64_t blocked_ns = frames.blocked_ns_cur + (int64_t)(sim_lcd_thread_io_wait_ns() - io_wait_before) +
+                         (int64_t)(flush_after.blocked_us - flush_before.blocked_us) * 1000;
+
+    pthread_mutex_lock(&frame_lock);
+    if (frames.frames == 0) {
+        frames.first_frame_ns = t0;
+        frames.lcd_at_first_frame = before;
+    }
+    frames.frames++;
+    frames.frame_ns_sum += frame_ns;
+    frames.blocked_ns_sum += blocked_ns;
+    if (frame_ns > frames.frame_ns_max) {
+        frames.frame_ns_max = frame_ns;
+    }
+    pthread_mutex_unlock(&frame_lock);
+
+    if (opts.scenario == SIM_SCENARIO_ANIM) {
+        sim_anim_check_step(lv_obj_get_child(lv_scr_act(), 0));
+    }
+}
+
+static void scenario_fullscreen_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    lv_obj_invalidate(lv_scr_act());
+}
+
+static void scenario_bounce_cb(lv_timer_t *timer)
+{
+    static lv_coord_t dx = 3, dy = 5;
+    lv_obj_t *img = timer->user_data;
+    lv_coord_t max_x = (EXAMPLE_LCD_H_RES - lv_obj_get_width(img)) / 2;
+    lv_coord_t max_y = (EXAMPLE_LCD_V_RES - lv_obj_get_height(img)) / 2;
+    lv_coord_t x = lv_obj_get_x_aligned(img) + dx;
+    lv_coord_t y = lv_obj_get_y_aligned(img) + dy;
+    if (x < -max_x || x > max_x) {
+        dx = -dx;
+    }
+    if (y < -max_y || y > max_y) {
+        dy = -dy;
+    }
+    lv_obj_set_pos(img, LV_CLAMP(-max_x, x, max_x), LV_CLAMP(-max_y, y, max_y));
+}
+
+static void scenario_scroll_cb(lv_timer_t *timer)
+{
+    static lv_coord_t dy = -4;
+    lv_obj_t *list = timer->user_data;
+    if ((dy < 0 && lv_obj_get_scroll_bottom(list) <= 0) || (dy > 0 && lv_obj_get_scroll_top(list) <= 0)) {
+        dy = -dy;
+    }
+    lv_obj_scroll_by_bounded(list, 0, dy, LV_ANIM_OFF);
+}
+
+/* A chat-like message list spanning the full width, plain enough for hardware scrolling */
+static lv_obj_t *scenario_scroll_create(void)
+{
+    static const char *const moods[] = {"hungry", "sleepy", "happy", "bored"};
+    lv_obj_t *list = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(list, EXAMPLE_LCD_H_RES, 220);
+    lv_obj_center(list);
+    lv_obj_set_style_radius(list, 0, 0);
+    lv_obj_set_style_border_width(list, 0, 0);
+    lv_obj_set_flex_flow(list, LV_FLEX_FLOW_COLUMN);
+    for (int i = 0; i < 24; i++) {
+        lv_obj_t *msg = lv_label_create(list);
+        lv_label_set_text_fmt(msg, "#%02d Jiumi is %s", i, moods[i % 4]);
+        if (i % 3 == 0) {
+            lv_obj_set_style_text_color(msg, lv_palette_main(LV_PALETTE_RED), 0);
+        }
+    }
+    return list;
+}
+
+/*
+ * Idle pet: an animation that invalidates the pet's whole bounding box every
+ * period (as a breathing zoom would) while only its eyes blink now and then.
+ */
+static void scenario_idle_cb(lv_timer_t *timer)
+{
+    static uint32_t period;
+    lv_obj_t *eyes = timer->user_data;
+    lv_obj_t *img = lv_obj_get_child(lv_scr_act(), 0);
+    lv_area_t box = img->coords;
+    lv_area_increase(&box, 16, 16);
+    lv_obj_invalidate_area(lv_scr_act(), &box);
+    if (++period % 8 == 0) {
+        if (lv_obj_has_flag(eyes, LV_OBJ_FLAG_HIDDEN)) {
+            lv_obj_clear_flag(eyes, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(eyes, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
+
+static lv_obj_t *scenario_idle_create(void)
+{
+    lv_obj_t *eyes = lv_obj_create(lv_scr_act());
+    lv_obj_remove_style_all(eyes);
+    lv_obj_set_size(eyes, 24, 3);
+    lv_obj_set_style_bg_opa(eyes, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(eyes, lv_color_black(), 0);
+    lv_obj_align(eyes, LV_ALIGN_CENTER, 0, -8);
+    lv_obj_add_flag(eyes, LV_OBJ_FLAG_HIDDEN);
+    return eyes;
+}
+
+/* Acts on main()'s requests for the redraw check */
+static void sim_control(void)
+{
+    pthread_mutex_lock(&frame_lock);
+    sim_phase_t phase = control.phase;
+    pthread_mutex_unlock(&frame_lock);
+
+    if (phase == SIM_PHASE_STOP) {
+        if (control.scenario_timer) {
+            lv_timer_del(control.scenario_timer);
+            control.scenario_timer = NULL;
+        }
+        lv_refr_now(NULL);
+        phase = SIM_PHASE_STOPPED;
+    } else if (phase == SIM_PHASE_REDRAW) {
+        LVGL_Flush_Reset_Shadow();
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+        phase = SIM_PHASE_REDRAWN;
+    } else {
+        return;
+    }
+    pthread_mutex_lock(&frame_lock);
+    control.phase = phase;
+    pthread_mutex_unlock(&frame_lock);
+}
+
+/* Runs on the app task whenever LVGL_Run() blocks or wakes up, once its UI is up, so LVGL is only touched from that thread */
+void sim_task_yield_hook(void)
+{
+    if (strcmp(pcTaskGetName(NULL), "app_task") != 0 || !lv_is_initialized() || lv_disp_get_default() == NULL) {
+        return;
+    }
+    if (frames.installed) {
+        sim_control();
+        return;
+    }
+    frames.installed = true;
+
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_timer_t *refr_timer = _lv_disp_get_refr_timer(disp);
+    frames.refr_timer_cb = refr_timer->timer_cb;
+    refr_timer->timer_cb = sim_refr_timer_cb;
+    if (disp->driver->wait_cb == NULL) {
+        disp->driver->wait_cb = sim_wait_cb;
+    }
+
+    switch (opts.scenario) {
+    case SIM_SCENARIO_FULLSCREEN:
+        lv_timer_create(scenario_fullscreen_cb, LV_DISP_DEF_REFR_PERIOD, NULL);
+        break;
+    case SIM_SCENARIO_BOUNCE:
+        lv_timer_create(scenario_bounce_cb, LV_DISP_DEF_REFR_PERIOD, lv_obj_get_child(lv_scr_act(), 0));
+        break;
+    case SIM_SCENARIO_SCROLL:
+        control.scenario_timer = lv_timer_create(scenario_scroll_cb, LV_DISP_DEF_REFR_PERIOD, scenario_scroll_create());
+        break;
+    case SIM_SCENARIO_IDLE:
+        control.scenario_timer = lv_timer_create(scenario_idle_cb, LV_DISP_DEF_REFR_PERIOD, scenario_idle_create());
+        break;
+    case SIM_SCENARIO_ANIM:
+        scenario_anim_create(lv_obj_get_child(lv_scr_act(), 0));
+        break;
+    case SIM_SCENARIO_TAP:
+    case SIM_SCENARIO_STATIC:
+        break;
+    }
+    // LVGL_Run() drew the first frame before blocking for the first time: draw it again, measured
+    lv_obj_invalidate(lv_scr_act());
+    LVGL_Wakeup();
+}
+
+/**********************
+ *  REPORT
+ **********************/
+
+/*
+ * The firmware UI's first child is jiumi_img. Compare its top-left source pixel with
+ * what reached GRAM, at the precision of the bus format, to catch byte order and
+ * packing mistakes end to end. Only meaningful while the image stays put, i.e. not
+ * in the bounce scenario.
+ */
+static bool check_img_px(uint32_t *expected, uint32_t *got)
+{
+    lv_obj_t *img = lv_obj_get_child(lv_scr_act(), 0);
+    if (img == NULL || !lv_obj_check_type(img, &lv_img_class) || lv_img_src_get_type(lv_img_get_src(img)) != LV_IMG_SRC_VARIABLE) {
+        return true;
+    }
+    lv_color_t c = lv_img_buf_get_px_color((lv_img_dsc_t *)lv_img_get_src(img), 0, 0, lv_color_black());
+    sim_lcd_stats_t lcd;
+    sim_lcd_get_stats(&lcd);
+    uint32_t mask = (lcd.colmod & 0x07) == 0x03 ? 0xF0F0F0 : 0xF8FCF8;
+    *expected = ((uint32_t)LV_COLOR_GET_R(c) << 19 | (uint32_t)LV_COLOR_GET_G(c) << 10 | (uint32_t)LV_COLOR_GET_B(c) << 3) & mask;
+    *got = sim_lcd_glass_get_px(img->coords.x1 + Offset_X, img->coords.y1 + Offset_Y) & mask;
+    return *expected == *got;
+}
+
+static int report(void)
+{
+    sim_lcd_stats_t lcd;
+    lvgl_flush_stats_t flush;
+    lvgl_loop_stats_t loop;
+    ui_cmd_stats_t cmds;
+    int64_t now = sim_clock_ns();
+    sim_lcd_get_stats(&lcd);
+    LVGL_Get_Flush_Stats(&flush);
+    LVGL_Get_Loop_Stats(&loop);
+    UI_Cmd_Get_Stats(&cmds);
+
+    pthread_mutex_lock(&frame_lock);
+    uint32_t n = frames.frames;
+    double elapsed_s = n ? (double)(now - frames.first_frame_ns) / 1e9 : 0.0;
+    uint64_t bytes = lcd.bus_bytes - frames.lcd_at_first_frame.bus_bytes;
+    uint64_t busy_ns = lcd.bus_busy_ns - frames.lcd_at_first_frame.bus_busy_ns;
+    uint32_t trans = lcd.transactions - frames.lcd_at_first_frame.transactions;
+    double frame_ms = n ? (double)frames.frame_ns_sum / n / 1e6 : 0.0;
+    double blocked_ms = n ? (double)frames.blocked_ns_sum / n / 1e6 : 0.0;
+    double frame_max_ms = (double)frames.frame_ns_max / 1e6;
+    pthread_mutex_unlock(&frame_lock);
+
+    double bus_ms_per_frame = n ? (double)busy_ns / n / 1e6 : 0.0;
+    printf("choomipet simulator: scenario %s, %.2f s\n", scenario_names[opts.scenario], elapsed_s);
+    printf("  frames            %u (%.1f fps)\n", n, elapsed_s > 0 ? n / elapsed_s : 0.0);
+    printf("  frame time        avg %.2f ms, max %.2f ms\n", frame_ms, frame_max_ms);
+    printf("  render time       avg %.2f ms/frame (host CPU)\n", frame_ms - blocked_ms);
+    printf("  blocked on flush  avg %.2f ms/frame\n", blocked_ms);
+    printf("  flush pipeline    depth %d, peak %u in flight, %u of %u bands stalled\n",
+           LVGL_FLUSH_QUEUE_DEPTH, flush.max_in_flight, flush.stalls, flush.bands);
+    printf("  spi traffic       %.2f MB, %.1f KB/frame, %u transactions\n",
+           bytes / 1e6, n ? bytes / 1024.0 / n : 0.0, trans);
+    printf("  spi bus           %.1f MHz, busy %.1f %%, %.2f ms/frame -> %.1f fps ceiling\n",
+           lcd.pclk_hz / 1e6, elapsed_s > 0 ? busy_ns / 1e7 / elapsed_s : 0.0,
+           bus_ms_per_frame, bus_ms_per_frame > 0 ? 1000.0 / bus_ms_per_frame : 0.0);
+#if EXAMPLE_LCD_BITS_PER_PIXEL == 12
+    printf("  pixel format      RGB444 packed by the flush task, dither %s, pack %.2f ms/frame\n",
+           LVGL_FLUSH_RGB444_DITHER ? "on" : "off", n ? flush.pack_us / 1e3 / n : 0.0);
+#else
+    printf("  pixel format      RGB565 %s, swap pass %.2f ms/frame\n",
+           LV_COLOR_16_SWAP ? "MSB first (LV_COLOR_16_SWAP 1)" : "LSB first (LV_COLOR_16_SWAP 0)",
+           n ? flush.swap_us / 1e3 / n : 0.0);
+#endif
+#if LVGL_HW_VSCROLL
+    printf("  hw scroll         %u steps moved by the panel, %u VSCSAD, scroll area %u+%u lines\n",
+           flush.vscrolls, lcd.vscsad_count, lcd.vscroll_top, lcd.vscroll_height);
+#else
+    printf("  hw scroll         off (LVGL_HW_VSCROLL 0)\n");
+#endif
+#if LVGL_FLUSH_DIFF
+    printf("  gram diff         %.1f %% of rendered pixels unchanged, %.1f KB/frame saved, %.1f windows/frame, hash %.2f ms/frame\n",
+           flush.diff_px ? 100.0 * flush.diff_skipped_px / flush.diff_px : 0.0,
+           n ? flush.diff_skipped_px * EXAMPLE_LCD_BITS_PER_PIXEL / 8 / 1024.0 / n : 0.0,
+           n ? (double)flush.windows / n : 0.0, n ? flush.diff_us / 1e3 / n : 0.0);
+#else
+    printf("  gram diff         off (LVGL_FLUSH_DIFF 0), %.1f windows/frame\n", n ? (double)flush.windows / n : 0.0);
+#endif
+    printf("  lvgl loop         %.1f wakeups/s, %u by events, event to first pixel avg %.2f ms, max %.2f ms (%u events drawn)\n",
+           loop.wakeups / (now / 1e9), loop.event_wakeups,
+           loop.latency_cnt ? loop.latency_us / 1e3 / loop.latency_cnt : 0.0, loop.latency_max_us / 1e3, loop.latency_cnt);
+    lv_refr_pacing_t pacing;
+    lv_refr_get_pacing(NULL, &pacing);
+    printf("  frame pacing      %u fps (%u of %.1f Hz panel refreshes), %u rate changes, %u slots dropped, jitter avg %.2f ms, max %.2f ms\n",
+           pacing.fps, pacing.div, 1e6 / lv_disp_get_default()->driver->panel_period_us, pacing.rate_changes,
+           pacing.dropped, pacing.jitter_avg_us / 1e3, pacing.jitter_max_us / 1e3);
+    bool anim_ok = true;
+    if (opts.scenario == SIM_SCENARIO_ANIM) {
+        pthread_mutex_lock(&frame_lock);
+        uint32_t steps = frames.anim_steps, even = frames.anim_steps_even;
+        pthread_mutex_unlock(&frame_lock);
+        anim_ok = steps > 0 && even * 10 >= steps * 9;
+        printf("  anim steps        %u of %u frames moved by speed x paced period%s\n", even, steps, anim_ok ? "" : " UNEVEN");
+    }
+    printf("  ui commands       %u posted, %u applied, %u coalesced, %u dropped, at most %u per cycle\n",
+           cmds.posted, cmds.applied, cmds.coalesced, cmds.dropped, cmds.max_pending);
+    lv_obj_t *img = lv_obj_get_child(lv_scr_act(), 0);
+    const lv_img_dsc_t *pack_img = Asset_Get("jiumi");
+    bool from_pack = pack_img && img && lv_img_get_src(img) == pack_img;
+    printf("  assets            %u images in %s, pet image %s\n", Asset_Count(), opts.assets_path ? opts.assets_path : "no pack",
+           from_pack ? "mapped from the pack" : "compiled in");
+    printf("  gram              COLMOD 0x%02X, MADCTL 0x%02X, RAMCTRL %s, %u protocol errors\n",
+           lcd.colmod, lcd.madctl, lcd.ramctrl & 0x08 ? "LSB first" : "MSB first", lcd.protocol_errors);
+
+    bool color_ok = true;
+    if (opts.scenario != SIM_SCENARIO_BOUNCE && opts.scenario != SIM_SCENARIO_SCROLL && opts.scenario != SIM_SCENARIO_TAP &&
+        opts.scenario != SIM_SCENARIO_ANIM) {
+        uint32_t expected = 0, got = 0;
+        color_ok = check_img_px(&expected, &got);
+        printf("  color check       image pixel #%06X, gram #%06X%s\n", (unsigned)expected, (unsigned)got,
+               color_ok ? "" : " MISMATCH");
+    }
+
+    if (opts.dump_path) {
+        if (!sim_lcd_dump_ppm(opts.dump_path, Offset_X, Offset_Y, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES)) {
+            fprintf(stderr, "cannot write %s\n", opts.dump_path);
+            return 1;
+        }
+        printf("  dumped            %s\n", opts.dump_path);
+    }
+    bool events_ok = opts.scenario != SIM_SCENARIO_TAP || (loop.latency_cnt > 0 && cmds.coalesced > 0 && cmds.dropped == 0);
+    bool assets_ok = opts.assets_path == NULL || from_pack;
+    return (n == 0 || lcd.protocol_errors || !color_ok || !events_ok || !assets_ok || !anim_ok) ? 1 : 0;
+}
+
+/* Asks the app task for a step and waits until it is done and the bands have left the bus */
+static void sim_request(sim_phase_t phase, sim_phase_t done)
+{
+    pthread_mutex_lock(&frame_lock);
+    control.phase = phase;
+    while (control.phase != done) {
+        pthread_mutex_unlock(&frame_lock);
+        LVGL_Wakeup();
+        sim_sleep_until_ns(sim_clock_ns() + 1000000);
+        pthread_mutex_lock(&frame_lock);
+    }
+    pthread_mutex_unlock(&frame_lock);
+    sim_sleep_until_ns(sim_clock_ns() + 200000000);
+}
+
+static void sim_snapshot(uint32_t shot[EXAMPLE_LCD_V_RES][EXAMPLE_LCD_H_RES])
+{
+    for (int y = 0; y < EXAMPLE_LCD_V_RES; y++) {
+        for (int x = 0; x < EXAMPLE_LCD_H_RES; x++) {
+            shot[y][x] = sim_lcd_glass_get_px(x + Offset_X, y + Offset_Y);
+        }
+    }
+}
+
+/*
+ * Stops the scenario and compares the glass with a full redraw of the same
+ * screen, sent in full. Content moved by hardware scrolling, remapped bands and
+ * spans skipped by the shadow diff must give exactly the pixels LVGL draws from scratch.
+ */
+static bool redraw_check(void)
+{
+    sim_request(SIM_PHASE_STOP, SIM_PHASE_STOPPED);
+    sim_snapshot(glass_before);
+    sim_request(SIM_PHASE_REDRAW, SIM_PHASE_REDRAWN);
+    sim_snapshot(glass_after);
+
+    uint32_t diff = 0;
+    int first_x = -1, first_y = -1;
+    for (int y = 0; y < EXAMPLE_LCD_V_RES; y++) {
+        for (int x = 0; x < EXAMPLE_LCD_H_RES; x++) {
+            if (glass_before[y][x] != glass_after[y][x]) {
+                if (diff++ == 0) {
+                    first_x = x;
+                    first_y = y;
+                }
+            }
+        }
+    }
+    if (diff) {
+        printf("  redraw check      %u pixels differ from a full redraw, first at %d,%d MISMATCH\n", diff, first_x, first_y);
+    } else {
+        printf("  redraw check      glass matches a full redraw\n");
+    }
+    return diff == 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [--scenario static|fullscreen|bounce|scroll|idle|tap|anim] [--seconds S] [--dump FILE.ppm] [--assets PACK] [--verbose]\n",
+            prog);
+}
+
+static bool parse_args(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--scenario") == 0 && val) {
+            size_t s;
+            for (s = 0; s < sizeof(scenario_names) / sizeof(scenario_names[0]); s++) {
+                if (strcmp(val, scenario_names[s]) == 0) {
+                    break;
+                }
+            }
+            if (s == sizeof(scenario_names) / sizeof(scenario_names[0])) {
+                return false;
+            }
+            opts.scenario = (sim_scenario_t)s;
+            i++;
+        } else if (strcmp(arg, "--seconds") == 0 && val) {
+            opts.seconds = atof(val);
+            i++;
+        } else if (strcmp(arg, "--dump") == 0 && val) {
+            opts.dump_path = val;
+            i++;
+        } else if (strcmp(arg, "--assets") == 0 && val) {
+            opts.assets_path = val;
+            i++;
+        } else if (strcmp(arg, "--verbose") == 0) {
+            opts.verbose = true;
+        } else {
+            return false;
+        }
+    }
+    return opts.seconds > 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (!parse_args(argc, argv)) {
+        usage(argv[0]);
+        return 2;
+    }
+    sim_clock_init();
+    esp_log_level_set("*", opts.verbose ? ESP_LOG_DEBUG : ESP_LOG_WARN);
+    if (opts.assets_path && !sim_flash_load_assets(opts.assets_path)) {
+        fprintf(stderr, "cannot load %s into the flash_test partition\n", opts.assets_path);
+        return 2;
+    }
+
+    app_main();
+    int64_t end = sim_clock_ns() + (int64_t)(opts.seconds * 1e9);
+    if (opts.scenario == SIM_SCENARIO_TAP) {
+        // A network task streaming a reply every 250 ms: growing partial texts and an emotion, then the final text
+        static const char *const words[] = { "Hi", "there,", "I", "missed", "you!" };
+        char text[UI_CMD_TEXT_MAX] = "";
+        int tap = 0;
+        for (int64_t t = sim_clock_ns() + 250000000; t < end; t += 250000000, tap++) {
+            sim_sleep_until_ns(t);
+            text[0] = '\0';
+            for (size_t w = 0; w < sizeof(words) / sizeof(words[0]); w++) {
+                snprintf(text + strlen(text), sizeof(text) - strlen(text), "%s%s", w ? " " : "", words[w]);
+                UI_Show_Text(UI_TARGET_REPLY, text);
+            }
+            UI_Set_Emotion((ui_emotion_t)(tap % UI_EMOTION_MAX));
+            if (tap % 4 == 3) {
+                UI_Start_Anim(tap % 8 == 3 ? UI_ANIM_JUMP : UI_ANIM_SHAKE);
+            }
+        }
+    }
+    sim_sleep_until_ns(end);
+
+    int ret = report();
+    if ((opts.scenario == SIM_SCENARIO_SCROLL || opts.scenario == SIM_SCENARIO_IDLE) && !redraw_check()) {
+        ret = 1;
+    }
+    fflush(stdout);
+    /* The app task never returns, leave without unwinding the other threads */
+    _exit(ret);
+}
@@ -0,0 +1,6 @@
+/*
+ * Host simulator subset of ESP-IDF esp_lcd_panel_vendor.h
+ */
+#pragma once
+
+#include "esp_lcd_types.h"
@@ -0,0 +1,30 @@
+/*
+ * Host simulator subset of ESP-IDF esp_lcd_types.h
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* newlib provides this in sys/cdefs.h, glibc does not */
+#ifndef __containerof
+#define __containerof(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int esp_lcd_spi_bus_handle_t;                       /*!< Type of LCD SPI bus handle */
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t; /*!< Type of LCD panel IO handle */
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;       /*!< Type of LCD panel handle */
+
+typedef enum {
+    LCD_RGB_ENDIAN_RGB = 0, /*!< RGB data endian: RGB */
+    LCD_RGB_ENDIAN_BGR,     /*!< RGB data endian: BGR */
+} lcd_color_rgb_endian_t;
+
+#ifdef __cplusplus
+}
+#endif
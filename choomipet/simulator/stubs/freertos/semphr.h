@@ -0,0 +1,29 @@
+/*
+ * Host simulator subset of FreeRTOS semphr.h. As in FreeRTOS, a semaphore is a
+ * queue of zero-sized items.
+ */
+#pragma once
+
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t xMutex, TickType_t xTicksToWait);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t xMutex);
+
+#define xSemaphoreCreateBinary()                xSemaphoreCreateCounting(1, 0)
+#define vSemaphoreDelete(s)                     vQueueDelete(s)
+#define xSemaphoreTake(s, ticks)                xQueueReceive((s), NULL, (ticks))
+#define xSemaphoreGive(s)                       xQueueSend((s), NULL, 0)
+#define xSemaphoreGiveFromISR(s, woken)         xQueueSendFromISR((s), NULL, (woken))
+#define uxSemaphoreGetCount(s)                  uxQueueMessagesWaiting(s)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,7 @@
+/*
+ * Host simulator stand-in for the ESP-IDF generated sdkconfig.h.
+ * Only the options referenced by the choomipet sources are listed.
+ */
+#pragma once
+
+#define CONFIG_LCD_ENABLE_DEBUG_LOG 0
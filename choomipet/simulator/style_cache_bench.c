@@ -0,0 +1,181 @@
+/**
+ * @file style_cache_bench.c
+ * Redraws the whole pet screen on a headless 172x320 display in every frame,
+ * with and without the style cache (LV_USE_OBJ_STYLE_CACHE), and compares the
+ * style scans (get_prop_core() calls) per frame and the render time (host CPU).
+ * Meanwhile buttons are checked with transitions, local and inherited
+ * properties change and a shared style is changed and reported: every frame
+ * must be identical.
+ */
+
+#include <stdio.h>
+#include "lvgl.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define FRAMES          240
+#define FRAME_MS        17
+
+static lv_style_t shared;
+static lv_obj_t *bubble;
+static lv_obj_t *btns[4];
+static lv_obj_t *sprite;
+
+static lv_obj_t *text(lv_obj_t *parent, lv_coord_t x, lv_coord_t y, const char *txt)
+{
+    lv_obj_t *label = lv_label_create(parent);
+    lv_label_set_text(label, txt);
+    lv_obj_set_pos(label, x, y);
+    return label;
+}
+
+static void sprite_x_cb(void *obj, int32_t v)
+{
+    lv_obj_set_x(obj, (lv_coord_t)v);
+}
+
+/* The pet screen: a status line, a bubble, buttons with labels and a progress bar, with a
+ * sparkle flying over them */
+static void create_scene(lv_obj_t *scr)
+{
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x80C0F0), 0);
+    text(scr, 8, 8, "Jiumi");
+    text(scr, 110, 8, "12:00");
+
+    bubble = lv_obj_create(scr);
+    lv_obj_set_pos(bubble, 6, 34);
+    lv_obj_set_size(bubble, 160, 90);
+    lv_obj_clear_flag(bubble, LV_OBJ_FLAG_SCROLLABLE);
+    text(bubble, 0, 0, "Feed me!\nI am hungry.");
+
+    static const char *const names[] = { "Feed", "Play", "Sleep", "Chat" };
+    for (int i = 0; i < 4; i++) {
+        btns[i] = lv_btn_create(scr);
+        lv_obj_add_style(btns[i], &shared, 0);
+        lv_obj_set_pos(btns[i], 6 + (i % 2) * 84, 140 + (i / 2) * 50);
+        lv_obj_set_size(btns[i], 76, 40);
+        lv_obj_t *label = text(btns[i], 0, 0, names[i]);
+        lv_obj_center(label);
+    }
+
+    lv_obj_t *bar = lv_bar_create(scr);
+    lv_obj_set_pos(bar, 16, 260);
+    lv_obj_set_size(bar, 140, 12);
+    lv_bar_set_value(bar, 70, LV_ANIM_OFF);
+    text(scr, 16, 280, "Hunger 70 %");
+
+    sprite = lv_obj_create(scr);
+    lv_obj_remove_style_all(sprite);
+    lv_obj_set_style_bg_opa(sprite, LV_OPA_70, 0);
+    lv_obj_set_style_bg_color(sprite, lv_color_hex(0xFFF060), 0);
+    lv_obj_set_style_radius(sprite, LV_RADIUS_CIRCLE, 0);
+    lv_obj_set_size(sprite, 24, 24);
+    lv_obj_set_y(sprite, 120);
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, sprite);
+    lv_anim_set_exec_cb(&a, sprite_x_cb);
+    lv_anim_set_values(&a, 0, HOR_RES - 24);
+    lv_anim_set_time(&a, 1000);
+    lv_anim_set_playback_time(&a, 1000);
+    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_start(&a);
+}
+
+/* Changes the scene now and then, the same way in both runs */
+static void change_scene(int f)
+{
+    switch (f % 40) {
+    case 5: // A bg color transition by the theme
+        lv_obj_add_state(btns[f / 40 % 4], LV_STATE_CHECKED);
+        break;
+    case 25:
+        lv_obj_clear_state(btns[f / 40 % 4], LV_STATE_CHECKED);
+        break;
+    case 10: // Inherited by the label of the bubble
+        lv_obj_set_style_text_color(bubble, lv_color_hex(f % 80 ? 0x2040A0 : 0xA02040), 0);
+        break;
+    case 15: // All the buttons use it
+        lv_style_set_bg_color(&shared, lv_color_hex(f % 80 ? 0x40A060 : 0xE08020));
+        lv_obj_report_style_change(&shared);
+        break;
+    case 30:
+        lv_obj_set_style_border_width(bubble, f % 80 ? 4 : 1, 0);
+        break;
+    }
+}
+
+static void run(bool cache, uint32_t *hashes, double *scans, double *ms)
+{
+    lv_obj_enable_style_cache(cache);
+    lv_anim_del_all();
+    lv_obj_clean(lv_scr_act());
+    lv_style_reset(&shared);
+    lv_style_set_radius(&shared, 6);
+    lv_style_set_bg_color(&shared, lv_color_hex(0x40A060));
+
+    // Both runs must animate from the same start: redo it if the tick changed meanwhile
+    uint32_t now;
+    do {
+        now = lv_tick_get();
+        create_scene(lv_scr_act());
+        if (lv_tick_get() != now) {
+            lv_anim_del_all();
+            lv_obj_clean(lv_scr_act());
+        }
+    } while (lv_tick_get() != now);
+    _lv_disp_refr_timer(lv_disp_get_default()->refr_timer);
+
+    uint32_t scan_cnt = 0;
+    int64_t t = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        now += FRAME_MS;
+        change_scene(f);
+        _lv_anim_refr_at(now, FRAME_MS);
+        lv_obj_invalidate(lv_scr_act());
+        uint32_t scans0 = _lv_obj_style_get_scan_cnt();
+        int64_t t0 = sim_clock_ns();
+        // Not lv_refr_now(): it would step the animations by the real tick too
+        _lv_disp_refr_timer(lv_disp_get_default()->refr_timer);
+        t += sim_clock_ns() - t0;
+        scan_cnt += _lv_obj_style_get_scan_cnt() - scans0;
+        hashes[f] = sim_bench_frame_hash();
+    }
+    *scans = (double)scan_cnt / FRAMES;
+    *ms = (double)t / FRAMES / 1e6;
+}
+
+int main(void)
+{
+    static uint32_t reference[FRAMES], hashes[FRAMES];
+    int ret = 0;
+
+    sim_bench_init();
+    lv_style_init(&shared);
+
+    printf("style cache, %dx%d, the whole pet screen redrawn in %d frames (host CPU)\n", HOR_RES, VER_RES,
+           FRAMES);
+    double scans_off, scans_on, ms_off, ms_on;
+    run(false, reference, &scans_off, &ms_off);
+    run(true, hashes, &scans_on, &ms_on);
+
+    int mismatch = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        mismatch += reference[f] != hashes[f];
+    }
+    printf("  styles scanned  %7.0f scans/frame  %6.3f ms/frame\n", scans_off, ms_off);
+    printf("  style cache     %7.0f scans/frame  %6.3f ms/frame  (%5.1f %%)%s\n", scans_on, ms_on,
+           100.0 * ms_on / ms_off, mismatch ? "  MISMATCH" : "");
+    if (mismatch) {
+        printf("  %d of %d frames differ\n", mismatch, FRAMES);
+        ret = 1;
+    }
+    if (scans_on >= scans_off) {
+        printf("  the cache saved no scans\n");
+        ret = 1;
+    }
+    return ret;
+}
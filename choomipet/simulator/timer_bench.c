@@ -0,0 +1,155 @@
+/**
+ * @file timer_bench.c
+ * Calls lv_timer_handler() in a busy loop with 10, 100 and 1000 timers of
+ * 10..1000 ms periods and reports the cost of a call (host CPU), next to one
+ * walk over the timer list, which the handler did twice per call before the
+ * timers were kept in a heap. Checks that every timer runs as often as its
+ * period allows, that paused timers don't run and that one-shot timers and
+ * timers deleted from callbacks are gone.
+ */
+
+#include <stdio.h>
+#include "esp_log.h"
+#include "lvgl.h"
+#include "sim.h"
+
+#define RUN_MS          300
+#define TIMERS_MAX      1000
+
+static uint32_t runs[TIMERS_MAX];
+static uint32_t once_runs;
+static uint32_t victim_runs;
+static lv_timer_t *victim;
+
+static void count_cb(lv_timer_t *t)
+{
+    runs[(uintptr_t)t->user_data]++;
+}
+
+static void once_cb(lv_timer_t *t)
+{
+    (void)t;
+    once_runs++;
+}
+
+static void victim_cb(lv_timer_t *t)
+{
+    (void)t;
+    victim_runs++;
+}
+
+/* Deletes an other timer and creates a one-shot timer from a callback */
+static void killer_cb(lv_timer_t *t)
+{
+    if (victim) {
+        lv_timer_del(victim);
+        victim = NULL;
+        lv_timer_t *once = lv_timer_create(once_cb, 0, NULL);
+        lv_timer_set_repeat_count(once, 1);
+    }
+}
+
+static uint32_t timer_cnt(void)
+{
+    uint32_t cnt = 0;
+    for (lv_timer_t *t = lv_timer_get_next(NULL); t; t = lv_timer_get_next(t)) {
+        cnt++;
+    }
+    return cnt;
+}
+
+static int run(uint32_t n)
+{
+    int ret = 0;
+    uint32_t timers_before = timer_cnt();
+    lv_timer_t *timers[TIMERS_MAX];
+    uint32_t periods[TIMERS_MAX];
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        periods[i] = 10 + (seed >> 16) % 991;
+        runs[i] = 0;
+        timers[i] = lv_timer_create(count_cb, periods[i], (void *)(uintptr_t)i);
+    }
+    // Every 8th timer is paused and must not run
+    for (uint32_t i = 0; i < n; i += 8) {
+        lv_timer_pause(timers[i]);
+    }
+    victim_runs = 0;
+    once_runs = 0;
+    victim = lv_timer_create(victim_cb, 5, NULL);
+    lv_timer_t *killer = lv_timer_create(killer_cb, 50, NULL);
+    lv_timer_set_repeat_count(killer, 2);
+    lv_timer_t *once = lv_timer_create(once_cb, 20, NULL);
+    lv_timer_set_repeat_count(once, 1);
+
+    uint32_t calls = 0;
+    int64_t start = sim_clock_ns();
+    int64_t t_handler = 0;
+    while (sim_clock_ns() - start < RUN_MS * 1000000LL) {
+        int64_t t0 = sim_clock_ns();
+        lv_timer_handler();
+        t_handler += sim_clock_ns() - t0;
+        calls++;
+    }
+    uint32_t elapsed_ms = (uint32_t)((sim_clock_ns() - start) / 1000000);
+
+    // One walk over the list computing the time until each timer is due
+    int64_t t0 = sim_clock_ns();
+    uint32_t walks = 0, min_remaining = LV_NO_TIMER_READY;
+    while (sim_clock_ns() - t0 < 50 * 1000000LL) {
+        for (lv_timer_t *t = lv_timer_get_next(NULL); t; t = lv_timer_get_next(t)) {
+            uint32_t elp = lv_tick_elaps(t->last_run);
+            uint32_t remaining = elp >= t->period ? 0 : t->period - elp;
+            if (!t->paused && remaining < min_remaining) {
+                min_remaining = remaining;
+            }
+        }
+        walks++;
+    }
+    double walk_ns = (double)(sim_clock_ns() - t0) / walks;
+
+    uint32_t missed = 0, extra = 0, paused_ran = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (i % 8 == 0) {
+            paused_ran += runs[i] != 0;
+        } else if (runs[i] > elapsed_ms / periods[i] + 1) {
+            extra++;
+        } else if (periods[i] < elapsed_ms / 2 && runs[i] == 0) {
+            missed++;
+        }
+        lv_timer_del(timers[i]);
+    }
+    // Two one-shot timers ran once, the victim ran and was deleted by the killer
+    uint32_t left = timer_cnt() - timers_before;
+
+    printf("  %4u timers  %8.0f ns/call  %9.0f ns/list walk  %7u calls  %s\n", (unsigned)n,
+           (double)t_handler / calls, walk_ns, (unsigned)calls,
+           missed || extra || paused_ran || once_runs != 2 || victim_runs == 0 || left ? "FAIL" : "ok");
+    if (missed || extra || paused_ran) {
+        printf("    %u timers never ran, %u ran too often, %u paused timers ran\n",
+               (unsigned)missed, (unsigned)extra, (unsigned)paused_ran);
+        ret = 1;
+    }
+    if (once_runs != 2 || victim_runs == 0 || left) {
+        printf("    one-shot timers ran %u times, the victim %u times, %u timers left\n",
+               (unsigned)once_runs, (unsigned)victim_runs, (unsigned)left);
+        ret = 1;
+    }
+    return ret;
+}
+
+int main(void)
+{
+    int ret = 0;
+
+    sim_clock_init();
+    esp_log_level_set("*", ESP_LOG_WARN);
+    lv_init();
+
+    printf("lv_timer_handler() in a busy loop for %d ms, periods of 10..1000 ms (host CPU)\n", RUN_MS);
+    ret |= run(10);
+    ret |= run(100);
+    ret |= run(1000);
+    return ret;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file transform_bench.c
+ * Transforms a low resolution pet sprite at draw time with the generic path of
+ * lv_draw_sw_transform() (per pixel affine math) and with its fast paths:
+ *  - 2x, 3x and 4x pixel-art upscale (no anti-aliasing, nearest neighbor),
+ *  - 1.4x, 0.7x and 4x zoom with anti-aliasing (separable),
+ *  - rotation by 90, 180 and 270 degrees (index remapping).
+ * For every case the whole transformed sprite is computed many times with both
+ * and timed (host CPU, fastest of a few runs), then the sprite is drawn moving
+ * on a headless 172x320 display in 40 line bands. The pixels and every frame of
+ * the fast paths must be identical to the generic path. Rotation by a right
+ * angle is an exact remapping in the fast path, so with anti-aliasing its
+ * reference is the generic path without it: the generic path blends a few edge
+ * pixels there because its sine is not exact.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "lvgl.h"
+#include "src/draw/sw/lv_draw_sw.h"
+#include "sim.h"
+#include "sim_bench.h"
+
+#define HOR_RES         SIM_BENCH_HOR_RES
+#define VER_RES         SIM_BENCH_VER_RES
+#define FRAMES          20
+#define RUNS            5
+#define REPEAT          200
+#define SPRITE_SIZE     32
+#define DEST_MAX        (SPRITE_SIZE * 5)
+
+static uint8_t argb_map[SPRITE_SIZE * SPRITE_SIZE * LV_IMG_PX_SIZE_ALPHA_BYTE];
+static uint8_t rgb565a8_map[SPRITE_SIZE * SPRITE_SIZE * 3];
+static lv_img_dsc_t argb_sprite;
+static lv_img_dsc_t rgb565a8_sprite;
+
+static lv_color_t cbuf[2][DEST_MAX * DEST_MAX];
+static lv_opa_t abuf[2][DEST_MAX * DEST_MAX];
+
+/* A round pet with an outline, eyes, a blush and a soft shadow, transparent around it */
+static void sprite_px(int x, int y, lv_color_t *c, lv_opa_t *a)
+{
+    int dx = 2 * x - (SPRITE_SIZE - 1);
+    int dy = 2 * y - (SPRITE_SIZE - 1);
+    int d2 = dx * dx + dy * dy;
+    int r = SPRITE_SIZE - 4;
+    *a = LV_OPA_COVER;
+    if (d2 > r * r) {
+        /* Shadow under the body, the rest is transparent */
+        *c = lv_color_hex(0x202020);
+        *a = y > SPRITE_SIZE * 3 / 4 && d2 < (r + 6) * (r + 6) ? LV_OPA_40 : LV_OPA_TRANSP;
+    } else if (d2 > (r - 4) * (r - 4)) {
+        *c = lv_color_hex(0x5A3A22);
+    } else if ((x == 11 || x == 20) && y >= 12 && y <= 15) {
+        *c = lv_color_hex(0x101010);
+    } else if ((x == 8 || x == 23) && y == 19) {
+        *c = lv_color_hex(0xF07C8A);
+    } else {
+        *c = lv_color_hex(y < 10 ? 0xF8D0A0 : 0xF0B878);
+    }
+}
+
+static void create_sprites(void)
+{
+    lv_opa_t *alpha = rgb565a8_map + SPRITE_SIZE * SPRITE_SIZE * sizeof(lv_color_t);
+    for (int y = 0; y < SPRITE_SIZE; y++) {
+        for (int x = 0; x < SPRITE_SIZE; x++) {
+            lv_color_t c;
+            lv_opa_t a;
+            sprite_px(x, y, &c, &a);
+            uint8_t *px = &argb_map[(y * SPRITE_SIZE + x) * LV_IMG_PX_SIZE_ALPHA_BYTE];
+            px[0] = c.full & 0xFF;
+            px[1] = c.full >> 8;
+            px[2] = a;
+            ((lv_color_t *)rgb565a8_map)[y * SPRITE_SIZE + x] = c;
+            alpha[y * SPRITE_SIZE + x] = a;
+        }
+    }
+    argb_sprite.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    argb_sprite.header.w = SPRITE_SIZE;
+    argb_sprite.header.h = SPRITE_SIZE;
+    argb_sprite.data_size = sizeof(argb_map);
+    argb_sprite.data = argb_map;
+    rgb565a8_sprite.header.cf = LV_IMG_CF_RGB565A8;
+    rgb565a8_sprite.header.w = SPRITE_SIZE;
+    rgb565a8_sprite.header.h = SPRITE_SIZE;
+    rgb565a8_sprite.data_size = sizeof(rgb565a8_map);
+    rgb565a8_sprite.data = rgb565a8_map;
+}
+
+typedef struct {
+    const char *name;
+    const lv_img_dsc_t *src;
+    uint16_t zoom;
+    int16_t angle;
+    bool antialias;
+} bench_case_t;
+
+/* Render the frames of a case */
+static void run(const bench_case_t *c, bool fast, bool antialias, uint32_t *hashes)
+{
+    lv_draw_sw_transform_set_fast_paths(fast);
+    lv_obj_clean(lv_scr_act());
+    lv_obj_set_style_bg_color(lv_scr_act(), lv_color_hex(0xBFE3F5), 0);
+    lv_obj_set_style_bg_opa(lv_scr_act(), LV_OPA_COVER, 0);
+    lv_obj_t *img = lv_img_create(lv_scr_act());
+    lv_img_set_src(img, c->src);
+    lv_img_set_zoom(img, c->zoom);
+    lv_img_set_angle(img, c->angle);
+    lv_img_set_antialias(img, antialias);
+
+    for (int f = 0; f < FRAMES; f++) {
+        lv_obj_set_pos(img, 70 + (f % 8) - 4, 140 + (f % 5) * 3);
+        _lv_disp_refr_timer(lv_disp_get_default()->refr_timer);
+        hashes[f] = sim_bench_frame_hash();
+    }
+    lv_draw_sw_transform_set_fast_paths(true);
+}
+
+/* Transform the whole sprite into `cbuf[b]`, `abuf[b]`, return the time of a transform [us] (fastest run) */
+static double time_transform(const bench_case_t *c, bool fast, bool antialias, int b, lv_coord_t *px_cnt)
+{
+    lv_draw_img_dsc_t dsc;
+    lv_draw_img_dsc_init(&dsc);
+    dsc.zoom = c->zoom;
+    dsc.angle = c->angle;
+    dsc.antialias = antialias;
+    dsc.pivot.x = SPRITE_SIZE / 2;
+    dsc.pivot.y = SPRITE_SIZE / 2;
+    lv_area_t dest;
+    _lv_img_buf_get_transformed_area(&dest, SPRITE_SIZE, SPRITE_SIZE, dsc.angle, dsc.zoom, &dsc.pivot);
+    *px_cnt = (lv_coord_t)lv_area_get_size(&dest);
+
+    lv_draw_sw_transform_set_fast_paths(fast);
+    int64_t best = INT64_MAX;
+    for (int r = 0; r < RUNS; r++) {
+        int64_t t0 = sim_clock_ns();
+        for (int n = 0; n < REPEAT; n++) {
+            lv_draw_sw_transform(NULL, &dest, c->src->data, SPRITE_SIZE, SPRITE_SIZE, SPRITE_SIZE, &dsc,
+                                 c->src->header.cf, cbuf[b], abuf[b]);
+        }
+        int64_t t = sim_clock_ns() - t0;
+        if (t < best) {
+            best = t;
+        }
+    }
+    lv_draw_sw_transform_set_fast_paths(true);
+    return (double)best / REPEAT / 1e3;
+}
+
+/* The pixels of the two transforms which differ (the color of transparent pixels doesn't matter) */
+static int diff_pixels(lv_coord_t px_cnt)
+{
+    int diff = 0;
+    for (lv_coord_t i = 0; i < px_cnt; i++) {
+        diff += abuf[0][i] != abuf[1][i] || (abuf[0][i] && cbuf[0][i].full != cbuf[1][i].full);
+    }
+    return diff;
+}
+
+static void print_result(const char *name, const char *cf, lv_coord_t px_cnt, double generic_us,
+                         double fast_us, int mismatch)
+{
+    printf("  %-22s %-8s %6d px %8.2f us generic %8.2f us fast  (%5.1f %%)%s\n", name, cf, px_cnt, generic_us,
+           fast_us, 100.0 * fast_us / generic_us, mismatch ? "  MISMATCH" : "");
+}
+
+int main(void)
+{
+    static uint32_t reference[FRAMES], hashes[FRAMES];
+    int ret = 0;
+
+    sim_bench_init();
+    create_sprites();
+
+    static const bench_case_t cases[] = {
+        { "2x nearest", &argb_sprite, 512, 0, false },
+        { "3x nearest", &argb_sprite, 768, 0, false },
+        { "4x nearest", &argb_sprite, 1024, 0, false },
+        { "4x nearest", &rgb565a8_sprite, 1024, 0, false },
+        { "1.4x nearest", &argb_sprite, 358, 0, false },
+        { "1.4x anti-aliased", &argb_sprite, 358, 0, true },
+        { "0.7x anti-aliased", &rgb565a8_sprite, 179, 0, true },
+        { "4x anti-aliased", &argb_sprite, 1024, 0, true },
+        { "90 deg", &argb_sprite, LV_IMG_ZOOM_NONE, 900, false },
+        { "180 deg", &argb_sprite, LV_IMG_ZOOM_NONE, 1800, false },
+        { "270 deg", &rgb565a8_sprite, LV_IMG_ZOOM_NONE, 2700, false },
+        { "90 deg anti-aliased", &argb_sprite, LV_IMG_ZOOM_NONE, 900, true },
+        { "270 deg anti-aliased", &rgb565a8_sprite, LV_IMG_ZOOM_NONE, 2700, true },
+    };
+
+    printf("image transforms of a %dx%d sprite, %d times (host CPU, fastest of %d), then drawn in %d frames\n",
+           SPRITE_SIZE, SPRITE_SIZE, REPEAT, RUNS, FRAMES);
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const bench_case_t *c = &cases[i];
+        const char *cf = c->src == &argb_sprite ? "ARGB" : "RGB565A8";
+        /* The exact rotation is what the generic path draws without anti-aliasing */
+        bool ref_antialias = c->antialias && c->angle == 0;
+        lv_coord_t px_cnt;
+        double generic_us = time_transform(c, false, c->antialias, 0, &px_cnt);
+        if (ref_antialias != c->antialias) {
+            time_transform(c, false, ref_antialias, 0, &px_cnt);
+        }
+        double fast_us = time_transform(c, true, c->antialias, 1, &px_cnt);
+        int diff = diff_pixels(px_cnt);
+
+        run(c, false, ref_antialias, reference);
+        run(c, true, c->antialias, hashes);
+        int mismatch = 0;
+        for (int f = 0; f < FRAMES; f++) {
+            mismatch += reference[f] != hashes[f];
+        }
+        print_result(c->name, cf, px_cnt, generic_us, fast_us, diff || mismatch);
+        if (diff || mismatch) {
+            printf("  %d pixels and %d of %d frames differ\n", diff, mismatch, FRAMES);
+            ret = 1;
+        }
+    }
+    return ret;
+}
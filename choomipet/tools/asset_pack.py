@@ -0,0 +1,259 @@
+#!/usr/bin/env python3
+"""
+Builds the asset pack the firmware maps from the flash_test partition
+(components/asset_pack/Asset_Pack.h) and lists existing packs.
+
+Every input file becomes one index entry named after the file: `jiumi.png`
+is the image "jiumi", `blink.0.png`, `blink.1.png`... are the frames of
+"blink". Accepted inputs:
+
+  *.ppm / *.pgm   binary PPM (P6) or PGM (P5), 8 bit, no dependencies
+  *.bin           LVGL binary images (4-byte lv_img_header_t + pixels), copied as is
+  anything else   any image Pillow can open (pip install pillow)
+
+Colour images become LV_IMG_CF_TRUE_COLOR (RGB565), or
+LV_IMG_CF_TRUE_COLOR_ALPHA (RGB565 + A8) when they have transparent pixels.
+16 bit pixels are stored MSB first to match LV_COLOR_16_SWAP 1 in
+main/lv_conf.h; pass --no-swap for a firmware built with LV_COLOR_16_SWAP 0.
+With --rle these become LV_IMG_CF_RLE_TRUE_COLOR(_ALPHA), run-length encoded
+rows behind a row index (see lv_img_buf.h), whenever that is smaller.
+
+  python tools/asset_pack.py -o assets.bin art/jiumi.png art/blink.*.png
+  python tools/asset_pack.py --rle -o assets.bin art/*.png
+  python tools/asset_pack.py --list assets.bin
+  parttool.py --port PORT write_partition --partition-name flash_test --input assets.bin
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+MAGIC = 0x4B415043  # "CPAK"
+VERSION = 1
+NAME_MAX = 24
+ALIGN = 4
+FLAG_COLOR_16_SWAP = 0x0001
+PARTITION_SIZE = 528 * 1024
+
+HEADER = struct.Struct("<IHHIHH")
+ENTRY = struct.Struct("<%dsHHIII" % NAME_MAX)
+
+CF_TRUE_COLOR = 4
+CF_TRUE_COLOR_ALPHA = 5
+CF_RLE_TRUE_COLOR = 21
+CF_RLE_TRUE_COLOR_ALPHA = 22
+CF_NAMES = {
+    4: "TRUE_COLOR", 5: "TRUE_COLOR_ALPHA", 6: "TRUE_COLOR_CHROMA_KEYED",
+    7: "INDEXED_1BIT", 8: "INDEXED_2BIT", 9: "INDEXED_4BIT", 10: "INDEXED_8BIT",
+    11: "ALPHA_1BIT", 12: "ALPHA_2BIT", 13: "ALPHA_4BIT", 14: "ALPHA_8BIT",
+    21: "RLE_TRUE_COLOR", 22: "RLE_TRUE_COLOR_ALPHA",
+}
+RLE_CF = {CF_TRUE_COLOR: CF_RLE_TRUE_COLOR, CF_TRUE_COLOR_ALPHA: CF_RLE_TRUE_COLOR_ALPHA}
+
+
+def img_header(cf, w, h):
+    """lv_img_header_t on a little-endian target: cf:5, always_zero:3, reserved:2, w:11, h:11"""
+    if not 0 < w < 2048 or not 0 < h < 2048:
+        raise ValueError("%dx%d does not fit lv_img_header_t" % (w, h))
+    return cf | w << 10 | h << 21
+
+
+def parse_img_header(word):
+    return word & 0x1F, (word >> 10) & 0x7FF, (word >> 21) & 0x7FF
+
+
+def rgb565(r, g, b, swap):
+    c = (r >> 3) << 11 | (g >> 2) << 5 | b >> 3
+    return struct.pack(">H" if swap else "<H", c)
+
+
+def encode(w, h, pixels, swap):
+    """pixels: w*h (r, g, b, a) tuples"""
+    alpha = any(p[3] != 255 for p in pixels)
+    out = bytearray()
+    for r, g, b, a in pixels:
+        out += rgb565(r, g, b, swap)
+        if alpha:
+            out.append(a)
+    return (CF_TRUE_COLOR_ALPHA if alpha else CF_TRUE_COLOR), bytes(out)
+
+
+def rle_encode(w, h, px_size, data):
+    """Row offsets (uint32 LE from the start of the data), then per row packets of a
+    control byte c: c < 0x80 is c + 1 literal pixels, else one pixel repeated (c & 0x7F) + 1 times"""
+    index = bytearray()
+    rows = bytearray()
+    for y in range(h):
+        index += struct.pack("<I", h * 4 + len(rows))
+        row = [data[(y * w + x) * px_size:(y * w + x + 1) * px_size] for x in range(w)]
+        x = 0
+        literal = []
+        while x < w:
+            n = 1
+            while x + n < w and n < 128 and row[x + n] == row[x]:
+                n += 1
+            if n == 1:
+                literal.append(row[x])
+            if literal and (n > 1 or len(literal) == 128 or x + 1 == w):
+                rows.append(len(literal) - 1)
+                rows += b"".join(literal)
+                literal = []
+            if n > 1:
+                rows.append(0x80 | (n - 1))
+                rows += row[x]
+            x += n
+    return bytes(index + rows)
+
+
+def read_pnm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    tokens = []
+    pos = 0
+    # Magic, width, height, maxval, separated by whitespace and comments, then one whitespace byte
+    while len(tokens) < 4:
+        m = re.compile(rb"\s*(#[^\n]*\n\s*)*(\S+)").match(data, pos)
+        if m is None:
+            raise ValueError("%s: truncated PNM header" % path)
+        tokens.append(m.group(2))
+        pos = m.end()
+    magic, w, h, maxval = tokens[0], int(tokens[1]), int(tokens[2]), int(tokens[3])
+    if magic not in (b"P5", b"P6") or maxval != 255:
+        raise ValueError("%s: only 8 bit binary PPM (P6) and PGM (P5) are supported" % path)
+    pos += 1
+    ch = 3 if magic == b"P6" else 1
+    raw = data[pos:pos + w * h * ch]
+    if len(raw) != w * h * ch:
+        raise ValueError("%s: truncated pixel data" % path)
+    if ch == 3:
+        pixels = [(raw[i], raw[i + 1], raw[i + 2], 255) for i in range(0, len(raw), 3)]
+    else:
+        pixels = [(v, v, v, 255) for v in raw]
+    return w, h, pixels
+
+
+def read_pillow(path):
+    try:
+        from PIL import Image
+    except ImportError:
+        raise ValueError("%s: install Pillow to read this format, or convert it to PPM" % path)
+    img = Image.open(path).convert("RGBA")
+    return img.width, img.height, list(img.getdata())
+
+
+def load(path, swap, rle):
+    """Returns (lv_img_header_t word, pixel bytes)"""
+    ext = os.path.splitext(path)[1].lower()
+    if ext == ".bin":
+        with open(path, "rb") as f:
+            data = f.read()
+        if len(data) < 4:
+            raise ValueError("%s: not an LVGL binary image" % path)
+        word = struct.unpack_from("<I", data)[0]
+        cf, w, h = parse_img_header(word)
+        if word & 0xE0 or cf == 0:
+            raise ValueError("%s: not an LVGL binary image" % path)
+        return word, data[4:]
+    w, h, pixels = read_pnm(path) if ext in (".ppm", ".pgm") else read_pillow(path)
+    cf, data = encode(w, h, pixels, swap)
+    if rle:
+        packed = rle_encode(w, h, 3 if cf == CF_TRUE_COLOR_ALPHA else 2, data)
+        if len(packed) < len(data):
+            cf, data = RLE_CF[cf], packed
+    return img_header(cf, w, h), data
+
+
+def entry_key(path):
+    """jiumi.png -> ("jiumi", 0, False), blink.3.png -> ("blink", 3, True)"""
+    stem = os.path.splitext(os.path.basename(path))[0]
+    m = re.match(r"^(.*)\.(\d+)$", stem)
+    name, frame, is_frame = (m.group(1), int(m.group(2)), True) if m else (stem, 0, False)
+    raw = name.encode("utf-8")
+    if not raw or len(raw) >= NAME_MAX:
+        raise ValueError("%s: the name must be 1 to %d bytes" % (path, NAME_MAX - 1))
+    return raw, frame, is_frame
+
+
+def build(paths, swap, max_size, rle=False):
+    entries = {}
+    for path in paths:
+        name, frame, is_frame = entry_key(path)
+        if (name, frame) in entries:
+            raise ValueError("%s: %s frame %d given twice" % (path, name.decode(), frame))
+        word, data = load(path, swap, rle)
+        entries[(name, frame)] = (word, data, is_frame)
+
+    # The firmware binary-searches the index: sort exactly like its strncmp on NUL-padded names
+    keys = sorted(entries, key=lambda k: (k[0].ljust(NAME_MAX, b"\0"), k[1]))
+    frames = {}
+    for name, frame in keys:
+        frames[name] = frames.get(name, 0) + 1
+    for name, count in frames.items():
+        got = sorted(f for n, f in keys if n == name)
+        if got != list(range(count)):
+            raise ValueError("%s: frames must be numbered 0 .. %d without gaps" % (name.decode(), count - 1))
+
+    offset = HEADER.size + ENTRY.size * len(keys)
+    index = bytearray()
+    blobs = bytearray()
+    for name, frame in keys:
+        word, data, _ = entries[(name, frame)]
+        pad = -(offset + len(blobs)) % ALIGN
+        blobs += b"\0" * pad
+        index += ENTRY.pack(name, frame, frames[name], word, offset + len(blobs), len(data))
+        blobs += data
+
+    size = offset + len(blobs)
+    if size > max_size:
+        raise ValueError("pack is %d bytes, the partition holds %d" % (size, max_size))
+    header = HEADER.pack(MAGIC, VERSION, len(keys), size, FLAG_COLOR_16_SWAP if swap else 0, ENTRY.size)
+    return header + bytes(index) + bytes(blobs)
+
+
+def list_pack(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, count, size, flags, entry_size = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION or entry_size != ENTRY.size:
+        raise ValueError("%s: not a version %d asset pack" % (path, VERSION))
+    print("%s: %d entries, %d bytes, 16 bit pixels %s first" % (path, count, size,
+          "MSB" if flags & FLAG_COLOR_16_SWAP else "LSB"))
+    for i in range(count):
+        name, frame, frames, word, offset, length = ENTRY.unpack_from(data, HEADER.size + i * ENTRY.size)
+        cf, w, h = parse_img_header(word)
+        label = name.rstrip(b"\0").decode("utf-8", "replace")
+        if frames > 1:
+            label += " [%d/%d]" % (frame, frames)
+        print("  %-28s %4dx%-4d %-24s %7d bytes @ 0x%06X" % (label, w, h, CF_NAMES.get(cf, str(cf)), length, offset))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0].strip())
+    parser.add_argument("inputs", nargs="*", help="images, one index entry each")
+    parser.add_argument("-o", "--output", help="pack file to write")
+    parser.add_argument("--no-swap", action="store_true", help="store 16 bit pixels LSB first (LV_COLOR_16_SWAP 0)")
+    parser.add_argument("--rle", action="store_true", help="run-length encode colour images when that is smaller")
+    parser.add_argument("--max-size", type=int, default=PARTITION_SIZE, help="partition size in bytes (default 528K)")
+    parser.add_argument("--list", metavar="PACK", help="print the index of an existing pack")
+    args = parser.parse_args()
+
+    try:
+        if args.list:
+            list_pack(args.list)
+            return 0
+        if not args.output or not args.inputs:
+            parser.error("give -o PACK and at least one input, or --list PACK")
+        pack = build(args.inputs, not args.no_swap, args.max_size, args.rle)
+    except (OSError, ValueError) as e:
+        print("asset_pack: %s" % e, file=sys.stderr)
+        return 1
+    with open(args.output, "wb") as f:
+        f.write(pack)
+    print("%s: %d bytes" % (args.output, len(pack)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())